@@ -0,0 +1,58 @@
+/*
+    DATE-OBS for exposures started before the driver was asked for them
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+
+#include <indiccd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#include <sys/time.h>
+
+/**
+ * @brief Replace the DATE-OBS record added by INDI::CCD::addFITSKeywords.
+ *
+ * The chip stamps the exposure start when StartExposure() is called. Drivers
+ * that pick up an exposure the camera started earlier, at the end of the
+ * previous frame, call this with the real start time.
+ */
+inline void setFITSDateObs(std::vector<INDI::FITSRecord> &fitsKeywords, const struct timeval &start)
+{
+    char ts[32] = {0};
+    struct tm utc;
+    time_t secs = start.tv_sec;
+    gmtime_r(&secs, &utc);
+    size_t len = strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%S", &utc);
+    snprintf(ts + len, sizeof(ts) - len, ".%03d", static_cast<int>(start.tv_usec / 1000));
+
+    for (auto &record : fitsKeywords)
+    {
+        if (record.key() == "DATE-OBS")
+            record = INDI::FITSRecord("DATE-OBS", ts, "UTC start date of observation");
+    }
+}
+
+inline void setFITSDateObs(std::vector<INDI::FITSRecord> &fitsKeywords, std::chrono::system_clock::time_point start)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count();
+    struct timeval tv;
+    tv.tv_sec  = static_cast<time_t>(us / 1000000);
+    tv.tv_usec = static_cast<suseconds_t>(us % 1000000);
+    setFITSDateObs(fitsKeywords, tv);
+}
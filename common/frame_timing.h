@@ -0,0 +1,264 @@
+/*
+    Per frame timing instrumentation for SDK camera worker loops
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Stage timings of the frame path, recorded lock free by the worker
+ * thread and aggregated into log2 histograms.
+ *
+ * Recording is a handful of relaxed atomic adds and costs nothing when the
+ * timing is disabled. The last TRACE_SIZE frames are also kept in a ring so
+ * they can be written to a CSV trace file. The ring is guarded by a mutex,
+ * taken once per frame by the worker and only briefly by the readers.
+ *
+ * Shared by the ASI, PlayerOne and SVBONY drivers.
+ */
+class FrameTiming
+{
+    public:
+        enum Stage
+        {
+            STAGE_SDK_WAIT,     /* Waiting in the SDK for frame data */
+            STAGE_BUFFER_LOCK,  /* Waiting for the CCD buffer lock */
+            STAGE_CONVERT,      /* Pixel format conversion */
+            STAGE_HANDOFF,      /* Hand off to the streamer or ExposureComplete */
+            STAGE_COUNT
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+        /** Records the time spent in its scope to the given stage. */
+        class Scope
+        {
+            public:
+                Scope(FrameTiming &timing, Stage stage)
+                    : mTiming(timing), mStage(stage), mEnabled(timing.isEnabled())
+                {
+                    if (mEnabled)
+                        mStart = Clock::now();
+                }
+                ~Scope()
+                {
+                    if (mEnabled)
+                        mTiming.record(mStage, Clock::now() - mStart);
+                }
+
+            private:
+                FrameTiming &mTiming;
+                Stage mStage;
+                bool mEnabled;
+                Clock::time_point mStart;
+        };
+
+        bool isEnabled() const
+        {
+            return mEnabled.load(std::memory_order_relaxed);
+        }
+
+        void setEnabled(bool enabled)
+        {
+            mEnabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        void record(Stage stage, Clock::duration elapsed)
+        {
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            Histogram &h = mStages[stage];
+
+            h.count.fetch_add(1, std::memory_order_relaxed);
+            h.sumNs.fetch_add(ns, std::memory_order_relaxed);
+            h.bucket[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+
+            uint64_t max = h.maxNs.load(std::memory_order_relaxed);
+            while (ns > max && !h.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+                ;
+
+            mCurrent.stageUs[stage] += static_cast<uint32_t>(ns / 1000);
+        }
+
+        /** Close the current frame. Only the worker thread may call this. */
+        void frameDone()
+        {
+            if (!isEnabled())
+                return;
+
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+            int64_t zero = 0;
+            mFirstFrameNs.compare_exchange_strong(zero, now, std::memory_order_relaxed);
+            mLastFrameNs.store(now, std::memory_order_relaxed);
+            mFrames.fetch_add(1, std::memory_order_relaxed);
+
+            mCurrent.timestampNs = now;
+            {
+                std::lock_guard<std::mutex> lock(mTraceLock);
+                mTrace[mTraceHead % TRACE_SIZE] = mCurrent;
+                mTraceHead++;
+            }
+            mCurrent = TraceRecord();
+        }
+
+        /** Returns true at most once per period, used to rate limit publishing. */
+        bool shouldPublish(std::chrono::milliseconds period = std::chrono::milliseconds(1000))
+        {
+            Clock::time_point now = Clock::now();
+            if (now - mLastPublish < period)
+                return false;
+            mLastPublish = now;
+            return true;
+        }
+
+        void reset()
+        {
+            for (auto &h : mStages)
+            {
+                h.count = 0;
+                h.sumNs = 0;
+                h.maxNs = 0;
+                for (auto &b : h.bucket)
+                    b = 0;
+            }
+            mFrames = 0;
+            mFirstFrameNs = 0;
+            mLastFrameNs = 0;
+
+            std::lock_guard<std::mutex> lock(mTraceLock);
+            mTraceHead = 0;
+        }
+
+        /** Mean time of the stage in milliseconds. */
+        double mean(Stage stage) const
+        {
+            const Histogram &h = mStages[stage];
+            uint64_t count = h.count.load(std::memory_order_relaxed);
+            return count ? h.sumNs.load(std::memory_order_relaxed) / 1e6 / count : 0;
+        }
+
+        /** Longest time of the stage in milliseconds. */
+        double max(Stage stage) const
+        {
+            return mStages[stage].maxNs.load(std::memory_order_relaxed) / 1e6;
+        }
+
+        /** Upper bound of the histogram bucket holding the given percentile, in milliseconds. */
+        double percentile(Stage stage, double p) const
+        {
+            const Histogram &h = mStages[stage];
+            uint64_t count = h.count.load(std::memory_order_relaxed);
+            if (count == 0)
+                return 0;
+
+            uint64_t target = static_cast<uint64_t>(count * p / 100.0 + 0.5), seen = 0;
+            for (int i = 0; i < BUCKETS; i++)
+            {
+                seen += h.bucket[i].load(std::memory_order_relaxed);
+                if (seen >= target)
+                    return (1ULL << i) / 1e3;
+            }
+            return max(stage);
+        }
+
+        double framesPerSecond() const
+        {
+            uint64_t frames = mFrames.load(std::memory_order_relaxed);
+            int64_t span = mLastFrameNs.load(std::memory_order_relaxed) - mFirstFrameNs.load(std::memory_order_relaxed);
+            return (frames > 1 && span > 0) ? (frames - 1) * 1e9 / span : 0;
+        }
+
+        uint64_t frames() const
+        {
+            return mFrames.load(std::memory_order_relaxed);
+        }
+
+        /** Write the most recent frames as CSV, one line per frame. */
+        bool dumpTrace(const char *path) const
+        {
+            // Snapshot the ring so the file is written without holding up the worker.
+            std::vector<TraceRecord> records;
+            {
+                std::lock_guard<std::mutex> lock(mTraceLock);
+                uint64_t first = mTraceHead > TRACE_SIZE ? mTraceHead - TRACE_SIZE : 0;
+                records.reserve(mTraceHead - first);
+                for (uint64_t i = first; i < mTraceHead; i++)
+                    records.push_back(mTrace[i % TRACE_SIZE]);
+            }
+
+            FILE *fp = fopen(path, "w");
+            if (fp == nullptr)
+                return false;
+
+            fprintf(fp, "timestamp_ns,sdk_wait_us,buffer_lock_us,convert_us,handoff_us\n");
+            for (const TraceRecord &r : records)
+                fprintf(fp, "%lld,%u,%u,%u,%u\n", static_cast<long long>(r.timestampNs),
+                        r.stageUs[STAGE_SDK_WAIT], r.stageUs[STAGE_BUFFER_LOCK],
+                        r.stageUs[STAGE_CONVERT], r.stageUs[STAGE_HANDOFF]);
+
+            fclose(fp);
+            return true;
+        }
+
+    private:
+        static constexpr int BUCKETS = 40;        /* log2 buckets of microseconds */
+        static constexpr size_t TRACE_SIZE = 4096;
+
+        static int bucketOf(uint64_t ns)
+        {
+            uint64_t us = ns / 1000;
+            int bucket = 0;
+            while (us > 0 && bucket < BUCKETS - 1)
+            {
+                us >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+        struct Histogram
+        {
+            std::atomic<uint64_t> count {0};
+            std::atomic<uint64_t> sumNs {0};
+            std::atomic<uint64_t> maxNs {0};
+            std::array<std::atomic<uint64_t>, BUCKETS> bucket {};
+        };
+
+        struct TraceRecord
+        {
+            int64_t timestampNs {0};
+            uint32_t stageUs[STAGE_COUNT] {};
+        };
+
+        std::atomic<bool> mEnabled {false};
+        std::array<Histogram, STAGE_COUNT> mStages;
+
+        std::atomic<uint64_t> mFrames {0};
+        std::atomic<int64_t> mFirstFrameNs {0};
+        std::atomic<int64_t> mLastFrameNs {0};
+        Clock::time_point mLastPublish;
+
+        TraceRecord mCurrent;
+        mutable std::mutex mTraceLock;
+        std::array<TraceRecord, TRACE_SIZE> mTrace {};
+        uint64_t mTraceHead {0};
+};
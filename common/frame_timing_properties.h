@@ -0,0 +1,217 @@
+/*
+    INDI properties for the per frame timing instrumentation
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+
+#include "frame_timing.h"
+
+#include <defaultdevice.h>
+#include <indilogger.h>
+#include <indipropertynumber.h>
+#include <indipropertyswitch.h>
+#include <indipropertytext.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+/**
+ * @brief The CCD_FRAME_TIMING properties of a camera driver.
+ *
+ * Turns the timing on and off, resets it, dumps the trace and publishes the
+ * aggregated stage times. The driver owns one next to its FrameTiming and
+ * forwards its initProperties, updateProperties, ISNewSwitch, ISNewText and
+ * saveConfigItems calls to it.
+ */
+class FrameTimingProperties
+{
+    public:
+        explicit FrameTimingProperties(FrameTiming &timing) : mTiming(timing) {}
+
+        void initProperties(INDI::DefaultDevice *device)
+        {
+            mDevice = device;
+            const char *dev = device->getDeviceName();
+
+            FrameTimingSP[TIMING_ON].fill("TIMING_ON", "On", ISS_OFF);
+            FrameTimingSP[TIMING_OFF].fill("TIMING_OFF", "Off", ISS_ON);
+            FrameTimingSP.fill(dev, "CCD_FRAME_TIMING", "Frame Timing", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+            FrameTimingActionSP[TIMING_RESET].fill("TIMING_RESET", "Reset", ISS_OFF);
+            FrameTimingActionSP[TIMING_DUMP].fill("TIMING_DUMP", "Dump Trace", ISS_OFF);
+            FrameTimingActionSP.fill(dev, "CCD_FRAME_TIMING_ACTION", "Timing", OPTIONS_TAB, IP_RW, ISR_ATMOST1, 60,
+                                     IPS_IDLE);
+
+            FrameTimingNP[TIMING_FPS].fill("FPS", "Frames/s", "%.2f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_SDK_WAIT_MEAN].fill("SDK_WAIT_MEAN", "SDK wait (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_SDK_WAIT_P95].fill("SDK_WAIT_P95", "SDK wait p95 (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_LOCK_WAIT_MEAN].fill("LOCK_WAIT_MEAN", "Lock wait (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_LOCK_WAIT_P95].fill("LOCK_WAIT_P95", "Lock wait p95 (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_CONVERT_MEAN].fill("CONVERT_MEAN", "Convert (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_CONVERT_P95].fill("CONVERT_P95", "Convert p95 (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_HANDOFF_MEAN].fill("HANDOFF_MEAN", "Hand-off (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP[TIMING_HANDOFF_P95].fill("HANDOFF_P95", "Hand-off p95 (ms)", "%.3f", 0, 0, 0, 0);
+            FrameTimingNP.fill(dev, "CCD_FRAME_TIMING_STATS", "Timing Stats", OPTIONS_TAB, IP_RO, 60, IPS_IDLE);
+
+            FrameTimingDirTP[0].fill("TIMING_DIR", "Directory", "/tmp");
+            FrameTimingDirTP.fill(dev, "CCD_FRAME_TIMING_DIR", "Timing Trace", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+        }
+
+        void updateProperties(bool connected)
+        {
+            if (connected)
+            {
+                mDevice->defineProperty(FrameTimingSP);
+                mDevice->defineProperty(FrameTimingActionSP);
+                mDevice->defineProperty(FrameTimingDirTP);
+                mDevice->defineProperty(FrameTimingNP);
+            }
+            else
+            {
+                mDevice->deleteProperty(FrameTimingSP);
+                mDevice->deleteProperty(FrameTimingActionSP);
+                mDevice->deleteProperty(FrameTimingDirTP);
+                mDevice->deleteProperty(FrameTimingNP);
+            }
+        }
+
+        bool ISNewSwitch(const char *name, ISState *states, char *names[], int n)
+        {
+            if (FrameTimingSP.isNameMatch(name))
+            {
+                FrameTimingSP.update(states, names, n);
+                mTiming.setEnabled(FrameTimingSP[TIMING_ON].getState() == ISS_ON);
+                FrameTimingSP.setState(IPS_OK);
+                FrameTimingSP.apply();
+                return true;
+            }
+
+            if (FrameTimingActionSP.isNameMatch(name))
+            {
+                FrameTimingActionSP.update(states, names, n);
+                FrameTimingActionSP.setState(IPS_OK);
+
+                if (FrameTimingActionSP[TIMING_RESET].getState() == ISS_ON)
+                {
+                    mTiming.reset();
+                    publish();
+                }
+                else if (FrameTimingActionSP[TIMING_DUMP].getState() == ISS_ON)
+                    dumpTrace();
+
+                FrameTimingActionSP.reset();
+                FrameTimingActionSP.apply();
+                return true;
+            }
+
+            return false;
+        }
+
+        bool ISNewText(const char *name, char *texts[], char *names[], int n)
+        {
+            if (FrameTimingDirTP.isNameMatch(name))
+            {
+                FrameTimingDirTP.update(texts, names, n);
+                FrameTimingDirTP.setState(IPS_OK);
+                FrameTimingDirTP.apply();
+                return true;
+            }
+
+            return false;
+        }
+
+        void saveConfigItems(FILE *fp)
+        {
+            FrameTimingDirTP.save(fp);
+        }
+
+        /** Close the current frame and publish the stage times at most once per second. */
+        void frameDone()
+        {
+            mTiming.frameDone();
+            if (mTiming.isEnabled() && mTiming.shouldPublish())
+                publish();
+        }
+
+        /** Send the aggregated frame timing to the client */
+        void publish()
+        {
+            FrameTimingNP[TIMING_FPS].setValue(mTiming.framesPerSecond());
+            for (int i = 0; i < FrameTiming::STAGE_COUNT; i++)
+            {
+                auto stage = static_cast<FrameTiming::Stage>(i);
+                FrameTimingNP[TIMING_SDK_WAIT_MEAN + 2 * i].setValue(mTiming.mean(stage));
+                FrameTimingNP[TIMING_SDK_WAIT_P95 + 2 * i].setValue(mTiming.percentile(stage, 95));
+            }
+            FrameTimingNP.setState(IPS_OK);
+            FrameTimingNP.apply();
+        }
+
+    private:
+        void dumpTrace()
+        {
+            const char *dev = mDevice->getDeviceName();
+            std::string file = std::string(dev) + "_timing_" + std::to_string(time(nullptr)) + ".csv";
+            std::replace(file.begin(), file.end(), ' ', '_');
+            std::string path = std::string(FrameTimingDirTP[0].getText()) + "/" + file;
+
+            if (mTiming.dumpTrace(path.c_str()))
+                DEBUGFDEVICE(dev, INDI::Logger::DBG_SESSION, "Frame timing trace written to %s", path.c_str());
+            else
+            {
+                DEBUGFDEVICE(dev, INDI::Logger::DBG_ERROR, "Failed to write frame timing trace to %s (%s).", path.c_str(),
+                             strerror(errno));
+                FrameTimingActionSP.setState(IPS_ALERT);
+            }
+        }
+
+        FrameTiming &mTiming;
+        INDI::DefaultDevice *mDevice {nullptr};
+
+        INDI::PropertySwitch FrameTimingSP {2};
+        enum
+        {
+            TIMING_ON,
+            TIMING_OFF
+        };
+
+        INDI::PropertySwitch FrameTimingActionSP {2};
+        enum
+        {
+            TIMING_RESET,
+            TIMING_DUMP
+        };
+
+        // Directory the frame timing trace is written to
+        INDI::PropertyText FrameTimingDirTP {1};
+
+        INDI::PropertyNumber FrameTimingNP {9};
+        enum
+        {
+            TIMING_FPS,
+            TIMING_SDK_WAIT_MEAN,
+            TIMING_SDK_WAIT_P95,
+            TIMING_LOCK_WAIT_MEAN,
+            TIMING_LOCK_WAIT_P95,
+            TIMING_CONVERT_MEAN,
+            TIMING_CONVERT_P95,
+            TIMING_HANDOFF_MEAN,
+            TIMING_HANDOFF_P95
+        };
+};
@@ -33,7 +33,9 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
-#include <regex>
+
+#include <cctype>
+#include <cerrno>
 
 #include <limits.h>
 
@@ -60,6 +62,7 @@ const char *CloudWatcherController::getDeviceName()
 void CloudWatcherController::setPortFD(int newPortFD)
 {
     PortFD = newPortFD;
+    resetWindows();
 }
 
 void CloudWatcherController::setAnemometerType(enum ANEMOMETER_TYPE type)
@@ -81,99 +84,134 @@ bool CloudWatcherController::getAllData(CloudWatcherData *cwd)
     timeval begin;
     gettimeofday(&begin, nullptr);
 
-    int skyTemperature[NUMBER_OF_READS] = {0};
-    int sensorTemperature[NUMBER_OF_READS] = {0};
-    int rainFrequency[NUMBER_OF_READS] = {0};
-    int internalSupplyVoltage[NUMBER_OF_READS] = {0};
-    float tempEstimate[NUMBER_OF_READS] = {0};
-    int ldrValue[NUMBER_OF_READS] = {0};
-    int lightFreq[NUMBER_OF_READS] = {0};
-    int rainSensorTemperature[NUMBER_OF_READS] = {0};
-    float wind[NUMBER_OF_READS] = {0};
-    float temperature[NUMBER_OF_READS] = {0};
-    float humidity[NUMBER_OF_READS] = {0};
-    float pressure[NUMBER_OF_READS] = {0};
-
-    for (int i = 0; i < NUMBER_OF_READS; i++)
+    int skyTemperature = 0;
+    int sensorTemperature = 0;
+    int rainFrequency = 0;
+    int internalSupplyVoltage = 0;
+    float tempEstimate = 0;
+    int ldrValue = 0;
+    int lightFreq = 0;
+    int rainSensorTemperature = 0;
+    float wind = 0;
+    float temperature = 0;
+    float humidity = 0;
+    float pressure = 0;
+
+    // All requests of a batch are written at once so the device answers them back
+    // to back instead of idling while we parse. Answers are read in the same order.
+    if (!sendCloudwatcherCommand("S!T!E!C!", 8))
+        return false;
+
+    check = getIRSkyTemperature(skyTemperature, false);
+
+    if (!check)
     {
-        check = getIRSkyTemperature(skyTemperature[i]);
+        LOG_ERROR( "ERROR in getIRSkyTemperature" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getIRSkyTemperature" );
-            return false;
-        }
+    check = getIRSensorTemperature(sensorTemperature, false);
 
-        check = getIRSensorTemperature(sensorTemperature[i]);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getIRSensorTemperature" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getIRSensorTemperature" );
-            return false;
-        }
+    check = getRainFrequency(rainFrequency, false);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getRainFrequency" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        check = getRainFrequency(rainFrequency[i]);
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getIRSensorTemperature" );
-            return false;
-        }
+    check = getValues(&internalSupplyVoltage, &tempEstimate, &ldrValue, &lightFreq, &rainSensorTemperature, false);
 
-        check = getValues(&internalSupplyVoltage[i], &tempEstimate[i], &ldrValue[i], &lightFreq[i],
-                          &rainSensorTemperature[i]);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getValues" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getValues" );
-            return false;
-        }
+    // Only request what the firmware and hardware support, the getters skip the rest
+    char batch[9] = {0};
+    if (m_FirmwareVersion >= 5 && m_AnemometerStatus)
+        strcat(batch, "V!");
+    if (m_FirmwareVersion >= 5.6)
+        strcat(batch, "t!h!");
+    if (m_FirmwareVersion >= 5.8)
+        strcat(batch, "p!");
 
-        check = getWindSpeed(wind[i]);
+    if (batch[0] && !sendCloudwatcherCommand(batch, strlen(batch)))
+        return false;
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getWindSpeed" );
-            return false;
-        }
+    check = getWindSpeed(wind, false);
 
-        check = getTemperature(temperature[i]);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getWindSpeed" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getTemperature" );
-            return false;
-        }
+    check = getTemperature(temperature, false);
 
-        check = getHumidity(humidity[i]);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getTemperature" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getHumidity" );
-            return false;
-        }
+    check = getHumidity(humidity, false);
 
-        check = getPressure(pressure[i]);
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getHumidity" );
+        discardPendingAnswers();
+        return false;
+    }
 
-        if (!check)
-        {
-            LOG_ERROR( "ERROR in getPressure" );
-            return false;
-        }
+    check = getPressure(pressure, false);
+
+    if (!check)
+    {
+        LOG_ERROR( "ERROR in getPressure" );
+        discardPendingAnswers();
+        return false;
     }
 
-    cwd->sky             = aggregateInts(skyTemperature, NUMBER_OF_READS);
-    cwd->sensor          = aggregateInts(sensorTemperature, NUMBER_OF_READS);
-    cwd->rain            = aggregateInts(rainFrequency, NUMBER_OF_READS);
-    cwd->supply          = aggregateInts(internalSupplyVoltage, NUMBER_OF_READS);
-    cwd->tempEst         = aggregateFloats(tempEstimate, NUMBER_OF_READS); // not really present since firmware 3.x.x
-    cwd->ldr             = aggregateInts(ldrValue, NUMBER_OF_READS);
-    cwd->lightFreq       = aggregateInts(lightFreq, NUMBER_OF_READS);
-    cwd->rainTemperature = aggregateInts(rainSensorTemperature, NUMBER_OF_READS);
-    cwd->windSpeed       = aggregateFloats(wind, NUMBER_OF_READS);
-    cwd->windSpeed       = aggregateFloats(wind, NUMBER_OF_READS);
-    cwd->tempAct         = aggregateFloats(temperature, NUMBER_OF_READS);
-    cwd->humidity        = aggregateFloats(humidity, NUMBER_OF_READS);
-    cwd->pressure        = aggregateFloats(pressure, NUMBER_OF_READS);
+    // Readings accumulate over consecutive cycles instead of being taken in a burst,
+    // so every cycle reports a fresh aggregate of the last NUMBER_OF_READS readings.
+    skyWindow.push(skyTemperature);
+    sensorWindow.push(sensorTemperature);
+    rainWindow.push(rainFrequency);
+    supplyWindow.push(internalSupplyVoltage);
+    tempEstWindow.push(tempEstimate);
+    ldrWindow.push(ldrValue);
+    lightFreqWindow.push(lightFreq);
+    rainTemperatureWindow.push(rainSensorTemperature);
+    windWindow.push(wind);
+    temperatureWindow.push(temperature);
+    humidityWindow.push(humidity);
+    pressureWindow.push(pressure);
+
+    cwd->sky             = (int)skyWindow.aggregate();
+    cwd->sensor          = (int)sensorWindow.aggregate();
+    cwd->rain            = (int)rainWindow.aggregate();
+    cwd->supply          = (int)supplyWindow.aggregate();
+    cwd->tempEst         = tempEstWindow.aggregate(); // not really present since firmware 3.x.x
+    cwd->ldr             = (int)ldrWindow.aggregate();
+    cwd->lightFreq       = (int)lightFreqWindow.aggregate();
+    cwd->rainTemperature = (int)rainTemperatureWindow.aggregate();
+    cwd->windSpeed       = windWindow.aggregate();
+    cwd->tempAct         = temperatureWindow.aggregate();
+    cwd->humidity        = humidityWindow.aggregate();
+    cwd->pressure        = pressureWindow.aggregate();
 
 
     if (m_FirmwareVersion >= 5.8)
@@ -214,25 +252,31 @@ bool CloudWatcherController::getAllData(CloudWatcherData *cwd)
         cwd->relpress = 0;
     }
 
-    check = getIRErrors(&cwd->firstByteErrors, &cwd->commandByteErrors, &cwd->secondByteErrors, &cwd->pecByteErrors);
+    if (!sendCloudwatcherCommand("D!Q!F!", 6))
+        return false;
+
+    check = getIRErrors(&cwd->firstByteErrors, &cwd->commandByteErrors, &cwd->secondByteErrors, &cwd->pecByteErrors,
+                        false);
 
     if (!check)
     {
         LOG_DEBUG( "ERROR in getIRErrors" );
+        discardPendingAnswers();
         return false;
     }
 
     cwd->internalErrors = cwd->firstByteErrors + cwd->commandByteErrors + cwd->secondByteErrors + cwd->pecByteErrors;
 
-    check = getPWMDutyCycle(cwd->rainHeater);
+    check = getPWMDutyCycle(cwd->rainHeater, false);
 
     if (!check)
     {
         LOG_DEBUG( "ERROR in getPWMDutyCycle" );
+        discardPendingAnswers();
         return false;
     }
 
-    check = getSwitchStatus(&cwd->switchStatus);
+    check = getSwitchStatus(&cwd->switchStatus, false);
 
     if (!check)
     {
@@ -384,9 +428,10 @@ bool CloudWatcherController::getFirmwareVersion(double &version) // CW Firmware
 // N.B. Documents Rs232_Comms_v110.pdf and Rs232_Comms_v140.pdf update the information in Rs232_Comms_v100.pdf (code below reflects latest updates)
 bool CloudWatcherController::getValues(int *internalSupplyVoltage, float *tempEstimate, int *ldrValue,
                                        int *lightFreq,
-                                       int *rainSensorTemperature) // CW Get Values Cmd: C! (private)
+                                       int *rainSensorTemperature, bool send) // CW Get Values Cmd: C! (private)
 {
-    sendCloudwatcherCommand("C!");
+    if (send)
+        sendCloudwatcherCommand("C!");
 
     static const int MAX_GV_BLOCKS = 6; // as of firmware 5.89, answer can be up to 90 characters (6 blocks)
 
@@ -461,19 +506,19 @@ retry:
                 switch(inputBuffer[i + 1])
                 {
                     case '3': // ambient temperature
-                        estTemp = std::stof(&inputBuffer[i + 2]);
+                        estTemp = strtof(&inputBuffer[i + 2], nullptr);
                         break;
                     case '4': // LDR (light-dependent resistor) voltage
-                        ldrRes = std::stoi(&inputBuffer[i + 2]);
+                        ldrRes = static_cast<int>(strtol(&inputBuffer[i + 2], nullptr, 10));
                         break;
                     case '5': // rain sensor temperature
-                        rainSensTemp = std::stoi(&inputBuffer[i + 2]);
+                        rainSensTemp = static_cast<int>(strtol(&inputBuffer[i + 2], nullptr, 10));
                         break;
                     case '6': // zener voltage
-                        zenerV = std::stoi(&inputBuffer[i + 2]);
+                        zenerV = static_cast<int>(strtol(&inputBuffer[i + 2], nullptr, 10));
                         break;
                     case '8': // raw frequency obtained by light sensor
-                        ltFreq = std::stoi(&inputBuffer[i + 2]);
+                        ltFreq = static_cast<int>(strtol(&inputBuffer[i + 2], nullptr, 10));
                         break;
                     case '\x11': // handshake
                         inputBuffer[i + 1] = '\0'; // trimString equivalent
@@ -613,9 +658,10 @@ retry:
 }
 
 bool CloudWatcherController::getIRErrors(int *firstAddressByteErrors, int *commandByteErrors,
-        int *secondAddressByteErrors, int *pecByteErrors) // CW Cmd: D! (private)
+        int *secondAddressByteErrors, int *pecByteErrors, bool send) // CW Cmd: D! (private)
 {
-    sendCloudwatcherCommand("D!");
+    if (send)
+        sendCloudwatcherCommand("D!");
 
     char inputBuffer[BLOCK_SIZE * 5] = {0};
 
@@ -637,9 +683,10 @@ bool CloudWatcherController::getIRErrors(int *firstAddressByteErrors, int *comma
     return true;
 }
 
-bool CloudWatcherController::getRainFrequency(int &rainFreq) // CW Get Rain Frequency Cmd: E! (private)
+bool CloudWatcherController::getRainFrequency(int &rainFreq, bool send) // CW Get Rain Frequency Cmd: E! (private)
 {
-    sendCloudwatcherCommand("E!");
+    if (send)
+        sendCloudwatcherCommand("E!");
 
     char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -649,9 +696,10 @@ bool CloudWatcherController::getRainFrequency(int &rainFreq) // CW Get Rain Freq
     return matchBlock(inputBuffer, "!R", rainFreq); // range is 0 to 6,000
 }
 
-bool CloudWatcherController::getSwitchStatus(int *switchStatus) // CW Get Switch Status Cmd: F! (public)
+bool CloudWatcherController::getSwitchStatus(int *switchStatus, bool send) // CW Get Switch Status Cmd: F! (public)
 {
-    sendCloudwatcherCommand("F!");
+    if (send)
+        sendCloudwatcherCommand("F!");
 
     char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -780,9 +828,10 @@ bool CloudWatcherController::setPWMDutyCycle(int pwmDutyCycle) // CW Set PWM Cmd
     return true;
 }
 
-bool CloudWatcherController::getPWMDutyCycle(int &pwmDutyCycle) // CW Get PWM Value Cmd: Q! (private)
+bool CloudWatcherController::getPWMDutyCycle(int &pwmDutyCycle, bool send) // CW Get PWM Value Cmd: Q! (private)
 {
-    sendCloudwatcherCommand("Q!");
+    if (send)
+        sendCloudwatcherCommand("Q!");
 
     char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -793,9 +842,10 @@ bool CloudWatcherController::getPWMDutyCycle(int &pwmDutyCycle) // CW Get PWM Va
 }
 
 bool CloudWatcherController::getIRSkyTemperature(int
-        &temp) // CW Get IR Sky Temp Cmd: S! (private); response in hundredths of a degree Celsius
+        &temp, bool send) // CW Get IR Sky Temp Cmd: S! (private); response in hundredths of a degree Celsius
 {
-    sendCloudwatcherCommand("S!");
+    if (send)
+        sendCloudwatcherCommand("S!");
 
     char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -806,9 +856,10 @@ bool CloudWatcherController::getIRSkyTemperature(int
 }
 
 bool CloudWatcherController::getIRSensorTemperature(int
-        &temp) // CW Get IR Sensor Temp Cmd: T! (private); response in hundredths of a degree Celsius
+        &temp, bool send) // CW Get IR Sensor Temp Cmd: T! (private); response in hundredths of a degree Celsius
 {
-    sendCloudwatcherCommand("T!");
+    if (send)
+        sendCloudwatcherCommand("T!");
 
     char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -915,12 +966,13 @@ bool CloudWatcherController::getAnemometerStatus(int &anemometerStatus) // CW Ch
     return true;
 }
 
-bool CloudWatcherController::getWindSpeed(float &windSpeed) // CW Get Wind Speed Cmd: V! (private)
+bool CloudWatcherController::getWindSpeed(float &windSpeed, bool send) // CW Get Wind Speed Cmd: V! (private)
 {
 
     if (m_FirmwareVersion >= 5 && m_AnemometerStatus)
     {
-        sendCloudwatcherCommand("V!");
+        if (send)
+            sendCloudwatcherCommand("V!");
 
         char inputBuffer[BLOCK_SIZE * 2] = {0};
 
@@ -966,11 +1018,12 @@ bool CloudWatcherController::getWindSpeed(float &windSpeed) // CW Get Wind Speed
 /******************************************************/
 /* CW Cmd funtions from Rs232_Comms_v130.pdf Document */
 /******************************************************/
-bool CloudWatcherController::getHumidity(float &humidity) // CW Get Relative Humidity Cmd: h! (private)
+bool CloudWatcherController::getHumidity(float &humidity, bool send) // CW Get Relative Humidity Cmd: h! (private)
 {
     if (m_FirmwareVersion >= 5.6)
     {
-        sendCloudwatcherCommand("h!");
+        if (send)
+            sendCloudwatcherCommand("h!");
 
         char inputBuffer[BLOCK_SIZE * 2] = {0};
         int h = 0;
@@ -1026,11 +1079,12 @@ bool CloudWatcherController::getHumidity(float &humidity) // CW Get Relative Hum
     return false;
 }
 
-bool CloudWatcherController::getTemperature(float &temperature) // CW Get Ambient Temperature Cmd: t! (private)
+bool CloudWatcherController::getTemperature(float &temperature, bool send) // CW Get Ambient Temperature Cmd: t! (private)
 {
     if (m_FirmwareVersion >= 5.6)
     {
-        sendCloudwatcherCommand("t!");
+        if (send)
+            sendCloudwatcherCommand("t!");
 
         char inputBuffer[BLOCK_SIZE * 2] = {0};
         int t = 0;
@@ -1095,11 +1149,12 @@ bool CloudWatcherController::getTemperature(float &temperature) // CW Get Ambien
     return false;
 }
 
-bool CloudWatcherController::getPressure(float &pressure) // CW Get Atmospheric Pressure Cmd: p! (private)
+bool CloudWatcherController::getPressure(float &pressure, bool send) // CW Get Atmospheric Pressure Cmd: p! (private)
 {
     if (m_FirmwareVersion >= 5.8)
     {
-        sendCloudwatcherCommand("p!");
+        if (send)
+            sendCloudwatcherCommand("p!");
 
         char inputBuffer[BLOCK_SIZE * 2] = {0};
         int p = 0;
@@ -1150,62 +1205,73 @@ bool CloudWatcherController::getPressure(float &pressure) // CW Get Atmospheric
 /******************************************************************/
 /* PRIVATE MEMBERS                                                */
 /******************************************************************/
-float CloudWatcherController::aggregateFloats(float values[], int numberOfValues)
+void CloudWatcherController::SampleWindow::push(float value)
 {
+    values[next] = value;
+    next = (next + 1) % NUMBER_OF_READS;
+
+    if (count < NUMBER_OF_READS)
+        count++;
+}
+
+void CloudWatcherController::SampleWindow::clear()
+{
+    next  = 0;
+    count = 0;
+}
+
+float CloudWatcherController::SampleWindow::aggregate() const
+{
+    if (count == 0)
+        return 0;
+
     float average = 0.0;
 
-    for (int i = 0; i < numberOfValues; i++)
+    for (int i = 0; i < count; i++)
     {
-        //    printMessage("%f\n", values[i]);
-
         average += values[i];
     }
 
-    average /= numberOfValues;
+    average /= count;
 
     float stdD = 0.0;
 
-    for (int i = 0; i < numberOfValues; i++)
+    for (int i = 0; i < count; i++)
     {
         stdD += (values[i] - average) * (values[i] - average);
     }
 
-    stdD /= numberOfValues;
+    stdD /= count;
 
     stdD = sqrt(stdD);
 
-    //  printMessage("Average: %f, stdD: %f\n", average, stdD);
-
     float newAverage  = 0.0;
     int numberOfItems = 0;
 
-    for (int i = 0; i < numberOfValues; i++)
+    for (int i = 0; i < count; i++)
     {
         if (fabs(values[i] - average) <= stdD)
         {
-            //      printMessage("%f\n", fabs(values[i] - average));
             newAverage += values[i];
             numberOfItems++;
         }
     }
 
-    newAverage /= numberOfItems;
-
-    printMessage("New average: %f\n", newAverage);
+    // Rounding can leave no reading within the deviation when all of them are equal
+    if (numberOfItems == 0)
+        return average;
 
-    return newAverage;
+    return newAverage / numberOfItems;
 }
 
-int CloudWatcherController::aggregateInts(int values[], int numberOfValues)
+void CloudWatcherController::resetWindows()
 {
-    float newValues[numberOfValues];
-
-    for (int i = 0; i < numberOfValues; i++)
-    {
-        newValues[i] = (float)values[i];
-    }
-
-    return (int)aggregateFloats(newValues, numberOfValues);
+    for (SampleWindow *window :
+            {
+                &skyWindow, &sensorWindow, &rainWindow, &supplyWindow, &tempEstWindow, &ldrWindow, &lightFreqWindow,
+                &rainTemperatureWindow, &windWindow, &temperatureWindow, &humidityWindow, &pressureWindow
+            })
+        window->clear();
 }
 
 void CloudWatcherController::trimString(char *str)
@@ -1299,6 +1365,19 @@ bool CloudWatcherController::getCloudWatcherAnswer(char *buffer, int nBlocks)
     return valid;
 }
 
+void CloudWatcherController::discardPendingAnswers()
+{
+    char buffer[BLOCK_SIZE];
+    int n = 0;
+
+    // Let the device finish answering the batch, bounded in case it keeps talking
+    for (int i = 0; i < 16; i++)
+    {
+        if (tty_read(PortFD, buffer, BLOCK_SIZE, 1, &n) != TTY_OK)
+            break;
+    }
+}
+
 void CloudWatcherController::printMessage(const char *fmt, ...)
 {
     if (verbose)
@@ -1321,27 +1400,39 @@ void CloudWatcherController::printBuffer(char *buffer, int num)
     }
 }
 
-bool CloudWatcherController::matchBlock(const std::string &response, const std::string &prefix, int &value)
+bool CloudWatcherController::matchBlock(const char *response, const char *prefix, int &value)
 {
-    std::regex rgx(prefix + R"(\s*([-+]?\d+))");
-    std::smatch match;
+    const size_t prefixLength = strlen(prefix);
 
-    if (std::regex_search(response, match, rgx))
+    // The value follows the prefix in the same 15 bytes block, right aligned with
+    // space padding, so it is picked up in place without building an expression.
+    for (const char *match = strstr(response, prefix); match != nullptr; match = strstr(match + 1, prefix))
     {
-        try
-        {
-            value = std::stol(match.str(1));
-            LOGF_DEBUG("match block is: %i", value);
-            return true;
-        }
-        catch (...)
+        const char *number = match + prefixLength;
+
+        while (isspace(static_cast<unsigned char>(*number)))
+            number++;
+
+        const char *digits = (*number == '-' || *number == '+') ? number + 1 : number;
+
+        if (!isdigit(static_cast<unsigned char>(*digits)))
+            continue;
+
+        errno = 0;
+        long parsed = strtol(number, nullptr, 10);
+
+        if (errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX)
         {
-            LOGF_DEBUG("matchBlock std::stoi conversion error: %s", match.str(1).c_str());
+            LOGF_DEBUG("matchBlock conversion error: %s", number);
             return false;
         }
+
+        value = static_cast<int>(parsed);
+        LOGF_DEBUG("match block is: %i", value);
+        return true;
     }
 
-    LOGF_DEBUG("matchBlock could not match an integer in response: %s", response.c_str());
+    LOGF_DEBUG("matchBlock could not match an integer in response: %s", response);
 
     return false;
 }
@@ -159,15 +159,17 @@ public:
      * Obtains the status of the internal Switch of the AAG CLoud Watcher.
      * @param switchStatus where the switch status will be stored. 1 if open,
      * 0 if closed.
+     * @param send false if the F! request was already written as part of a batch.
      * @return true if the status of the switch has been correctly determined.
      * false otherwise.
      */
-    bool getSwitchStatus(int *switchStatus);
+    bool getSwitchStatus(int *switchStatus, bool send = true);
 
     /**
-     * Gets all raw dynamic data from the AAG Cloud Watcher. It follows the
-     * procedure described in the AAG Documents (5 readings for some values). This
-     * function takes more than 2 seconds and less than 3 to complete.
+     * Gets all raw dynamic data from the AAG Cloud Watcher. Every call takes one
+     * reading of each sensor, with the requests pipelined so the device answers
+     * them back to back, and reports the aggregate of the last NUMBER_OF_READS
+     * readings as described in the AAG Documents.
      * @param cwd where the dynamic data of the AAG Cloud Watcher will be stored.
      * @return true if the data has been correctly gathered. false otherwise.
      */
@@ -245,6 +247,41 @@ private:
      */
     const static int NUMBER_OF_READS = 5;
 
+    /**
+     * Rolling window holding the last NUMBER_OF_READS readings of a sensor.
+     */
+    class SampleWindow
+    {
+    public:
+        void push(float value);
+        void clear();
+
+        /**
+         * Computes average and standard deviation of the readings in the window
+         * and averages only the values within [average - deviation, average + deviation]
+         * @return the aggregated value
+         */
+        float aggregate() const;
+
+    private:
+        float values[NUMBER_OF_READS] = {0};
+        int next = 0;
+        int count = 0;
+    };
+
+    SampleWindow skyWindow;
+    SampleWindow sensorWindow;
+    SampleWindow rainWindow;
+    SampleWindow supplyWindow;
+    SampleWindow tempEstWindow;
+    SampleWindow ldrWindow;
+    SampleWindow lightFreqWindow;
+    SampleWindow rainTemperatureWindow;
+    SampleWindow windWindow;
+    SampleWindow temperatureWindow;
+    SampleWindow humidityWindow;
+    SampleWindow pressureWindow;
+
     /**
      * Hard coded constant. May be changed with internal device constants.
      * @see getElectricalConstants()
@@ -367,6 +404,17 @@ private:
      */
     bool getCloudWatcherAnswer(char *buffer, int nBlocks);
 
+    /**
+     * Drops whatever is left of the answers to a batch of requests, so that an
+     * error in the middle of a batch does not shift the next answers.
+     */
+    void discardPendingAnswers();
+
+    /**
+     * Clears the rolling windows of all sensors
+     */
+    void resetWindows();
+
     /**
      * Reads the firmware version of the AAG Cloud Watcher (if not previously
      * read).
@@ -383,46 +431,29 @@ private:
      */
     bool getSerialNumber(int &serialNumber);
 
-    /**
-     * Performs an aggregation of the values stored in a float array. It computes
-     * average and standard deviation of the array and averages only the values
-     * within [average - deviation, average + deviation]
-     * @param values the values to be aggregated
-     * @param numberOfValues the size of values
-     * @return the aggregated value
-     */
-    float aggregateFloats(float values[], int numberOfValues);
-
-    /**
-     * Performs an aggregation of the values stored in a int array. It computes
-     * average and standard deviation of the array and averages only the values
-     * within [average - deviation, average + deviation]
-     * @param values the values to be aggregated
-     * @param numberOfValues the size of values
-     * @return the aggregated value
-     */
-    int aggregateInts(int values[], int numberOfValues);
-
     /**
      * Reads the current IR Sky Temperature value of the AAG Cloud Watcher
      * @param temp where the sensor value will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getIRSkyTemperature(int &temp);
+    bool getIRSkyTemperature(int &temp, bool send = true);
 
     /**
      * Reads the current IR Sensor Temperature value of the AAG Cloud Watcher
      * @param temp where the sensor value will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getIRSensorTemperature(int &temp);
+    bool getIRSensorTemperature(int &temp, bool send = true);
 
     /**
      * Reads the current Rain Frequency value of the AAG Cloud Watcher
      * @param rainFreq where the sensor value will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getRainFrequency(int &rainFreq);
+    bool getRainFrequency(int &rainFreq, bool send = true);
 
     /**
      * Reads the current Internal Supply Voltage, Ambient Temperature, LDR Value
@@ -432,17 +463,20 @@ private:
      * @param ldrValue where the sensor value will be
      * @param ldrFreqValue where the sensor value in K will be stored, if Firmware >= 5.88
      * @param rainSensorTemperature where the sensor value will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getValues(int *internalSupplyVoltage, float *ambientTemperature, int *ldrValue, int *ldrFreqValue, int *rainSensorTemperature);
+    bool getValues(int *internalSupplyVoltage, float *ambientTemperature, int *ldrValue, int *ldrFreqValue, int *rainSensorTemperature,
+                   bool send = true);
 
 
     /**
      * Reads the current PWM Duty Cycle value of the AAG Cloud Watcher
      * @param pwmDutyCycle where the sensor value will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getPWMDutyCycle(int &pwmDutyCycle);
+    bool getPWMDutyCycle(int &pwmDutyCycle, bool send = true);
 
     /**
      * Reads the current Error values of the AAG Cloud Watcher
@@ -450,10 +484,11 @@ private:
      * @param commandByteErrors where the command byte error count will be stored
      * @param secondAddressByteErrors where the second byte error count will be stored
      * @param pecByteErrors where the PEC byte error count will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
     bool getIRErrors(int *firstAddressByteErrors, int *commandByteErrors, int *secondAddressByteErrors,
-		     int *pecByteErrors);
+		     int *pecByteErrors, bool send = true);
 
     /**
      * Reads the electrical constants from the AAG Cloud Watcher and stores them
@@ -485,33 +520,37 @@ private:
     /**
      * Reads the wind speed from the anemomter
      * @param windSpeed where the wind speed will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getWindSpeed(float &windSpeed);
+    bool getWindSpeed(float &windSpeed, bool send = true);
 
     /**
      * Reads the humidity from external sensor
      * @param humidity where the humidity will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getHumidity(float &humidity);
+    bool getHumidity(float &humidity, bool send = true);
 
     /**
      * Reads the temperature from external sensor.
      * @param temperature where the temperature will be stored
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getTemperature(float &temperature);
+    bool getTemperature(float &temperature, bool send = true);
 
     /**
      * Reads the pressure from external sensor
      * @param pressure where the absolute pressure will be stored. Unit is hPa (a.k.a millibars) * 16
+     * @param send false if the request was already written as part of a batch.
      * @return true if succesfully read. false otherwise.
      */
-    bool getPressure(float &pressure);
+    bool getPressure(float &pressure, bool send = true);
 
     /**
-     * Use regex to extract the block value, skipping any space
+     * Extracts the integer value following prefix in the answer, skipping any space
      */
-    bool matchBlock(const std::string &response, const std::string &prefix, int &value);
+    bool matchBlock(const char *response, const char *prefix, int &value);
 };
@@ -35,6 +35,8 @@
 #include <map>
 #include <unistd.h>
 #include <cstring>
+#include <ctime>
+#include <string>
 #include <errno.h>
 
 #define MAX_EXP_RETRIES         2
@@ -76,7 +78,10 @@ void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
         uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
         int waitMS           = static_cast<int>((ExposureRequest * 2000.0) + 500);
 
-        ret = ASIGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
+        {
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+            ret = ASIGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
+        }
         if (ret != ASI_SUCCESS)
         {
             if (ret != ASI_ERROR_TIMEOUT)
@@ -91,10 +96,18 @@ void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
         }
 
         if (mCurrentVideoFormat == ASI_IMG_RGB24)
+        {
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
             for (uint32_t i = 0; i < totalBytes; i += 3)
                 std::swap(targetFrame[i], targetFrame[i + 2]);
+        }
+
+        {
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+            Streamer->newFrame(targetFrame, totalBytes);
+        }
 
-        Streamer->newFrame(targetFrame, totalBytes);
+        mFrameTimingProperties.frameDone();
     }
 
     ASIStopVideoCapture(mCameraInfo.CameraID);
@@ -397,6 +410,8 @@ bool ASIBase::initProperties()
     BlinkNP.fill(getDeviceName(), "BLINK", "Blink", CONTROL_TAB, IP_RW, 60, IPS_IDLE);
     BlinkNP.load();
 
+    mFrameTimingProperties.initProperties(this);
+
     BayerTP[2].setText(getBayerString());
 
     ADCDepthNP[0].fill("BITS", "Bits", "%2.0f", 0, 32, 1, mCameraInfo.BitDepth);
@@ -530,6 +545,7 @@ bool ASIBase::updateProperties()
 
         defineProperty(BlinkNP);
         defineProperty(ADCDepthNP);
+        mFrameTimingProperties.updateProperties(true);
         defineProperty(SDKVersionSP);
         if (!mSerialNumber.empty())
         {
@@ -562,6 +578,7 @@ bool ASIBase::updateProperties()
             deleteProperty(VideoFormatSP.getName());
 
         deleteProperty(BlinkNP.getName());
+        mFrameTimingProperties.updateProperties(false);
         deleteProperty(SDKVersionSP.getName());
         if (!mSerialNumber.empty())
         {
@@ -775,6 +792,17 @@ void ASIBase::setupParams()
     Streamer->setSize(maxWidth, maxHeight);
 }
 
+bool ASIBase::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
+{
+    if (dev != nullptr && !strcmp(dev, getDeviceName()))
+    {
+        if (mFrameTimingProperties.ISNewText(name, texts, names, n))
+            return true;
+    }
+
+    return INDI::CCD::ISNewText(dev, name, texts, names, n);
+}
+
 bool ASIBase::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
 {
     ASI_ERROR_CODE ret = ASI_SUCCESS;
@@ -851,6 +879,9 @@ bool ASIBase::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
 {
     if (dev != nullptr && !strcmp(dev, getDeviceName()))
     {
+        if (mFrameTimingProperties.ISNewSwitch(name, states, names, n))
+            return true;
+
         if (ControlSP.isNameMatch(name))
         {
             if (ControlSP.update(states, names, n) == false)
@@ -1223,7 +1254,11 @@ int ASIBase::grabImage(float duration)
 
     ASI_IMG_TYPE type = getImageType();
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    std::unique_lock<std::mutex> guard(ccdBufferLock, std::defer_lock);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_BUFFER_LOCK);
+        guard.lock();
+    }
     uint8_t *image = PrimaryCCD.getFrameBuffer();
     uint8_t *buffer = image;
 
@@ -1242,7 +1277,10 @@ int ASIBase::grabImage(float duration)
         }
     }
 
-    ret = ASIGetDataAfterExp(mCameraInfo.CameraID, buffer, nTotalBytes);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+        ret = ASIGetDataAfterExp(mCameraInfo.CameraID, buffer, nTotalBytes);
+    }
     if (ret != ASI_SUCCESS)
     {
         LOGF_ERROR(
@@ -1256,6 +1294,7 @@ int ASIBase::grabImage(float duration)
 
     if (type == ASI_IMG_RGB24)
     {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
         uint8_t *dstR = image;
         uint8_t *dstG = image + subW * subH;
         uint8_t *dstB = image + subW * subH * 2;
@@ -1285,7 +1324,12 @@ int ASIBase::grabImage(float duration)
     if (duration > VERBOSE_EXPOSURE)
         LOG_INFO("Download complete.");
 
-    ExposureComplete(&PrimaryCCD);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+        ExposureComplete(&PrimaryCCD);
+    }
+
+    mFrameTimingProperties.frameDone();
     return 0;
 }
 
@@ -1665,6 +1709,7 @@ bool ASIBase::saveConfigItems(FILE *fp)
         VideoFormatSP.save(fp);
 
     BlinkNP.save(fp);
+    mFrameTimingProperties.saveConfigItems(fp);
 
     return true;
 }
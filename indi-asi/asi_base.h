@@ -29,6 +29,7 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "frame_timing_properties.h"
 
 #include <vector>
 
@@ -58,6 +59,7 @@ class ASIBase : public INDI::CCD
     protected:
 
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+        virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
 
         // Streaming
@@ -163,6 +165,9 @@ class ASIBase : public INDI::CCD
             FLIP_VERTICAL
         };
 
+        FrameTiming mFrameTiming;
+        FrameTimingProperties mFrameTimingProperties {mFrameTiming};
+
         std::string mCameraName, mCameraID, mSerialNumber, mNickname;
         ASI_CAMERA_INFO mCameraInfo;
         uint8_t mExposureRetry {0};
@@ -23,14 +23,18 @@
 #include "atik_ccd.h"
 
 #include "config.h"
+#include "fits_date_obs.h"
 
 #include <stream/streammanager.h>
 
 #include <algorithm>
 #include <math.h>
 #include <unistd.h>
+#include <cstring>
 #include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 
 #define MAX_CONNECTION_RETRIES  5
 #define MAX_EXP_RETRIES         3
@@ -40,6 +44,10 @@
 
 #define CONTROL_TAB "Controls"
 
+// The fast mode callback carries no context, cameras are looked up by handle
+static std::map<ArtemisHandle, ATIKCCD *> fastModeCameras;
+static std::mutex fastModeMutex;
+
 static class Loader
 {
         std::deque<std::unique_ptr<ATIKCCD>> cameras;
@@ -184,6 +192,12 @@ bool ATIKCCD::initProperties()
     IUFillSwitchVector(&FastModeSP, FastModeS, 2, getDeviceName(), "CCD_FAST_MODE", "Fast Mode", CONTROLS_TAB, IP_RW,
                        ISR_1OFMANY, 60, IPS_IDLE);
 
+    // Overlapped exposures
+    IUFillSwitch(&OverlappedS[OVERLAPPED_OFF], "OVERLAPPED_OFF", "OFF", ISS_ON);
+    IUFillSwitch(&OverlappedS[OVERLAPPED_ON], "OVERLAPPED_ON", "ON", ISS_OFF);
+    IUFillSwitchVector(&OverlappedSP, OverlappedS, 2, getDeviceName(), "CCD_OVERLAPPED", "Overlapped", CONTROLS_TAB, IP_RW,
+                       ISR_1OFMANY, 60, IPS_IDLE);
+
 #if 0
     // Bit send format
     IUFillSwitch(&BitSendS[BITSEND_16BITS], "BITSEND_16BITS", "16BITS", ISS_OFF);
@@ -241,6 +255,9 @@ bool ATIKCCD::updateProperties()
             //loadConfig(true, "CCD_BIT_SEND");
         }
 
+        defineProperty(&OverlappedSP);
+        loadConfig(true, "CCD_OVERLAPPED");
+
         if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
             INDI::FilterInterface::updateProperties();
 
@@ -268,6 +285,8 @@ bool ATIKCCD::updateProperties()
             // deleteProperty(BitSendSP.name); // unused
         }
 
+        deleteProperty(OverlappedSP.name);
+
         if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
             INDI::FilterInterface::updateProperties();
 
@@ -390,9 +409,22 @@ bool ATIKCCD::setupParams()
         cap |= CCD_HAS_ST4_PORT;
     }
 
+    // Can we stream?
+    if (ArtemisHasFastMode(hCam))
+    {
+        LOG_DEBUG("Camera supports fast mode streaming.");
+        cap |= CCD_HAS_STREAMING;
+    }
+
     // Done with the capabilities!
     SetCCDCapability(cap);
 
+    if (HasStreaming())
+    {
+        Streamer->setPixelFormat(colorType == ARTEMIS_COLOUR_RGGB ? INDI_BAYER_RGGB : INDI_MONO, 16);
+        Streamer->setSize(PrimaryCCD.getXRes(), PrimaryCCD.getYRes());
+    }
+
     // Check if camra has internal filter wheel
     if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
     {
@@ -650,6 +682,10 @@ bool ATIKCCD::Disconnect()
     RemoveTimer(genTimerID);
     genTimerID = -1;
 
+    if (threadState == StateStream)
+        StopStreaming();
+    cancelOverlappedExposure();
+
     pthread_mutex_lock(&condMutex);
     tState = threadState;
     threadRequest = StateTerminate;
@@ -692,6 +728,8 @@ bool ATIKCCD::ISNewNumber(const char *dev, const char *name, double values[], ch
         {
             bool changed = false;
 
+            cancelOverlappedExposure();
+
             if (!strcmp(name, ControlNP.name))
             {
                 std::vector<double> oldValues;
@@ -861,6 +899,7 @@ bool ATIKCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
         if (!strcmp(name, ControlPresetsSP.name))
         {
             // Warning: setting a preset will not change the gain read with the Custom gain/offset ID as these are actually custom
+            cancelOverlappedExposure();
             _ISwitchVectorProperty &v = ControlPresetsSP;
             int prevIndex = IUFindOnSwitchIndex(&v);
             IUUpdateSwitch(&v, states, names, n);
@@ -932,6 +971,7 @@ bool ATIKCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
         }
         else if (!strcmp(name, EvenIlluminationSP.name))
         {
+            cancelOverlappedExposure();
             _ISwitchVectorProperty &v = EvenIlluminationSP;
             int prevIndex = IUFindOnSwitchIndex(&v);
             IUUpdateSwitch(&v, states, names, n);
@@ -954,6 +994,7 @@ bool ATIKCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
         }
         else if (!strcmp(name, PadDataSP.name))
         {
+            cancelOverlappedExposure();
             _ISwitchVectorProperty &v = PadDataSP;
             int prevIndex = IUFindOnSwitchIndex(&v);
             IUUpdateSwitch(&v, states, names, n);
@@ -974,8 +1015,24 @@ bool ATIKCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
             IDSetSwitch(&v, nullptr);
             return true;
         }
+        else if (!strcmp(name, OverlappedSP.name))
+        {
+            IUUpdateSwitch(&OverlappedSP, states, names, n);
+            bool const enabled = OverlappedS[OVERLAPPED_ON].s == ISS_ON;
+            if (!enabled)
+                cancelOverlappedExposure();
+
+            // Titan cameras keep the sensor exposing while the previous frame is read out
+            if (ArtemisContinuousExposingModeSupported(hCam))
+                ArtemisSetContinuousExposingMode(hCam, enabled);
+
+            OverlappedSP.s = IPS_OK;
+            IDSetSwitch(&OverlappedSP, nullptr);
+            return true;
+        }
         else if (!strcmp(name, FastModeSP.name))
         {
+            cancelOverlappedExposure();
             _ISwitchVectorProperty &v = FastModeSP;
             int prevIndex = IUFindOnSwitchIndex(&v);
             IUUpdateSwitch(&v, states, names, n);
@@ -1102,6 +1159,34 @@ bool ATIKCCD::StartExposure(float duration)
     PrimaryCCD.setExposureDuration(duration);
     ExposureRequest = duration;
 
+    // Pick up the exposure started right after the previous frame if it matches the request
+    pthread_mutex_lock(&accessMutex);
+    if (m_OverlappedPending)
+    {
+        m_OverlappedPending = false;
+        if (duration == m_OverlappedDuration && PrimaryCCD.getFrameType() == m_OverlappedFrameType &&
+                ArtemisOverlappedExposureValid(hCam))
+        {
+            pthread_mutex_unlock(&accessMutex);
+            ExpStart = m_OverlappedStart;
+            m_FrameOverlapped = true;
+            LOGF_DEBUG("Continuing overlapped exposure : %.3fs", duration);
+            if (ExposureRequest > VERBOSE_EXPOSURE)
+                LOGF_INFO("Taking a %g seconds frame...", ExposureRequest);
+
+            InExposure = true;
+            pthread_mutex_lock(&condMutex);
+            threadRequest = StateExposure;
+            pthread_cond_signal(&cv);
+            pthread_mutex_unlock(&condMutex);
+            return true;
+        }
+
+        LOG_DEBUG("Discarding overlapped exposure, request differs.");
+        ArtemisStopExposure(hCam);
+    }
+    pthread_mutex_unlock(&accessMutex);
+
     // Camera needs to be in idle state to start exposure after previous abort
     int maxWaitCount = 1000; // 1000 * 0.1s = 100s
     while (ArtemisCameraState(hCam) != CAMERA_IDLE && --maxWaitCount > 0)
@@ -1142,6 +1227,7 @@ bool ATIKCCD::StartExposure(float duration)
     }
 
     gettimeofday(&ExpStart, nullptr);
+    m_FrameOverlapped = false;
     if (ExposureRequest > VERBOSE_EXPOSURE)
         LOGF_INFO("Taking a %g seconds frame...", ExposureRequest);
 
@@ -1170,15 +1256,188 @@ bool ATIKCCD::AbortExposure()
     }
     pthread_mutex_unlock(&condMutex);
     ArtemisStopExposure(hCam);
+    cancelOverlappedExposure();
     InExposure = false;
     return true;
 }
 
+/////////////////////////////////////////////////////////
+/// Start streaming using the SDK fast mode
+/////////////////////////////////////////////////////////
+bool ATIKCCD::StartStreaming()
+{
+    int ms = std::max(1, static_cast<int>(1000.0 / Streamer->getTargetFPS()));
+
+    cancelOverlappedExposure();
+
+    pthread_mutex_lock(&condMutex);
+    streamHead = streamCount = 0;
+    streamDropped = 0;
+    pthread_mutex_unlock(&condMutex);
+
+    {
+        std::lock_guard<std::mutex> guard(fastModeMutex);
+        fastModeCameras[hCam] = this;
+    }
+
+    pthread_mutex_lock(&accessMutex);
+    bool ok = ArtemisSetFastCallbackEx(hCam, &ATIKCCD::fastCallbackHelper) && ArtemisStartFastExposure(hCam, ms);
+    pthread_mutex_unlock(&accessMutex);
+    if (!ok)
+    {
+        LOG_ERROR("Failed to start fast mode exposures.");
+        ArtemisSetFastCallbackEx(hCam, nullptr);
+        std::lock_guard<std::mutex> guard(fastModeMutex);
+        fastModeCameras.erase(hCam);
+        return false;
+    }
+
+    LOGF_DEBUG("Streaming %dms fast mode exposures.", ms);
+
+    pthread_mutex_lock(&condMutex);
+    threadRequest = StateStream;
+    pthread_cond_broadcast(&cv);
+    pthread_mutex_unlock(&condMutex);
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////
+/// Stop fast mode streaming
+/////////////////////////////////////////////////////////
+bool ATIKCCD::StopStreaming()
+{
+    pthread_mutex_lock(&condMutex);
+    if (threadRequest == StateStream)
+        threadRequest = StateAbort;
+    pthread_cond_broadcast(&cv);
+    while (threadState == StateStream)
+    {
+        pthread_cond_wait(&cv, &condMutex);
+    }
+    uint32_t dropped = streamDropped;
+    pthread_mutex_unlock(&condMutex);
+
+    pthread_mutex_lock(&accessMutex);
+    ArtemisStopExposure(hCam);
+    ArtemisSetFastCallbackEx(hCam, nullptr);
+    pthread_mutex_unlock(&accessMutex);
+
+    {
+        // Waits for a callback in progress
+        std::lock_guard<std::mutex> guard(fastModeMutex);
+        fastModeCameras.erase(hCam);
+    }
+
+    if (dropped > 0)
+        LOGF_INFO("%u frames were dropped while streaming.", dropped);
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////
+/// Fast mode callback, called from an SDK thread
+/////////////////////////////////////////////////////////
+void ATIKCCD::fastCallbackHelper(ArtemisHandle handle, int x, int y, int w, int h, int binx, int biny,
+                                 void *imageBuffer, unsigned char *info)
+{
+    INDI_UNUSED(x);
+    INDI_UNUSED(y);
+    INDI_UNUSED(binx);
+    INDI_UNUSED(biny);
+
+    std::lock_guard<std::mutex> guard(fastModeMutex);
+    auto camera = fastModeCameras.find(handle);
+    if (camera != fastModeCameras.end())
+        camera->second->fastCallback(w, h, imageBuffer, reinterpret_cast<const FastCallbackInfo *>(info));
+}
+
+/////////////////////////////////////////////////////////
+/// Copy a streamed frame into the ring, the SDK reuses its buffer
+/////////////////////////////////////////////////////////
+void ATIKCCD::fastCallback(int w, int h, const void *imageBuffer, const FastCallbackInfo *info)
+{
+    if (imageBuffer == nullptr || w <= 0 || h <= 0)
+        return;
+
+    size_t size = static_cast<size_t>(w) * h * PrimaryCCD.getBPP() / 8;
+
+    pthread_mutex_lock(&condMutex);
+    if (info != nullptr)
+        streamDropped += info->droppedFrames;
+
+    // Streamer is behind, drop the oldest frame
+    if (streamCount == STREAM_RING_SIZE)
+    {
+        streamHead = (streamHead + 1) % STREAM_RING_SIZE;
+        streamCount--;
+        streamDropped++;
+    }
+
+    StreamFrame &frame = streamRing[(streamHead + streamCount) % STREAM_RING_SIZE];
+    frame.data.resize(size);
+    memcpy(frame.data.data(), imageBuffer, size);
+    frame.w = w;
+    frame.h = h;
+    streamCount++;
+
+    pthread_cond_broadcast(&cv);
+    pthread_mutex_unlock(&condMutex);
+}
+
+/////////////////////////////////////////////////////////
+/// Start the next exposure of a sequence, must hold accessMutex
+/////////////////////////////////////////////////////////
+bool ATIKCCD::startOverlappedExposure()
+{
+    int rc = ArtemisSetOverlappedExposureTime(hCam, ExposureRequest);
+    if (rc == ARTEMIS_OK)
+        rc = ArtemisStartOverlappedExposure(hCam);
+
+    if (rc != ARTEMIS_OK)
+    {
+        LOGF_WARN("Camera does not support overlapped exposures (%d).", rc);
+        IUResetSwitch(&OverlappedSP);
+        OverlappedS[OVERLAPPED_OFF].s = ISS_ON;
+        OverlappedSP.s = IPS_ALERT;
+        IDSetSwitch(&OverlappedSP, nullptr);
+        return false;
+    }
+
+    m_OverlappedPending = true;
+    m_OverlappedDuration = ExposureRequest;
+    m_OverlappedFrameType = PrimaryCCD.getFrameType();
+    gettimeofday(&m_OverlappedStart, nullptr);
+    return true;
+}
+
+/////////////////////////////////////////////////////////
+/// Stop a pending overlapped exposure
+/////////////////////////////////////////////////////////
+void ATIKCCD::cancelOverlappedExposure()
+{
+    pthread_mutex_lock(&accessMutex);
+    if (m_OverlappedPending)
+    {
+        m_OverlappedPending = false;
+        ArtemisStopExposure(hCam);
+    }
+    pthread_mutex_unlock(&accessMutex);
+}
+
 /////////////////////////////////////////////////////////
 /// Updates CCD sub frame
 /////////////////////////////////////////////////////////
 bool ATIKCCD::UpdateCCDFrame(int x, int y, int w, int h)
 {
+    if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot change the frame while streaming.");
+        return false;
+    }
+
+    cancelOverlappedExposure();
+
     int rc = ArtemisSubframe(hCam, x, y, w, h);
     if (rc != ARTEMIS_OK)
     {
@@ -1192,6 +1451,9 @@ bool ATIKCCD::UpdateCCDFrame(int x, int y, int w, int h)
 
     // Total bytes required for image buffer
     PrimaryCCD.setFrameBufferSize(w / PrimaryCCD.getBinX() * h / PrimaryCCD.getBinY() * PrimaryCCD.getBPP() / 8, false);
+
+    if (HasStreaming())
+        Streamer->setSize(w / PrimaryCCD.getBinX(), h / PrimaryCCD.getBinY());
     return true;
 }
 
@@ -1200,6 +1462,14 @@ bool ATIKCCD::UpdateCCDFrame(int x, int y, int w, int h)
 /////////////////////////////////////////////////////////
 bool ATIKCCD::UpdateCCDBin(int binx, int biny)
 {
+    if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot change binning while streaming.");
+        return false;
+    }
+
+    cancelOverlappedExposure();
+
     int rc = ArtemisBin(hCam, binx, biny);
 
     if (rc != ARTEMIS_OK)
@@ -1492,6 +1762,10 @@ void *ATIKCCD::imagingThreadEntry()
         {
             checkExposureProgress();
         }
+        else if (threadRequest == StateStream)
+        {
+            streamFrames();
+        }
         else if (threadRequest == StateRestartExposure)
         {
             threadRequest = StateIdle;
@@ -1538,7 +1812,8 @@ void ATIKCCD::checkExposureProgress()
             pthread_mutex_lock(&condMutex);
             exposureSetRequest(StateIdle);
             pthread_mutex_unlock(&condMutex);
-            grabImage();
+            if (grabImage() && OverlappedS[OVERLAPPED_ON].s == ISS_ON)
+                startOverlappedExposure();
             pthread_mutex_lock(&condMutex);
             pthread_mutex_unlock(&accessMutex);
             break;
@@ -1609,6 +1884,50 @@ void ATIKCCD::checkExposureProgress()
     }
 }
 
+/////////////////////////////////////////////////////////
+/// Feed the streamer from the frame ring
+/////////////////////////////////////////////////////////
+void ATIKCCD::streamFrames()
+{
+    std::vector<uint8_t> frame;
+    int frameW = 0, frameH = 0;
+    uint32_t reportedDropped = 0;
+
+    while (threadRequest == StateStream)
+    {
+        if (streamCount == 0)
+        {
+            pthread_cond_wait(&cv, &condMutex);
+            continue;
+        }
+
+        // Take the buffer, the ring gets the previous one back to fill
+        StreamFrame &next = streamRing[streamHead];
+        frame.swap(next.data);
+        int w = next.w, h = next.h;
+        streamHead = (streamHead + 1) % STREAM_RING_SIZE;
+        streamCount--;
+        uint32_t dropped = streamDropped;
+        pthread_mutex_unlock(&condMutex);
+
+        if (w != frameW || h != frameH)
+        {
+            Streamer->setSize(w, h);
+            frameW = w;
+            frameH = h;
+        }
+        if (dropped != reportedDropped)
+        {
+            LOGF_DEBUG("%u frames dropped while streaming.", dropped);
+            reportedDropped = dropped;
+        }
+
+        Streamer->newFrame(frame.data(), frame.size());
+
+        pthread_mutex_lock(&condMutex);
+    }
+}
+
 /////////////////////////////////////////////////////////
 /// Update Exposure Request
 /////////////////////////////////////////////////////////
@@ -1627,6 +1946,10 @@ void ATIKCCD::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSR
 {
     INDI::CCD::addFITSKeywords(targetChip, fitsKeywords);
 
+    // The chip stamps the start when StartExposure() is called, an overlapped exposure started earlier
+    if (m_FrameOverlapped)
+        setFITSDateObs(fitsKeywords, ExpStart);
+
     if (m_isHorizon)
     {
         fitsKeywords.push_back({"GAIN", ControlN[CONTROL_GAIN].value, 3, "Gain"});
@@ -1658,6 +1981,8 @@ bool ATIKCCD::saveConfigItems(FILE *fp)
         // IUSaveConfigSwitch(fp, &BitSendSP); // unused
     }
 
+    IUSaveConfigSwitch(fp, &OverlappedSP);
+
     if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
         FilterNameTP.save(fp);
     // JM 2020-01-15: Seems like setting filter slot results in spinning
@@ -1670,6 +1995,8 @@ bool ATIKCCD::saveConfigItems(FILE *fp)
 bool ATIKCCD::SelectFilter(int targetFilter)
 {
     LOGF_DEBUG("Selecting filter %d", targetFilter);
+    // The pending overlapped exposure would be taken through the wrong filter
+    cancelOverlappedExposure();
     int rc = ArtemisFilterWheelMove(hCam, targetFilter - 1);
     return (rc == ARTEMIS_OK);
 }
@@ -26,6 +26,8 @@
 #include <indifilterinterface.h>
 #include <indiccd.h>
 
+#include <vector>
+
 class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
 {
     public:
@@ -44,6 +46,9 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
         virtual bool StartExposure(float duration) override;
         virtual bool AbortExposure() override;
 
+        virtual bool StartStreaming() override;
+        virtual bool StopStreaming() override;
+
         static void debugCallbackHelper(void *context, const char *message);
 
     protected:
@@ -119,6 +124,16 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
         // Debug
         void debugCallback(const char *message);
 
+        // Streaming, frames are delivered by the SDK fast mode callback
+        static void fastCallbackHelper(ArtemisHandle handle, int x, int y, int w, int h, int binx, int biny,
+                                       void *imageBuffer, unsigned char *info);
+        void fastCallback(int w, int h, const void *imageBuffer, const FastCallbackInfo *info);
+        void streamFrames();
+
+        // Overlapped exposures, the next exposure of a sequence starts as soon as a frame is downloaded
+        bool startOverlappedExposure();
+        void cancelOverlappedExposure();
+
         // Exposure Progress
         void checkExposureProgress();
         void exposureSetRequest(ImageState request);
@@ -220,6 +235,15 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
             FASTMODE_FAST,
         };
 
+        // Overlapped exposures
+        ISwitch OverlappedS[2];
+        ISwitchVectorProperty OverlappedSP;
+        enum
+        {
+            OVERLAPPED_OFF = 0,
+            OVERLAPPED_ON
+        };
+
 #if 0 // unused
         // Bit send
         ISwitch BitSendS[2];
@@ -254,6 +278,27 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
         pthread_mutex_t condMutex = PTHREAD_MUTEX_INITIALIZER;
         pthread_mutex_t accessMutex = PTHREAD_MUTEX_INITIALIZER;
 
+        // Streaming frame ring, filled by the fast mode callback and drained by the imaging thread, guarded by condMutex
+        static constexpr int STREAM_RING_SIZE = 4;
+        struct StreamFrame
+        {
+            std::vector<uint8_t> data;
+            int w {0}, h {0};
+        };
+        StreamFrame streamRing[STREAM_RING_SIZE];
+        int streamHead {0};
+        int streamCount {0};
+        // Frames dropped by the camera, the SDK or a full ring
+        uint32_t streamDropped {0};
+
+        // Pending overlapped exposure, guarded by accessMutex
+        bool m_OverlappedPending { false };
+        double m_OverlappedDuration { 0 };
+        INDI::CCDChip::CCD_FRAME m_OverlappedFrameType { INDI::CCDChip::LIGHT_FRAME };
+        struct timeval m_OverlappedStart;
+        // The current frame continues an overlapped exposure, DATE-OBS comes from ExpStart
+        bool m_FrameOverlapped { false };
+
         // Pulse Guiding
         int WEtimerID;
         int NStimerID;
@@ -23,11 +23,14 @@
 
 #include "lx200stargofocuser.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <memory>
 #include <cstring>
 #include <unistd.h>
 #include <numeric>
+#include <poll.h>
 #ifndef _WIN32
 #include <termios.h>
 #endif
@@ -131,9 +134,12 @@ bool LX200StarGo::Handshake()
     bool isTracking;
     int alignmentPoints;
 
+    startReader();
+
     if(!getScopeAlignmentStatus(&mountType, &isTracking, &alignmentPoints))
     {
         LOG_ERROR("Error communication with telescope.");
+        stopReader();
         return false;
     }
 
@@ -517,6 +523,8 @@ bool LX200StarGo::Connect()
 
 bool LX200StarGo::Disconnect()
 {
+    // the port is closed below, the reader must be gone by then
+    stopReader();
     bool result = DefaultDevice::Disconnect();
     result &= activateFocuserAux1(false);
     return result;
@@ -1179,44 +1187,42 @@ bool LX200StarGo::sendQuery(const char* cmd, char* response, char end, int wait)
     char lresponse[AVALON_RESPONSE_BUFFER_LENGTH];
     int lbytes = 0;
     lresponse [0] = '\0';
-    while (receive(lresponse, &lbytes, '#', 0))
-    {
-        lbytes = 0;
-        ParseMotionState(lresponse);
-        lresponse [0] = '\0';
-    }
+
+    // motion states arriving in the meantime have been set aside by the reader,
+    // stale replies are dropped
+    applyMotionState();
     flush();
+
+    replyEnd = end;
     if(!transmit(cmd))
     {
         LOGF_ERROR("Command <%s> failed.", cmd);
-        // sleep for 50 mseconds to avoid flooding the mount with commands
-        nanosleep(&mount_request_delay, nullptr);
+        replyEnd = '#';
         return false;
     }
-    lresponse[0] = '\0';
-    int lwait = wait;
-    bool found = false;
-    while (receive(lresponse, &lbytes, end, lwait))
-    {
-        //        LOGF_DEBUG("Found response after %ds %s", lwait, lresponse);
-        lbytes = 0;
-        if(! ParseMotionState(lresponse))
-        {
-            // Take the first response that is no motion state
-            if (!found)
-                strcpy(response, lresponse);
-            found = true;
-            lwait = 0;
-        }
-    }
-    flush();
-
-    // sleep for 50 mseconds to avoid flooding the mount with commands
-    nanosleep(&mount_request_delay, nullptr);
+    // Take the first response that is no motion state
+    if (wait > 0 && receive(lresponse, &lbytes, end, wait))
+        strcpy(response, lresponse);
+    replyEnd = '#';
 
+    applyMotionState();
     return true;
 }
 
+bool LX200StarGo::applyMotionState()
+{
+    char state[AVALON_RESPONSE_BUFFER_LENGTH];
+    {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        if (pendingMotionState.empty())
+            return false;
+        strncpy(state, pendingMotionState.c_str(), sizeof(state) - 1);
+        state[sizeof(state) - 1] = '\0';
+        pendingMotionState.clear();
+    }
+    return ParseMotionState(state);
+}
+
 bool LX200StarGo::ParseMotionState(char* state)
 {
     LOGF_DEBUG("%s %s", __FUNCTION__, state);
@@ -1819,36 +1825,70 @@ bool LX200StarGo::getFirmwareInfo (char* firmwareInfo)
  * @param bytes - number of bytes contained in the answer
  * @author CanisUrsa
  * @return true if communication succeeded, false otherwise
+ *
+ * Once the reader runs, the answer is the next reply it queued.
  */
 bool LX200StarGo::receive(char* buffer, int* bytes, char end, int wait)
 {
     //    LOGF_DEBUG("%s timeout=%ds",__FUNCTION__, wait);
-    int timeout = wait; //? AVALON_TIMEOUT: 0;
-    int returnCode = tty_read_section(PortFD, buffer, end, timeout, bytes);
-    if (returnCode != TTY_OK)
+    if (!readerRunning)
     {
-        char errorString[MAXRBUF];
-        tty_error_msg(returnCode, errorString, MAXRBUF);
-        if(returnCode == TTY_TIME_OUT && wait <= 0) return false;
-        LOGF_WARN("Failed to receive full response: %s. (Return code: %d)", errorString, returnCode);
-        return false;
+        int timeout = wait; //? AVALON_TIMEOUT: 0;
+        int returnCode = tty_read_section(PortFD, buffer, end, timeout, bytes);
+        if (returnCode != TTY_OK)
+        {
+            char errorString[MAXRBUF];
+            tty_error_msg(returnCode, errorString, MAXRBUF);
+            if(returnCode == TTY_TIME_OUT && wait <= 0) return false;
+            LOGF_WARN("Failed to receive full response: %s. (Return code: %d)", errorString, returnCode);
+            return false;
+        }
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(readerMutex);
+        if (!replyReceived.wait_for(lock, std::chrono::seconds(wait > 0 ? wait : 0), [this] { return !replyQueue.empty() || !readerRunning; }) || replyQueue.empty())
+        {
+            if (wait > 0)
+                LOGF_WARN("Failed to receive full response: %s. (Return code: %d)", "Timeout error", TTY_TIME_OUT);
+            return false;
+        }
+        std::string reply = replyQueue.front();
+        replyQueue.pop_front();
+        lock.unlock();
+
+        *bytes = std::min(static_cast<int>(reply.size()), AVALON_RESPONSE_BUFFER_LENGTH - 1);
+        memcpy(buffer, reply.data(), *bytes);
+    }
+    if (*bytes == 0)
+    {
+        buffer[0] = '\0';
+        return true;
     }
     if(buffer[*bytes - 1] == '#')
         buffer[*bytes - 1] = '\0'; // remove #
     else
         buffer[*bytes] = '\0';
 
+    // the mount answered, it is ready for the next command
+    mountReadyTime = std::chrono::steady_clock::now();
     return true;
 }
 
 /**
  * @brief Flush the communication port.
  * @author CanisUrsa
+ *
+ * Drops replies nobody waited for.
  */
 void LX200StarGo::flush()
 {
     //    LOG_DEBUG(__FUNCTION__);
     //    tcflush(PortFD, TCIOFLUSH);
+    std::lock_guard<std::mutex> lock(readerMutex);
+    for (auto &reply : replyQueue)
+        LOGF_DEBUG("Dropping unexpected response %s", reply.c_str());
+    replyQueue.clear();
 }
 
 bool LX200StarGo::transmit(const char* buffer)
@@ -1856,7 +1896,16 @@ bool LX200StarGo::transmit(const char* buffer)
     //    LOG_DEBUG(__FUNCTION__);
     int bytesWritten = 0;
     flush();
+
+    // avoid flooding the mount, wait until it answered the last command or
+    // had the request delay to digest it
+    auto now = std::chrono::steady_clock::now();
+    if (now < mountReadyTime)
+        std::this_thread::sleep_for(mountReadyTime - now);
+
     int returnCode = tty_write_string(PortFD, buffer, &bytesWritten);
+    mountReadyTime = std::chrono::steady_clock::now() + std::chrono::seconds(mount_request_delay.tv_sec) +
+                     std::chrono::nanoseconds(mount_request_delay.tv_nsec);
 
     if (returnCode != TTY_OK)
     {
@@ -1868,6 +1917,93 @@ bool LX200StarGo::transmit(const char* buffer)
     return true;
 }
 
+/**
+ * @brief Start the background reader on the communication port.
+ */
+void LX200StarGo::startReader()
+{
+    stopReader();
+    if (PortFD < 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        replyQueue.clear();
+        pendingMotionState.clear();
+    }
+    mountReadyTime = std::chrono::steady_clock::now();
+    readerRunning = true;
+    readerThread = std::thread(&LX200StarGo::readerLoop, this, PortFD);
+}
+
+void LX200StarGo::stopReader()
+{
+    readerRunning = false;
+    if (readerThread.joinable())
+        readerThread.join();
+}
+
+/**
+ * @brief Split the incoming data into frames. Motion states (:Z1mts#) are sent by the
+ * mount at any time, they are kept aside. Everything else is a reply, terminated by '#'
+ * or by the terminator of the outstanding query.
+ */
+void LX200StarGo::readerLoop(int fd)
+{
+    std::string frame;
+    char buffer[64];
+
+    while (readerRunning)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int rc = poll(&pfd, 1, 100);
+        if (rc < 0 && errno != EINTR)
+            break;
+        if (rc <= 0)
+            continue;
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+            break;
+
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (n <= 0)
+            break;
+
+        for (ssize_t i = 0; i < n; i++)
+        {
+            char c = buffer[i];
+            frame += c;
+
+            bool complete = (c == '#') || (frame[0] != ':' && c == replyEnd);
+            if (!complete)
+            {
+                if (frame.size() > 4 * AVALON_RESPONSE_BUFFER_LENGTH)
+                    frame.clear();  // garbage
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(readerMutex);
+            if (frame.compare(0, 3, ":Z1") == 0)
+            {
+                frame.pop_back();
+                pendingMotionState = frame;
+            }
+            else
+            {
+                replyQueue.push_back(frame);
+                if (replyQueue.size() > 16)
+                    replyQueue.pop_front();
+                replyReceived.notify_all();
+            }
+            frame.clear();
+        }
+    }
+
+    readerRunning = false;
+    replyReceived.notify_all();
+}
+
 bool LX200StarGo::SetTrackMode(uint8_t mode)
 {
     LOGF_DEBUG("%s: Set Track Mode %d", __FUNCTION__, mode);
@@ -29,8 +29,14 @@
 #include <indilogger.h>
 #include <termios.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unistd.h>
 #include <queue>
 #include <list>
@@ -177,6 +183,7 @@ class LX200StarGo : public LX200Telescope
         bool getSystemSlewSpeedMode (int *index);
         bool setSystemSlewSpeedMode(int index);
 
+        // longest time the mount may need to digest a command it does not answer
         struct timespec mount_request_delay = {0, 50000000L};
         void setMountRequestDelay(int secs, long nanosecs)
         {
@@ -184,6 +191,25 @@ class LX200StarGo : public LX200Telescope
             mount_request_delay.tv_nsec = nanosecs;
         };
 
+        // Background reader. It owns all reads from the port, keeps the latest
+        // unsolicited :Z1 motion state and queues everything else as replies.
+        void startReader();
+        void stopReader();
+        void readerLoop(int fd);
+        // apply the latest :Z1 motion state received, if any
+        bool applyMotionState();
+
+        std::thread readerThread;
+        std::atomic_bool readerRunning {false};
+        std::mutex readerMutex;
+        std::condition_variable replyReceived;
+        std::deque<std::string> replyQueue;
+        std::string pendingMotionState;
+        // terminator of the reply to the outstanding query
+        std::atomic<char> replyEnd {'#'};
+        // the mount is busy with the last command until it answers or the request delay passes
+        std::chrono::steady_clock::time_point mountReadyTime;
+
         // autoguiding
         virtual bool setGuidingSpeeds(int raSpeed, int decSpeed);
 
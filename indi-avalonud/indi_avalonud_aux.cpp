@@ -593,6 +593,12 @@ bool AUDAUX::Connect()
         return false;
     }
 
+    telemetryStale = false;
+
+    // housekeepings are polled in background on their own socket, commands keep the requester one
+    telemetry.start(context, addr, "HOUSEKEEPINGS", getCurrentPollingPeriod());
+    telemetry.waitFirst(1000);
+
     tid = SetTimer(getCurrentPollingPeriod());
 
     DEBUGF(INDI::Logger::DBG_SESSION, "Successfully connected %s aux",IPaddress);
@@ -608,6 +614,7 @@ bool AUDAUX::Disconnect()
 
     DEBUG(INDI::Logger::DBG_SESSION, "Attempting to disconnect aux...");
 
+    telemetry.stop();
     zmq_close(requester);
 
     RemoveTimer( tid );
@@ -625,6 +632,7 @@ void AUDAUX::TimerHit()
         return;
 
     // Read the current status
+    telemetry.setPeriod(getCurrentPollingPeriod());
     readStatus();
 
     if ( SystemManagementSP.getState() == IPS_BUSY ) {
@@ -640,99 +648,96 @@ void AUDAUX::TimerHit()
 
 bool AUDAUX::readStatus()
 {
-    char *answer;
-
-    answer = sendRequest("HOUSEKEEPINGS");
-    if ( answer ) {
-        json j;
-        int value;
-
-        j = json::parse(answer,nullptr,false);
-        free(answer);
-
-        if ( j.is_discarded() )
-            return false;
-
-        if ( features & 0x0004 ) {
-            if ( j.contains("voltage_V") )
-                j["voltage_V"].get_to(PSUNP[PSU_VOLTAGE].value);
-            if ( j.contains("current_A") )
-                j["current_A"].get_to(PSUNP[PSU_CURRENT].value);
-            if ( j.contains("power_W") )
-                j["power_W"].get_to(PSUNP[PSU_POWER].value);
-            if ( j.contains("charge_Ah") )
-                j["charge_Ah"].get_to(PSUNP[PSU_CHARGE].value);
-            PSUNP.apply();
+    std::string answer;
+    int value;
+
+    // latest housekeepings from the telemetry poller, nothing to update until a new one arrives
+    if ( !telemetry.fetch(answer) ) {
+        // the poller gets no answer, keep the last values but flag them as outdated
+        if ( telemetry.isStale() && !telemetryStale ) {
+            DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
+            telemetryStale = true;
+            setTelemetryAlert(true);
         }
-        if ( j.contains("feedtime_perc") )
-            j["feedtime_perc"].get_to(SMNP[SM_FEEDTIME].value);
-        if ( j.contains("bufferload_perc") )
-            j["bufferload_perc"].get_to(SMNP[SM_BUFFERLOAD].value);
-        if ( j.contains("uptime_sec") )
-            j["uptime_sec"].get_to(SMNP[SM_UPTIME].value);
-        SMNP.apply();
-        if ( j.contains("cputemp_celsius") )
-            j["cputemp_celsius"].get_to(CPUNP[0].value);
-        CPUNP.apply();
+        return false;
+    }
 
-        if ( features & 0x0010 ) {
-            if ( j.contains("POWER_PORT_OUT1") ) {
-                j["POWER_PORT_OUT1"].get_to(value);
-                OUTPort1SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-                OUTPort1SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-                OUTPort1SP.apply();
-            }
-        }
-        if ( features & 0x0020 ) {
-            if ( j.contains("POWER_PORT_OUT2") ) {
-                j["POWER_PORT_OUT2"].get_to(value);
-                OUTPort2SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-                OUTPort2SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-                OUTPort2SP.apply();
-            }
-        }
-        if ( features & 0x0040 ) {
-            if ( j.contains("POWER_PORT_OUTPWM_DUTYCYCLE") ) {
-                j["POWER_PORT_OUTPWM_DUTYCYCLE"].get_to(OUTPortPWMDUTYCYCLENP[0].value);
-                OUTPortPWMDUTYCYCLENP[0].value *= 100.0 / 255.0;
-                OUTPortPWMDUTYCYCLENP.apply();
-            }
-            if ( j.contains("POWER_PORT_OUTPWM") ) {
-                j["POWER_PORT_OUTPWM"].get_to(value);
-                OUTPortPWMSP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-                OUTPortPWMSP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-                OUTPortPWMSP.apply();
-            }
-        }
+    if ( telemetryStale ) {
+        DEBUG(INDI::Logger::DBG_SESSION, "Driver is answering again");
+        telemetryStale = false;
+        setTelemetryAlert(false);
+    }
 
-        if ( j.contains("POWER_PORT_USB1") ) {
-            j["POWER_PORT_USB1"].get_to(value);
-            USBPort1SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-            USBPort1SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-            USBPort1SP.apply();
-        }
-        if ( j.contains("POWER_PORT_USB2") ) {
-            j["POWER_PORT_USB2"].get_to(value);
-            USBPort2SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-            USBPort2SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-            USBPort2SP.apply();
+    auto setPort = [&](INDI::PropertySwitch &port, const char *key) {
+        if ( AUDJSON::getInt(answer,key,value) ) {
+            port[POWER_ON].setState((value?ISS_ON:ISS_OFF));
+            port[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
+            port.apply();
         }
-        if ( j.contains("POWER_PORT_USB3") ) {
-            j["POWER_PORT_USB3"].get_to(value);
-            USBPort3SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-            USBPort3SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-            USBPort3SP.apply();
-        }
-        if ( j.contains("POWER_PORT_USB4") ) {
-            j["POWER_PORT_USB4"].get_to(value);
-            USBPort4SP[POWER_ON].setState((value?ISS_ON:ISS_OFF));
-            USBPort4SP[POWER_OFF].setState((value?ISS_OFF:ISS_ON));
-            USBPort4SP.apply();
+    };
+
+    if ( features & 0x0004 ) {
+        AUDJSON::getNumber(answer,"voltage_V",PSUNP[PSU_VOLTAGE].value);
+        AUDJSON::getNumber(answer,"current_A",PSUNP[PSU_CURRENT].value);
+        AUDJSON::getNumber(answer,"power_W",PSUNP[PSU_POWER].value);
+        AUDJSON::getNumber(answer,"charge_Ah",PSUNP[PSU_CHARGE].value);
+        PSUNP.apply();
+    }
+    AUDJSON::getNumber(answer,"feedtime_perc",SMNP[SM_FEEDTIME].value);
+    AUDJSON::getNumber(answer,"bufferload_perc",SMNP[SM_BUFFERLOAD].value);
+    AUDJSON::getNumber(answer,"uptime_sec",SMNP[SM_UPTIME].value);
+    SMNP.apply();
+    AUDJSON::getNumber(answer,"cputemp_celsius",CPUNP[0].value);
+    CPUNP.apply();
+
+    if ( features & 0x0010 )
+        setPort(OUTPort1SP,"POWER_PORT_OUT1");
+    if ( features & 0x0020 )
+        setPort(OUTPort2SP,"POWER_PORT_OUT2");
+    if ( features & 0x0040 ) {
+        if ( AUDJSON::getNumber(answer,"POWER_PORT_OUTPWM_DUTYCYCLE",OUTPortPWMDUTYCYCLENP[0].value) ) {
+            OUTPortPWMDUTYCYCLENP[0].value *= 100.0 / 255.0;
+            OUTPortPWMDUTYCYCLENP.apply();
         }
-        return true;
+        setPort(OUTPortPWMSP,"POWER_PORT_OUTPWM");
     }
 
-    return false;
+    setPort(USBPort1SP,"POWER_PORT_USB1");
+    setPort(USBPort2SP,"POWER_PORT_USB2");
+    setPort(USBPort3SP,"POWER_PORT_USB3");
+    setPort(USBPort4SP,"POWER_PORT_USB4");
+
+    return true;
+}
+
+void AUDAUX::setTelemetryAlert(bool alert)
+{
+    // status vectors are normally idle, port switches ok
+    IPState status = ( alert ? IPS_ALERT : IPS_IDLE );
+    IPState port = ( alert ? IPS_ALERT : IPS_OK );
+
+    auto setState = [](INDI::Property &vector, IPState state) {
+        vector.setState(state);
+        vector.apply();
+    };
+
+    if ( features & 0x0004 )
+        setState(PSUNP,status);
+    setState(SMNP,status);
+    setState(CPUNP,status);
+
+    if ( features & 0x0010 )
+        setState(OUTPort1SP,port);
+    if ( features & 0x0020 )
+        setState(OUTPort2SP,port);
+    if ( features & 0x0040 ) {
+        setState(OUTPortPWMDUTYCYCLENP,port);
+        setState(OUTPortPWMSP,port);
+    }
+    setState(USBPort1SP,port);
+    setState(USBPort2SP,port);
+    setState(USBPort3SP,port);
+    setState(USBPort4SP,port);
 }
 
 bool AUDAUX::saveConfigItems(FILE *fp)
@@ -770,6 +775,7 @@ char* AUDAUX::sendCommand(const char *fmt, ... )
             // communication succeeded
             rc = zmq_recv(requester, answer, sizeof(answer), 0);
             if ( rc >= 0 ) {
+                telemetry.invalidate();
                 pthread_mutex_unlock( &connectionmutex );
                 answer[MIN(rc,(int)sizeof(answer)-1)] = '\0';
                 if ( !strncmp(answer,"OK",2) )
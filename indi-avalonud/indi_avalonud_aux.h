@@ -23,6 +23,7 @@
 #include <time.h>
 #include <pthread.h>
 #include "defaultdevice.h"
+#include "indi_avalonud_telemetry.h"
 
 #define MIN(a,b) (((a)<=(b))?(a):(b))
 
@@ -101,12 +102,15 @@ private:
     INDI::PropertyNumber CPUNP {1};
 
     bool readStatus();
+    void setTelemetryAlert(bool);
 
     char* IPaddress;
     char* sendCommand(const char*,...);
     char* sendRequest(const char*,...);
 
     void *context,*requester;
+    AUDTELEMETRY telemetry;
+    bool telemetryStale;
     time_t reboot_time,shutdown_time;
 
     pthread_mutex_t connectionmutex;
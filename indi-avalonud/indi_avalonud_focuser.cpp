@@ -210,7 +210,7 @@ bool AUDFOCUSER::ISNewSwitch(const char * dev, const char * name, ISState * stat
 
 bool AUDFOCUSER::Connect()
 {
-    char addr[1024], *answer;
+    char addr[1024], request[64], *answer;
     int timeout = 500;
 
     if (isConnected())
@@ -280,6 +280,11 @@ bool AUDFOCUSER::Connect()
         return false;
     }
 
+    // status is polled in background on its own socket, commands keep the requester one
+    snprintf( request, sizeof(request), "STATUS %d", STEPMACHINE_DRIVER_NUM );
+    telemetry.start(context, addr, request, getCurrentPollingPeriod());
+    telemetry.waitFirst(1000);
+
     tid = SetTimer(getCurrentPollingPeriod());
 
     DEBUGF(INDI::Logger::DBG_SESSION, "Successfully connected %s focuser",IPaddress);
@@ -295,6 +300,7 @@ bool AUDFOCUSER::Disconnect()
 
     DEBUG(INDI::Logger::DBG_SESSION, "Attempting to disconnect focuser...");
 
+    telemetry.stop();
     zmq_close(requester);
 
     RemoveTimer( tid );
@@ -392,6 +398,7 @@ void AUDFOCUSER::TimerHit()
         return;
 
     // Read the current position
+    telemetry.setPeriod(getCurrentPollingPeriod());
     readPosition();
 
     // Check if we have a pending motion
@@ -416,27 +423,26 @@ void AUDFOCUSER::TimerHit()
 
 bool AUDFOCUSER::readPosition()
 {
-    char *answer;
-
-    answer = sendRequest("STATUS %d",STEPMACHINE_DRIVER_NUM);
-    if ( answer ) {
-        json j;
-
-        j = json::parse(answer,nullptr,false);
-        free(answer);
-        if ( j.is_discarded() ||
-                !j.contains("position_step") ||
-                !j.contains("statusCode") )
-        {
-            DEBUG(INDI::Logger::DBG_WARNING,"Status communication error");
-            return false;
-        }
-        j["position_step"].get_to(currentPosition);
-        j["statusCode"].get_to(statusCode);
-        return true;
+    std::string answer;
+    int64_t position;
+    int code;
+
+    // latest status from the telemetry poller, previous values are kept until a new one arrives
+    if ( !telemetry.fetch(answer) ) {
+        if ( telemetry.isStale() )
+            statusCode = UNRESPONSIVE;
+        return false;
     }
 
-    return false;
+    if ( !AUDJSON::getInt64(answer,"position_step",position) ||
+            !AUDJSON::getInt(answer,"statusCode",code) )
+    {
+        DEBUG(INDI::Logger::DBG_WARNING,"Status communication error");
+        return false;
+    }
+    currentPosition = position;
+    statusCode = code;
+    return true;
 }
 
 bool AUDFOCUSER::saveConfigItems(FILE *fp)
@@ -474,6 +480,7 @@ char* AUDFOCUSER::sendCommand(const char *fmt, ... )
             // communication succeeded
             rc = zmq_recv(requester, answer, sizeof(answer), 0);
             if ( rc >= 0 ) {
+                telemetry.invalidate();
                 pthread_mutex_unlock( &connectionmutex );
                 answer[MIN(rc,(int)sizeof(answer)-1)] = '\0';
                 if ( !strncmp(answer,"OK",2) )
@@ -22,6 +22,7 @@
 
 #include <pthread.h>
 #include "indifocuser.h"
+#include "indi_avalonud_telemetry.h"
 
 #define MIN(a,b) (((a)<=(b))?(a):(b))
 
@@ -76,6 +77,7 @@ private:
     char* sendRequest(const char*,...);
 
     void *context,*requester;
+    AUDTELEMETRY telemetry;
     int64_t currentPosition;
     int statusCode;
 
@@ -0,0 +1,285 @@
+/*
+    Avalon Unified Driver Telemetry
+
+    Copyright (C) 2020,2023
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indi_avalonud_telemetry.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zmq.h>
+
+
+// longest time the worker blocks in zmq_poll, bounds the stop() latency
+#define POLL_SLICE_MS 100
+
+// replies missing for this many periods make the telemetry stale
+#define STALE_PERIODS 3
+
+
+AUDTELEMETRY::~AUDTELEMETRY()
+{
+    stop();
+}
+
+bool AUDTELEMETRY::start(void *ctx, const char *addr, const char *req, int period)
+{
+    stop();
+
+    context = ctx;
+    address = addr;
+    request = req;
+    setPeriod(period);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        reply.clear();
+        sequence = fetched = 0;
+        lastReply = notBefore = std::chrono::steady_clock::now();
+    }
+
+    running = true;
+    worker = std::thread(&AUDTELEMETRY::run, this);
+    return true;
+}
+
+void AUDTELEMETRY::stop()
+{
+    running = false;
+    if ( worker.joinable() )
+        worker.join();
+}
+
+void AUDTELEMETRY::setPeriod(int period)
+{
+    periodMs = ( period > 0 ) ? period : 1000;
+}
+
+bool AUDTELEMETRY::waitFirst(int timeoutMs)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    return updated.wait_for(guard, std::chrono::milliseconds(timeoutMs), [this] { return sequence > 0; });
+}
+
+bool AUDTELEMETRY::fetch(std::string &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if ( sequence == fetched )
+        return false;
+    out = reply;
+    fetched = sequence;
+    return true;
+}
+
+void AUDTELEMETRY::invalidate()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    notBefore = std::chrono::steady_clock::now();
+}
+
+bool AUDTELEMETRY::isStale() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto limit = std::chrono::milliseconds(std::max(STALE_PERIODS * periodMs.load(), 1500));
+    return ( std::chrono::steady_clock::now() - lastReply ) > limit;
+}
+
+void AUDTELEMETRY::run()
+{
+    char answer[4096];
+    int on = 1, linger = 0;
+    void *socket;
+
+    socket = zmq_socket(context, ZMQ_REQ);
+    // a new request may be sent while the previous answer is still missing,
+    // and a late answer to the previous one is dropped
+    zmq_setsockopt(socket, ZMQ_REQ_RELAXED, &on, sizeof(on));
+    zmq_setsockopt(socket, ZMQ_REQ_CORRELATE, &on, sizeof(on));
+    zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_connect(socket, address.c_str());
+
+    while ( running ) {
+        auto sent = std::chrono::steady_clock::now();
+        auto next = sent + std::chrono::milliseconds(periodMs.load());
+
+        zmq_send(socket, request.data(), request.size(), 0);
+
+        // wait for the answer, at most until the next request is due
+        while ( running ) {
+            int left = std::chrono::duration_cast<std::chrono::milliseconds>(next - std::chrono::steady_clock::now()).count();
+            if ( left <= 0 )
+                break;
+
+            zmq_pollitem_t item = { socket, 0, ZMQ_POLLIN, 0 };
+            int rc = zmq_poll( &item, 1, std::min(left, POLL_SLICE_MS) );
+            if ( ( rc > 0 ) && ( item.revents & ZMQ_POLLIN ) ) {
+                rc = zmq_recv(socket, answer, sizeof(answer), 0);
+                if ( rc >= 0 ) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    lastReply = std::chrono::steady_clock::now();
+                    if ( sent >= notBefore ) {
+                        reply.assign(answer, std::min(rc, (int)sizeof(answer)));
+                        sequence++;
+                        updated.notify_all();
+                    } else {
+                        // asked before the last command, poll again at once
+                        next = lastReply;
+                    }
+                }
+                break;
+            }
+        }
+
+        // then sleep out the rest of the period
+        while ( running && std::chrono::steady_clock::now() < next )
+            std::this_thread::sleep_for(std::min(std::chrono::duration_cast<std::chrono::milliseconds>(next - std::chrono::steady_clock::now()),
+                                                 std::chrono::milliseconds(POLL_SLICE_MS)));
+    }
+
+    zmq_close(socket);
+}
+
+
+namespace AUDJSON
+{
+
+// Find the value of a top level key, returns a pointer past the ':' or nullptr
+static const char *findValue(const std::string &json, const char *key)
+{
+    const char *p = json.c_str();
+    size_t keylen = strlen(key);
+    int depth = 0;
+
+    while ( *p ) {
+        if ( *p == '{' || *p == '[' ) {
+            depth++;
+            p++;
+        } else if ( *p == '}' || *p == ']' ) {
+            depth--;
+            p++;
+        } else if ( *p == '"' ) {
+            const char *start = ++p;
+            while ( *p && *p != '"' ) {
+                if ( *p == '\\' && p[1] )
+                    p++;
+                p++;
+            }
+            if ( !*p )
+                return nullptr;
+            const char *end = p++;
+
+            while ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' )
+                p++;
+            if ( *p != ':' )
+                continue;   // a string value, not a key
+            p++;
+
+            if ( depth == 1 && (size_t)(end - start) == keylen && !strncmp(start, key, keylen) ) {
+                while ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' )
+                    p++;
+                return p;
+            }
+        } else {
+            p++;
+        }
+    }
+
+    return nullptr;
+}
+
+bool getNumber(const std::string &json, const char *key, double &value)
+{
+    const char *p = findValue(json, key);
+    char *end;
+
+    if ( !p )
+        return false;
+    if ( !strncmp(p, "true", 4) ) {
+        value = 1;
+        return true;
+    }
+    if ( !strncmp(p, "false", 5) ) {
+        value = 0;
+        return true;
+    }
+
+    double v = strtod(p, &end);
+    if ( end == p )
+        return false;
+    value = v;
+    return true;
+}
+
+bool getInt(const std::string &json, const char *key, int &value)
+{
+    double v;
+
+    if ( !getNumber(json, key, v) )
+        return false;
+    value = (int)v;
+    return true;
+}
+
+bool getInt64(const std::string &json, const char *key, int64_t &value)
+{
+    const char *p = findValue(json, key);
+    char *end;
+
+    if ( !p )
+        return false;
+
+    // integers are parsed as such to keep the full range
+    long long v = strtoll(p, &end, 10);
+    if ( end == p )
+        return false;
+    if ( *end == '.' || *end == 'e' || *end == 'E' )
+        v = (long long)strtod(p, &end);
+    value = v;
+    return true;
+}
+
+bool getString(const std::string &json, const char *key, std::string &value)
+{
+    const char *p = findValue(json, key);
+
+    if ( !p || *p != '"' )
+        return false;
+
+    std::string s;
+    for ( p++; *p && *p != '"'; p++ ) {
+        if ( *p == '\\' && p[1] ) {
+            p++;
+            switch ( *p ) {
+                case 'n' : s += '\n'; break;
+                case 't' : s += '\t'; break;
+                case 'r' : s += '\r'; break;
+                default  : s += *p; break;
+            }
+        } else {
+            s += *p;
+        }
+    }
+    if ( !*p )
+        return false;
+
+    value = s;
+    return true;
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+    Avalon Unified Driver Telemetry
+
+    Copyright (C) 2020,2023
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+ * Status telemetry for the AvalonUD drivers.
+ *
+ * A background thread owns a dedicated REQ socket and asks the controller for the
+ * status at the configured period, keeping only the latest reply. The drivers pick
+ * the reply up from their timer without ever waiting on the network, and their
+ * command socket is left free for commands. The socket is relaxed/correlated so a
+ * missed reply never requires tearing it down.
+ */
+class AUDTELEMETRY
+{
+public:
+    AUDTELEMETRY() = default;
+    ~AUDTELEMETRY();
+
+    bool start(void *context, const char *address, const char *request, int periodMs);
+    void stop();
+
+    void setPeriod(int periodMs);
+
+    // Wait for the first reply after start(), used to fill properties on connect
+    bool waitFirst(int timeoutMs);
+
+    // Copy the latest reply if one arrived since the previous call
+    bool fetch(std::string &reply);
+
+    // Drop replies to requests sent before now, called after each command so the
+    // next status seen by the driver reflects it
+    void invalidate();
+
+    // True when no reply arrived for several periods
+    bool isStale() const;
+
+private:
+    void run();
+
+    void *context { nullptr };
+    std::string address;
+    std::string request;
+    std::atomic<int> periodMs { 1000 };
+
+    std::thread worker;
+    std::atomic<bool> running { false };
+
+    mutable std::mutex lock;
+    std::condition_variable updated;
+    std::string reply;
+    uint64_t sequence { 0 };
+    uint64_t fetched { 0 };
+    std::chrono::steady_clock::time_point lastReply;
+    std::chrono::steady_clock::time_point notBefore;
+};
+
+/*
+ * Field extraction from the flat JSON objects sent by the controller, without
+ * building a document. Values are only written when the key is found.
+ */
+namespace AUDJSON
+{
+bool getNumber(const std::string &json, const char *key, double &value);
+bool getInt(const std::string &json, const char *key, int &value);
+bool getInt64(const std::string &json, const char *key, int64_t &value);
+bool getString(const std::string &json, const char *key, std::string &value);
+}
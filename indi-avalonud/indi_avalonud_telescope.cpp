@@ -449,6 +449,11 @@ bool AUDTELESCOPE::Connect()
     northernHemisphere = 1;
 
     slewState = IPS_IDLE;
+    telemetryStale = false;
+
+    // status is polled in background on its own socket, commands keep the requester one
+    telemetry.start(context, addr, "ASTRO_STATUS", getCurrentPollingPeriod());
+    telemetry.waitFirst(1000);
 
     tid = SetTimer(getCurrentPollingPeriod());
 
@@ -467,6 +472,7 @@ bool AUDTELESCOPE::Disconnect()
 
     DEBUG(INDI::Logger::DBG_SESSION, "Attempting to disconnect telescope...");
 
+    telemetry.stop();
     zmq_close(requester);
 
     RemoveTimer( tid );
@@ -644,69 +650,48 @@ bool AUDTELESCOPE::updateTime(ln_date *utc, double utc_offset)
 
 bool AUDTELESCOPE::ReadScopeStatus()
 {
-    char *answer;
+    std::string answer;
     int sts, pierside, exposureready, meridianflip;
     double utc, lst, jd, ha, ra, dec, az, alt, meridianflipha;
 
 
-    answer = sendRequest("ASTRO_STATUS");
-    if ( answer )
+    // latest status from the telemetry poller, nothing to update until a new one arrives
+    if ( telemetry.fetch(answer) )
     {
-        json j;
+        std::string msg;
 
-        j = json::parse(answer, nullptr, false);
-        free(answer);
-        if ( j.is_discarded() ||
-                !j.contains("UTC") ||
-                !j.contains("JD") ||
-                !j.contains("LST") ||
-                !j.contains("HA") ||
-                !j.contains("RA") ||
-                !j.contains("Dec") ||
-                !j.contains("Az") ||
-                !j.contains("Alt") ||
-                !j.contains("globalStatus") ||
-                !j.contains("meridianFlip") ||
-                !j.contains("pierSide") ||
-                !j.contains("meridianFlipHA") ||
-                !j.contains("exposureReady") )
+        if ( telemetryStale )
+        {
+            DEBUG(INDI::Logger::DBG_SESSION, "Driver is answering again");
+            telemetryStale = false;
+        }
+
+        if ( !AUDJSON::getNumber(answer, "UTC", utc) ||
+                !AUDJSON::getNumber(answer, "JD", jd) ||
+                !AUDJSON::getNumber(answer, "LST", lst) ||
+                !AUDJSON::getNumber(answer, "HA", ha) ||
+                !AUDJSON::getNumber(answer, "RA", ra) ||
+                !AUDJSON::getNumber(answer, "Dec", dec) ||
+                !AUDJSON::getNumber(answer, "Az", az) ||
+                !AUDJSON::getNumber(answer, "Alt", alt) ||
+                !AUDJSON::getInt(answer, "globalStatus", sts) ||
+                !AUDJSON::getInt(answer, "meridianFlip", meridianflip) ||
+                !AUDJSON::getInt(answer, "pierSide", pierside) ||
+                !AUDJSON::getNumber(answer, "meridianFlipHA", meridianflipha) ||
+                !AUDJSON::getInt(answer, "exposureReady", exposureready) )
         {
             DEBUG(INDI::Logger::DBG_WARNING, "Status communication error");
             return false;
         }
-        j["UTC"].get_to(utc);
-        j["JD"].get_to(jd);
-        j["LST"].get_to(lst);
-        j["HA"].get_to(ha);
-        j["RA"].get_to(ra);
-        j["Dec"].get_to(dec);
-        j["Az"].get_to(az);
-        j["Alt"].get_to(alt);
-        j["globalStatus"].get_to(sts);
-        j["meridianFlip"].get_to(meridianflip);
-        j["pierSide"].get_to(pierside);
-        j["meridianFlipHA"].get_to(meridianflipha);
-        j["exposureReady"].get_to(exposureready);
-        if ( j.contains("errorMsg") )
+        if ( AUDJSON::getString(answer, "errorMsg", msg) && ( msg.length() > 0 ) )
         {
-            std::string msg;
-            j["errorMsg"].get_to(msg);
-            if ( msg.length() > 0 )
-            {
-                if ( !lastErrorMsg || ( lastErrorMsg && strcmp(msg.c_str(), lastErrorMsg) ) )
-                {
-                    // the error message is written only once until it changes
-                    DEBUGF(INDI::Logger::DBG_WARNING, "Failed due to %s", msg.c_str());
-                    if ( lastErrorMsg )
-                        free( lastErrorMsg );
-                    lastErrorMsg = strdup(msg.c_str());
-                }
-            }
-            else
+            if ( !lastErrorMsg || ( lastErrorMsg && strcmp(msg.c_str(), lastErrorMsg) ) )
             {
+                // the error message is written only once until it changes
+                DEBUGF(INDI::Logger::DBG_WARNING, "Failed due to %s", msg.c_str());
                 if ( lastErrorMsg )
                     free( lastErrorMsg );
-                lastErrorMsg = NULL;
+                lastErrorMsg = strdup(msg.c_str());
             }
         }
         else
@@ -804,6 +789,17 @@ bool AUDTELESCOPE::ReadScopeStatus()
         return true;
     }
 
+    // the poller gets no answer, keep the last position but flag it as outdated
+    if ( telemetry.isStale() )
+    {
+        if ( !telemetryStale )
+        {
+            DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
+            telemetryStale = true;
+        }
+        EqNP.setState(IPS_ALERT);
+    }
+
     return false;
 }
 
@@ -1392,6 +1388,7 @@ void AUDTELESCOPE::TimerHit()
     if (isConnected() == false)
         return;
 
+    telemetry.setPeriod(getCurrentPollingPeriod());
     ReadScopeStatus();
     EqNP.apply();
 
@@ -1436,6 +1433,7 @@ char* AUDTELESCOPE::sendCommand(const char *fmt, ...)
             rc = zmq_recv(requester, answer, sizeof(answer), 0);
             if ( rc >= 0 )
             {
+                telemetry.invalidate();
                 pthread_mutex_unlock( &connectionmutex );
                 answer[MIN(rc, (int)sizeof(answer) - 1)] = '\0';
                 if ( !strncmp(answer, "OK", 2) )
@@ -1477,6 +1475,7 @@ char* AUDTELESCOPE::sendCommandOnce(const char *fmt, ...)
         rc = zmq_recv(requester, answer, sizeof(answer), 0);
         if ( rc >= 0 )
         {
+            telemetry.invalidate();
             pthread_mutex_unlock( &connectionmutex );
             answer[MIN(rc, (int)sizeof(answer) - 1)] = '\0';
             if ( !strncmp(answer, "OK", 2) )
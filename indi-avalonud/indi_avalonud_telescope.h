@@ -28,6 +28,8 @@
 #include <indiguiderinterface.h>
 #include <pthread.h>
 
+#include "indi_avalonud_telemetry.h"
+
 
 #define MIN(a,b) (((a)<=(b))?(a):(b))
 
@@ -161,7 +163,7 @@ private:
     bool SlewToHome();
 
     // Variables
-    bool fFirstTime,fTracking;
+    bool fFirstTime,fTracking,telemetryStale;
     int northernHemisphere;
     IPState slewState;
     TelescopeStatus previousTrackState;
@@ -173,6 +175,7 @@ private:
     char* sendRequest(const char*,...);
 
     void *context,*requester;
+    AUDTELEMETRY telemetry;
     char *lastErrorMsg;
 
     pthread_mutex_t connectionmutex;
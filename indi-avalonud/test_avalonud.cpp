@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "indi_avalonud_telemetry.h"
+
+#include <cstdint>
+#include <string>
+
+// A status as sent by the controller, trimmed down
+static const std::string STATUS =
+    "{\"UTC\": 12.5, \"HA\": -3.25, \"Dec\": 4.5e1, \"position_step\": -1234567890123,"
+    " \"errorMsg\": \"Dec limit\", \"axis\": {\"Dec\": 99, \"HA\": 7},"
+    " \"tracking\": true, \"parked\": false, \"limits\": [1, 2, {\"UTC\": 0}],"
+    " \"label\": \"line\\nwith \\\"quotes\\\" and \\\\ tab\\t\"}";
+
+TEST(AUDJSON, readsTopLevelNumbers)
+{
+    double value = 0;
+
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "UTC", value));
+    EXPECT_DOUBLE_EQ(value, 12.5);
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "HA", value));
+    EXPECT_DOUBLE_EQ(value, -3.25);
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "Dec", value));
+    EXPECT_DOUBLE_EQ(value, 45.0);
+}
+
+TEST(AUDJSON, ignoresNestedKeys)
+{
+    double value = 0;
+    int count = 0;
+
+    // "Dec" and "HA" also appear inside "axis", "UTC" inside an array element
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "Dec", value));
+    EXPECT_DOUBLE_EQ(value, 45.0);
+    EXPECT_TRUE(AUDJSON::getInt(STATUS, "HA", count));
+    EXPECT_EQ(count, -3);
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "UTC", value));
+    EXPECT_DOUBLE_EQ(value, 12.5);
+
+    EXPECT_FALSE(AUDJSON::getNumber("{\"axis\": {\"RA\": 1}}", "RA", value));
+}
+
+TEST(AUDJSON, skipsStringValuesMatchingAKey)
+{
+    double value = 0;
+    std::string text;
+
+    // the value of "mode" is the name of the key looked for
+    const std::string json = "{\"mode\": \"speed\", \"speed\": 3}";
+    EXPECT_TRUE(AUDJSON::getNumber(json, "speed", value));
+    EXPECT_DOUBLE_EQ(value, 3.0);
+    EXPECT_TRUE(AUDJSON::getString(json, "mode", text));
+    EXPECT_EQ(text, "speed");
+
+    EXPECT_FALSE(AUDJSON::getNumber("{\"errorMsg\": \"speed\"}", "speed", value));
+}
+
+TEST(AUDJSON, unescapesStrings)
+{
+    std::string text;
+
+    EXPECT_TRUE(AUDJSON::getString(STATUS, "errorMsg", text));
+    EXPECT_EQ(text, "Dec limit");
+    EXPECT_TRUE(AUDJSON::getString(STATUS, "label", text));
+    EXPECT_EQ(text, "line\nwith \"quotes\" and \\ tab\t");
+
+    // an escaped quote does not end the value
+    EXPECT_TRUE(AUDJSON::getString("{\"a\": \"x\\\": 1\", \"b\": \"y\"}", "b", text));
+    EXPECT_EQ(text, "y");
+
+    // numbers are not strings, unterminated strings are rejected
+    EXPECT_FALSE(AUDJSON::getString(STATUS, "UTC", text));
+    EXPECT_FALSE(AUDJSON::getString("{\"a\": \"open", "a", text));
+}
+
+TEST(AUDJSON, readsBooleans)
+{
+    double value = -1;
+    int flag = -1;
+
+    EXPECT_TRUE(AUDJSON::getNumber(STATUS, "tracking", value));
+    EXPECT_DOUBLE_EQ(value, 1.0);
+    EXPECT_TRUE(AUDJSON::getInt(STATUS, "parked", flag));
+    EXPECT_EQ(flag, 0);
+}
+
+TEST(AUDJSON, readsInt64)
+{
+    int64_t value = 0;
+
+    EXPECT_TRUE(AUDJSON::getInt64(STATUS, "position_step", value));
+    EXPECT_EQ(value, -1234567890123LL);
+
+    // exponent and fractional values go through the floating point parser
+    EXPECT_TRUE(AUDJSON::getInt64("{\"p\": -1.5e3}", "p", value));
+    EXPECT_EQ(value, -1500);
+    EXPECT_TRUE(AUDJSON::getInt64("{\"p\": 2E2}", "p", value));
+    EXPECT_EQ(value, 200);
+    EXPECT_TRUE(AUDJSON::getInt64("{\"p\": 42.9}", "p", value));
+    EXPECT_EQ(value, 42);
+}
+
+TEST(AUDJSON, keepsValuesOfMissingKeys)
+{
+    double number = 7;
+    int count = 7;
+    int64_t big = 7;
+    std::string text = "kept";
+
+    EXPECT_FALSE(AUDJSON::getNumber(STATUS, "Az", number));
+    EXPECT_FALSE(AUDJSON::getInt(STATUS, "Az", count));
+    EXPECT_FALSE(AUDJSON::getInt64(STATUS, "Az", big));
+    EXPECT_FALSE(AUDJSON::getString(STATUS, "Az", text));
+    EXPECT_FALSE(AUDJSON::getNumber("", "UTC", number));
+    EXPECT_FALSE(AUDJSON::getNumber("{\"UTC\": \"now\"}", "UTC", number));
+
+    EXPECT_DOUBLE_EQ(number, 7.0);
+    EXPECT_EQ(count, 7);
+    EXPECT_EQ(big, 7);
+    EXPECT_EQ(text, "kept");
+}
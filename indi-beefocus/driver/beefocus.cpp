@@ -34,6 +34,7 @@
 #include "beeconnect.h"
 
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <memory>
 #include <regex>
@@ -86,6 +87,7 @@ Driver::Driver()
     setSupportedConnections( CONNECTION_TCP );
     timerTicks = 0;
     ignoreNextStatusUpdate = false;
+    hasStatusReports = false;
 
     // 
     // Create custom connection interface for the simulator and unit testing.
@@ -131,6 +133,9 @@ bool Driver::Connect()
 //    c) Handle Received Handshake
 // 6. Handle Timeout
 //
+// Firmware 1.1 and later report their status on their own, older
+// firmware still gets polled.
+//
 bool Driver::Handshake()
 {
     Connection::Interface* indiCon = getActiveConnection();
@@ -158,6 +163,7 @@ bool Driver::Handshake()
 
     // 3. Send requests for state down the network
     *Connection << "\n";
+    *Connection << "firmware\n";
     *Connection << "pstatus\n";
     *Connection << "sstatus\n";
     *Connection << "mstatus\n";
@@ -165,11 +171,18 @@ bool Driver::Handshake()
     // 4. Wait for responses
     constexpr int timeBetweenChecks = 10;       // in ms
     constexpr int timeOut           = 3000;     // in ms
+    hasStatusReports = false;
     for ( int mtime= 0;  mtime< timeOut ; mtime += timeBetweenChecks )
     {
         // 4a) Check for input
         HardwareState input( Connection.get() );
 
+        Optional<unsigned int> firmware = input.getFirmware();
+        if ( firmware )
+        {
+            hasStatusReports = *firmware >= FirmwareWithStatusReports;
+        }
+
         // 4b) Handle Lost Connection
         if ( Connection->Failed() )
         {
@@ -185,9 +198,16 @@ bool Driver::Handshake()
 
             *Connection << "lazyhome\n";
             *Connection << "caps\n";
-            *Connection << "pstatus\n";
-            *Connection << "sstatus\n";
-            *Connection << "mstatus\n";
+            if ( hasStatusReports )
+            {
+              *Connection << "status\n";
+            }
+            else
+            {
+              *Connection << "pstatus\n";
+              *Connection << "sstatus\n";
+              *Connection << "mstatus\n";
+            }
 
             return true;
         }
@@ -338,17 +358,27 @@ void Driver::TimerHit()
 
     HardwareState hwState( Connection.get() );
 
+    if ( hasStatusReports )
+    {
+      // The firmware reports changes on its own.  Ask every 8 ticks
+      // anyway in case a report got lost, and right away when this
+      // tick's report gets ignored so a fresh one follows.
+      if ( ( timerTicks % 8 ) == 0 || ignoreNextStatusUpdate )
+      {
+        *Connection << "STATUS\n";
+      }
+    }
     // Send out a new status request if we get a status request back or
     // every 8 ticks
-    if ( ( timerTicks % 8 ) == 0 || hwState.getIsSynced() )
+    else if ( ( timerTicks % 8 ) == 0 || hwState.getIsSynced() )
     { 
       *Connection << "SSTATUS\n";
     }
-    if ( ( timerTicks % 8 ) == 0 || hwState.getMode() )
+    if ( !hasStatusReports && ( ( timerTicks % 8 ) == 0 || hwState.getMode() ))
     { 
       *Connection << "MSTATUS\n";
     }
-    if ( ( timerTicks % 8 ) == 0 || hwState.getPosition() )
+    if ( !hasStatusReports && ( ( timerTicks % 8 ) == 0 || hwState.getPosition() ))
     {
       *Connection << "PSTATUS\n";
     }
@@ -539,6 +569,7 @@ const ModeToString stateFriendlyName = {
   { Mode::MOVING,            "Moving"                      },
   { Mode::HOMING,            "Searching for Home Position" },
   { Mode::LOW_POWER,         "Ready (Low Power Mode)"      },
+  { Mode::ERROR,             "Error"                       },
 };
 
 HardwareState::HardwareState( BeeFocusedCon::Interface* connection )
@@ -569,6 +600,21 @@ HardwareState::HardwareState( BeeFocusedCon::Interface* connection )
       {
         maxAbsPos = std::stoi( noun );
       }
+      if ( verb == "Firmware:" )
+      {
+        unsigned int major = 0, minor = 0;
+        sscanf( noun.c_str(), "%u.%u", &major, &minor );
+        firmware = major * 100 + minor;
+      }
+      // Status: <position> <synched> <mode>
+      if ( verb == "Status:" && tokens.size() >= 4 )
+      {
+        int pos = std::stoi( noun );
+        currentPos = pos > 0 ? pos : 0;
+        isSynced = ( tokens[2] == "YES" ) ? true : false;
+        bool found=focuserSStatusToMode.find( tokens[3] ) != focuserSStatusToMode.end();
+        mode = !found ? Mode::ERROR : focuserSStatusToMode.at( tokens[3] );
+      }
     }
   }
 }
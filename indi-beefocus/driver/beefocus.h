@@ -162,6 +162,9 @@ class HardwareState
   /// @brief    What is the focuser absolute maximum position?
   /// @return   The Current Position 
   Optional<unsigned int> getMaxAbsPos() const { return maxAbsPos; }
+  /// @brief    What firmware version (if any) did the focuser send?
+  /// @return   The version, as major * 100 + minor
+  Optional<unsigned int> getFirmware() const { return firmware; }
 
   private:
 
@@ -169,8 +172,12 @@ class HardwareState
   Optional<bool> isSynced;
   Optional<unsigned int> currentPos;
   Optional<unsigned int> maxAbsPos;
+  Optional<unsigned int> firmware;
 };
 
+/// @brief First firmware version that sends the combined status report
+constexpr unsigned int FirmwareWithStatusReports=101;
+
 ///
 /// @brief The INDI BeeFocus Driver Class 
 ///
@@ -234,6 +241,8 @@ class Driver: public INDI::Focuser
 
     /// @brief Should we ignore the next status update packet?  Wee hacky.
     bool ignoreNextStatusUpdate;
+    /// @brief Does the firmware send status reports on its own?
+    bool hasStatusReports;
     /// @brief Timer ticks since the Focuser started.
     int timerTicks;
 
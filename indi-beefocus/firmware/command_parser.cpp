@@ -34,6 +34,7 @@ const std::vector<CommandTemplate> commandTemplates =
   { "pstatus",    Command::PStatus,  HasArg::No  },
   { "mstatus",    Command::MStatus,  HasArg::No  },
   { "sstatus",    Command::SStatus,  HasArg::No  },
+  { "status",     Command::Status,   HasArg::No  },
   { "abs_pos",    Command::ABSPos,   HasArg::Yes },
   { "rel_pos",    Command::RELPos,   HasArg::Yes },
   { "sync",       Command::Sync,     HasArg::Yes },
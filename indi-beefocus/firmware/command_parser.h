@@ -19,6 +19,7 @@ namespace CommandParser {
     PStatus,              ///<  Return Position to Caller
     MStatus,              ///<  Return the Mode (i.e., "moving", "homing")
     SStatus,              ///<  Is the focuser synced (i.e., homed)
+    Status,               ///<  Position, Sync and Mode in one reply
     ABSPos,               ///<  Move to an absolute position
     RELPos,               ///<  Move relative to the current position
     Sync,                 ///<  Argument is the new position
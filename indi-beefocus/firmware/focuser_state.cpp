@@ -1,4 +1,6 @@
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <vector>
 #include <string>
@@ -30,6 +32,7 @@ const CommandToBool FS::doesCommandInterrupt=
   { CommandParser::Command::PStatus,       false  },
   { CommandParser::Command::MStatus,       false  },
   { CommandParser::Command::SStatus,       false  },
+  { CommandParser::Command::Status,        false  },
   { CommandParser::Command::ABSPos,        true   },
   { CommandParser::Command::RELPos,        true   },
   { CommandParser::Command::Sync,          true   },
@@ -48,6 +51,7 @@ const std::unordered_map<CommandParser::Command,
   { CommandParser::Command::PStatus,    &Focuser::doPStatus },
   { CommandParser::Command::MStatus,    &Focuser::doMStatus },
   { CommandParser::Command::SStatus,    &Focuser::doSStatus },
+  { CommandParser::Command::Status,     &Focuser::doStatus },
   { CommandParser::Command::ABSPos,     &Focuser::doABSPos },
   { CommandParser::Command::RELPos,     &Focuser::doRELPos },
   { CommandParser::Command::Sync,       &Focuser::doSync},
@@ -79,7 +83,10 @@ BuildParams::BuildParamMap BuildParams::builds = {
         50,         // Take 50 steps before checking for interrupts
         5*60*1000,  // Go to sleep after 5 minutes of inactivity
         1000,       // Check for new input in sleep mode every second
-        1000        // Take 1 second to power up the focuser motor on awaken
+        1000,       // Take 1 second to power up the focuser motor on awaken
+        500,        // Start and end moves at 500 steps/s
+        2500,       // Cruise at 2500 steps/s
+        4000        // Take 0.5 seconds to get up to speed
       },
       true,         // Focuser can use a home switch to synch
       35000         // End of the line for my focuser
@@ -93,6 +100,9 @@ BuildParams::BuildParamMap BuildParams::builds = {
         1000,       // Go to sleep after 1 second of inactivity
         500,        // Check for new input in sleep mode every 500ms
         200,        // Allow 200ms to power on the motor
+        500,        // Start and end moves at 500 steps/s
+        2500,       // Cruise at 2500 steps/s
+        4000        // Take 0.5 seconds to get up to speed
       },
       true,         // Focuser can use a home switch to synch
       35000         // End of the line for my focuser
@@ -106,7 +116,10 @@ BuildParams::BuildParamMap BuildParams::builds = {
         50,         // Take 50 steps before checking for interrupts
         10*24*60*1000,  // Go to sleep after 10 days of inactivity
         1000,       // Check for new input in sleep mode every second
-        1000        // Take 1 second to power up the focuser motor on awaken
+        1000,       // Take 1 second to power up the focuser motor on awaken
+        500,        // Start and end moves at 500 steps/s
+        1500,       // Cruise at 1500 steps/s, traditional focusers carry more load
+        2000        // Take 0.5 seconds to get up to speed
       },
       false,        // Focuser cannot use a home switch to synch
       5000          // Mostly a place holder
@@ -120,6 +133,9 @@ BuildParams::BuildParamMap BuildParams::builds = {
         1000,       // Go to sleep after 1 second of inactivity
         500,        // Check for new input in sleep mode every 500ms
         200,        // Allow 200ms to power on the motor
+        500,        // Start and end moves at 500 steps/s
+        1500,       // Cruise at 1500 steps/s
+        2000        // Take 0.5 seconds to get up to speed
       },
       false,        // Focuser cannot use a home switch to synch
       5000          // Mostly a place holder
@@ -140,6 +156,14 @@ Focuser::Focuser(
   uSecRemainder = 0;
   timeLastInterruptingCommandOccured = 0;
   motorState = MotorState::OFF;
+  rampSteps = false;
+  moveTarget = 0;
+  stepRate = buildParams.timingParams.getStartStepRate();
+  uSecHalfStep = (unsigned int) ( 500000.0f / stepRate );
+  reportedMode = State::ACCEPT_COMMANDS;
+  reportedPosition = 0;
+  reportedSynched = false;
+  timeLastReport = 0;
 
   std::swap( net, netArg );
   std::swap( hardware, hardwareArg );
@@ -176,7 +200,8 @@ Focuser::Focuser(
 void Focuser::doAbort( CommandParser::CommandPacket cp )
 {
   (void) cp;
-  // Do nothing - command triggers a state interrupt.
+  // Command triggers a state interrupt.  The next move starts from rest.
+  stepRate = buildParams.timingParams.getStartStepRate();
 }
 
 void Focuser::doHome( CommandParser::CommandPacket cp )
@@ -227,13 +252,22 @@ void Focuser::doSStatus( CommandParser::CommandPacket cp )
   *net << "Synched: " << (isSynched ? "YES" : "NO" ) << "\n";
 }
 
+void Focuser::doStatus( CommandParser::CommandPacket cp )
+{
+  (void) cp;
+  DebugInterface& log = *debugLog;
+
+  log << "Processing status request\n";
+  reportStatus( true );
+}
+
 void Focuser::doFirmware( CommandParser::CommandPacket cp )
 {
   (void) cp;
   DebugInterface& log = *debugLog;
 
   log << "Processing firmware request\n";
-  *net << "Firmware: 1.0\n";
+  *net << "Firmware: 1.1\n";
 }
 
 void Focuser::doCaps( CommandParser::CommandPacket cp )
@@ -325,6 +359,8 @@ unsigned int Focuser::stateSetDir()
   if ( desiredDir != dir )
   {
     dir = desiredDir;
+    // Reversing has to start from rest
+    stepRate = buildParams.timingParams.getStartStepRate();
     if ( dir == Dir::FORWARD )
       hardware->DigitalWrite( HWI::Pin::DIR, HWI::PinState::DIR_FORWARD); 
     if ( dir == Dir::REVERSE )       
@@ -341,14 +377,14 @@ unsigned int Focuser::stateStepInactiveAndWait()
 {
   hardware->DigitalWrite( HWI::Pin::STEP, HWI::PinState::STEP_INACTIVE );
   stateStack.pop();
-  return 1000;
+  return uSecHalfStep;
 }
 
 unsigned int Focuser::stateStepActiveAndWait()
 {
   hardware->DigitalWrite( HWI::Pin::STEP, HWI::PinState::STEP_ACTIVE );
   stateStack.pop();
-  return 1000;
+  return uSecHalfStep;
 }
 
 unsigned int Focuser::stateDoingSteps()
@@ -361,6 +397,7 @@ unsigned int Focuser::stateDoingSteps()
   }
   stateStack.topArgSet( stateStack.topArg().getInt()-1 );
 
+  planStep();
   stateStack.push( State::STEPPER_INACTIVE_AND_WAIT );
   stateStack.push( State::STEPPER_ACTIVE_AND_WAIT );
 
@@ -378,6 +415,7 @@ unsigned int Focuser::stateMoving()
   if ( stateStack.topArg().getInt() == focuserPosition ) {
     // We're at the target,  exit
     stateStack.pop();
+    stepRate = buildParams.timingParams.getStartStepRate();
     return 0;    
   }
 
@@ -404,6 +442,8 @@ unsigned int Focuser::stateMoving()
   const int  doStepsMax   = buildParams.timingParams.getMaxStepsBetweenChecks(); 
   const int  clippedSteps = absSteps > doStepsMax ? doStepsMax : absSteps;
 
+  rampSteps  = true;
+  moveTarget = stateStack.topArg().getInt();
   stateStack.push( State::DO_STEPS, clippedSteps );
   stateStack.push( State::SET_DIR,  nextDir );
   return 0;        
@@ -449,6 +489,8 @@ unsigned int Focuser::stateStopAtHome()
     }
   }
 
+  // Home slowly, the end stop is found one step at a time
+  rampSteps = false;
   stateStack.push( State::DO_STEPS, 1 );
   stateStack.push( State::SET_DIR, Dir::REVERSE );
   return 0;        
@@ -503,9 +545,66 @@ unsigned int Focuser::loop()
   uSecRemainder += uSecToNextCall;
   time += uSecRemainder / 1000;
   uSecRemainder = uSecRemainder % 1000;
+  reportStatus( false );
   return uSecToNextCall;
 }
 
+void Focuser::planStep()
+{
+  const TimingParams& tp = buildParams.timingParams;
+  const float startRate = tp.getStartStepRate();
+
+  if ( !rampSteps )
+  {
+    stepRate = startRate;
+  }
+  else
+  {
+    //
+    // Trapezoidal profile.  Each step changes the rate by at most what
+    // the acceleration allows over one step (v^2 = v0^2 + 2as, s = 1),
+    // and we start slowing down once the remaining steps are what it
+    // takes to get back to the start rate.
+    //
+    const float accel       = tp.getStepAcceleration();
+    const float maxRate     = std::max( (float) tp.getMaxStepRate(), startRate );
+    const int   stepsLeft   = std::abs( moveTarget - focuserPosition ) - 1;
+    const float stepsToStop = ( stepRate * stepRate - startRate * startRate ) / ( 2 * accel );
+
+    if ( stepsLeft < stepsToStop )
+    {
+      stepRate = std::sqrt( std::max( stepRate * stepRate - 2 * accel, startRate * startRate ));
+    }
+    else if ( stepRate < maxRate )
+    {
+      stepRate = std::min( std::sqrt( stepRate * stepRate + 2 * accel ), maxRate );
+    }
+  }
+  uSecHalfStep = (unsigned int) ( 500000.0f / stepRate );
+}
+
+void Focuser::reportStatus( bool force )
+{
+  const State mode = stateStack.modeState();
+  const bool changed = mode != reportedMode || isSynched != reportedSynched;
+  const bool moved = focuserPosition != reportedPosition &&
+    time - timeLastReport >= (unsigned) buildParams.timingParams.getEpochBetweenCommandChecks();
+
+  if ( !force && !changed && !moved )
+  {
+    return;
+  }
+
+  // Mode goes last, the error state's name has spaces in it.
+  *net << "Status: " << focuserPosition << " " << (isSynched ? "YES" : "NO" ) <<
+                " " << stateNames.at( mode ) << "\n";
+
+  reportedMode = mode;
+  reportedPosition = focuserPosition;
+  reportedSynched = isSynched;
+  timeLastReport = time;
+}
+
 void Focuser::setMotor( WifiDebugOstream& log, MotorState m )
 {
   motorState = m;
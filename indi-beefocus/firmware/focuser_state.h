@@ -122,13 +122,19 @@ class TimingParams
     int maxStepsBetweenChecksRHS          = 50,
     unsigned msInactivityToSleepRHS       = 5*60*1000,  // 5 minutes
     int msEpochForSleepCommandChecksRHS   = 1*1000,     // 1 seconds
-    int msToPowerStepperRHS               = 1*1000      // 1 second
+    int msToPowerStepperRHS               = 1*1000,     // 1 second
+    int stepsPerSecStartRHS               = 500,        // 500 steps/s
+    int stepsPerSecMaxRHS                 = 500,        // No ramp
+    int stepsPerSecPerSecRHS              = 2000        // 2000 steps/s^2
   ) :
     msEpochBetweenCommandChecks{ msEpochBetweenCommandChecksRHS },
     maxStepsBetweenChecks{ maxStepsBetweenChecksRHS },
     msInactivityToSleep{ msInactivityToSleepRHS },
     msEpochForSleepCommandChecks{ msEpochForSleepCommandChecksRHS },
-    msToPowerStepper{ msToPowerStepperRHS}
+    msToPowerStepper{ msToPowerStepperRHS},
+    stepsPerSecStart{ stepsPerSecStartRHS },
+    stepsPerSecMax{ stepsPerSecMaxRHS },
+    stepsPerSecPerSec{ stepsPerSecPerSecRHS }
   {
   }
 
@@ -152,6 +158,21 @@ class TimingParams
   { 
     return msToPowerStepper;
   }
+  /// @brief Step rate a move starts and ends at.  Homing runs at this rate.
+  int getStartStepRate() const
+  {
+    return stepsPerSecStart;
+  }
+  /// @brief Step rate a long move ramps up to
+  int getMaxStepRate() const
+  {
+    return stepsPerSecMax;
+  }
+  /// @brief How fast the step rate may change, in steps/s^2
+  int getStepAcceleration() const
+  {
+    return stepsPerSecPerSec;
+  }
 
   private:
   int msEpochBetweenCommandChecks;
@@ -159,6 +180,9 @@ class TimingParams
   unsigned msInactivityToSleep;
   int msEpochForSleepCommandChecks;
   int msToPowerStepper;
+  int stepsPerSecStart;
+  int stepsPerSecMax;
+  int stepsPerSecPerSec;
 };
 
 enum class Build
@@ -261,6 +285,29 @@ class StateStack {
   {
     stack.push_back( { newState , newArg } );
   }  
+
+  /// @brief Get the state the focuser is in, from a client's point of view
+  ///
+  /// The states used to take individual steps are skipped, so a focuser
+  /// that's in the middle of a step while moving reports MOVING.
+  ///
+  State modeState( void )
+  {
+    for ( auto it = stack.rbegin(); it != stack.rend(); ++it )
+    {
+      switch ( it->state )
+      {
+        case State::DO_STEPS:
+        case State::STEPPER_INACTIVE_AND_WAIT:
+        case State::STEPPER_ACTIVE_AND_WAIT:
+        case State::SET_DIR:
+          break;
+        default:
+          return it->state;
+      }
+    }
+    return State::ERROR_STATE;
+  }
   
   private:
 
@@ -347,6 +394,7 @@ class Focuser
   void doABSPos( CommandParser::CommandPacket );
   void doRELPos( CommandParser::CommandPacket );
   void doSync( CommandParser::CommandPacket );
+  void doStatus( CommandParser::CommandPacket );
   void doFirmware( CommandParser::CommandPacket );
   void doCaps( CommandParser::CommandPacket );
   void doError( CommandParser::CommandPacket );
@@ -374,6 +422,15 @@ class Focuser
 
   void setMotor( WifiDebugOstream& log, MotorState );
 
+  /// @brief Pick the step rate for the next step and update uSecHalfStep
+  void planStep( void );
+
+  /// @brief Send a combined status report if something the client cares about changed
+  ///
+  /// @param[in] force - Send the report even if nothing changed
+  ///
+  void reportStatus( bool force );
+
   /// @brief What is the focuser's position of record
   int focuserPosition;
 
@@ -388,6 +445,30 @@ class Focuser
 
   /// @brief Time the last command that could have caused an interrupt happened
   unsigned int timeLastInterruptingCommandOccured;
+
+  /// @brief Current step rate in steps/second
+  float stepRate;
+
+  /// @brief Time spent in each of the step's active and inactive states (in microseconds)
+  unsigned int uSecHalfStep;
+
+  /// @brief Should DO_STEPS ramp the step rate towards moveTarget?
+  bool rampSteps;
+
+  /// @brief Where the current move ends, used to plan the deceleration
+  int moveTarget;
+
+  /// @brief Mode last sent in a status report
+  State reportedMode;
+
+  /// @brief Position last sent in a status report
+  int reportedPosition;
+
+  /// @brief Sync state last sent in a status report
+  bool reportedSynched;
+
+  /// @brief Time the last status report was sent
+  unsigned int timeLastReport;
 };
 
 /// @brief Increment operator for State enum
@@ -177,11 +177,11 @@ TEST( DEVICE, SetABSPos )
     AdvanceTimeForward( driver, 2000 );
     ITH::SetNumber( driver, "ABS_FOCUS_POSITION",
       ITH::NumberData{{{"FOCUS_ABSOLUTE_POSITION", 1000.0 }}} );
-    AdvanceTimeForward( driver, 2000 );
+    AdvanceTimeForward( driver, 500 );
     ITH::XMLCapture xml( outCap.getOutput() );
 
     // should be not synced (home interrupted) and at 
-    // position 0 (still re-winding from the home attempt)
+    // position 0 (still coming back from the home attempt)
     ASSERT_EQ( xml.lastState( "HOME_STATUS"), "Not Synced" );
     ASSERT_EQ( xml.lastState( "ABS_FOCUS_POSITION"), "Busy" );
     ASSERT_EQ( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "0" );
@@ -215,6 +215,65 @@ TEST( DEVICE, SetABSPos )
   }
 }
 
+///
+/// @brief Verify long moves ramp up to speed and land on the target
+///
+/// 1. Sync to 0 (also interrupts homing)
+/// 2. Start a move across the whole range and verify we report progress
+/// 3. Verify the move finishes well before it would at the start rate
+/// 4. Move back in with a backtrack and verify the final position
+///
+TEST( DEVICE, LongMoveRampsUp )
+{
+  BeeFocused::Driver driver;
+  EstablishConnection( driver );
+
+  // 1. Sync to 0 (also interrupts homing)
+  {
+    ITH::StdoutCapture outCap;
+    AdvanceTimeForward( driver, 250 );
+    ITH::SetNumber( driver, "FOCUS_SYNC",
+      ITH::NumberData{{{"FOCUS_SYNC_VALUE", 0.0 }}} );
+    AdvanceTimeForward( driver, 1000 );
+    ITH::XMLCapture xml( outCap.getOutput() );
+    ASSERT_EQ( xml.lastState( "HOME_STATUS"), "Synced" );
+    ASSERT_EQ( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "0" );
+  }
+
+  // 2. Start a move across the whole range and verify we report progress
+  {
+    ITH::StdoutCapture outCap;
+    ITH::SetNumber( driver, "ABS_FOCUS_POSITION",
+      ITH::NumberData{{{"FOCUS_ABSOLUTE_POSITION", 35000.0 }}} );
+    AdvanceTimeForward( driver, 2000 );
+    ITH::XMLCapture xml( outCap.getOutput() );
+    ASSERT_EQ( xml.lastState( "ABS_FOCUS_POSITION"), "Busy" );
+    ASSERT_NE( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "0" );
+    ASSERT_NE( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "35000" );
+  }
+
+  // 3. Verify the move finishes well before it would at the start rate
+  //    (35000 steps at 500 steps/s would take 70 seconds)
+  {
+    ITH::StdoutCapture outCap;
+    AdvanceTimeForward( driver, 14000 );
+    ITH::XMLCapture xml( outCap.getOutput() );
+    ASSERT_EQ( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "35000" );
+    ASSERT_EQ( xml.lastState( "ABS_FOCUS_POSITION"), "Ok" );
+  }
+
+  // 4. Move back in with a backtrack and verify the final position
+  {
+    ITH::StdoutCapture outCap;
+    ITH::SetNumber( driver, "ABS_FOCUS_POSITION",
+      ITH::NumberData{{{"FOCUS_ABSOLUTE_POSITION", 12345.0 }}} );
+    AdvanceTimeForward( driver, 12000 );
+    ITH::XMLCapture xml( outCap.getOutput() );
+    ASSERT_EQ( xml.lastState( "FOCUS_ABSOLUTE_POSITION"), "12345" );
+    ASSERT_EQ( xml.lastState( "ABS_FOCUS_POSITION"), "Ok" );
+  }
+}
+
 ///
 /// @brief Verify that abort works
 ///
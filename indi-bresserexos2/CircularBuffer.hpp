@@ -26,6 +26,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include "config.h"
@@ -78,6 +79,24 @@ class CircularBuffer
             return false;
         }
 
+        //appends as many values as fit into the buffer, returns the number of values added.
+        size_t PushBack(const T* values, size_t count)
+        {
+            size_t added = 0;
+
+            while(added < count && !IsFull())
+            {
+                size_t chunk = std::min(count - added, std::min(max_size - mSize, max_size - mEnd));
+
+                std::memcpy(&mBuffer[mEnd], &values[added], chunk * sizeof(T));
+                mEnd = (mEnd + chunk) % max_size;
+                mSize += chunk;
+                added += chunk;
+            }
+
+            return added;
+        }
+
         bool PopFront()
         {
             if(!IsEmpty())
@@ -210,7 +229,7 @@ class CircularBuffer
             {
                 value = max_size;
             }
-            value++;
+            value--;
         }
 };
 }
@@ -48,6 +48,13 @@ class ISerialInterface
         //Reads a byte from the serial device. Can safely cast to uint8_t unless -1 is returned, corresponding to "stream end reached".
         virtual int16_t ReadByte() = 0;
 
+        //Blocks until data is available to read or the timeout in milliseconds expired. Returns true if data is available.
+        virtual bool WaitForData(int timeoutMs) = 0;
+
+        //Reads the available data up to length bytes into the buffer without blocking. Returns the number of bytes read, or -1 on error.
+        //Called after WaitForData reported data, so -1 is also returned if nothing can be read.
+        virtual int Read(uint8_t* buffer, size_t length) = 0;
+
         //writes the buffer to the serial interface.
         //this function should handle all the quirks of various serial interfaces.
         virtual bool Write(uint8_t* buffer, size_t offset, size_t length) = 0;
@@ -1,4 +1,6 @@
 #include "IndiSerialWrapper.hpp"
+#include <algorithm>
+#include <cerrno>
 
 using namespace GoToDriver;
 
@@ -99,6 +101,74 @@ int16_t IndiSerialWrapper::ReadByte()
     return -1;
 }
 
+//Blocks until data is available to read or the timeout in milliseconds expired. Returns true if data is available.
+bool IndiSerialWrapper::WaitForData(int timeoutMs)
+{
+    if(IsOpen())
+    {
+        struct pollfd pfd;
+        pfd.fd = mTtyFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int result = poll(&pfd, 1, timeoutMs);
+
+        if(result < 0)
+        {
+            //interrupted by a signal, just try again.
+            if(errno != EINTR)
+            {
+                usleep(timeoutMs * 1000);
+            }
+            return false;
+        }
+
+        //an error or a hangup on the port, checked first since POLLIN may be set along with it.
+        //do not spin on it.
+        if((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+        {
+            usleep(timeoutMs * 1000);
+            return false;
+        }
+
+        return (pfd.revents & POLLIN) != 0;
+    }
+
+    usleep(timeoutMs * 1000);
+    return false;
+}
+
+//Reads the available data up to length bytes into the buffer without blocking. Returns the number of bytes read, or -1 on error.
+int IndiSerialWrapper::Read(uint8_t* buffer, size_t length)
+{
+    if(IsOpen() && buffer != nullptr && length > 0)
+    {
+        //poll() reported data, so nothing to read here means the device is gone.
+        size_t available = BytesToRead();
+
+        if(available == 0)
+        {
+            return -1;
+        }
+
+        ssize_t result = read(mTtyFd, buffer, std::min(available, length));
+
+        if(result < 0)
+        {
+            return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+        }
+
+        //end of file, the port was closed on the other side.
+        if(result == 0)
+        {
+            return -1;
+        }
+
+        return (int)result;
+    }
+    return -1;
+}
+
 //writes the buffer to the serial interface.
 //this function should handle all the quirks of various serial interfaces.
 bool IndiSerialWrapper::Write(uint8_t* buffer, size_t offset, size_t length)
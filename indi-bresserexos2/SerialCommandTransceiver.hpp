@@ -30,6 +30,7 @@
 #include <deque>
 #include <queue>
 #include <thread>
+#include <chrono>
 
 #include <algorithm>
 #include "config.h"
@@ -39,6 +40,18 @@
 #include "SerialCommand.hpp"
 #include "CircularBuffer.hpp"
 
+//size of the buffer holding received data until it is parsed.
+#define SERIAL_RECEIVER_BUFFER_SIZE (1024)
+
+//maximum number of bytes read from the serial interface at once.
+#define SERIAL_READ_CHUNK_SIZE (256)
+
+//longest time the reader waits for data before checking if it should stop.
+#define SERIAL_READER_WAIT_TIMEOUT_MS (250)
+
+//time the reader backs off after the serial interface failed to read.
+#define SERIAL_READER_ERROR_BACKOFF_MS (1000)
+
 namespace SerialDeviceControl
 {
 //These types have to inherit/implement:
@@ -117,7 +130,8 @@ class SerialCommandTransceiver
         CriticalData<bool> mThreadRunning;
 
         //A cicular buffer implementation to receive serial message from the mount.
-        CircularBuffer<uint8_t, 256> mSerialReceiverBuffer;
+        //large enough to hold several bursts of status messages until they are parsed.
+        CircularBuffer<uint8_t, SERIAL_RECEIVER_BUFFER_SIZE> mSerialReceiverBuffer;
 
         //Contains a message header for convinience.
         std::vector<uint8_t> mMessageHeader;
@@ -128,9 +142,60 @@ class SerialCommandTransceiver
         //buffer used when serial messages are parsed.
         std::vector<uint8_t> mParseBuffer;
 
+        //buffer the serial data is read into, before it is appended to the receiver buffer.
+        uint8_t mReadBuffer[SERIAL_READ_CHUNK_SIZE];
+
+        //number of bytes discarded because the receiver buffer overflowed.
+        size_t mOverflowCount {0};
+
+        //Decode a single complete message starting at the provided position and notify the callback.
+        void DispatchMessage(std::vector<uint8_t>::iterator startPosition)
+        {
+            FloatByteConverter ra_bytes;
+            FloatByteConverter dec_bytes;
+
+            ra_bytes.bytes[0] = *(startPosition + 5);
+            ra_bytes.bytes[1] = *(startPosition + 6);
+            ra_bytes.bytes[2] = *(startPosition + 7);
+            ra_bytes.bytes[3] = *(startPosition + 8);
+
+            dec_bytes.bytes[0] = *(startPosition + 9);
+            dec_bytes.bytes[1] = *(startPosition + 10);
+            dec_bytes.bytes[2] = *(startPosition + 11);
+            dec_bytes.bytes[3] = *(startPosition + 12);
+
+            uint8_t cid = *(startPosition + 4);
+            float ra = ra_bytes.decimal_number;
+            float dec = dec_bytes.decimal_number;
+
+            //std::cerr << "COMMAND RECEIVED:" << std::hex << (int)cid << std::endl;
+
+            //handle specific response.
+            switch(cid)
+            {
+                case SerialCommandID::TELESCOPE_SITE_LOCATION_REPORT_COMMAND_ID:
+                    //std::cout << "new location received!" << std::endl;
+                    mDataReceivedCallback.OnSiteLocationCoordinatesReceived(ra, dec);
+                    break;
+
+                /* The handbox unfortunately does not report "untracked" coordinates, -> reason for this big state machine.
+                 * case SerialCommandID::TELESCOPE_POSITION_REPORT_UNTRACKED_COMMAND_ID:
+                    std::cerr << "untracked pointing report:" << "RA:" << ra << " DEC:" << dec << std::endl;
+                    break;*/
+
+                case SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID:
+                    mDataReceivedCallback.OnPointingCoordinatesReceived(ra, dec);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
         //When messages are received, try parsing them.
         //It may happen that messages are received in fragments, this function tries to piece together these fragments to valid messages.
-        //skip any previous junk if message was found, drop anything until the end of the parsed message, to clean up the buffer.
+        //every complete message in the buffer is dispatched, any junk in front of a message and the parsed messages are dropped.
+        //A trailing fragment is kept until the rest of the message arrives.
         void TryParseMessagesFromBuffer()
         {
             mParseBuffer.clear();
@@ -139,61 +204,65 @@ class SerialCommandTransceiver
             {
                 mSerialReceiverBuffer.CopyToVector(mParseBuffer);
 
-                std::vector<uint8_t>::iterator startPosition = std::search(mParseBuffer.begin(), mParseBuffer.end(), mMessageHeader.begin(),
-                        mMessageHeader.end());
+                std::vector<uint8_t>::iterator parsePosition = mParseBuffer.begin();
 
-                std::vector<uint8_t>::iterator endPosition = startPosition + MESSAGE_FRAME_SIZE;
-
-                if(startPosition != mParseBuffer.end() && endPosition != mParseBuffer.end())
+                while(true)
                 {
-                    FloatByteConverter ra_bytes;
-                    FloatByteConverter dec_bytes;
+                    std::vector<uint8_t>::iterator startPosition = std::search(parsePosition, mParseBuffer.end(), mMessageHeader.begin(),
+                            mMessageHeader.end());
 
-                    ra_bytes.bytes[0] = *(startPosition + 5);
-                    ra_bytes.bytes[1] = *(startPosition + 6);
-                    ra_bytes.bytes[2] = *(startPosition + 7);
-                    ra_bytes.bytes[3] = *(startPosition + 8);
+                    if(startPosition == mParseBuffer.end())
+                    {
+                        //no header, keep what could be the beginning of the next one.
+                        size_t keep = std::min<size_t>(mParseBuffer.end() - parsePosition, mMessageHeader.size() - 1);
+                        parsePosition = mParseBuffer.end() - keep;
+                        break;
+                    }
 
-                    dec_bytes.bytes[0] = *(startPosition + 9);
-                    dec_bytes.bytes[1] = *(startPosition + 10);
-                    dec_bytes.bytes[2] = *(startPosition + 11);
-                    dec_bytes.bytes[3] = *(startPosition + 12);
+                    if(mParseBuffer.end() - startPosition < MESSAGE_FRAME_SIZE)
+                    {
+                        //incomplete message, wait for the rest.
+                        parsePosition = startPosition;
+                        break;
+                    }
 
-                    uint8_t cid = *(startPosition + 4);
-                    float ra = ra_bytes.decimal_number;
-                    float dec = dec_bytes.decimal_number;
+                    DispatchMessage(startPosition);
 
-                    //std::cerr << "COMMAND RECEIVED:" << std::hex << (int)cid << std::endl;
+                    parsePosition = startPosition + MESSAGE_FRAME_SIZE;
+                }
 
-                    //handle specific response.
-                    switch(cid)
-                    {
-                        case SerialCommandID::TELESCOPE_SITE_LOCATION_REPORT_COMMAND_ID:
-                            //std::cout << "new location received!" << std::endl;
-                            mDataReceivedCallback.OnSiteLocationCoordinatesReceived(ra, dec);
-                            break;
-                            
-                        /* The handbox unfortunately does not report "untracked" coordinates, -> reason for this big state machine.
-                         * case SerialCommandID::TELESCOPE_POSITION_REPORT_UNTRACKED_COMMAND_ID:
-                            std::cerr << "untracked pointing report:" << "RA:" << ra << " DEC:" << dec << std::endl;
-                            break;*/
-
-                        case SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID:
-                            mDataReceivedCallback.OnPointingCoordinatesReceived(ra, dec);
-                            break;
-
-                        default:
-                            break;
-                    }
+                size_t dropCount = parsePosition - mParseBuffer.begin();
+
+                mSerialReceiverBuffer.DiscardFront(dropCount);
+
+                //std::cout << "Receive size after :" << mSerialReceiverBuffer.Size() << " dropped " << dropCount << std::endl;
+            }
+        }
+
+        //Append the received data to the receiver buffer and parse it, keeping track of data lost to an overflow.
+        void ReceiveData(const uint8_t* data, size_t length)
+        {
+            size_t offset = 0;
+
+            while(offset < length)
+            {
+                offset += mSerialReceiverBuffer.PushBack(data + offset, length - offset);
+
+                TryParseMessagesFromBuffer();
 
-                    size_t dropCount = endPosition - mParseBuffer.begin();
+                //parsing leaves at most a fragment behind, so a full buffer only holds a message longer than the buffer can hold, drop it.
+                if(mSerialReceiverBuffer.IsFull())
+                {
+                    size_t dropCount = mSerialReceiverBuffer.Size() - (MESSAGE_FRAME_SIZE - 1);
 
                     mSerialReceiverBuffer.DiscardFront(dropCount);
+                    mOverflowCount += dropCount;
 
-                    //std::cout << "Receive size after :" << mSerialReceiverBuffer.Size() << " dropped " << dropCount << std::endl;
+                    std::cerr << "Serial receiver buffer overflow, " << dropCount << " bytes dropped, " << mOverflowCount << " in total." << std::endl;
                 }
             }
         }
+
         //Endless loop function of the thread used to receive the serial messages of the mount.
         void SerialReaderThreadFunction()
         {
@@ -205,29 +274,32 @@ class SerialCommandTransceiver
             if(running == false)
             {
                 mThreadRunning.Set(true);
+                bool readFailed = false;
 
                 do
                 {
-                    //controller sends status messages about every second so wait a bit
-                    std::this_thread::sleep_until(std::chrono::system_clock::now() + std::chrono::milliseconds(500));
-
-                    size_t bufferContent = mInterfaceImplementation.BytesToRead();
-                    int16_t data = -1;
-
-                    bool addSucceed = false;
-
-                    if(bufferContent > 0)
+                    //wake up as soon as data arrives, the timeout only limits how long stopping the thread takes.
+                    if(mInterfaceImplementation.WaitForData(SERIAL_READER_WAIT_TIMEOUT_MS))
                     {
-                        while((data = mInterfaceImplementation.ReadByte()) > -1)
+                        int bytesRead = mInterfaceImplementation.Read(mReadBuffer, sizeof(mReadBuffer));
+
+                        if(bytesRead > 0)
                         {
-                            addSucceed = mSerialReceiverBuffer.PushBack((uint8_t)data);
+                            ReceiveData(mReadBuffer, bytesRead);
+                            readFailed = false;
                         }
-
-                        if(addSucceed)
+                        else if(bytesRead < 0)
                         {
-                            TryParseMessagesFromBuffer();
+                            //data was reported but could not be read, back off instead of spinning on the port.
+                            if(readFailed == false)
+                            {
+                                std::cerr << "Serial read failed, retrying every " << SERIAL_READER_ERROR_BACKOFF_MS << " ms." << std::endl;
+                                readFailed = true;
+                            }
+                            std::this_thread::sleep_for(std::chrono::milliseconds(SERIAL_READER_ERROR_BACKOFF_MS));
                         }
                     }
+
                     running = mThreadRunning.Get();
                 }
                 while(running == true);
@@ -92,8 +92,12 @@ void indiduino::TimerHit()
     if (isConnected() == false)
         return;
 
-    sf->OnIdle();
+    // With the reader thread running the port is already drained in the background
+    if (!sf->isReaderRunning())
+        sf->OnIdle();
 
+    // The reader thread updates pin_info while it parses, hold the lock for all reads below
+    std::unique_lock<std::mutex> guard(sf->state_lock);
     for (const auto &it: *getProperties())
     {
         const char *name = it.getName();
@@ -257,6 +261,11 @@ void indiduino::TimerHit()
             }
         }
     }
+    guard.unlock();
+
+    if (AnalogStreamSP[INDI_ENABLED].getState() == ISS_ON)
+        sendAnalogSamples();
+
     // START: Switch of for debugging!
     time_t sec_since_reply = sf->secondsSinceVersionReply();
     time_t max_delay = static_cast<time_t>(5*getCurrentPollingPeriod() < 30000 ? 30 : 5*getCurrentPollingPeriod()/1000);
@@ -268,6 +277,12 @@ void indiduino::TimerHit()
         sf = NULL;
         Disconnect();
 
+        // a new Firmata does not capture analog samples until the stream is switched on again
+        AnalogStreamSP.reset();
+        AnalogStreamSP[INDI_DISABLED].setState(ISS_ON);
+        AnalogStreamSP.setState(IPS_IDLE);
+        AnalogStreamSP.apply();
+
         if (getActiveConnection() == tcpConnection)
         {
             // handle reset of the device
@@ -351,6 +366,17 @@ bool indiduino::initProperties()
     tcpConnection->registerHandshake([&]() { return Handshake(); });
     registerConnection(tcpConnection);
 
+    AnalogStreamSP[INDI_ENABLED].fill("INDI_ENABLED", "On", ISS_OFF);
+    AnalogStreamSP[INDI_DISABLED].fill("INDI_DISABLED", "Off", ISS_ON);
+    AnalogStreamSP.fill(getDeviceName(), "ANALOG_STREAM", "Analog Stream", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
+
+    AnalogStreamNP[STREAM_INTERVAL].fill("INTERVAL", "Sampling (ms)", "%.f", 1, 1000, 1, 10);
+    AnalogStreamNP[STREAM_BUFFER].fill("BUFFER", "Buffer (samples)", "%.f", 1024, 1048576, 1024, 65536);
+    AnalogStreamNP.fill(getDeviceName(), "ANALOG_STREAM_SETTINGS", "Stream Settings", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
+
+    AnalogSamplesBP[0].fill("SAMPLES", "Samples", ".csv");
+    AnalogSamplesBP.fill(getDeviceName(), "ANALOG_SAMPLES", "Analog Samples", OPTIONS_TAB, IP_RO, 60, IPS_IDLE);
+
     addDebugControl();
     addPollPeriodControl();
     return true;
@@ -413,6 +439,13 @@ bool indiduino::updateProperties()
         }
 
 
+        // From now on the port is drained continuously, independent of the polling period
+        sf->startReader();
+
+        defineProperty(AnalogStreamSP);
+        defineProperty(AnalogStreamNP);
+        defineProperty(AnalogSamplesBP);
+
         // Mapping the controller according to the properties previously read from the XML file
         // We only map controls for pin of type AO and SERVO
         for (int numiopin = 0; numiopin < MAX_IO_PIN; numiopin++)
@@ -447,6 +480,13 @@ bool indiduino::updateProperties()
     }
     else
     {
+        deleteProperty(AnalogStreamSP);
+        deleteProperty(AnalogStreamNP);
+        deleteProperty(AnalogSamplesBP);
+        AnalogStreamSP.reset();
+        AnalogStreamSP[INDI_DISABLED].setState(ISS_ON);
+        AnalogStreamSP.setState(IPS_IDLE);
+
         delete sf;
         sf = NULL;
         LOG_INFO("Arduino board disconnected.");
@@ -506,6 +546,16 @@ bool indiduino::ISNewNumber(const char *dev, const char *name, double values[],
         return false;
     }
 
+    if (AnalogStreamNP.isNameMatch(name))
+    {
+        AnalogStreamNP.update(values, names, n);
+        AnalogStreamNP.setState(IPS_OK);
+        AnalogStreamNP.apply();
+        if (AnalogStreamSP[INDI_ENABLED].getState() == ISS_ON)
+            setAnalogStream();
+        return true;
+    }
+
     bool change = false;
     for (int i = 0; i < n; i++)
     {
@@ -578,6 +628,13 @@ bool indiduino::ISNewSwitch(const char *dev, const char *name, ISState *states,
     if (!svp)
         return false;
 
+    if (AnalogStreamSP.isNameMatch(name))
+    {
+        AnalogStreamSP.update(states, names, n);
+        setAnalogStream();
+        return true;
+    }
+
     //for (int i = 0; i < svp->nsp; i++)
     for (auto &sqp: svp)
     {
@@ -596,6 +653,7 @@ bool indiduino::ISNewSwitch(const char *dev, const char *name, ISState *states,
                 if (sf->writeDigitalPin(pin, ARDUINO_HIGH) == 0)
                 {
                     //IDSetSwitch(svp, "%s.%s ON", svp->name, sqp->name); Seems not to work anymore!
+                    std::lock_guard<std::mutex> guard(sf->state_lock);
                     sf->pin_info[pin].value = 1; // Set Standard Firmata record, so time loop can set correct switch state!
                     svp.setState(IPS_OK);
                 }
@@ -606,6 +664,7 @@ bool indiduino::ISNewSwitch(const char *dev, const char *name, ISState *states,
                 if (sf->writeDigitalPin(pin, ARDUINO_LOW) ==0)
                 {
                     //IDSetSwitch(svp, "%s.%s OFF", svp->name, sqp->name); Seems not to work anymore!
+                    std::lock_guard<std::mutex> guard(sf->state_lock);
                     sf->pin_info[pin].value = 0; // Set Standard Firmata record, so time loop can set correct switch state!
                     svp.setState(IPS_OK);
                 }
@@ -921,6 +980,66 @@ bool indiduino::setPinModesFromSKEL()
     return true;
 }
 
+/**************************************************************************************
+** Start or stop recording analog samples at the configured sampling interval
+***************************************************************************************/
+void indiduino::setAnalogStream()
+{
+    bool enabled = AnalogStreamSP[INDI_ENABLED].getState() == ISS_ON;
+
+    sf->setAnalogCapture(enabled, static_cast<size_t>(AnalogStreamNP[STREAM_BUFFER].getValue()));
+    analogDropped = 0;
+
+    if (enabled)
+    {
+        sf->setSamplingInterval(static_cast<int16_t>(AnalogStreamNP[STREAM_INTERVAL].getValue()));
+        LOGF_INFO("Analog stream started, sampling every %.f ms.", AnalogStreamNP[STREAM_INTERVAL].getValue());
+    }
+    else
+    {
+        sf->setSamplingInterval(getCurrentPollingPeriod() / 2);
+        LOG_INFO("Analog stream stopped.");
+    }
+
+    AnalogStreamSP.setState(enabled ? IPS_BUSY : IPS_IDLE);
+    AnalogStreamSP.apply();
+}
+
+/**************************************************************************************
+** Send the samples recorded since the last poll as one CSV block: time (us), pin, raw value
+***************************************************************************************/
+void indiduino::sendAnalogSamples()
+{
+    std::vector<analog_sample_t> samples;
+    if (sf->readAnalogSamples(samples) == 0)
+        return;
+
+    uint64_t dropped = sf->droppedAnalogSamples();
+    if (dropped > analogDropped)
+    {
+        LOGF_WARN("%llu analog samples were dropped, increase the buffer or lower the polling period.",
+                  static_cast<unsigned long long>(dropped - analogDropped));
+        analogDropped = dropped;
+    }
+
+    char line[64];
+    analogBlock.clear();
+    analogBlock.reserve(samples.size() * 32);
+    for (const auto &sample : samples)
+    {
+        int len = snprintf(line, sizeof(line), "%llu,%u,%llu\n", static_cast<unsigned long long>(sample.timestamp),
+                           sample.pin, static_cast<unsigned long long>(sample.value));
+        analogBlock.append(line, len);
+    }
+
+    AnalogSamplesBP[0].setBlob(const_cast<char *>(analogBlock.data()));
+    AnalogSamplesBP[0].setBlobLen(analogBlock.size());
+    AnalogSamplesBP[0].setSize(analogBlock.size());
+    AnalogSamplesBP[0].setFormat(".csv");
+    AnalogSamplesBP.setState(IPS_OK);
+    AnalogSamplesBP.apply();
+}
+
 bool indiduino::readInduinoXml(XMLEle *ioep, int npin)
 {
     char *propertyTag;
@@ -26,6 +26,8 @@
 
 #include <defaultdevice.h>
 
+#include <string>
+
 namespace Connection
 {
 class Serial;
@@ -100,7 +102,21 @@ class indiduino : public INDI::DefaultDevice
 
     bool setPinModesFromSKEL();
     bool readInduinoXml(XMLEle *ioep, int npin);
+    void setAnalogStream();
+    void sendAnalogSamples();
     Firmata *sf;
+
+    // High rate analog capture, sent as blocks of timestamped samples
+    INDI::PropertySwitch AnalogStreamSP {2};
+    INDI::PropertyNumber AnalogStreamNP {2};
+    enum
+    {
+        STREAM_INTERVAL,
+        STREAM_BUFFER
+    };
+    INDI::PropertyBlob AnalogSamplesBP {1};
+    std::string analogBlock;
+    uint64_t analogDropped { 0 };
     INDI::Controller *controller;
 
     Connection::Serial *serialConnection { nullptr };
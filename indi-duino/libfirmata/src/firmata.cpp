@@ -15,12 +15,18 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctime>
+#include <chrono>
 
 void (*firmata_debug_cb)(const char *file, int line, const char *msg, ...) = NULL;
 
 #define LOG_DEBUG(msg) {if (firmata_debug_cb) firmata_debug_cb(__FILE__, __LINE__, msg);}
 #define LOGF_DEBUG(msg, ...) {if (firmata_debug_cb) firmata_debug_cb(__FILE__, __LINE__, msg, __VA_ARGS__);}
 
+static uint64_t nowMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 Firmata::Firmata()
 {
     init("/dev/ttyACM0", FIRMATA_DEFAULT_BAUD);
@@ -44,6 +50,7 @@ Firmata::Firmata(int fd)
 
 Firmata::~Firmata()
 {
+    stopReader();
     delete arduino;
 }
 
@@ -76,14 +83,19 @@ int Firmata::writeDigitalPin(unsigned char pin, unsigned char mode)
 {
     int rv = 0;
     int port;
+    int port_val;
 
-    port = updateDigitalPort(pin, mode);
-
-    if (port < 0) return port;
+    {
+        // PIN_STATE_RESPONSE updates the same port bits from the reader thread
+        std::lock_guard<std::mutex> guard(state_lock);
+        port = updateDigitalPort(pin, mode);
+        if (port < 0) return port;
+        port_val = digitalPortValue[port];
+    }
 
     rv |= arduino->sendUchar(FIRMATA_DIGITAL_MESSAGE + port);
-    rv |= sendValueAsTwo7bitBytes(digitalPortValue[port]); //ARDUINO_HIGH OR ARDUINO_LOW
-    LOGF_DEBUG("Sending DIGITAL_MESSAGE pin:%d, mode:%d, port:%d, port_val:%02X", pin, mode, port, digitalPortValue[port]);
+    rv |= sendValueAsTwo7bitBytes(port_val); //ARDUINO_HIGH OR ARDUINO_LOW
+    LOGF_DEBUG("Sending DIGITAL_MESSAGE pin:%d, mode:%d, port:%d, port_val:%02X", pin, mode, port, port_val);
     return (rv);
 }
 
@@ -279,6 +291,7 @@ int Firmata::init(const char *_serialPort, uint32_t baud)
 {
     arduino  = new Arduino();
     portOpen = 0;
+    memset(analog_pin, FIRMATA_NO_PIN, sizeof(analog_pin));
     if (arduino->openPort(_serialPort, baud) != 0)
     {
         LOGF_DEBUG("sf->openPort(%s) failed: exiting", _serialPort);
@@ -291,6 +304,7 @@ int Firmata::init(int fd)
 {
     arduino  = new Arduino();
     portOpen = 0;
+    memset(analog_pin, FIRMATA_NO_PIN, sizeof(analog_pin));
     if (arduino->openPort(fd) != 0)
     {
         LOGF_DEBUG("sf->openPort(%d) failed: exiting", fd);
@@ -301,20 +315,30 @@ int Firmata::init(int fd)
 
 int Firmata::handshake()
 {
-    firmata_name[0] = 0;
+    // Parse() fills firmata_name, from the reader thread if it is running
+    char name[sizeof(firmata_name)] = {0};
+    {
+        std::lock_guard<std::mutex> guard(state_lock);
+        firmata_name[0] = 0;
+    }
 
     for (int i = 0; i < 3000; i++) // 30s
     {
         if (i % 50 == 0) askFirmwareVersion(); // try again every 0.5s
         OnIdle(); // wait 10ms
-        if (strlen(firmata_name) > 0) break;
+
+        std::lock_guard<std::mutex> guard(state_lock);
+        if (strlen(firmata_name) > 0) {
+            strcpy(name, firmata_name);
+            break;
+        }
     }
 
-    if (strlen(firmata_name) == 0) return 1;
+    if (strlen(name) == 0) return 1;
 
     char *requested_name = getenv("INDIDUINO_CHECK_FIRMWARE");
-    if (requested_name && strcmp(firmata_name, requested_name) != 0) {
-        LOGF_DEBUG("reported firmware '%s' does not match requested '%s'", firmata_name, requested_name);
+    if (requested_name && strcmp(name, requested_name) != 0) {
+        LOGF_DEBUG("reported firmware '%s' does not match requested '%s'", name, requested_name);
         return 1;
     }
     portOpen = 1;
@@ -404,15 +428,7 @@ void Firmata::DoMessage(void)
     {
         int analog_ch  = (parse_buf[0] & 0x0F);
         int analog_val = parse_buf[1] | (parse_buf[2] << 7);
-        for (int pin = 0; pin < 128; pin++)
-        {
-            if (pin_info[pin].analog_channel == analog_ch)
-            {
-                pin_info[pin].value = analog_val;
-                LOGF_DEBUG("ANALOG_MESSAGE: pin %d is A%d = %d", pin, analog_ch, analog_val);
-                return;
-            }
-        }
+        setAnalogValue(analog_ch, analog_val);
         return;
     }
     if (cmd == FIRMATA_DIGITAL_MESSAGE && parse_count == 3)
@@ -491,9 +507,13 @@ void Firmata::DoMessage(void)
         else if (parse_buf[1] == FIRMATA_ANALOG_MAPPING_RESPONSE)
         {
             int pin = 0;
-            for (int i = 2; i < parse_count - 1; i++)
+            memset(analog_pin, FIRMATA_NO_PIN, sizeof(analog_pin));
+            for (int i = 2; i < parse_count - 1 && pin < 128; i++)
             {
                 pin_info[pin].analog_channel = parse_buf[i];
+                // 127 marks a pin without analog input, the first pin of a channel wins
+                if (parse_buf[i] < 127 && analog_pin[parse_buf[i]] == FIRMATA_NO_PIN)
+                    analog_pin[parse_buf[i]] = pin;
                 LOGF_DEBUG("ANALOG_MAPPING: pin %d is A%d", pin, pin_info[pin].analog_channel);
                 pin++;
             }
@@ -545,15 +565,7 @@ void Firmata::DoMessage(void)
             {
                 analog_val = (analog_val << 7) | (parse_buf[i] & 0x7F);
             }
-            for (int pin = 0; pin < 128; pin++)
-            {
-                if (pin_info[pin].analog_channel == analog_ch)
-                {
-                    pin_info[pin].value = analog_val;
-                    LOGF_DEBUG("EXTENDED_ANALOG: pin %d is A%d = %lu", pin, analog_ch, analog_val);
-                    break;
-                }
-            }
+            setAnalogValue(analog_ch, analog_val);
         }
         else if (parse_buf[1] == FIRMATA_I2C_REPLY)
         {
@@ -578,6 +590,13 @@ int Firmata::OnIdle()
     uint8_t buf[1024];
     int r = 1;
 
+    // The reader thread parses everything, just give it the time a read would have taken
+    if (reader_run)
+    {
+        usleep(10000);
+        return reader_error;
+    }
+
     //if (debug) LOGF_DEBUG("Idle event");
     if (r > 0)
     {
@@ -598,6 +617,7 @@ int Firmata::OnIdle()
             if (debug)
                 printf("\n");
 */
+            parse_time = nowMicroseconds();
             Parse(buf, r);
             return 0;
         }
@@ -613,5 +633,103 @@ time_t Firmata::secondsSinceVersionReply()
 {
     time_t now;
     time(&now);
+    std::lock_guard<std::mutex> guard(state_lock);
     return now - version_reply_time;
 }
+
+void Firmata::setAnalogValue(int analog_ch, uint64_t value)
+{
+    int pin = analog_pin[analog_ch & 0x7F];
+    if (pin == FIRMATA_NO_PIN)
+        return;
+
+    pin_info[pin].value = value;
+    LOGF_DEBUG("ANALOG: pin %d is A%d = %llu", pin, analog_ch, static_cast<unsigned long long>(value));
+
+    if (!sample_capture)
+        return;
+
+    // Overwrite the oldest sample when the reader of the ring falls behind
+    analog_sample_t &sample = sample_ring[(sample_head + sample_count) % sample_ring.size()];
+    sample.timestamp = parse_time;
+    sample.pin       = pin;
+    sample.value     = value;
+    if (sample_count < sample_ring.size())
+        sample_count++;
+    else
+    {
+        sample_head = (sample_head + 1) % sample_ring.size();
+        sample_dropped++;
+    }
+}
+
+void Firmata::setAnalogCapture(bool enable, size_t capacity)
+{
+    std::lock_guard<std::mutex> guard(state_lock);
+    sample_capture = enable && capacity > 0;
+    if (sample_capture && sample_ring.size() != capacity)
+        sample_ring.assign(capacity, analog_sample_t());
+    else if (!sample_capture)
+        sample_ring.clear();
+    sample_head = sample_count = 0;
+    sample_dropped = 0;
+}
+
+size_t Firmata::readAnalogSamples(std::vector<analog_sample_t> &samples)
+{
+    std::lock_guard<std::mutex> guard(state_lock);
+    size_t count = sample_count;
+    for (size_t i = 0; i < count; i++)
+        samples.push_back(sample_ring[(sample_head + i) % sample_ring.size()]);
+    sample_head  = sample_ring.empty() ? 0 : (sample_head + count) % sample_ring.size();
+    sample_count = 0;
+    return count;
+}
+
+uint64_t Firmata::droppedAnalogSamples()
+{
+    std::lock_guard<std::mutex> guard(state_lock);
+    return sample_dropped;
+}
+
+int Firmata::startReader()
+{
+    if (reader_run)
+        return 0;
+
+    reader_error = 0;
+    reader_run   = true;
+    reader       = std::thread(&Firmata::readerLoop, this);
+    LOG_DEBUG("Firmata reader thread started");
+    return 0;
+}
+
+void Firmata::stopReader()
+{
+    reader_run = false;
+    if (reader.joinable())
+        reader.join();
+}
+
+void Firmata::readerLoop()
+{
+    uint8_t buf[4096];
+
+    while (reader_run)
+    {
+        // readPort() waits at most 10ms, so stopReader() is noticed quickly
+        int r = arduino->readPort(buf, sizeof(buf));
+        if (r < 0)
+        {
+            LOGF_DEBUG("Firmata reader stopped, readPort() failed: %d", r);
+            reader_error = r;
+            break;
+        }
+        if (r > 0)
+        {
+            std::lock_guard<std::mutex> guard(state_lock);
+            parse_time = nowMicroseconds();
+            Parse(buf, r);
+        }
+    }
+}
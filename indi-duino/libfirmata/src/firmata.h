@@ -12,6 +12,9 @@
 */
 
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <stdint.h>
 #include <arduino.h>
 
@@ -74,6 +77,10 @@
 
 #define MAX_STRING_DATA_LEN 164
 
+#define FIRMATA_NO_PIN 0xFF // analog channel not mapped to any pin
+
+#define FIRMATA_DEFAULT_SAMPLE_BUFFER 65536 // analog samples kept for readAnalogSamples()
+
 using namespace std;
 
 extern void (*firmata_debug_cb)(const char *file, int line, const char *msg, ...);
@@ -86,6 +93,13 @@ typedef struct
     uint64_t value;
 } pin_t;
 
+typedef struct
+{
+    uint64_t timestamp; // microseconds since the epoch, when the message was received
+    uint8_t pin;
+    uint64_t value;
+} analog_sample_t;
+
 class Firmata
 {
   public:
@@ -120,13 +134,40 @@ class Firmata
     int OnIdle();
     bool portOpen;
 
+    // Background reader: once started, the port is drained continuously and OnIdle() only waits
+    int startReader();
+    void stopReader();
+    bool isReaderRunning() const { return reader_run; }
+    // Guards pin_info, string_buffer and firmata_name while the reader is running
+    std::mutex state_lock;
+
+    // Timestamped analog samples, recorded while enabled
+    void setAnalogCapture(bool enable, size_t capacity = FIRMATA_DEFAULT_SAMPLE_BUFFER);
+    size_t readAnalogSamples(std::vector<analog_sample_t> &samples);
+    uint64_t droppedAnalogSamples();
+
   private:
     int parse_count { 0 };
     int parse_command_len { 0 };
     uint8_t parse_buf[4096];
     void Parse(const uint8_t *buf, int len);
     void DoMessage(void);
+    void setAnalogValue(int analog_ch, uint64_t value);
+    void readerLoop();
     int have_analog_mapping { 0 };
+    uint8_t analog_pin[128]; // analog channel -> pin, FIRMATA_NO_PIN if unmapped
+
+    std::thread reader;
+    std::atomic<bool> reader_run { false };
+    std::atomic<int> reader_error { 0 };
+    uint64_t parse_time { 0 };
+
+    // Ring buffer of analog samples, guarded by state_lock
+    bool sample_capture { false };
+    std::vector<analog_sample_t> sample_ring;
+    size_t sample_head { 0 };
+    size_t sample_count { 0 };
+    uint64_t sample_dropped { 0 };
     int have_capabilities { 0 };
     time_t version_reply_time { 0 };
 
@@ -25,6 +25,13 @@
 #include <dc1394/dc1394.h>
 #include <indiapi.h>
 #include <iostream>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "ffmv_ccd.h"
 #include "config.h"
@@ -297,6 +304,12 @@ bool FFMVCCD::initProperties()
     IUFillSwitchVector(&GainSP, GainS, 2, getDeviceName(), "GAIN", "Gain", IMAGE_SETTINGS_TAB, IP_WO, ISR_NOFMANY, 0,
                        IPS_IDLE);
 
+    /* Sub stacking: average into 16 bits or keep the full 32-bit sum */
+    IUFillSwitch(&StackS[STACK_AVERAGE], "STACK_AVERAGE", "Average (16 bit)", ISS_ON);
+    IUFillSwitch(&StackS[STACK_SUM], "STACK_SUM", "Sum (32 bit)", ISS_OFF);
+    IUFillSwitchVector(&StackSP, StackS, 2, getDeviceName(), "STACK_MODE", "Subs", IMAGE_SETTINGS_TAB, IP_RW, ISR_1OFMANY, 0,
+                       IPS_IDLE);
+
     setDefaultPollingPeriod(250);
 
     return true;
@@ -319,15 +332,26 @@ bool FFMVCCD::updateProperties()
         // Start the timer
         SetTimer(getCurrentPollingPeriod());
         defineProperty(&GainSP);
+        defineProperty(&StackSP);
     }
     else
     {
         deleteProperty(GainSP.name);
+        deleteProperty(StackSP.name);
     }
 
     return true;
 }
 
+bool FFMVCCD::saveConfigItems(FILE *fp)
+{
+    INDI::CCD::saveConfigItems(fp);
+
+    IUSaveConfigSwitch(fp, &StackSP);
+
+    return true;
+}
+
 /**************************************************************************************
 ** Setting up CCD parameters
 ***************************************************************************************/
@@ -364,7 +388,12 @@ bool FFMVCCD::StartExposure(float duration)
     ExposureRequest = duration;
 
     // Since we have only have one CCD with one chip, we set the exposure duration of the primary CCD
-    PrimaryCCD.setBPP(16);
+    if (PrimaryCCD.getBPP() != (StackS[STACK_SUM].s == ISS_ON ? 32 : 16))
+    {
+        std::unique_lock<std::mutex> guard(ccdBufferLock);
+        PrimaryCCD.setBPP(StackS[STACK_SUM].s == ISS_ON ? 32 : 16);
+        PrimaryCCD.setFrameBufferSize(PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * PrimaryCCD.getBPP() / 8);
+    }
     PrimaryCCD.setExposureDuration(duration);
 
     gettimeofday(&ExpStart, nullptr);
@@ -372,11 +401,6 @@ bool FFMVCCD::StartExposure(float duration)
     InExposure = true;
     LOG_ERROR("Exposure has begun.");
 
-    // Let's get a pointer to the frame buffer
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
-
-    memset(image, 0, PrimaryCCD.getFrameBufferSize());
-
     if (duration != last_exposure_length)
     {
         /* Calculate the number of exposures needed */
@@ -558,6 +582,14 @@ bool FFMVCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
             setDigitalGain(GainS[1].s);
             return true;
         }
+
+        if (!strcmp(name, StackSP.name))
+        {
+            IUUpdateSwitch(&StackSP, states, names, n);
+            StackSP.s = IPS_OK;
+            IDSetSwitch(&StackSP, nullptr);
+            return true;
+        }
     }
 
     //  Nobody has claimed this, so, ignore it
@@ -603,6 +635,41 @@ void FFMVCCD::TimerHit()
     return;
 }
 
+/**
+ * Add one big endian 16-bit frame to the 32-bit running sum.
+ * The byte swap and widening add work on 8 pixels at a time where the CPU allows.
+ */
+void FFMVCCD::accumulateFrame(const uint16_t *frame, int count)
+{
+    uint32_t *sum = sumBuffer.data();
+    int i = 0;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(frame + i));
+        v         = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        __m128i lo = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(sum + i)), _mm_unpacklo_epi16(v, zero));
+        __m128i hi = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(sum + i + 4)), _mm_unpackhi_epi16(v, zero));
+        _mm_storeu_si128((__m128i *)(sum + i), lo);
+        _mm_storeu_si128((__m128i *)(sum + i + 4), hi);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t v = vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(vld1q_u16(frame + i))));
+        vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vget_low_u16(v)));
+        vst1q_u32(sum + i + 4, vaddw_u16(vld1q_u32(sum + i + 4), vget_high_u16(v)));
+    }
+#endif
+#endif
+
+    for (; i < count; i++)
+        sum[i] += ntohs(frame[i]);
+}
+
 /**
  * Download image from FireFly
  */
@@ -610,63 +677,63 @@ void FFMVCCD::grabImage()
 {
     dc1394error_t err;
     dc1394video_frame_t *frame;
-    uint32_t uheight, uwidth;
-    int sub;
-    uint16_t val;
+    int sub, subs_added = 0;
     struct timeval start, end;
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    // Let's get a pointer to the frame buffer
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
-
     // Get width and height
     int width  = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     int height = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
 
-    memset(image, 0, PrimaryCCD.getFrameBufferSize());
-
-    /*-----------------------------------------------------------------------
-    *  stop data transmission
-    *-----------------------------------------------------------------------*/
+    sumBuffer.assign(width * height, 0);
 
     gettimeofday(&start, nullptr);
     for (sub = 0; sub < sub_count; ++sub)
     {
         LOGF_DEBUG("Getting sub %d of %d", sub, sub_count);
         err = dc1394_capture_dequeue(dcam, DC1394_CAPTURE_POLICY_WAIT, &frame);
-        if (err != DC1394_SUCCESS)
+        if (err != DC1394_SUCCESS || !frame)
         {
             LOG_ERROR("Could not capture frame");
+            continue;
         }
-        dc1394_get_image_size_from_video_mode(dcam, DC1394_VIDEO_MODE_640x480_MONO16, &uwidth, &uheight);
 
         if (DC1394_TRUE == dc1394_capture_is_frame_corrupt(dcam, frame))
         {
             LOG_ERROR("Corrupt frame!");
-            continue;
         }
-        // Fill buffer with random pattern
-        for (int i = 0; i < height; i++)
+        else
         {
-            for (int j = 0; j < width; j++)
-            {
-                /* Detect unsigned overflow */
-                val = ((uint16_t *)image)[i * width + j] + ntohs(((uint16_t *)(frame->image))[i * width + j]);
-                if (val > ((uint16_t *)image)[i * width + j])
-                {
-                    ((uint16_t *)image)[i * width + j] = val;
-                }
-                else
-                {
-                    ((uint16_t *)image)[i * width + j] = 0xFFFF;
-                }
-            }
+            accumulateFrame(reinterpret_cast<const uint16_t *>(frame->image),
+                            std::min<int>(width * height, frame->image_bytes / sizeof(uint16_t)));
+            subs_added++;
         }
 
+        // Hand the DMA buffer straight back so the ring keeps capturing the next sub
         dc1394_capture_enqueue(dcam, frame);
     }
-    guard.unlock();
+
+    /*-----------------------------------------------------------------------
+    *  stop data transmission
+    *-----------------------------------------------------------------------*/
     err = dc1394_video_set_transmission(dcam, DC1394_OFF);
+
+    // Only the hand-off to the frame buffer needs the lock
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    uint8_t *image = PrimaryCCD.getFrameBuffer();
+
+    if (PrimaryCCD.getBPP() == 32)
+    {
+        memcpy(image, sumBuffer.data(), sumBuffer.size() * sizeof(uint32_t));
+    }
+    else
+    {
+        uint16_t *out = reinterpret_cast<uint16_t *>(image);
+        uint32_t div  = subs_added > 0 ? subs_added : 1;
+        for (size_t i = 0; i < sumBuffer.size(); i++)
+            out[i] = (sumBuffer[i] + div / 2) / div;
+    }
+    guard.unlock();
+
     gettimeofday(&end, nullptr);
     LOGF_DEBUG("Download took %d uS", (int)((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec)));
 
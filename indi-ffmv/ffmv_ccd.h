@@ -23,6 +23,8 @@
 #include <indiccd.h>
 #include <dc1394/dc1394.h>
 
+#include <vector>
+
 using namespace std;
 
 class FFMVCCD : public INDI::CCD
@@ -39,6 +41,7 @@ class FFMVCCD : public INDI::CCD
     const char *getDefaultName();
     bool initProperties();
     bool updateProperties();
+    bool saveConfigItems(FILE *fp);
 
     // CCD specific functions
     bool StartExposure(float duration);
@@ -50,6 +53,7 @@ class FFMVCCD : public INDI::CCD
     float CalcTimeLeft();
     void setupParams();
     void grabImage();
+    void accumulateFrame(const uint16_t *frame, int count);
     dc1394error_t writeMicronReg(unsigned int offset, unsigned int val);
     dc1394error_t readMicronReg(unsigned int offset, unsigned int *val);
 
@@ -70,6 +74,18 @@ class FFMVCCD : public INDI::CCD
     ISwitch GainS[2];
     ISwitchVectorProperty GainSP;
 
+    // How the subs of an exposure are combined into the image
+    ISwitch StackS[2];
+    ISwitchVectorProperty StackSP;
+    enum
+    {
+        STACK_AVERAGE,
+        STACK_SUM
+    };
+
+    // 32-bit running sum of the subs, reused between exposures
+    std::vector<uint32_t> sumBuffer;
+
     dc1394_t *dc1394;
     dc1394camera_t *dcam;
 
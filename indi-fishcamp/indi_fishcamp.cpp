@@ -397,7 +397,7 @@ int FishCampCCD::grabImage()
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     uint8_t *image = PrimaryCCD.getFrameBuffer();
     UInt16 *frameBuffer = (UInt16 *)image;
-    int numBytes = fcUsb_cmd_getRawFrame(cameraNum, PrimaryCCD.getSubW(), PrimaryCCD.getSubH(), frameBuffer);
+    int numBytes = fcUsb_cmd_getRawFrame(cameraNum, PrimaryCCD.getSubH(), PrimaryCCD.getSubW(), frameBuffer);
     guard.unlock();
     if(numBytes != 0)
     {
@@ -22,6 +22,7 @@
 */
 
 #include <memory>
+#include <algorithm>
 #include <time.h>
 #include <math.h>
 #include <unistd.h>
@@ -39,6 +40,7 @@
 #define MAX_X_BIN      16   /* Max Horizontal binning */
 #define MAX_Y_BIN      16   /* Max Vertical binning */
 #define TEMP_THRESHOLD .25  /* Differential temperature threshold (C)*/
+#define STATUS_POLL_MS 10   /* Status poll interval once the exposure is about to end (ms) */
 
 static std::unique_ptr<FLICCD> fliCCD(new FLICCD());
 
@@ -94,6 +96,16 @@ bool FLICCD::initProperties()
     IUFillSwitchVector(&BackgroundFlushSP, BackgroundFlushS, 2, getDeviceName(), "CCD_BACKGROUND_FLUSH", "BKG. Flush",
                        OPTIONS_TAB, IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
 
+    // Rows per bulk download. 0 downloads the whole frame at once.
+    IUFillNumber(&DownloadBatchN[0], "ROWS", "Rows", "%.f", 0., 4096., 16, 256);
+    IUFillNumberVector(&DownloadBatchNP, DownloadBatchN, 1, getDeviceName(), "CCD_DOWNLOAD_BATCH", "Download Batch",
+                       OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    // Download Progress
+    IUFillNumber(&DownloadProgressN[0], "PROGRESS", "Progress (%)", "%.f", 0., 100., 1, 0);
+    IUFillNumberVector(&DownloadProgressNP, DownloadProgressN, 1, getDeviceName(), "CCD_DOWNLOAD_PROGRESS", "Download",
+                       MAIN_CONTROL_TAB, IP_RO, 60, IPS_IDLE);
+
     SetCCDCapability(CCD_CAN_ABORT | CCD_CAN_BIN | CCD_CAN_SUBFRAME | CCD_HAS_COOLER | CCD_HAS_SHUTTER);
 
     PrimaryCCD.setMinMaxStep("CCD_EXPOSURE", "CCD_EXPOSURE_VALUE", 0.04, 3600, 1, false);
@@ -120,6 +132,8 @@ bool FLICCD::updateProperties()
         defineProperty(&CoolerNP);
         defineProperty(&FlushNP);
         defineProperty(&BackgroundFlushSP);
+        defineProperty(&DownloadBatchNP);
+        defineProperty(&DownloadProgressNP);
 
         setupParams();
 
@@ -134,6 +148,8 @@ bool FLICCD::updateProperties()
         deleteProperty(CoolerNP.name);
         deleteProperty(FlushNP.name);
         deleteProperty(BackgroundFlushSP.name);
+        deleteProperty(DownloadBatchNP.name);
+        deleteProperty(DownloadProgressNP.name);
 
         if (CameraModeS != nullptr)
             deleteProperty(CameraModeSP.name);
@@ -166,6 +182,14 @@ bool FLICCD::ISNewNumber(const char *dev, const char *name, double values[], cha
             IDSetNumber(&FlushNP, nullptr);
             return true;
         }
+
+        if (!strcmp(name, DownloadBatchNP.name))
+        {
+            IUUpdateNumber(&DownloadBatchNP, values, names, n);
+            DownloadBatchNP.s = IPS_OK;
+            IDSetNumber(&DownloadBatchNP, nullptr);
+            return true;
+        }
     }
 
     return INDI::CCD::ISNewNumber(dev, name, values, names, n);
@@ -274,6 +298,8 @@ bool FLICCD::Disconnect()
 {
     int err;
 
+    mWorker.quit();
+
     if (sim)
         return true;
 
@@ -492,6 +518,7 @@ bool FLICCD::setupParams()
 int FLICCD::SetTemperature(double temperature)
 {
     int err = 0;
+    std::lock_guard<std::mutex> lock(fliLock);
 
     if (!sim && (err = FLISetTemperature(fli_dev, temperature)))
     {
@@ -517,6 +544,7 @@ bool FLICCD::StartExposure(float duration)
 
     if (!sim)
     {
+        std::lock_guard<std::mutex> lock(fliLock);
         if ((err = FLISetExposureTime(fli_dev, (long)(duration * 1000))))
         {
             LOGF_ERROR("FLISetExposureTime() failed. %s.", strerror(-err));
@@ -536,6 +564,7 @@ bool FLICCD::StartExposure(float duration)
     LOGF_DEBUG("Taking a %g seconds frame...", ExposureRequest);
 
     InExposure = true;
+    mWorker.start(std::bind(&FLICCD::workerExposure, this, std::placeholders::_1, duration));
     return true;
 }
 
@@ -543,6 +572,9 @@ bool FLICCD::AbortExposure()
 {
     int err = 0;
 
+    mWorker.quit();
+
+    std::lock_guard<std::mutex> lock(fliLock);
     if (!sim && (err = FLICancelExposure(fli_dev)))
     {
         LOGF_ERROR("FLICancelExposure() failed. %s.", strerror(-err));
@@ -643,15 +675,92 @@ bool FLICCD::UpdateCCDBin(int binx, int biny)
     return UpdateCCDFrame(PrimaryCCD.getSubX(), PrimaryCCD.getSubY(), PrimaryCCD.getSubW(), PrimaryCCD.getSubH());
 }
 
+void FLICCD::workerExposure(const std::atomic_bool &isAboutToQuit, float duration)
+{
+    int err = 0;
+    long timeleft = 0;
+    long camera_status = 0;
+
+    while (!isAboutToQuit)
+    {
+        if (sim)
+        {
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            double elapsed = (now.tv_sec - ExpStart.tv_sec) + (now.tv_usec - ExpStart.tv_usec) / 1e6;
+            timeleft = std::max(0L, static_cast<long>((duration - elapsed) * 1000));
+            if (timeleft == 0)
+                break;
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(fliLock);
+
+            if ((err = FLIGetDeviceStatus(fli_dev, &camera_status)))
+            {
+                lock.unlock();
+                LOGF_ERROR("FLIGetDeviceStatus() failed. %s.", strerror(-err));
+                usleep(getCurrentPollingPeriod() * 1000);
+                continue;
+            }
+
+            if ((err = FLIGetExposureStatus(fli_dev, &timeleft)))
+            {
+                lock.unlock();
+                LOGF_ERROR("FLIGetExposureStatus() failed. %s.", strerror(-err));
+                usleep(getCurrentPollingPeriod() * 1000);
+                continue;
+            }
+
+            if (((camera_status == FLI_CAMERA_STATUS_UNKNOWN) && (timeleft == 0)) ||
+                    ((camera_status != FLI_CAMERA_STATUS_UNKNOWN) && ((camera_status & FLI_CAMERA_DATA_READY) != 0)))
+                break;
+        }
+
+        PrimaryCCD.setExposureLeft(timeleft / 1000.0);
+
+        /*
+         * Keep the countdown on whole seconds while the exposure is long, then
+         * poll quickly so the download starts as soon as the data is ready.
+         */
+        long delay = STATUS_POLL_MS;
+        if (timeleft > 1000)
+            delay = (timeleft % 1000) ? (timeleft % 1000) : 1000;
+        else if (timeleft > STATUS_POLL_MS)
+            delay = timeleft;
+
+        for (; delay > 0 && !isAboutToQuit; delay -= STATUS_POLL_MS)
+            usleep(std::min(delay, static_cast<long>(STATUS_POLL_MS)) * 1000);
+    }
+
+    if (isAboutToQuit)
+        return;
+
+    /* We're done exposing */
+    LOG_INFO("Exposure done, downloading image...");
+
+    PrimaryCCD.setExposureLeft(0);
+    InExposure = false;
+    /* grab and save image */
+    grabImage(isAboutToQuit);
+}
+
 // Downloads the image from the CCD.
-bool FLICCD::grabImage()
+bool FLICCD::grabImage(const std::atomic_bool &isAboutToQuit)
 {
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     int err        = 0;
     uint8_t *image = PrimaryCCD.getFrameBuffer();
     int row_size   = PrimaryCCD.getSubW() / PrimaryCCD.getBinX() * PrimaryCCD.getBPP() / 8;
-    int width      = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     int height     = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
+    int batch      = static_cast<int>(DownloadBatchN[0].value);
+
+    if (batch <= 0 || batch > height)
+        batch = height;
+
+    DownloadProgressN[0].value = 0;
+    DownloadProgressNP.s = IPS_BUSY;
+    IDSetNumber(&DownloadProgressNP, nullptr);
 
     if (sim)
     {
@@ -662,24 +771,47 @@ bool FLICCD::grabImage()
     else
     {
         bool success = true;
-        for (int i = 0; i < height; i++)
+        for (int i = 0; i < height && !isAboutToQuit; i += batch)
         {
-            if ((err = FLIGrabRow(fli_dev, image + (i * row_size), width)))
+            int rows = std::min(batch, height - i);
+            size_t grabbed = 0;
+
+            std::unique_lock<std::mutex> lock(fliLock);
+            err = FLIGrabFrame(fli_dev, image + (i * row_size), rows * row_size, &grabbed);
+            lock.unlock();
+
+            if (err)
             {
                 /* print this error once but read to the end to flush the array */
                 if (success)
                 {
-                    LOGF_ERROR("FLIGrabRow() failed at row %d. %s.", i, strerror(-err));
+                    LOGF_ERROR("FLIGrabFrame() failed at row %d. %s.", i + static_cast<int>(grabbed / row_size), strerror(-err));
                     success = false;
                 }
             }
+
+            if (batch < height)
+            {
+                DownloadProgressN[0].value = 100.0 * (i + rows) / height;
+                IDSetNumber(&DownloadProgressNP, nullptr);
+            }
         }
 
-        if (!success)
+        if (!success || isAboutToQuit)
+        {
+            DownloadProgressNP.s = IPS_ALERT;
+            IDSetNumber(&DownloadProgressNP, nullptr);
+            if (!success)
+                PrimaryCCD.setExposureFailed();
             return false;
+        }
     }
     guard.unlock();
 
+    DownloadProgressN[0].value = 100;
+    DownloadProgressNP.s = IPS_OK;
+    IDSetNumber(&DownloadProgressNP, nullptr);
+
     LOG_INFO("Download complete.");
 
     ExposureComplete(&PrimaryCCD);
@@ -691,58 +823,18 @@ void FLICCD::TimerHit()
 {
     int timerID     = -1;
     int err         = 0;
-    long timeleft   = 0;
     double ccdTemp  = 0;
     double ccdPower = 0;
-    long camera_status = 0;
 
     if (isConnected() == false)
         return; //  No need to reset timer if we are not connected anymore
 
-    if (InExposure)
+    // Skip this temperature poll if the worker is busy talking to the camera
+    std::unique_lock<std::mutex> lock(fliLock, std::try_to_lock);
+    if (!lock.owns_lock())
     {
-        if (sim)
-        {
-            PrimaryCCD.setExposureLeft(0);
-            InExposure = false;
-            grabImage();
-        }
-        else
-        {
-            if ((err = FLIGetDeviceStatus(fli_dev, &camera_status)))
-            {
-                LOGF_ERROR("FLIGetDeviceStatus() failed. %s.", strerror(-err));
-                SetTimer(getCurrentPollingPeriod());
-                return;
-            }
-            LOGF_DEBUG("FLIGetDeviceStatus() succeed -> %ld", camera_status);
-
-            if ((err = FLIGetExposureStatus(fli_dev, &timeleft)))
-            {
-                LOGF_ERROR("FLIGetExposureStatus() failed. %s.", strerror(-err));
-                SetTimer(getCurrentPollingPeriod());
-                return;
-            }
-            LOGF_DEBUG("FLIGetExposureStatus() succeed -> %ld", timeleft);
-
-            if (!sim && (((camera_status == FLI_CAMERA_STATUS_UNKNOWN) && (timeleft == 0)) ||
-                         ((camera_status != FLI_CAMERA_STATUS_UNKNOWN) && ((camera_status & FLI_CAMERA_DATA_READY) != 0))))
-            {
-
-                /* We're done exposing */
-                LOG_INFO("Exposure done, downloading image...");
-
-                PrimaryCCD.setExposureLeft(0);
-                InExposure = false;
-                /* grab and save image */
-                grabImage();
-            }
-            else
-            {
-                LOGF_DEBUG("Exposure in progress. Time left: %ld seconds", timeleft / 1000);
-                PrimaryCCD.setExposureLeft(timeleft / 1000.0);
-            }
-        }
+        SetTimer(getCurrentPollingPeriod());
+        return;
     }
 
     switch (TemperatureNP.getState())
@@ -917,6 +1009,7 @@ bool FLICCD::saveConfigItems(FILE *fp)
 
     IUSaveConfigNumber(fp, &FlushNP);
     IUSaveConfigSwitch(fp, &BackgroundFlushSP);
+    IUSaveConfigNumber(fp, &DownloadBatchNP);
 
     if (CameraModeS)
         IUSaveConfigSwitch(fp, &CameraModeSP);
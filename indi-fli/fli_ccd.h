@@ -25,7 +25,9 @@
 
 #include <libfli.h>
 #include <indiccd.h>
+#include <indisinglethreadpool.h>
 #include <iostream>
+#include <mutex>
 
 using namespace std;
 
@@ -67,8 +69,11 @@ class FLICCD : public INDI::CCD
         // Calculate Time until exposure is complete
         float calcTimeLeft();
 
-        // Fetch image row by row from the CCD
-        bool grabImage();
+        // Wait for the exposure to complete and download the frame
+        void workerExposure(const std::atomic_bool &isAboutToQuit, float duration);
+
+        // Fetch image in row bands from the CCD
+        bool grabImage(const std::atomic_bool &isAboutToQuit);
 
         // Get initial CCD values upon connection
         bool setupParams();
@@ -107,8 +112,19 @@ class FLICCD : public INDI::CCD
         ISwitch *CameraModeS = nullptr;
         ISwitchVectorProperty CameraModeSP;
 
+        INumber DownloadBatchN[1];
+        INumberVectorProperty DownloadBatchNP;
+
+        INumber DownloadProgressN[1];
+        INumberVectorProperty DownloadProgressNP;
+
         int timerID = 0;
 
+        // Exposure and download run here so the main loop stays responsive
+        INDI::SingleThreadPool mWorker;
+        // Serializes libfli access between the worker and the main loop
+        std::mutex fliLock;
+
         // Exposure timing
         struct timeval ExpStart;
         float ExposureRequest {0};
@@ -301,6 +301,16 @@ bool GPhotoCCD::initProperties()
     ForceBULBSP[INDI_DISABLED].fill("Off", "Off", isNikon ? ISS_ON : ISS_OFF);
     ForceBULBSP.fill(getDeviceName(), "CCD_FORCE_BLOB", "Force BULB", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
 
+    // Live View
+    LiveViewSP[LIVE_VIEW_FULL].fill("LIVE_VIEW_FULL", "Full", ISS_ON);
+    LiveViewSP[LIVE_VIEW_HALF].fill("LIVE_VIEW_HALF", "1/2", ISS_OFF);
+    LiveViewSP[LIVE_VIEW_QUARTER].fill("LIVE_VIEW_QUARTER", "1/4", ISS_OFF);
+    LiveViewSP[LIVE_VIEW_EIGHTH].fill("LIVE_VIEW_EIGHTH", "1/8", ISS_OFF);
+    LiveViewSP[LIVE_VIEW_JPEG].fill("LIVE_VIEW_JPEG", "JPEG", ISS_OFF);
+    LiveViewSP.fill(getDeviceName(), "CCD_LIVE_VIEW", "Live View", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
+    LiveViewSP.load();
+    m_LiveViewMode = LiveViewSP.findOnSwitchIndex();
+
     // Upload File
     UploadFileTP[0].fill("PATH", "Path", nullptr);
     UploadFileTP.fill(getDeviceName(), "CCD_UPLOAD_FILE", "Upload File", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
@@ -425,6 +435,7 @@ bool GPhotoCCD::updateProperties()
 
         defineProperty(ForceBULBSP);
         defineProperty(DownloadTimeoutNP);
+        defineProperty(LiveViewSP);
     }
     else
     {
@@ -451,6 +462,7 @@ bool GPhotoCCD::updateProperties()
 
         deleteProperty(ForceBULBSP);
         deleteProperty(DownloadTimeoutNP);
+        deleteProperty(LiveViewSP);
 
         HideExtendedOptions();
     }
@@ -592,6 +604,25 @@ bool GPhotoCCD::ISNewSwitch(const char * dev, const char * name, ISState * state
             return true;
         }
 
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+        // Live View
+        // Scale live view frames down while decoding, or stream the camera JPEG without decoding.
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+        if (LiveViewSP.isNameMatch(name))
+        {
+            if (!LiveViewSP.update(states, names, n))
+                return false;
+
+            std::unique_lock<std::mutex> guard(liveStreamMutex);
+            m_LiveViewMode = LiveViewSP.findOnSwitchIndex();
+            guard.unlock();
+
+            LiveViewSP.setState(IPS_OK);
+            LiveViewSP.apply();
+            saveConfig(LiveViewSP);
+            return true;
+        }
+
         if (ExposurePresetSP.isNameMatch(name))
         {
             if (!ExposurePresetSP.update(states, names, n))
@@ -1899,10 +1930,11 @@ bool GPhotoCCD::StartStreaming()
 {
     if (gphoto_start_preview(gphotodrv) == GP_OK)
     {
-        Streamer->setPixelFormat(INDI_RGB);
         std::unique_lock<std::mutex> guard(liveStreamMutex);
         m_RunLiveStream = true;
+        m_LiveFramePending = false;
         guard.unlock();
+        m_LiveDecodeThread = std::thread(&GPhotoCCD::decodeLiveView, this);
         m_LiveViewThread = std::thread(&GPhotoCCD::streamLiveView, this);
         return true;
     }
@@ -1919,16 +1951,18 @@ bool GPhotoCCD::StopStreaming()
     std::unique_lock<std::mutex> guard(liveStreamMutex);
     m_RunLiveStream = false;
     guard.unlock();
+    m_LiveFrameCV.notify_all();
     m_LiveViewThread.join();
+    m_LiveDecodeThread.join();
     return (gphoto_stop_preview(gphotodrv) == GP_OK);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//
+// Capture previews as fast as the camera delivers them and hand the latest one to decodeLiveView.
+// If decoding falls behind, older frames are dropped rather than queued.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void GPhotoCCD::streamLiveView()
 {
-    //char errMsg[MAXRBUF];
     const char * previewData = nullptr;
     unsigned long int previewSize = 0;
     CameraFile * previewFile = nullptr;
@@ -1956,82 +1990,104 @@ void GPhotoCCD::streamLiveView()
             continue;
         }
 
-        if (rc >= GP_OK)
+        rc = gp_file_get_data_and_size(previewFile, &previewData, &previewSize);
+        if (rc != GP_OK)
         {
-            rc = gp_file_get_data_and_size(previewFile, &previewData, &previewSize);
-            if (rc != GP_OK)
-            {
-                LOGF_ERROR("Error getting preview image data and size: %s", gp_result_as_string(rc));
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
-            }
+            LOGF_ERROR("Error getting preview image data and size: %s", gp_result_as_string(rc));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
         }
 
-        uint8_t * inBuffer = reinterpret_cast<uint8_t *>(const_cast<char *>(previewData));
+        // previewFile is reused by the next capture, so keep a copy for the decoder
+        guard.lock();
+        m_LiveFrame.assign(previewData, previewData + previewSize);
+        m_LiveFramePending = true;
+        guard.unlock();
+        m_LiveFrameCV.notify_one();
+    }
 
-        //        if (streamSubframeS[1].s == ISS_ON)
-        //        {
-        //            if (liveVideoWidth <= 0)
-        //            {
-        //                read_jpeg_size(inBuffer, previewSize, &liveVideoWidth, &liveVideoHeight);
-        //                Streamer->setSize(liveVideoWidth, liveVideoHeight);
-        //            }
+    gp_file_unref(previewFile);
+}
 
-        //            std::unique_lock<std::mutex> ccdguard(ccdBufferLock);
-        //            Streamer->newFrame(inBuffer, previewSize);
-        //            ccdguard.unlock();
-        //            continue;
-        //        }
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Decode the previews captured by streamLiveView and feed them to the streamer. The CCD frame buffer
+// is not touched, so live view never holds ccdBufferLock.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void GPhotoCCD::decodeLiveView()
+{
+    std::vector<uint8_t> jpeg, image;
+    int lastMode = -1;
 
-        uint8_t * ccdBuffer      = PrimaryCCD.getFrameBuffer();
-        size_t size             = 0;
-        int w = 0, h = 0, naxis = 0;
+    while (true)
+    {
+        std::unique_lock<std::mutex> guard(liveStreamMutex);
+        m_LiveFrameCV.wait(guard, [this]()
+        {
+            return m_LiveFramePending || m_RunLiveStream == false;
+        });
+        if (m_RunLiveStream == false)
+            break;
+        // Swap rather than copy, both buffers keep their capacity
+        jpeg.swap(m_LiveFrame);
+        m_LiveFramePending = false;
+        int mode = m_LiveViewMode;
+        guard.unlock();
 
-        // Read jpeg from memory
-        std::unique_lock<std::mutex> ccdguard(ccdBufferLock);
-        rc = read_jpeg_mem(inBuffer, previewSize, &ccdBuffer, &size, &naxis, &w, &h);
+        if (mode != lastMode)
+        {
+            lastMode = mode;
+            liveVideoWidth = liveVideoHeight = -1;
+            Streamer->setPixelFormat(mode == LIVE_VIEW_JPEG ? INDI_JPG : (PrimaryCCD.getNAxis() == 2 ? INDI_MONO : INDI_RGB));
+        }
 
-        if (rc != 0)
+        // Pass the camera MJPEG frame through without decoding it
+        if (mode == LIVE_VIEW_JPEG)
         {
-            LOG_ERROR("Error getting live video frame.");
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (liveVideoWidth <= 0)
+            {
+                if (m_LiveDecoder.readSize(jpeg.data(), jpeg.size(), &liveVideoWidth, &liveVideoHeight) != 0)
+                {
+                    LOG_DEBUG("Dropping corrupt live video frame.");
+                    liveVideoWidth = liveVideoHeight = -1;
+                    continue;
+                }
+                Streamer->setSize(liveVideoWidth, liveVideoHeight);
+            }
+
+            Streamer->newFrame(jpeg.data(), jpeg.size());
             continue;
         }
 
-        if (liveVideoWidth <= 0)
+        int w = 0, h = 0, naxis = 0;
+        if (m_LiveDecoder.decode(jpeg.data(), jpeg.size(), 1 << mode, image, &naxis, &w, &h) != 0)
         {
-            liveVideoWidth = w;
-            liveVideoHeight = h;
-            Streamer->setSize(liveVideoWidth, liveVideoHeight);
+            LOG_DEBUG("Dropping corrupt live video frame.");
+            continue;
         }
 
-        PrimaryCCD.setFrameBuffer(ccdBuffer);
-
-        // We are done with writing to CCD buffer
-        ccdguard.unlock();
-
-        if (naxis != PrimaryCCD.getNAxis())
+        // JPEG components: 1 for grayscale, 3 for RGB
+        int axes = naxis == 1 ? 2 : 3;
+        if (axes != PrimaryCCD.getNAxis())
         {
-            if (naxis == 1)
-                Streamer->setPixelFormat(INDI_MONO);
-
-            PrimaryCCD.setNAxis(naxis);
+            Streamer->setPixelFormat(axes == 2 ? INDI_MONO : INDI_RGB);
+            PrimaryCCD.setNAxis(axes);
         }
 
-        if (PrimaryCCD.getSubW() != w || PrimaryCCD.getSubH() != h)
+        if (liveVideoWidth != w || liveVideoHeight != h)
         {
+            liveVideoWidth = w;
+            liveVideoHeight = h;
             Streamer->setSize(w, h);
-            PrimaryCCD.setBin(1, 1);
-            PrimaryCCD.setFrame(0, 0, w, h);
+            // Only a full size stream describes the sensor frame
+            if (mode == LIVE_VIEW_FULL && (PrimaryCCD.getSubW() != w || PrimaryCCD.getSubH() != h))
+            {
+                PrimaryCCD.setBin(1, 1);
+                PrimaryCCD.setFrame(0, 0, w, h);
+            }
         }
 
-        if (PrimaryCCD.getFrameBufferSize() != static_cast<int>(size))
-            PrimaryCCD.setFrameBufferSize(size, false);
-
-        Streamer->newFrame(ccdBuffer, size);
+        Streamer->newFrame(image.data(), image.size());
     }
-
-    gp_file_unref(previewFile);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2074,6 +2130,9 @@ bool GPhotoCCD::saveConfigItems(FILE * fp)
     // Force BULB Mode
     ForceBULBSP.save(fp);
 
+    // Live View
+    LiveViewSP.save(fp);
+
     return true;
 }
 
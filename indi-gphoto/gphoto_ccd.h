@@ -23,6 +23,7 @@
 #pragma once
 
 #include "gphoto_driver.h"
+#include "gphoto_readimage.h"
 
 #include <indiccd.h>
 #include <indifocuserinterface.h>
@@ -30,6 +31,7 @@
 #include <map>
 #include <future>
 #include <string>
+#include <condition_variable>
 
 #define MAXEXPERR 10 /* max err in exp time we allow, secs */
 #define OPENDT    5  /* open retry delay, secs */
@@ -129,9 +131,15 @@ class GPhotoCCD : public INDI::CCD, public INDI::FocuserInterface
         bool StartStreaming() override;
         bool StopStreaming() override;
         void streamLiveView();
+        void decodeLiveView();
 
         std::mutex liveStreamMutex;
         bool m_RunLiveStream;
+        // Latest preview captured by streamLiveView, waiting for decodeLiveView. Guarded by liveStreamMutex.
+        std::vector<uint8_t> m_LiveFrame;
+        bool m_LiveFramePending {false};
+        int m_LiveViewMode {0};
+        std::condition_variable m_LiveFrameCV;
 
     private:
         void createSwitch(INDI::PropertySwitch &property, const char *baseName, char ** options, int max_opts, int setidx);
@@ -208,11 +216,23 @@ class GPhotoCCD : public INDI::CCD, public INDI::FocuserInterface
         // Upload file, used for testing purposes under simulation under native mode
         INDI::PropertyText UploadFileTP {1};
         INDI::PropertyBlob imageBP {INDI::Property()};
+        // Live view decoding: downscale factor, or forward the camera JPEG as is
+        INDI::PropertySwitch LiveViewSP {5};
+        enum
+        {
+            LIVE_VIEW_FULL,
+            LIVE_VIEW_HALF,
+            LIVE_VIEW_QUARTER,
+            LIVE_VIEW_EIGHTH,
+            LIVE_VIEW_JPEG
+        };
 
         Camera * camera = nullptr;
 
         // Threading
         std::thread m_LiveViewThread;
+        std::thread m_LiveDecodeThread;
+        JpegFrameDecoder m_LiveDecoder;
 
         std::map <uint8_t, uint8_t> m_CaptureFormatMap;
 
@@ -15,6 +15,7 @@
 
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <setjmp.h>
 
 
 char dcraw_cmd[] = "dcraw";
@@ -387,3 +388,104 @@ int read_jpeg_size(unsigned char *inBuffer, unsigned long inSize, int *w, int *h
 
     return 0;
 }
+
+namespace
+{
+struct JpegErrorManager
+{
+    struct jpeg_error_mgr pub;
+    jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo)
+{
+    char msg[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, msg);
+    DEBUGFDEVICE(device, INDI::Logger::DBG_DEBUG, "JPEG decoding failed: %s", msg);
+    longjmp(reinterpret_cast<JpegErrorManager *>(cinfo->err)->jump, 1);
+}
+}
+
+struct JpegFrameDecoder::Private
+{
+    struct jpeg_decompress_struct cinfo;
+    JpegErrorManager jerr;
+    std::vector<JSAMPROW> rows;
+};
+
+JpegFrameDecoder::JpegFrameDecoder() : d(new Private)
+{
+    d->cinfo.err = jpeg_std_error(&d->jerr.pub);
+    d->jerr.pub.error_exit = jpegErrorExit;
+    jpeg_create_decompress(&d->cinfo);
+}
+
+JpegFrameDecoder::~JpegFrameDecoder()
+{
+    jpeg_destroy_decompress(&d->cinfo);
+}
+
+int JpegFrameDecoder::decode(const uint8_t *inBuffer, unsigned long inSize, int scale, std::vector<uint8_t> &out,
+                             int *naxis, int *w, int *h)
+{
+    struct jpeg_decompress_struct &cinfo = d->cinfo;
+
+    if (setjmp(d->jerr.jump))
+    {
+        // Leaves the decompressor ready for the next frame
+        jpeg_abort_decompress(&cinfo);
+        return -1;
+    }
+
+    jpeg_mem_src(&cinfo, const_cast<unsigned char *>(inBuffer), inSize);
+    jpeg_read_header(&cinfo, (boolean)TRUE);
+
+    // Live view favours speed over the last bit of fidelity
+    cinfo.scale_num           = 1;
+    cinfo.scale_denom         = scale;
+    cinfo.dct_method          = JDCT_IFAST;
+    cinfo.do_fancy_upsampling = (boolean)FALSE;
+
+    jpeg_start_decompress(&cinfo);
+
+    const size_t stride = cinfo.output_width * cinfo.output_components;
+    out.resize(stride * cinfo.output_height);
+
+    // Decode straight into the output buffer
+    d->rows.resize(cinfo.output_height);
+    for (unsigned int row = 0; row < cinfo.output_height; row++)
+        d->rows[row] = out.data() + row * stride;
+
+    while (cinfo.output_scanline < cinfo.output_height)
+        jpeg_read_scanlines(&cinfo, d->rows.data() + cinfo.output_scanline, cinfo.output_height - cinfo.output_scanline);
+
+    *naxis = cinfo.output_components;
+    *w     = cinfo.output_width;
+    *h     = cinfo.output_height;
+
+    jpeg_finish_decompress(&cinfo);
+
+    return 0;
+}
+
+int JpegFrameDecoder::readSize(const uint8_t *inBuffer, unsigned long inSize, int *w, int *h)
+{
+    struct jpeg_decompress_struct &cinfo = d->cinfo;
+
+    if (setjmp(d->jerr.jump))
+    {
+        jpeg_abort_decompress(&cinfo);
+        return -1;
+    }
+
+    jpeg_mem_src(&cinfo, const_cast<unsigned char *>(inBuffer), inSize);
+    jpeg_read_header(&cinfo, (boolean)TRUE);
+
+    *w = cinfo.image_width;
+    *h = cinfo.image_height;
+
+    // Only the header was needed, leave the decompressor ready for the next frame
+    jpeg_abort_decompress(&cinfo);
+
+    return 0;
+}
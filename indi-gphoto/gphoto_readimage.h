@@ -4,6 +4,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <memory>
+#include <vector>
+
 int read_libraw(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel,
                 char *bayer_pattern);
 int read_jpeg(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h);
@@ -11,3 +14,33 @@ int read_jpeg_mem(unsigned char *inBuffer, unsigned long inSize, uint8_t **mempt
                   int *h);
 int read_jpeg_size(unsigned char *inBuffer, unsigned long inSize, int *w, int *h);
 void gphoto_read_set_debug(const char *name);
+
+/**
+ * @brief Decodes a stream of JPEG frames (e.g. live view) reusing one libjpeg decompressor.
+ *
+ * Unlike read_jpeg_mem, a corrupt frame is reported as an error instead of terminating the driver.
+ */
+class JpegFrameDecoder
+{
+    public:
+        JpegFrameDecoder();
+        ~JpegFrameDecoder();
+
+        /**
+         * @brief decode Decompress a JPEG frame into out.
+         * @param scale Downscale factor (1, 2, 4 or 8), applied in the DCT domain by libjpeg.
+         * @return 0 on success, -1 if the frame could not be decoded.
+         */
+        int decode(const uint8_t *inBuffer, unsigned long inSize, int scale, std::vector<uint8_t> &out, int *naxis, int *w,
+                   int *h);
+
+        /**
+         * @brief readSize Read only the frame size from the JPEG header.
+         * @return 0 on success, -1 if the header could not be read.
+         */
+        int readSize(const uint8_t *inBuffer, unsigned long inSize, int *w, int *h);
+
+    private:
+        struct Private;
+        std::unique_ptr<Private> d;
+};
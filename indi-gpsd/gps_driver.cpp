@@ -43,6 +43,13 @@ GPSD::GPSD()
     setVersion(GPSD_VERSION_MAJOR, GPSD_VERSION_MINOR);
 }
 
+GPSD::~GPSD()
+{
+    m_WatcherRunning = false;
+    if (m_Watcher.joinable())
+        m_Watcher.join();
+}
+
 const char *GPSD::getDefaultName()
 {
     return "GPSD";
@@ -59,11 +66,22 @@ bool GPSD::Connect()
         LOG_WARN("No GPSD running.");
         return false;
     }
+
+    {
+        std::lock_guard<std::mutex> lock(m_ReportLock);
+        m_Report = GPSReport();
+    }
+    m_WatcherRunning = true;
+    m_Watcher = std::thread(&GPSD::watchGPS, this);
     return true;
 }
 
 bool GPSD::Disconnect()
 {
+    m_WatcherRunning = false;
+    if (m_Watcher.joinable())
+        m_Watcher.join();
+
     delete gps;
     gps = nullptr;
     LOG_INFO("GPS disconnected successfully.");
@@ -100,7 +118,8 @@ bool GPSD::initProperties()
     INDI::GPS::initProperties();
 
     IUFillText(&GPSstatusT[0], "GPS_FIX", "Fix Mode", nullptr);
-    IUFillTextVector(&GPSstatusTP, GPSstatusT, 1, getDeviceName(), "GPS_STATUS", "GPS Status", MAIN_CONTROL_TAB, IP_RO,
+    IUFillText(&GPSstatusT[1], "GPS_SATELLITES", "Satellites (used/seen)", nullptr);
+    IUFillTextVector(&GPSstatusTP, GPSstatusT, 2, getDeviceName(), "GPS_STATUS", "GPS Status", MAIN_CONTROL_TAB, IP_RO,
                      60, IPS_IDLE);
 
     IUFillNumber(&PolarisN[0], "HA", "Polaris Hour Angle", "%010.6m", 0, 24, 0, 0.0);
@@ -184,8 +203,7 @@ IPState GPSD::updateGPS()
         RefreshSP.apply();
     }
 
-    struct gps_data_t *gpsData;
-    time_t raw_time;
+    time_t raw_time = time(nullptr);
 
     if (isSimulation() || IUFindOnSwitchIndex(&TimeSourceSP) == TS_SYSTEM)
     {
@@ -225,7 +243,29 @@ IPState GPSD::updateGPS()
         return IPS_OK;
     }
 
-    if (!gps->waiting(1000))
+    // Take the latest reports from the watcher thread, we never wait for gpsd here
+    GPSReport report;
+    {
+        std::lock_guard<std::mutex> lock(m_ReportLock);
+        report = m_Report;
+        m_Report.readError = false;
+    }
+
+    if (report.readError)
+    {
+        LOG_ERROR("GPSD read error.");
+        IDSetText(&GPSstatusTP, nullptr);
+        return IPS_ALERT;
+    }
+
+    if (report.satellitesVisible >= 0)
+    {
+        char sats[16] = {0};
+        snprintf(sats, sizeof(sats), "%d/%d", report.satellitesUsed, report.satellitesVisible);
+        IUSaveText(&GPSstatusT[1], sats);
+    }
+
+    if (!report.received)
     {
         if (GPSstatusTP.s != IPS_BUSY)
         {
@@ -235,29 +275,22 @@ IPState GPSD::updateGPS()
         return IPS_BUSY;
     }
 
-    // Empty the buffer and keep only the last data block
-    while (1)
+    // Never publish a fix, or a time extrapolated from it, once reports stopped coming
+    auto reportAge = std::chrono::steady_clock::now() - report.receivedAt;
+    if (reportAge > MAX_REPORT_AGE)
     {
-        if ((gpsData = gps->read()) == nullptr)
+        IUSaveText(&GPSstatusT[0], "NO FIX");
+        if (GPSstatusTP.s != IPS_ALERT)
         {
-            LOG_ERROR("GPSD read error.");
-            IDSetText(&GPSstatusTP, nullptr);
-            return IPS_ALERT;
+            LOGF_WARN("No GPS report received for %lld seconds.",
+                      static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(reportAge).count()));
         }
-        // Exit the loop if there is no more data in the buffer
-        if (!gps->waiting(0))
-            break;
+        GPSstatusTP.s = IPS_ALERT;
+        IDSetText(&GPSstatusTP, nullptr);
+        return IPS_BUSY;
     }
 
-#if GPSD_API_MAJOR_VERSION >= 11
-    // From gpsd v3.22 STATUS_NO_FIX may also mean unknown fix state, can
-    // only tell from the mode value
-    if (gpsData->fix.mode < MODE_2D)
-#elif GPSD_API_MAJOR_VERSION >= 10
-    if (gpsData->fix.status == STATUS_NO_FIX || gpsData->fix.mode < MODE_2D)
-#else
-    if (gpsData->status == STATUS_NO_FIX || gpsData->fix.mode < MODE_2D )
-#endif
+    if (!report.fix)
     {
         // We have no fix and there is no point in further processing.
         IUSaveText(&GPSstatusT[0], "NO FIX");
@@ -275,13 +308,13 @@ IPState GPSD::updateGPS()
         LOG_INFO("GPS fix obtained.");
 
     // update gps fix status
-    if (gpsData->fix.mode == MODE_3D)
+    if (report.mode == MODE_3D)
     {
         IUSaveText(&GPSstatusT[0], "3D FIX");
         GPSstatusTP.s      = IPS_OK;
         IDSetText(&GPSstatusTP, nullptr);
     }
-    else if (gpsData->fix.mode == MODE_2D)
+    else if (report.mode == MODE_2D)
     {
         IUSaveText(&GPSstatusT[0], "2D FIX");
         GPSstatusTP.s      = IPS_OK;
@@ -299,15 +332,15 @@ IPState GPSD::updateGPS()
     // we should have a gps fix data now
     // fprintf(stderr,"Fix: %d time: %lf\n", data->fix.mode, data->fix.time);
 
-    LocationNP[LOCATION_LATITUDE].value  = gpsData->fix.latitude;
-    LocationNP[LOCATION_LONGITUDE].value = gpsData->fix.longitude;
+    LocationNP[LOCATION_LATITUDE].value  = report.latitude;
+    LocationNP[LOCATION_LONGITUDE].value = report.longitude;
     // 2017-11-15 Jasem: INDI Longitude is 0 to 360 East+
     if (LocationNP[LOCATION_LONGITUDE].value < 0)
         LocationNP[LOCATION_LONGITUDE].value += 360;
 
-    if (gpsData->fix.mode == MODE_3D)
+    if (report.mode == MODE_3D)
     {
-        LocationNP[LOCATION_ELEVATION].value = gpsData->fix.altitude;
+        LocationNP[LOCATION_ELEVATION].value = report.altitude;
     }
     else
     {
@@ -317,20 +350,29 @@ IPState GPSD::updateGPS()
     LocationNP.setState(IPS_OK);
 
     // Get Time from raw GPS source
-    if (IUFindOnSwitchIndex(&TimeSourceSP) == TS_GPS)
+    if (IUFindOnSwitchIndex(&TimeSourceSP) == TS_GPS && report.hasTime)
     {
         char ts[32] = {0};
-#if GPSD_API_MAJOR_VERSION < 9
-        raw_time = gpsData->fix.time;
-#else
-        raw_time = gpsData->fix.time.tv_sec;
+
+        // The fix time is when the receiver took the fix. Advance it by the time
+        // that passed since the report was received so it is current.
+        int64_t age = std::chrono::duration_cast<std::chrono::nanoseconds>(reportAge).count();
+        struct timespec now = report.time;
+        now.tv_sec  += age / 1000000000;
+        now.tv_nsec += age % 1000000000;
+        if (now.tv_nsec >= 1000000000)
+        {
+            now.tv_sec++;
+            now.tv_nsec -= 1000000000;
+        }
+
+        raw_time = now.tv_sec;
         m_GPSTime = raw_time;
-#endif
 
 #if GPSD_API_MAJOR_VERSION < 9
-        unix_to_iso8601(gpsData->fix.time, ts, 32);
+        unix_to_iso8601(now.tv_sec + now.tv_nsec / 1e9, ts, 32);
 #else
-        timespec_to_iso8601(gpsData->fix.time, ts, 32);
+        timespec_to_iso8601(now, ts, 32);
 #endif
         TimeTP[0].setText(ts);
 
@@ -349,7 +391,7 @@ IPState GPSD::updateGPS()
     lst = ln_get_apparent_sidereal_time(jd);
 
     // Local Hour Angle = Local Sidereal Time - Polaris Right Ascension
-    polarislsrt       = lst - 2.529722222 + (gpsData->fix.longitude / 15.0);
+    polarislsrt       = lst - 2.529722222 + (report.longitude / 15.0);
     PolarisN[0].value = polarislsrt;
 
     GPSstatusTP.s = IPS_OK;
@@ -362,6 +404,70 @@ IPState GPSD::updateGPS()
     return IPS_OK;
 }
 
+/**************************************************************************************
+** Runs in its own thread while connected. Reads every report gpsd sends and keeps
+** the latest TPV (fix) and SKY (satellites) data together with when it arrived.
+***************************************************************************************/
+void GPSD::watchGPS()
+{
+    while (m_WatcherRunning)
+    {
+        // Wake up regularly to notice Disconnect
+        if (!gps->waiting(250000))
+            continue;
+
+        struct gps_data_t *gpsData = gps->read();
+        auto receivedAt = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_ReportLock);
+
+        if (gpsData == nullptr)
+        {
+            m_Report.readError = true;
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        if (gpsData->set & SATELLITE_SET)
+        {
+            m_Report.satellitesVisible = gpsData->satellites_visible;
+            m_Report.satellitesUsed    = gpsData->satellites_used;
+        }
+
+        // Only TPV reports carry the fix mode
+        if (!(gpsData->set & MODE_SET))
+            continue;
+
+        m_Report.received   = true;
+        m_Report.receivedAt = receivedAt;
+        m_Report.mode       = gpsData->fix.mode;
+#if GPSD_API_MAJOR_VERSION >= 11
+        // From gpsd v3.22 STATUS_NO_FIX may also mean unknown fix state, can
+        // only tell from the mode value
+        m_Report.fix = gpsData->fix.mode >= MODE_2D;
+#elif GPSD_API_MAJOR_VERSION >= 10
+        m_Report.fix = gpsData->fix.status != STATUS_NO_FIX && gpsData->fix.mode >= MODE_2D;
+#else
+        m_Report.fix = gpsData->status != STATUS_NO_FIX && gpsData->fix.mode >= MODE_2D;
+#endif
+        m_Report.latitude  = gpsData->fix.latitude;
+        m_Report.longitude = gpsData->fix.longitude;
+        m_Report.altitude  = gpsData->fix.altitude;
+
+        m_Report.hasTime = (gpsData->set & TIME_SET) != 0;
+        if (m_Report.hasTime)
+        {
+#if GPSD_API_MAJOR_VERSION < 9
+            m_Report.time.tv_sec  = static_cast<time_t>(gpsData->fix.time);
+            m_Report.time.tv_nsec = static_cast<long>((gpsData->fix.time - m_Report.time.tv_sec) * 1e9);
+#else
+            m_Report.time = gpsData->fix.time;
+#endif
+        }
+    }
+}
+
 bool GPSD::ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n)
 {
     if (dev != nullptr && !strcmp(dev, getDeviceName()))
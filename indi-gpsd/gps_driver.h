@@ -27,12 +27,19 @@
 
 #include "indigps.h"
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
 class gpsmm;
 
 class GPSD : public INDI::GPS
 {
     public:
         GPSD();
+        virtual ~GPSD() override;
 
         virtual const char *getDefaultName() override;
         virtual void ISGetProperties(const char *dev) override;
@@ -50,10 +57,37 @@ class GPSD : public INDI::GPS
         virtual IPState updateGPS() override;
 
     private:
+        // Latest gpsd reports as collected by the watcher thread
+        struct GPSReport
+        {
+            bool received { false };    // at least one TPV report arrived
+            bool fix { false };
+            int mode { 0 };
+            double latitude { 0 };
+            double longitude { 0 };
+            double altitude { 0 };
+            bool hasTime { false };
+            struct timespec time { 0, 0 };
+            std::chrono::steady_clock::time_point receivedAt;
+            int satellitesVisible { -1 };
+            int satellitesUsed { -1 };
+            bool readError { false };
+        };
+
+        void watchGPS();
+
+        // Past this age the last report is stale, gpsd or the receiver stopped reporting
+        static constexpr std::chrono::seconds MAX_REPORT_AGE { 10 };
+
         gpsmm *gps = nullptr;
 
+        GPSReport m_Report;
+        std::mutex m_ReportLock;
+        std::thread m_Watcher;
+        std::atomic_bool m_WatcherRunning { false };
+
         ITextVectorProperty GPSstatusTP;
-        IText GPSstatusT[1] {};
+        IText GPSstatusT[2] {};
 
         INumberVectorProperty PolarisNP;
         INumber PolarisN[1];
@@ -6,10 +6,20 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/file.h>
+#include <algorithm>
 #include <memory>
+#include <thread>
+#include <vector>
 #include "inovaplx_ccd.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 int timerNS = -1;
 int timerWE = -1;
 unsigned char DIR          = 0xF;
@@ -131,6 +141,11 @@ bool INovaCCD::initProperties()
     IUFillNumberVector(&CameraPropertiesNP, CameraPropertiesN, 2, getDeviceName(), "CCD_PROPERTIES", "Control",
                        MAIN_CONTROL_TAB, IP_RW, 60, IPS_IDLE);
 
+    IUFillSwitch(&BinningModeS[BINNING_AVG], "BINNING_AVG", "AVG", ISS_OFF);
+    IUFillSwitch(&BinningModeS[BINNING_ADD], "BINNING_ADD", "Add", ISS_ON);
+    IUFillSwitchVector(&BinningModeSP, BinningModeS, 2, getDeviceName(), "CCD_BINNING_MODE", "Binning Mode",
+                       IMAGE_SETTINGS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
     // Set minimum exposure speed to 0.001 seconds
     PrimaryCCD.setMinMaxStep("CCD_EXPOSURE", "CCD_EXPOSURE_VALUE", 0.0001, 1000, 1, false);
 
@@ -152,6 +167,7 @@ void INovaCCD::ISGetProperties(const char *dev)
         // Define our properties
         defineProperty(&iNovaInformationTP);
         defineProperty(&CameraPropertiesNP);
+        defineProperty(&BinningModeSP);
     }
 }
 
@@ -174,6 +190,8 @@ bool INovaCCD::updateProperties()
         IUSaveText(&iNovaInformationT[4], (iNovaSDK_HasColorSensor() ? "Yes" : "No"));
         defineProperty(&iNovaInformationTP);
         defineProperty(&CameraPropertiesNP);
+        defineProperty(&BinningModeSP);
+        loadConfig(true, BinningModeSP.name);
 
         // Let's get parameters now from CCD
         setupParams();
@@ -186,6 +204,7 @@ bool INovaCCD::updateProperties()
     {
         deleteProperty(iNovaInformationTP.name);
         deleteProperty(CameraPropertiesNP.name);
+        deleteProperty(BinningModeSP.name);
     }
 
     return true;
@@ -275,6 +294,37 @@ bool INovaCCD::ISNewNumber(const char *dev, const char *name, double values[], c
     return INDI::CCD::ISNewNumber(dev, name, values, names, n);
 }
 
+/**************************************************************************************
+** Client is asking us to set a new switch
+***************************************************************************************/
+bool INovaCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n)
+{
+    if (dev != nullptr && !strcmp(dev, getDeviceName()))
+    {
+        if (!strcmp(name, BinningModeSP.name))
+        {
+            IUUpdateSwitch(&BinningModeSP, states, names, n);
+            BinningModeSP.s = IPS_OK;
+            IDSetSwitch(&BinningModeSP, nullptr);
+            saveConfig(true, BinningModeSP.name);
+            return true;
+        }
+    }
+
+    return INDI::CCD::ISNewSwitch(dev, name, states, names, n);
+}
+
+/**************************************************************************************
+** Save the driver settings
+***************************************************************************************/
+bool INovaCCD::saveConfigItems(FILE *fp)
+{
+    INDI::CCD::saveConfigItems(fp);
+
+    IUSaveConfigSwitch(fp, &BinningModeSP);
+    return true;
+}
+
 /**************************************************************************************
 ** INDI is asking us to add any FITS keywords to the FITS header
 ***************************************************************************************/
@@ -368,6 +418,218 @@ IPState INovaCCD::GuideSouth(uint32_t ms)
     return IPS_IDLE;
 }
 
+/**************************************************************************************
+** Software binning and subframing.
+** The camera always delivers the full sensor as big endian 16 bit (or 8 bit) pixels.
+** Each output row is built by adding binY sensor rows into 32 bit accumulators, then
+** binX neighbouring accumulators are added (or averaged) and saturated into the frame.
+** Frames that are large enough are split by row band across the available cores.
+***************************************************************************************/
+namespace
+{
+
+// Below this many output rows per core a frame is binned on the calling thread
+constexpr int MIN_BAND_ROWS = 64;
+
+struct BinJob
+{
+    const uint8_t *raw;     // full sensor frame
+    int rawStride;          // bytes per sensor row
+    int startX, startY;     // subframe origin in sensor pixels
+    int binX, binY;
+    int outW;               // output pixels per row
+    int Bpp;                // bytes per pixel, 1 or 2
+    bool average;
+    uint8_t *image;         // output frame buffer
+};
+
+// Copy big endian 16 bit pixels into native 16 bit pixels
+void swapRow16(const uint8_t *src, uint16_t *dst, int count)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+        vst1q_u16(dst + i, vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(src + 2 * i))));
+#endif
+    for (; i < count; i++)
+        dst[i] = (src[2 * i] << 8) | src[2 * i + 1];
+}
+
+// Add a row of big endian 16 bit pixels into the accumulators
+void accumulateRow16(const uint8_t *src, uint32_t *acc, int count)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        __m128i *a = reinterpret_cast<__m128i *>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(v, zero)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(src + 2 * i)));
+        vst1q_u32(acc + i, vaddw_u16(vld1q_u32(acc + i), vget_low_u16(v)));
+        vst1q_u32(acc + i + 4, vaddw_u16(vld1q_u32(acc + i + 4), vget_high_u16(v)));
+    }
+#endif
+    for (; i < count; i++)
+        acc[i] += (src[2 * i] << 8) | src[2 * i + 1];
+}
+
+// Add a row of 8 bit pixels into the accumulators
+void accumulateRow8(const uint8_t *src, uint32_t *acc, int count)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *a = reinterpret_cast<__m128i *>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+        vst1q_u32(acc + i, vaddw_u16(vld1q_u32(acc + i), vget_low_u16(v)));
+        vst1q_u32(acc + i + 4, vaddw_u16(vld1q_u32(acc + i + 4), vget_high_u16(v)));
+    }
+#endif
+    for (; i < count; i++)
+        acc[i] += src[i];
+}
+
+// Combine BIN neighbouring accumulators into each output pixel. BIN = 0 handles
+// any other binning at runtime.
+template <int BIN, typename T>
+void reduceRow(const uint32_t *acc, T *dst, int count, int binX, uint32_t divisor, uint32_t maxValue)
+{
+    const int bin = BIN > 0 ? BIN : binX;
+
+    for (int x = 0; x < count; x++, acc += bin)
+    {
+        uint32_t t = 0;
+        for (int i = 0; i < bin; i++)
+            t += acc[i];
+        if (divisor > 1)
+            t = (t + divisor / 2) / divisor;
+        dst[x] = static_cast<T>(std::min(t, maxValue));
+    }
+}
+
+template <typename T>
+void reduceRow(const uint32_t *acc, T *dst, int count, int binX, uint32_t divisor, uint32_t maxValue)
+{
+    switch (binX)
+    {
+        case 1:
+            reduceRow<1>(acc, dst, count, binX, divisor, maxValue);
+            break;
+        case 2:
+            reduceRow<2>(acc, dst, count, binX, divisor, maxValue);
+            break;
+        case 3:
+            reduceRow<3>(acc, dst, count, binX, divisor, maxValue);
+            break;
+        case 4:
+            reduceRow<4>(acc, dst, count, binX, divisor, maxValue);
+            break;
+        default:
+            reduceRow<0>(acc, dst, count, binX, divisor, maxValue);
+            break;
+    }
+}
+
+// Produce output rows [rowBegin, rowEnd) of the frame
+void binRows(const BinJob &job, int rowBegin, int rowEnd)
+{
+    const int outStride = job.outW * job.Bpp;
+
+    // Unbinned: a copy (or byte swap) of the subframe rows, in one go if they are contiguous
+    if (job.binX == 1 && job.binY == 1)
+    {
+        const uint8_t *src = job.raw + (job.startY + rowBegin) * job.rawStride + job.startX * job.Bpp;
+        uint8_t *dst = job.image + rowBegin * outStride;
+        int rows = rowEnd - rowBegin;
+        int count = job.outW;
+
+        if (outStride == job.rawStride)
+        {
+            count *= rows;
+            rows = 1;
+        }
+
+        for (int y = 0; y < rows; y++, src += job.rawStride, dst += outStride)
+        {
+            if (job.Bpp > 1)
+                swapRow16(src, reinterpret_cast<uint16_t *>(dst), count);
+            else
+                memcpy(dst, src, count);
+        }
+        return;
+    }
+
+    const int accCount = job.outW * job.binX;
+    const uint32_t divisor = job.average ? job.binX * job.binY : 1;
+    std::vector<uint32_t> acc(accCount);
+
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const uint8_t *src = job.raw + (job.startY + y * job.binY) * job.rawStride + job.startX * job.Bpp;
+        uint8_t *dst = job.image + y * outStride;
+
+        std::fill(acc.begin(), acc.end(), 0);
+        for (int yy = 0; yy < job.binY; yy++, src += job.rawStride)
+        {
+            if (job.Bpp > 1)
+                accumulateRow16(src, acc.data(), accCount);
+            else
+                accumulateRow8(src, acc.data(), accCount);
+        }
+
+        if (job.Bpp > 1)
+            reduceRow(acc.data(), reinterpret_cast<uint16_t *>(dst), job.outW, job.binX, divisor, 0xffff);
+        else
+            reduceRow(acc.data(), dst, job.outW, job.binX, divisor, 0xff);
+    }
+}
+
+void binFrame(const BinJob &job, int outH)
+{
+    int bands = std::min<int>(std::thread::hardware_concurrency(), outH / MIN_BAND_ROWS);
+    if (bands < 2)
+    {
+        binRows(job, 0, outH);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(binRows, std::cref(job), outH * b / bands, outH * (b + 1) / bands);
+    binRows(job, 0, outH / bands);
+    for (auto &worker : workers)
+        worker.join();
+}
+
+}
+
 void INovaCCD::grabImage()
 {
     std::unique_lock<std::mutex> guard(ccdBufferLock);
@@ -375,52 +637,30 @@ void INovaCCD::grabImage()
     unsigned char * image = PrimaryCCD.getFrameBuffer();
     if(image != nullptr)
     {
-        int Bpp = iNovaSDK_GetDataWide() > 0 ? 2 : 1;
-        int p = 0;
-
-        int binX = PrimaryCCD.getBinX();
-        int binY = PrimaryCCD.getBinY();
-        int startX = PrimaryCCD.getSubX();
-        int startY = PrimaryCCD.getSubY();
-        int endX = startX + PrimaryCCD.getSubW();
-        int endY = startY + PrimaryCCD.getSubH();
+        BinJob job;
+        job.raw = RawData;
+        job.Bpp = iNovaSDK_GetDataWide() > 0 ? 2 : 1;
+        job.binX = PrimaryCCD.getBinX();
+        job.binY = PrimaryCCD.getBinY();
+        job.startX = PrimaryCCD.getSubX();
+        job.startY = PrimaryCCD.getSubY();
+        job.average = BinningModeS[BINNING_AVG].s == ISS_ON;
+        job.image = image;
+
+        int endX = job.startX + PrimaryCCD.getSubW();
+        int endY = job.startY + PrimaryCCD.getSubH();
         int maxW = PrimaryCCD.getXRes();
         int maxH = PrimaryCCD.getYRes();
         endX = (endX > maxW ? maxW : endX);
         endY = (endY > maxH ? maxH : endY);
 
-        for(int y = startY; y < endY; y += binY)
-        {
-            if(endY - y < binY)
-                break;
-            for(int x = startX * Bpp; x < endX * Bpp; x += Bpp * binX)
-            {
-                if(endX * Bpp - x < binX * Bpp)
-                    break;
-                int t = 0;
-                for(int yy = y; yy < y + binY; yy++)
-                {
-                    for(int xx = x; xx < x + Bpp * binX; xx += Bpp)
-                    {
-                        if(Bpp > 1)
-                        {
-                            t += RawData[1 + xx + yy * maxW * Bpp] + (RawData[xx + yy * maxW * Bpp] << 8);
-                            t = (t < 0xffff ? t : 0xffff);
-                        }
-                        else
-                        {
-                            t += RawData[xx + yy * maxW * Bpp];
-                            t = (t < 0xff ? t : 0xff);
-                        }
-                    }
-                }
-                image[p++] = (unsigned char)(t & 0xff);
-                if(Bpp > 1)
-                {
-                    image[p++] = (unsigned char)((t >> 8) & 0xff);
-                }
-            }
-        }
+        job.rawStride = maxW * job.Bpp;
+        job.outW = std::max(0, (endX - job.startX) / job.binX);
+        int outH = std::max(0, (endY - job.startY) / job.binY);
+
+        if (job.outW > 0)
+            binFrame(job, outH);
+
         guard.unlock();
         // Let INDI::CCD know we're done filling the image buffer
         LOG_INFO("Download complete.");
@@ -22,6 +22,7 @@ public:
     INovaCCD();
 
     bool ISNewNumber (const char *dev, const char *name, double values[], char *names[], int n);
+    bool ISNewSwitch (const char *dev, const char *name, ISState *states, char *names[], int n);
     void ISGetProperties(const char *dev);
 
     void CaptureThread();
@@ -40,6 +41,7 @@ protected:
     bool AbortExposure();
     void TimerHit();
     void addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRecord> &fitsKeywords);
+    bool saveConfigItems(FILE *fp);
 
     // Guiding
     IPState GuideEast(uint32_t ms);
@@ -75,6 +77,15 @@ private:
         CCD_BLACKLEVEL_N,
     };
 
+    // Software binning adds or averages the binned pixels
+    ISwitch BinningModeS[2];
+    ISwitchVectorProperty BinningModeSP;
+    enum
+    {
+        BINNING_AVG,
+        BINNING_ADD,
+    };
+
 
 };
 
@@ -30,11 +30,15 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <algorithm>
 #include <memory>
-#include <regex>
-#include <termios.h>
+#include <sstream>
 
 #include <indicom.h>
+#include <indidevapi.h>
 #include <cmath>
 
 #include "config.h"
@@ -54,6 +58,11 @@ NexDome::NexDome()
                       DOME_CAN_SYNC);
 }
 
+NexDome::~NexDome()
+{
+    stopReader();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -163,6 +172,9 @@ bool NexDome::Handshake()
     std::string value;
     bool rotatorOK = false;
 
+    if (!startReader())
+        return false;
+
     if (getParameter(ND::SEMANTIC_VERSION, ND::ROTATOR, value))
     {
         LOGF_INFO("Detected rotator firmware version %s", value.c_str());
@@ -170,6 +182,7 @@ bool NexDome::Handshake()
         {
             LOGF_ERROR("Rotator version %s is not supported. Please upgrade to version %s or higher.", value.c_str(),
                        ND::MINIMUM_VERSION.c_str());
+            stopReader();
             return false;
         }
 
@@ -185,6 +198,7 @@ bool NexDome::Handshake()
         {
             LOGF_ERROR("Shutter version %s is not supported. Please upgrade to version %s or higher.", value.c_str(),
                        ND::MINIMUM_VERSION.c_str());
+            stopReader();
             return false;
         }
 
@@ -196,9 +210,22 @@ bool NexDome::Handshake()
     else
         LOG_WARN("No shutter detected.");
 
+    if (!rotatorOK)
+        stopReader();
+
     return rotatorOK;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+bool NexDome::Disconnect()
+{
+    // Stop reading before the connection plugin closes the port.
+    stopReader();
+    return INDI::Dome::Disconnect();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -591,11 +618,8 @@ bool NexDome::Sync(double az)
 ///////////////////////////////////////////////////////////////////////////////
 void NexDome::TimerHit()
 {
-    std::string response;
-
-    if (checkEvents(response))
-        processEvent(response);
-
+    // Unsolicited events are handed over by the reader thread as soon as they arrive.
+    // Reports are still requested while moving in case the firmware stays silent.
     if (getDomeState() == DOME_MOVING || getDomeState() == DOME_PARKING)
     {
         std::string value;
@@ -606,7 +630,7 @@ void NexDome::TimerHit()
     if (HasShutter() && getShutterState() == SHUTTER_MOVING)
     {
         std::string value;
-        if (getParameter(ND::POSITION, ND::SHUTTER, value))
+        if (getParameter(ND::REPORT, ND::SHUTTER, value))
             processEvent(value);
     }
 
@@ -862,23 +886,20 @@ bool NexDome::saveConfigItems(FILE * fp)
 //////////////////////////////////////////////////////////////////////////////
 bool NexDome::setParameter(ND::Commands command, ND::Targets target, int32_t value)
 {
-    std::string verb = ND::CommandsMap.at(command);
-    std::ostringstream cmd;
-    cmd << "@";
-    cmd << verb;
+    const std::string &verb = ND::CommandsMap.at(command);
     // Commands with two letters do not need Write (W)
-    if (verb.size() == 1)
-        cmd << "W";
-    cmd << ((target == ND::ROTATOR) ? "R" : "S");
+    char prefix[16] = {0};
+    snprintf(prefix, sizeof(prefix), "%s%s%c", verb.c_str(), verb.size() == 1 ? "W" : "",
+             (target == ND::ROTATOR) ? 'R' : 'S');
 
+    char cmd[ND::DRIVER_LEN] = {0};
     if (value != -1e6)
-    {
-        cmd << ",";
-        cmd << value;
-    }
+        snprintf(cmd, ND::DRIVER_LEN, "@%s,%d", prefix, value);
+    else
+        snprintf(cmd, ND::DRIVER_LEN, "@%s", prefix);
 
-    char res[ND::DRIVER_LEN] = {0};
-    return sendCommand(cmd.str().c_str(), res);
+    // The firmware acknowledges by echoing the command verb and target.
+    return sendCommand(cmd, prefix);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -916,100 +937,47 @@ bool NexDome::executeFactoryCommand(uint8_t command, ND::Targets target)
 //////////////////////////////////////////////////////////////////////////////
 bool NexDome::getParameter(ND::Commands command, ND::Targets target, std::string &value)
 {
-    char res[ND::DRIVER_LEN] = {0};
-    bool response_found = false;
-
-    std::string verb = ND::CommandsMap.at(command) + "R";
-
-    std::ostringstream cmd;
-    // Magic start character
-    cmd << "@";
-    // Command verb
-    cmd << verb;
-    // Target (Rotator or Shutter)
-    cmd << ((target == ND::ROTATOR) ? "R" : "S");
-
-    if (sendCommand(cmd.str().c_str(), res))
-    {
-        std::string response(res);
-
-        // Since we can get many unrelated responses from the firmware
-        // i.e. events, we need to parse all responses, and see which
-        // one is related to our get command.
-        std::vector<std::string> all = split(response, "\r\n");
-
-        // Let's find our match using this regex
-        std::regex re;
-
-        // Firmware is exception since the response does not include the target
-        // for everything else, the echo back includes the target.
-        if (command != ND::SEMANTIC_VERSION)
-            re = (verb + ((target == ND::ROTATOR) ? "R" : "S") + "([^#]+)");
-        else
-            re = (verb + "([^#]+)");
-
-        std::smatch match;
-
-        // Not iterate over all responses
-        for (auto &oneEvent : all)
-        {
-            std::string trimmedEvent = trim(oneEvent);
-
-            // If we find the match, tag it.
-            if (std::regex_search(trimmedEvent, match, re))
-            {
-                value = match.str(1);
-                response_found = true;
-            }
-            // Otherwise process the event
-            else
-                processEvent(trimmedEvent);
-        }
-    }
-
-    return response_found;
-}
+    const std::string &verb = ND::CommandsMap.at(command);
+    const char targetChar = (target == ND::ROTATOR) ? 'R' : 'S';
+
+    char cmd[ND::DRIVER_LEN] = {0};
+    snprintf(cmd, ND::DRIVER_LEN, "@%sR%c", verb.c_str(), targetChar);
+
+    // Replies echo the verb followed by the target, except for the firmware
+    // version which does not include the target, and reports which come back
+    // as SER/SES events and are returned whole so they can be processed as such.
+    char prefix[16] = {0};
+    size_t valueOffset = 0;
+    if (command == ND::SEMANTIC_VERSION)
+        valueOffset = snprintf(prefix, sizeof(prefix), "%sR", verb.c_str());
+    else if (command == ND::REPORT)
+        snprintf(prefix, sizeof(prefix), "SE%c", targetChar);
+    else
+        valueOffset = snprintf(prefix, sizeof(prefix), "%sR%c", verb.c_str(), targetChar);
 
-//////////////////////////////////////////////////////////////////////////////
-///
-//////////////////////////////////////////////////////////////////////////////
-bool NexDome::checkEvents(std::string &response)
-{
-    int nbytes_read = 0;
     char res[ND::DRIVER_LEN] = {0};
-
-    int rc = tty_nread_section(PortFD, res, ND::DRIVER_LEN, ND::DRIVER_EVENT_CHAR, ND::DRIVER_EVENT_TIMEOUT, &nbytes_read);
-
-    if (rc != TTY_OK || nbytes_read < 3)
+    if (!sendCommand(cmd, prefix, res))
         return false;
 
-    std::string raw_response = res;
-
-    // Trim
-    response = trim(raw_response);
-
-    return true;
+    value = res + valueOffset;
+    return !value.empty();
 }
 
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-bool NexDome::processEvent(const std::string &event)
+bool NexDome::processEvent(std::string_view event)
 {
     for (const auto &kv : ND::EventsMap)
     {
-        std::regex re(kv.second + "([^#]+)");
-        std::smatch match;
-        std::string value;
-
-        if (event == kv.second)
-            value = event;
-        else if (std::regex_search(event, match, re))
-            value = match.str(1);
-        else
+        const std::string &key = kv.second;
+        if (event.compare(0, key.size(), key) != 0)
             continue;
 
-        LOGF_DEBUG("Processing event <%s> with value <%s>", event.c_str(), value.c_str());
+        std::string_view value = (event.size() == key.size()) ? event : event.substr(key.size());
+
+        LOGF_DEBUG("Processing event <%.*s> with value <%.*s>", static_cast<int>(event.size()), event.data(),
+                   static_cast<int>(value.size()), value.data());
 
         switch (kv.first)
         {
@@ -1028,37 +996,30 @@ bool NexDome::processEvent(const std::string &event)
 
             case ND::ROTATOR_POSITION:
             {
-                try
-                {
-                    // 153 = full_steps_circumference / 360 = 55080 / 360
-                    double newAngle = range360(std::stoi(value) / StepsPerDegree);
-                    if (std::abs(DomeAbsPosNP[0].getValue() - newAngle) > 0.001)
-                    {
-                        DomeAbsPosNP[0].setValue(newAngle);
-                        DomeAbsPosNP.apply();
-                    }
-                }
-                catch (...)
-                {
+                int32_t position = 0;
+                if (!ND::parseNumber(value, position))
                     return false;
+
+                // 153 = full_steps_circumference / 360 = 55080 / 360
+                double newAngle = range360(position / StepsPerDegree);
+                if (std::abs(DomeAbsPosNP[0].getValue() - newAngle) > 0.001)
+                {
+                    DomeAbsPosNP[0].setValue(newAngle);
+                    DomeAbsPosNP.apply();
                 }
             }
             return true;
 
             case ND::SHUTTER_POSITION:
             {
-                try
-                {
-                    int32_t position = std::stoi(value);
-                    if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
-                    {
-                        ShutterSyncNP[0].setValue(position);
-                        ShutterSyncNP.apply();
-                    }
-                }
-                catch (...)
-                {
+                int32_t position = 0;
+                if (!ND::parseNumber(value, position))
                     return false;
+
+                if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
+                {
+                    ShutterSyncNP[0].setValue(position);
+                    ShutterSyncNP.apply();
                 }
             }
             return true;
@@ -1113,28 +1074,24 @@ bool NexDome::processEvent(const std::string &event)
 
             case ND::SHUTTER_BATTERY:
             {
-                try
-                {
-                    uint32_t battery_adu = std::stoul(value);
-                    double vref = battery_adu * ND::ADU_TO_VREF;
-                    if (std::fabs(vref - ShutterBatteryLevelNP[0].getValue()) > 0.01)
-                    {
-                        ShutterBatteryLevelNP[0].setValue(vref);
-                        // TODO: Must check if batter is OK, warning, or in critical level
-                        ShutterBatteryLevelNP.setState(IPS_OK);
-                        ShutterBatteryLevelNP.apply();
-                    }
-                }
-                catch(...)
-                {
+                int32_t battery_adu = 0;
+                if (!ND::parseNumber(value, battery_adu))
                     return false;
+
+                double vref = battery_adu * ND::ADU_TO_VREF;
+                if (std::fabs(vref - ShutterBatteryLevelNP[0].getValue()) > 0.01)
+                {
+                    ShutterBatteryLevelNP[0].setValue(vref);
+                    // TODO: Must check if batter is OK, warning, or in critical level
+                    ShutterBatteryLevelNP.setState(IPS_OK);
+                    ShutterBatteryLevelNP.apply();
                 }
             }
-            break;
+            return true;
 
             default:
-                LOGF_DEBUG("Unhandled event: %s", value.c_str());
-                break;
+                LOGF_DEBUG("Unhandled event: %.*s", static_cast<int>(value.size()), value.data());
+                return false;
         }
     }
 
@@ -1144,101 +1101,93 @@ bool NexDome::processEvent(const std::string &event)
 //////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////
-bool NexDome::processRotatorReport(const std::string &report)
+bool NexDome::processRotatorReport(std::string_view report)
 {
-    std::regex re(R"((\d+),(\d+),(\d+),(\d+),(\d+))");
-    std::smatch match;
-    if (std::regex_search(report, match, re))
+    int32_t fields[5] = {0};
+    if (!ND::parseNumbers(report, fields, 5))
+        return false;
+
+    uint32_t position = fields[0];
+    uint32_t at_home = fields[1];
+    uint32_t cirumference = fields[2];
+    uint32_t home_position = fields[3];
+    uint32_t dead_zone = fields[4];
+
+    double newStepsPerDegree = cirumference / 360.0;
+    if (std::abs(newStepsPerDegree - StepsPerDegree) > 0.01)
+        StepsPerDegree = newStepsPerDegree;
+
+    if (std::abs(position - RotatorSyncNP[0].getValue()) > 0)
     {
-        try
-        {
-            uint32_t position = std::stoul(match.str(1));
-            uint32_t at_home = std::stoul(match.str(2));
-            uint32_t cirumference = std::stoul(match.str(3));
-            uint32_t home_position = std::stoul(match.str(4));
-            uint32_t dead_zone = std::stoul(match.str(5));
+        RotatorSyncNP[0].setValue(position);
+        RotatorSyncNP.apply(nullptr);
+    }
 
-            double newStepsPerDegree = cirumference / 360.0;
-            if (std::abs(newStepsPerDegree - StepsPerDegree) > 0.01)
-                StepsPerDegree = newStepsPerDegree;
+    double posAngle = range360(position / StepsPerDegree);
+    if (std::fabs(posAngle - DomeAbsPosNP[0].getValue()) > 0.01)
+    {
+        DomeAbsPosNP[0].setValue(posAngle);
+        DomeAbsPosNP.apply();
+    }
 
-            if (std::abs(position - RotatorSyncNP[0].getValue()) > 0)
-            {
-                RotatorSyncNP[0].setValue(position);
-                RotatorSyncNP.apply(nullptr);
-            }
+    double homeAngle = range360(home_position / StepsPerDegree);
+    if (std::fabs(homeAngle - HomePositionNP[0].getValue()) > 0.01)
+    {
+        HomePositionNP[0].setValue(homeAngle);
+        HomePositionNP.apply(nullptr);
+    }
 
-            double posAngle = range360(position / StepsPerDegree);
-            if (std::fabs(posAngle - DomeAbsPosNP[0].getValue()) > 0.01)
-            {
-                DomeAbsPosNP[0].setValue(posAngle);
-                DomeAbsPosNP.apply();
-            }
+    double homeDiff = std::abs(homeAngle - posAngle);
+    if (GoHomeSP.getState() == IPS_BUSY &&
+        ((GoHomeSP[HOME_FIND].getState() == ISS_ON && at_home == 1) ||
+         (GoHomeSP[HOME_GOTO].getState() == ISS_ON && homeDiff <= 0.1)))
+    {
+        LOG_INFO("Rotator reached home position.");
+        GoHomeSP.reset();
+        GoHomeSP.setState(IPS_OK);
+        GoHomeSP.apply();
+    }
 
-            double homeAngle = range360(home_position / StepsPerDegree);
-            if (std::fabs(homeAngle - HomePositionNP[0].getValue()) > 0.01)
-            {
-                HomePositionNP[0].setValue(homeAngle);
-                HomePositionNP.apply(nullptr);
-            }
+    if (dead_zone != static_cast<uint32_t>(RotatorSettingsNP[S_ZONE].getValue()))
+    {
+        RotatorSettingsNP[S_ZONE].setValue(dead_zone);
+        RotatorSettingsNP.apply();
+    }
 
-            double homeDiff = std::abs(homeAngle - posAngle);
-            if (GoHomeSP.getState() == IPS_BUSY &&
-                ((GoHomeSP[HOME_FIND].getState() == ISS_ON && at_home == 1) ||
-                 (GoHomeSP[HOME_GOTO].getState() == ISS_ON && homeDiff <= 0.1)))
-            {
-                LOG_INFO("Rotator reached home position.");
-                GoHomeSP.reset();
-                GoHomeSP.setState(IPS_OK);
-                GoHomeSP.apply();
-            }
+    // update to fix issue with movement across 0 degrees
+    // for example, if the dead zone is 0.5 degrees, then NexDome won't move if going from 0.1 to 359.9 degrees.
+    // however driver expects response from rotator unless difference calculation is modified, and movement stalls
+    // e.g. the angles 0.1 and -0.1 should be compared instead
+    int a = position;
+    int b = m_TargetAZSteps;
 
-            if (dead_zone != static_cast<uint32_t>(RotatorSettingsNP[S_ZONE].getValue()))
+    if (getDomeState() == DOME_MOVING || getDomeState() == DOME_PARKING)
+    {
+        // if a > 0 and b < 360 and both within dead zone, make b negative equivalent angle
+        if(a >= 0 && a <= int(dead_zone) && b >= (int(cirumference) - int(dead_zone)))
+        {
+            b -= int(cirumference);
+        }  // if opposite case then make a the negative angle equivalent
+        else if(b >= 0 && b <=int(dead_zone) && a >= (int(cirumference) - int(dead_zone)))
+        {
+            a -= int(cirumference);
+        }
+
+        // If we reach target position.  (now calculation is correct)
+        if (std::abs(a - b) <= int(dead_zone) )
+        {                    
+            if (getDomeState() == DOME_MOVING)
             {
-                RotatorSettingsNP[S_ZONE].setValue(dead_zone);
-                RotatorSettingsNP.apply();
+                LOG_INFO("Dome reached target position.");
+                setDomeState(DOME_SYNCED);
             }
-
-            // update to fix issue with movement across 0 degrees
-            // for example, if the dead zone is 0.5 degrees, then NexDome won't move if going from 0.1 to 359.9 degrees.
-            // however driver expects response from rotator unless difference calculation is modified, and movement stalls
-            // e.g. the angles 0.1 and -0.1 should be compared instead
-            int a = position;
-            int b = m_TargetAZSteps;
-
-            if (getDomeState() == DOME_MOVING || getDomeState() == DOME_PARKING)
+            else if (getDomeState() == DOME_PARKING)
             {
-                // if a > 0 and b < 360 and both within dead zone, make b negative equivalent angle
-                if(a >= 0 && a <= int(dead_zone) && b >= (int(cirumference) - int(dead_zone)))
-                {
-                    b -= int(cirumference);
-                }  // if opposite case then make a the negative angle equivalent
-                else if(b >= 0 && b <=int(dead_zone) && a >= (int(cirumference) - int(dead_zone)))
-                {
-                    a -= int(cirumference);
-                }
-
-                // If we reach target position.  (now calculation is correct)
-                if (std::abs(a - b) <= int(dead_zone) )
-                {                    
-                    if (getDomeState() == DOME_MOVING)
-                    {
-                        LOG_INFO("Dome reached target position.");
-                        setDomeState(DOME_SYNCED);
-                    }
-                    else if (getDomeState() == DOME_PARKING)
-                    {
-                        LOG_INFO("Dome is parked.");
-                        SetParked(true);
-                        //setDomeState(DOME_PARKED);
-                    }
-                }
+                LOG_INFO("Dome is parked.");
+                SetParked(true);
+                //setDomeState(DOME_PARKED);
             }
         }
-        catch(...)
-        {
-            return false;
-        }
     }
 
     return true;
@@ -1247,52 +1196,43 @@ bool NexDome::processRotatorReport(const std::string &report)
 //////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////
-bool NexDome::processShutterReport(const std::string &report)
+bool NexDome::processShutterReport(std::string_view report)
 {
-    std::regex re(R"((-?\d+),(\d+),(\d+),(\d+))");
-    std::smatch match;
-    if (std::regex_search(report, match, re))
-    {
-        try
-        {
-            int32_t position = std::stoi(match.str(1));
-            int32_t travel_limit = std::stoi(match.str(2));
-            bool open_limit_switch = std::stoul(match.str(3)) == 1;
-            bool close_limit_switch = std::stoul(match.str(4)) == 1;
-
-            if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
-            {
-                ShutterSyncNP[0].setValue(position);
-                ShutterSyncNP.apply();
-            }
+    int32_t fields[4] = {0};
+    if (!ND::parseNumbers(report, fields, 4))
+        return false;
 
-            INDI_UNUSED(travel_limit);
+    int32_t position = fields[0];
+    int32_t travel_limit = fields[1];
+    bool open_limit_switch = fields[2] == 1;
+    bool close_limit_switch = fields[3] == 1;
 
-            if (getShutterState() == SHUTTER_MOVING || getShutterState() == SHUTTER_UNKNOWN)
-            {
-                //if (position == travel_limit || open_limit_switch)
-                if (open_limit_switch)
-                {
-                    setShutterState(SHUTTER_OPENED);
-                    LOG_INFO("Shutter is fully opened.");
+    if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
+    {
+        ShutterSyncNP[0].setValue(position);
+        ShutterSyncNP.apply();
+    }
 
-                    if (getDomeState() == DOME_UNPARKING)
-                        SetParked(false);
-                }
-                //else if (position == 0 || close_limit_switch)
-                else if (close_limit_switch)
-                {
-                    setShutterState(SHUTTER_CLOSED);
-                    LOG_INFO("Shutter is fully closed.");
-                }
+    INDI_UNUSED(travel_limit);
 
-            }
+    if (getShutterState() == SHUTTER_MOVING || getShutterState() == SHUTTER_UNKNOWN)
+    {
+        //if (position == travel_limit || open_limit_switch)
+        if (open_limit_switch)
+        {
+            setShutterState(SHUTTER_OPENED);
+            LOG_INFO("Shutter is fully opened.");
 
+            if (getDomeState() == DOME_UNPARKING)
+                SetParked(false);
         }
-        catch(...)
+        //else if (position == 0 || close_limit_switch)
+        else if (close_limit_switch)
         {
-            return false;
+            setShutterState(SHUTTER_CLOSED);
+            LOG_INFO("Shutter is fully closed.");
         }
+
     }
 
     return true;
@@ -1302,115 +1242,169 @@ bool NexDome::processShutterReport(const std::string &report)
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-bool NexDome::sendCommand(const char * cmd, char * res, int cmd_len, int res_len)
+bool NexDome::sendCommand(const char * cmd, const char * replyPrefix, char * reply)
 {
-    int nbytes_written = 0, nbytes_read = 0, rc = -1;
+    std::lock_guard<std::mutex> commandLock(m_CommandLock);
 
-    tcflush(PortFD, TCIOFLUSH);
+    if (replyPrefix)
+        m_Demux.expect(replyPrefix);
 
-    if (cmd_len > 0)
-    {
-        char hex_cmd[ND::DRIVER_LEN * 3] = {0};
-        hexDump(hex_cmd, cmd, cmd_len);
-        LOGF_DEBUG("CMD <%s>", hex_cmd);
-        rc = tty_write(PortFD, cmd, cmd_len, &nbytes_written);
-    }
-    else
-    {
-        LOGF_DEBUG("CMD <%s>", cmd);
-        char cmd_terminated[ND::DRIVER_LEN * 2] = {0};
-        snprintf(cmd_terminated, ND::DRIVER_LEN * 2, "%s\r\n", cmd);
-        rc = tty_write_string(PortFD, cmd_terminated, &nbytes_written);
-    }
+    LOGF_DEBUG("CMD <%s>", cmd);
+
+    int nbytes_written = 0;
+    char cmd_terminated[ND::DRIVER_LEN * 2] = {0};
+    snprintf(cmd_terminated, ND::DRIVER_LEN * 2, "%s\r\n", cmd);
+    int rc = tty_write_string(PortFD, cmd_terminated, &nbytes_written);
 
     if (rc != TTY_OK)
     {
+        m_Demux.cancel();
         char errstr[MAXRBUF] = {0};
         tty_error_msg(rc, errstr, MAXRBUF);
         LOGF_ERROR("Serial write error: %s.", errstr);
         return false;
     }
 
-    if (res == nullptr)
+    if (replyPrefix == nullptr)
         return true;
 
-    if (res_len > 0)
-        rc = tty_read(PortFD, res, res_len, ND::DRIVER_TIMEOUT, &nbytes_read);
-    else
-        rc = tty_nread_section(PortFD, res, ND::DRIVER_LEN, ND::DRIVER_STOP_CHAR, ND::DRIVER_TIMEOUT, &nbytes_read);
-
-    if (rc != TTY_OK)
+    if (!m_Demux.waitReply(std::chrono::seconds(ND::DRIVER_TIMEOUT), reply))
     {
-        char errstr[MAXRBUF] = {0};
-        tty_error_msg(rc, errstr, MAXRBUF);
-        LOGF_ERROR("Serial read error: %s.", errstr);
+        LOGF_ERROR("Timed out waiting for %s reply.", replyPrefix);
         return false;
     }
 
-    if (res_len > 0)
-    {
-        char hex_res[ND::DRIVER_LEN * 3] = {0};
-        hexDump(hex_res, res, res_len);
-        LOGF_DEBUG("RES <%s>", hex_res);
-    }
-    else
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+bool NexDome::startReader()
+{
+    stopReader();
+
+    if (pipe(m_EventPipe) < 0)
     {
-        res[nbytes_read - 1] = 0;
-        LOGF_DEBUG("RES <%s>", res);
+        LOGF_ERROR("Failed to create event pipe: %s.", strerror(errno));
+        return false;
     }
+    for (int fd : m_EventPipe)
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    m_EventCallbackID = IEAddCallback(m_EventPipe[0], &NexDome::processQueuedEventsHelper, this);
 
-    tcflush(PortFD, TCIOFLUSH);
-
+    m_Parser.reset();
+    m_ReaderQuit = false;
+    m_ReaderThread = std::thread(&NexDome::readerLoop, this);
     return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-void NexDome::hexDump(char * buf, const char * data, int size)
+void NexDome::stopReader()
 {
-    for (int i = 0; i < size; i++)
-        sprintf(buf + 3 * i, "%02X ", static_cast<uint8_t>(data[i]));
+    m_ReaderQuit = true;
+    if (m_ReaderThread.joinable())
+        m_ReaderThread.join();
+
+    if (m_EventCallbackID >= 0)
+    {
+        IERmCallback(m_EventCallbackID);
+        m_EventCallbackID = -1;
+    }
+
+    for (int &fd : m_EventPipe)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
 
-    if (size > 0)
-        buf[3 * size - 1] = '\0';
+    m_Demux.clearEvents();
 }
 
-//////////////////////////////////////////////////////////////////////
-///
-//////////////////////////////////////////////////////////////////////
-std::vector<std::string> NexDome::split(const std::string &input, const std::string &regex)
+//////////////////////////////////////////////////////////////////////////////
+/// Read everything the firmware sends and split it into frames. Polling with a
+/// short timeout keeps the thread responsive to stopReader().
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::readerLoop()
 {
-    // passing -1 as the submatch index parameter performs splitting
-    std::regex re(regex);
-    std::sregex_token_iterator
-    first{input.begin(), input.end(), re, -1},
-          last;
-    return {first, last};
+    char buffer[ND::DRIVER_LEN];
+    auto onFrame = [this](std::string_view frame)
+    {
+        processFrame(frame);
+    };
+
+    while (!m_ReaderQuit)
+    {
+        struct pollfd pfd = {PortFD, POLLIN, 0};
+        int rc = poll(&pfd, 1, 100);
+        if (rc == 0 || (rc < 0 && errno == EINTR))
+            continue;
+
+        if (rc < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+        {
+            LOGF_ERROR("Serial port error: %s.", rc < 0 ? strerror(errno) : "connection lost");
+            break;
+        }
+
+        ssize_t nbytes = read(PortFD, buffer, sizeof(buffer));
+        if (nbytes < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        if (nbytes <= 0)
+        {
+            LOGF_ERROR("Serial read error: %s.", nbytes < 0 ? strerror(errno) : "end of file");
+            break;
+        }
+
+        m_Parser.feed(buffer, nbytes, onFrame);
+    }
 }
 
-//////////////////////////////////////////////////////////////////////
-///
-//////////////////////////////////////////////////////////////////////
-std::string &NexDome::ltrim(std::string &str, const std::string &chars)
+//////////////////////////////////////////////////////////////////////////////
+/// Hand the frame over to the pending command if it is its reply, otherwise
+/// queue it as an event for the main thread.
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::processFrame(std::string_view frame)
 {
-    str.erase(0, str.find_first_not_of(chars));
-    return str;
+    LOGF_DEBUG("RES <%.*s>", static_cast<int>(frame.size()), frame.data());
+
+    switch (m_Demux.dispatch(frame))
+    {
+        case ND::ReplyDemux::DISPATCH_REPLY:
+            return;
+        case ND::ReplyDemux::DISPATCH_DROPPED:
+            LOGF_DEBUG("Event queue full, dropping <%.*s>", static_cast<int>(frame.size()), frame.data());
+            return;
+        case ND::ReplyDemux::DISPATCH_EVENT:
+            break;
+    }
+
+    // Wake up the main thread. A full pipe already has a wake up pending.
+    const char wake = 0;
+    if (write(m_EventPipe[1], &wake, 1) < 0 && errno != EAGAIN)
+        LOGF_DEBUG("Event pipe write failed: %s", strerror(errno));
 }
 
-//////////////////////////////////////////////////////////////////////
-///
-//////////////////////////////////////////////////////////////////////
-std::string &NexDome::rtrim(std::string &str, const std::string &chars)
+//////////////////////////////////////////////////////////////////////////////
+/// Called by the INDI event loop when the reader queued events.
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::processQueuedEventsHelper(int fd, void *context)
 {
-    str.erase(str.find_last_not_of(chars) + 1);
-    return str;
+    INDI_UNUSED(fd);
+    static_cast<NexDome *>(context)->processQueuedEvents();
 }
 
-//////////////////////////////////////////////////////////////////////
-///
-//////////////////////////////////////////////////////////////////////
-std::string &NexDome::trim(std::string &str, const std::string &chars)
+void NexDome::processQueuedEvents()
 {
-    return ltrim(rtrim(str, chars), chars);
+    char drain[64];
+    while (read(m_EventPipe[0], drain, sizeof(drain)) > 0)
+        ;
+
+    std::vector<std::string> events;
+    m_Demux.takeEvents(events);
+
+    for (const auto &event : events)
+        processEvent(event);
 }
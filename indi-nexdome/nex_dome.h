@@ -29,16 +29,24 @@
 #include <indidome.h>
 
 #include <math.h>
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include <sys/time.h>
 
 #include "nex_dome_constants.h"
+#include "nex_dome_demux.h"
+#include "nex_dome_parser.h"
 
 class NexDome : public INDI::Dome
 {
     public:
         NexDome();
+        virtual ~NexDome() override;
 
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
@@ -50,6 +58,7 @@ class NexDome : public INDI::Dome
 
     protected:
         bool Handshake() override;
+        bool Disconnect() override;
         void TimerHit() override;
 
         // Motion
@@ -127,23 +136,26 @@ class NexDome : public INDI::Dome
         /// Settings
         ///////////////////////////////////////////////////////////////////////////////
         bool executeFactoryCommand(uint8_t command, ND::Targets target);
-        bool processRotatorReport(const std::string &report);
-        bool processShutterReport(const std::string &report);
+        bool processRotatorReport(std::string_view report);
+        bool processShutterReport(std::string_view report);
+
+        ///////////////////////////////////////////////////////////////////////////////
+        /// Serial Reader
+        ///////////////////////////////////////////////////////////////////////////////
+        bool startReader();
+        void stopReader();
+        void readerLoop();
+        void processFrame(std::string_view frame);
+        static void processQueuedEventsHelper(int fd, void *context);
+        void processQueuedEvents();
 
         ///////////////////////////////////////////////////////////////////////////////
         /// Utility Functions
         ///////////////////////////////////////////////////////////////////////////////
         bool setParameter(ND::Commands command, ND::Targets target, int32_t value = -1e6);
         bool getParameter(ND::Commands command, ND::Targets target, std::string &value);
-        bool checkEvents(std::string &response);
-        bool processEvent(const std::string &event);
-        bool sendCommand(const char * cmd, char * res = nullptr, int cmd_len = -1, int res_len = -1);
-        void hexDump(char * buf, const char * data, int size);
-
-        std::string &ltrim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
-        std::string &rtrim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
-        std::string &trim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
-        std::vector<std::string> split(const std::string &input, const std::string &regex);
+        bool processEvent(std::string_view event);
+        bool sendCommand(const char * cmd, const char * replyPrefix = nullptr, char * reply = nullptr);
 
         ///////////////////////////////////////////////////////////////////////////////
         /// Private Members
@@ -152,5 +164,22 @@ class NexDome : public INDI::Dome
         int32_t m_TargetAZSteps {1000000};
         double StepsPerDegree { 153.0 };
 
+        // The reader thread owns all input from the port. It hands command replies
+        // over to the waiting sendCommand() call and queues everything else as events.
+        std::thread m_ReaderThread;
+        std::atomic_bool m_ReaderQuit { false };
+        ND::LineParser m_Parser;
+
+        // Serializes commands so that only one reply is expected at a time.
+        std::mutex m_CommandLock;
+
+        // Reply hand-off between the reader thread and sendCommand(). Events are
+        // processed on the main thread, which owns the dome state and the properties.
+        // The reader queues them and writes to the pipe so the INDI event loop picks
+        // them up right away.
+        ND::ReplyDemux m_Demux;
+        int m_EventPipe[2] = {-1, -1};
+        int m_EventCallbackID {-1};
+
 };
 
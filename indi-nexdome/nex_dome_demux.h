@@ -0,0 +1,150 @@
+/*******************************************************************************
+ NexDome reply and event demultiplexer
+
+ Sorts the frames read from the Firmware v3+ stream into the reply to the pending
+ command and unsolicited events for the NexDome driver.
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nex_dome_constants.h"
+
+namespace ND
+{
+
+/**
+ * @brief Hands command replies over to the waiting command and queues everything else.
+ *
+ * The reader thread calls dispatch() with every frame. A command arms the expected
+ * reply prefix with expect() before it is written, then blocks in waitReply() until
+ * the reader sees a frame starting with that prefix. Events that arrive meanwhile are
+ * queued in order for the main thread, which collects them with takeEvents(). Only
+ * one reply is expected at a time, the caller serializes its commands.
+ */
+class ReplyDemux
+{
+    public:
+        enum Dispatch
+        {
+            DISPATCH_REPLY,
+            DISPATCH_EVENT,
+            DISPATCH_DROPPED
+        };
+
+        static constexpr size_t MAX_QUEUED_EVENTS {256};
+
+        /**
+         * @brief expect Arm the reply of the command about to be written.
+         * @param prefix the reply starts with it, e.g. "SER" for "@GRR".
+         */
+        void expect(const char *prefix)
+        {
+            std::lock_guard<std::mutex> lock(m_ReplyLock);
+            m_ReplyPrefix[0] = 0;
+            strncat(m_ReplyPrefix, prefix, sizeof(m_ReplyPrefix) - 1);
+            m_ReplyPending = true;
+        }
+
+        /** Give up on the pending reply, e.g. when the command could not be written. */
+        void cancel()
+        {
+            std::lock_guard<std::mutex> lock(m_ReplyLock);
+            m_ReplyPending = false;
+        }
+
+        /**
+         * @brief waitReply Wait for the reply armed by expect().
+         * @param timeout how long to wait for it.
+         * @param reply filled with the reply if not null, at least DRIVER_LEN bytes.
+         * @return false on time out, the reply is no longer expected then.
+         */
+        bool waitReply(std::chrono::milliseconds timeout, char *reply = nullptr)
+        {
+            std::unique_lock<std::mutex> lock(m_ReplyLock);
+            if (!m_ReplyCV.wait_for(lock, timeout, [this]() { return !m_ReplyPending; }))
+            {
+                m_ReplyPending = false;
+                return false;
+            }
+
+            if (reply)
+                strncpy(reply, m_Reply, DRIVER_LEN - 1);
+            return true;
+        }
+
+        /**
+         * @brief dispatch Sort a frame read from the port.
+         * @return DISPATCH_EVENT when the frame was queued, the caller wakes up the
+         * main thread then. DISPATCH_DROPPED when the event queue is full.
+         */
+        Dispatch dispatch(std::string_view frame)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_ReplyLock);
+                if (m_ReplyPending && frame.compare(0, strlen(m_ReplyPrefix), m_ReplyPrefix) == 0)
+                {
+                    size_t length = std::min(frame.size(), sizeof(m_Reply) - 1);
+                    memcpy(m_Reply, frame.data(), length);
+                    m_Reply[length] = 0;
+                    m_ReplyPending = false;
+                    m_ReplyCV.notify_one();
+                    return DISPATCH_REPLY;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_EventLock);
+            if (m_EventQueue.size() >= MAX_QUEUED_EVENTS)
+                return DISPATCH_DROPPED;
+            m_EventQueue.emplace_back(frame);
+            return DISPATCH_EVENT;
+        }
+
+        /** Move the queued events, oldest first, into events. */
+        void takeEvents(std::vector<std::string> &events)
+        {
+            events.clear();
+            std::lock_guard<std::mutex> lock(m_EventLock);
+            events.swap(m_EventQueue);
+        }
+
+        void clearEvents()
+        {
+            std::lock_guard<std::mutex> lock(m_EventLock);
+            m_EventQueue.clear();
+        }
+
+    private:
+        std::mutex m_ReplyLock;
+        std::condition_variable m_ReplyCV;
+        bool m_ReplyPending { false };
+        char m_ReplyPrefix[16] = {0};
+        char m_Reply[DRIVER_LEN] = {0};
+
+        std::mutex m_EventLock;
+        std::vector<std::string> m_EventQueue;
+};
+
+}
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ NexDome serial stream tokenizer
+
+ Splits the Firmware v3+ byte stream into command replies and events for the
+ NexDome driver.
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "nex_dome_constants.h"
+
+namespace ND
+{
+
+/**
+ * @brief Splits the raw byte stream coming from the firmware into frames.
+ *
+ * Command replies are terminated by '#' and unsolicited events by a new line. The
+ * leading ':' of replies and surrounding white space are stripped. Frames are handed
+ * out as views into an internal fixed buffer, so nothing is allocated while parsing.
+ * The parser does not know about the serial port, it can be fed from any byte source.
+ */
+class LineParser
+{
+    public:
+        /**
+         * @brief feed Push raw bytes into the parser.
+         * @param data bytes read from the port.
+         * @param size number of bytes.
+         * @param onFrame called with every complete frame. The view is only valid during the call.
+         */
+        template <typename Callback>
+        void feed(const char *data, size_t size, Callback &&onFrame)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                char c = data[i];
+                if (c == DRIVER_STOP_CHAR || c == DRIVER_EVENT_CHAR || c == '\r')
+                {
+                    std::string_view frame = current();
+                    bool overflow = m_Overflow;
+                    m_Length = 0;
+                    m_Overflow = false;
+                    if (!frame.empty() && !overflow)
+                        onFrame(frame);
+                }
+                else if (m_Length < sizeof(m_Buffer))
+                    m_Buffer[m_Length++] = c;
+                // Overlong garbage is dropped up to the next terminator instead of
+                // being split or truncated into bogus frames.
+                else
+                    m_Overflow = true;
+            }
+        }
+
+        void reset()
+        {
+            m_Length = 0;
+            m_Overflow = false;
+        }
+
+    private:
+        std::string_view current() const
+        {
+            size_t start = 0, end = m_Length;
+            while (start < end && (m_Buffer[start] == ':' || isSpace(m_Buffer[start])))
+                start++;
+            while (end > start && isSpace(m_Buffer[end - 1]))
+                end--;
+            return std::string_view(m_Buffer + start, end - start);
+        }
+
+        static bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+        }
+
+        char m_Buffer[DRIVER_LEN] = {0};
+        size_t m_Length {0};
+        bool m_Overflow {false};
+};
+
+/**
+ * @brief parseNumbers Parse up to count comma separated integers without allocating.
+ * @param text input such as "1234,0,55080,0,300".
+ * @param values output array of at least count entries.
+ * @param count number of integers expected.
+ * @return true if count integers were found. Anything after the last one is ignored.
+ */
+inline bool parseNumbers(std::string_view text, int32_t *values, int count)
+{
+    size_t pos = 0;
+    for (int i = 0; i < count; i++)
+    {
+        bool negative = false;
+        if (pos < text.size() && text[pos] == '-')
+        {
+            negative = true;
+            pos++;
+        }
+
+        if (pos >= text.size() || text[pos] < '0' || text[pos] > '9')
+            return false;
+
+        int64_t value = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+        {
+            value = value * 10 + (text[pos++] - '0');
+            if (value > INT32_MAX)
+                return false;
+        }
+        values[i] = static_cast<int32_t>(negative ? -value : value);
+
+        if (i + 1 < count)
+        {
+            if (pos >= text.size() || text[pos] != ',')
+                return false;
+            pos++;
+        }
+    }
+
+    return true;
+}
+
+inline bool parseNumber(std::string_view text, int32_t &value)
+{
+    return parseNumbers(text, &value, 1);
+}
+
+}
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "nex_dome_demux.h"
+#include "nex_dome_parser.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::vector<std::string> parseAll(ND::LineParser &parser, const std::string &input, size_t chunk)
+{
+    std::vector<std::string> frames;
+    auto onFrame = [&frames](std::string_view frame)
+    {
+        frames.emplace_back(frame);
+    };
+
+    for (size_t i = 0; i < input.size(); i += chunk)
+        parser.feed(input.data() + i, std::min(chunk, input.size() - i), onFrame);
+    return frames;
+}
+
+// A short session as sent by Firmware v3: replies end with '#', events with a new line.
+static const std::string SESSION =
+    ":FR3.1.0#"
+    "XB->Online\r\n"
+    ":SER,1234,0,55080,0,300#"
+    "left\r\n"
+    "P1240\r\n"
+    "P1250\r\n"
+    "STOP\r\n"
+    ":SES,0,46000,0,1#"
+    "open\r\n"
+    "S1200\r\n"
+    "BV700\r\n";
+
+static const std::vector<std::string> SESSION_FRAMES =
+{
+    "FR3.1.0", "XB->Online", "SER,1234,0,55080,0,300", "left", "P1240", "P1250", "STOP",
+    "SES,0,46000,0,1", "open", "S1200", "BV700"
+};
+
+TEST(NexDomeParser, splitsRepliesAndEvents)
+{
+    ND::LineParser parser;
+    ASSERT_EQ(parseAll(parser, SESSION, SESSION.size()), SESSION_FRAMES);
+}
+
+TEST(NexDomeParser, reassemblesFragments)
+{
+    for (size_t chunk = 1; chunk <= 7; chunk++)
+    {
+        ND::LineParser parser;
+        ASSERT_EQ(parseAll(parser, SESSION, chunk), SESSION_FRAMES) << "chunk size " << chunk;
+    }
+}
+
+TEST(NexDomeParser, stripsPrefixAndSpaces)
+{
+    ND::LineParser parser;
+    ASSERT_EQ(parseAll(parser, ":  PR1234 \t#\r\n\r\n  STOP  \n", 64),
+              std::vector<std::string>({"PR1234", "STOP"}));
+}
+
+TEST(NexDomeParser, dropsOverlongFrames)
+{
+    ND::LineParser parser;
+    std::string input(ND::DRIVER_LEN * 3, 'x');
+    input += "\nSTOP\n";
+    input += std::string(ND::DRIVER_LEN + 1, 'y');
+    input += "#P1240\n";
+
+    ASSERT_EQ(parseAll(parser, input, 100), std::vector<std::string>({"STOP", "P1240"}));
+
+    // A frame filling the buffer exactly is still complete.
+    std::string exact(ND::DRIVER_LEN, 'z');
+    ASSERT_EQ(parseAll(parser, exact + "\n", 7), std::vector<std::string>({exact}));
+}
+
+TEST(NexDomeParser, parseNumbers)
+{
+    int32_t values[5] = {0};
+    ASSERT_TRUE(ND::parseNumbers("1234,0,55080,-7,300", values, 5));
+    ASSERT_EQ(values[0], 1234);
+    ASSERT_EQ(values[2], 55080);
+    ASSERT_EQ(values[3], -7);
+    ASSERT_EQ(values[4], 300);
+
+    ASSERT_TRUE(ND::parseNumbers("1,2,3 trailing", values, 3));
+    ASSERT_FALSE(ND::parseNumbers("1,2", values, 3));
+    ASSERT_FALSE(ND::parseNumbers("1,,3", values, 3));
+    ASSERT_FALSE(ND::parseNumbers("Online", values, 1));
+    ASSERT_FALSE(ND::parseNumbers("99999999999", values, 1));
+
+    int32_t value = 0;
+    ASSERT_TRUE(ND::parseNumber("700", value));
+    ASSERT_EQ(value, 700);
+}
+
+TEST(NexDomeDemux, queuesEventsWithoutPendingCommand)
+{
+    ND::ReplyDemux demux;
+    ASSERT_EQ(demux.dispatch("SER,1234,0,55080,0,300"), ND::ReplyDemux::DISPATCH_EVENT);
+    ASSERT_EQ(demux.dispatch("P1240"), ND::ReplyDemux::DISPATCH_EVENT);
+
+    std::vector<std::string> events;
+    demux.takeEvents(events);
+    ASSERT_EQ(events, std::vector<std::string>({"SER,1234,0,55080,0,300", "P1240"}));
+    demux.takeEvents(events);
+    ASSERT_TRUE(events.empty());
+}
+
+TEST(NexDomeDemux, matchesReplyPrefix)
+{
+    ND::ReplyDemux demux;
+    demux.expect("SER");
+
+    // "SES" is the shutter report, only the rotator one answers the command.
+    ASSERT_EQ(demux.dispatch("SES,0,46000,0,1"), ND::ReplyDemux::DISPATCH_EVENT);
+    ASSERT_EQ(demux.dispatch("SER,1234,0,55080,0,300"), ND::ReplyDemux::DISPATCH_REPLY);
+    ASSERT_EQ(demux.dispatch("SER,1240,0,55080,0,300"), ND::ReplyDemux::DISPATCH_EVENT);
+
+    char reply[ND::DRIVER_LEN] = {0};
+    ASSERT_TRUE(demux.waitReply(std::chrono::milliseconds(0), reply));
+    ASSERT_STREQ(reply, "SER,1234,0,55080,0,300");
+
+    std::vector<std::string> events;
+    demux.takeEvents(events);
+    ASSERT_EQ(events, std::vector<std::string>({"SES,0,46000,0,1", "SER,1240,0,55080,0,300"}));
+}
+
+TEST(NexDomeDemux, timesOutAndCancels)
+{
+    ND::ReplyDemux demux;
+    demux.expect("FR");
+    ASSERT_FALSE(demux.waitReply(std::chrono::milliseconds(10)));
+
+    // A late reply is no longer taken for the command.
+    ASSERT_EQ(demux.dispatch("FR3.1.0"), ND::ReplyDemux::DISPATCH_EVENT);
+
+    demux.expect("FR");
+    demux.cancel();
+    ASSERT_EQ(demux.dispatch("FR3.1.0"), ND::ReplyDemux::DISPATCH_EVENT);
+}
+
+TEST(NexDomeDemux, dropsEventsWhenFull)
+{
+    ND::ReplyDemux demux;
+    for (size_t i = 0; i < ND::ReplyDemux::MAX_QUEUED_EVENTS; i++)
+        ASSERT_EQ(demux.dispatch("P1240"), ND::ReplyDemux::DISPATCH_EVENT);
+    ASSERT_EQ(demux.dispatch("P1250"), ND::ReplyDemux::DISPATCH_DROPPED);
+
+    // Replies still get through a full queue.
+    demux.expect("PR");
+    ASSERT_EQ(demux.dispatch("PR1250"), ND::ReplyDemux::DISPATCH_REPLY);
+
+    demux.clearEvents();
+    ASSERT_EQ(demux.dispatch("P1250"), ND::ReplyDemux::DISPATCH_EVENT);
+}
+
+// Commands wait on the main thread while a reader thread feeds the stream in random
+// fragments, with events arriving before, between and after the replies.
+TEST(NexDomeDemux, interleavedEventsDuringCommands)
+{
+    struct Command
+    {
+        const char *prefix;
+        std::string reply;
+    };
+    const std::vector<Command> commands =
+    {
+        {"FR", "FR3.1.0"}, {"SER", "SER,1234,0,55080,0,300"}, {"SES", "SES,0,46000,0,1"}, {"BV", "BV700"}
+    };
+
+    ND::ReplyDemux demux;
+    std::mutex streamLock;
+    std::condition_variable streamCV;
+    std::string pending;
+    bool done = false;
+
+    std::thread reader([&]()
+    {
+        ND::LineParser parser;
+        std::mt19937 rng(29);
+        std::uniform_int_distribution<size_t> chunk(1, 16);
+        auto onFrame = [&demux](std::string_view frame)
+        {
+            demux.dispatch(frame);
+        };
+
+        std::unique_lock<std::mutex> lock(streamLock);
+        while (!done || !pending.empty())
+        {
+            if (pending.empty())
+            {
+                streamCV.wait(lock);
+                continue;
+            }
+            size_t length = std::min(chunk(rng), pending.size());
+            std::string bytes = pending.substr(0, length);
+            pending.erase(0, length);
+
+            lock.unlock();
+            parser.feed(bytes.data(), bytes.size(), onFrame);
+            std::this_thread::sleep_for(std::chrono::microseconds(rng() % 200));
+            lock.lock();
+        }
+    });
+
+    auto send = [&](const std::string &bytes)
+    {
+        std::lock_guard<std::mutex> lock(streamLock);
+        pending += bytes;
+        streamCV.notify_one();
+    };
+
+    // The main thread collects the events as the driver does, keeping the queue short.
+    std::vector<std::string> events, expectedEvents;
+    auto collect = [&]()
+    {
+        std::vector<std::string> queued;
+        demux.takeEvents(queued);
+        events.insert(events.end(), queued.begin(), queued.end());
+    };
+
+    for (int round = 0; round < 20; round++)
+    {
+        for (const auto &command : commands)
+        {
+            demux.expect(command.prefix);
+
+            // Events sent around the reply, some starting like another command's reply.
+            send("left\r\nP1240\r\nSES,0,45000,0,1\n:" + command.reply + "#P1250\r\nSTOP\r\n");
+            // A shutter report event answers the "SES" command, its own reply is an event then.
+            bool shutter = strcmp(command.prefix, "SES") == 0;
+            expectedEvents.insert(expectedEvents.end(), {"left", "P1240"});
+            expectedEvents.emplace_back(shutter ? command.reply : "SES,0,45000,0,1");
+            expectedEvents.insert(expectedEvents.end(), {"P1250", "STOP"});
+
+            char reply[ND::DRIVER_LEN] = {0};
+            ASSERT_TRUE(demux.waitReply(std::chrono::seconds(5), reply)) << command.prefix;
+            ASSERT_STREQ(reply, shutter ? "SES,0,45000,0,1" : command.reply.c_str());
+        }
+        collect();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(streamLock);
+        done = true;
+        streamCV.notify_one();
+    }
+    reader.join();
+
+    collect();
+    ASSERT_EQ(events, expectedEvents);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
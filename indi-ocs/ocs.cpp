@@ -38,6 +38,9 @@ USB and network connections supported.
 #include "ocs.h"
 #include "termios.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <ctime>
 #include <memory>
@@ -51,9 +54,6 @@ USB and network connections supported.
 #define WEATHER_TAB "Weather"
 #define MANUAL_TAB "Manual"
 
-// Mutex for communications
-std::mutex ocsCommsLock;
-
 // Declare an auto pointer to OCS.
 std::unique_ptr<OCS> ocs(new OCS());
 
@@ -70,6 +70,11 @@ OCS::OCS() : INDI::Dome(), WI(this)
     SlowTimer.callOnTimeout(std::bind(&OCS::SlowTimerHit, this));
 }
 
+OCS::~OCS()
+{
+    stopCommandThread();
+}
+
 /*******************************************************
  * INDI is asking us for our default device name.
  * Must match Ekos selection menu and ParkData.xml names
@@ -99,6 +104,8 @@ bool OCS::Handshake()
             OCSTimeoutSeconds = 0;
         }
 
+        startCommandThread();
+
         char handshake_response[RB_MAX_LEN] = {0};
         handshake_status = getCommandSingleCharErrorOrLongResponse(PortFD, handshake_response,
                                                                    OCS_handshake);
@@ -107,11 +114,14 @@ bool OCS::Handshake()
             LOG_DEBUG("OCS handshake established");
             handshake_status = true;
             GetCapabilites();
-            SlowTimer.start(60000);
+            SlowTimer.start(slow_update_period_ms);
         }
         else {
             LOGF_DEBUG("OCS handshake error, reponse was: %s", handshake_response);
         }
+
+        if (!handshake_status)
+            stopCommandThread();
     }
     else {
         LOG_ERROR("OCS can't handshake, device not connected");
@@ -802,8 +812,8 @@ void OCS::TimerHit()
 {
     // Get the roof/shutter status
     char roof_status_response[RB_MAX_LEN] = {0};
-    int roof_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, roof_status_response,
-                                                                             OCS_get_roof_status);
+    int roof_status_error_or_fail  = getPolledResponse(roof_status_response, OCS_get_roof_status,
+                                                       getCurrentPollingPeriod(), PRIORITY_STATUS);
     if (roof_status_error_or_fail > 1) {
         bool roof_was_in_error = (getShutterState() == SHUTTER_ERROR);
 
@@ -870,8 +880,8 @@ void OCS::TimerHit()
         // Get the dome status
         char dome_message[10];
         char dome_status_response[RB_MAX_LEN] = {0};
-        int dome_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, dome_status_response,
-                                                                                 OCS_get_dome_status);
+        int dome_status_error_or_fail  = getPolledResponse(dome_status_response, OCS_get_dome_status,
+                                                           getCurrentPollingPeriod(), PRIORITY_STATUS);
         if (dome_status_error_or_fail > 1) { //> 1 as an OCS error would be 1 char in response
             if (strcmp(dome_status_response, "H") == 0) {
                 if (getDomeState() != DOME_IDLE) {
@@ -929,8 +939,9 @@ void OCS::TimerHit()
         // Get the dome position
         char dome_position_response[RB_MAX_LEN] = {0};
         double position = conversion_error ;
-        int dome_position_error_or_fail = getCommandDoubleResponse(PortFD, &position, dome_position_response,
-                                                                   OCS_get_dome_azimuth);
+        int dome_position_error_or_fail = getPolledDoubleResponse(&position, dome_position_response,
+                                                                  OCS_get_dome_azimuth, getCurrentPollingPeriod(),
+                                                                  PRIORITY_STATUS);
         if (dome_position_error_or_fail > 1 && position != conversion_error) {
             // DomeAbsPosN->value = position;
             DomeAbsPosNP[0].setValue(position);
@@ -957,8 +968,8 @@ void OCS::SlowTimerHit()
 {
     // Status tab
     char power_status_response[RB_MAX_LEN] = {0};
-    int power_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, power_status_response,
-                                                                              OCS_get_power_status);
+    int power_status_error_or_fail  = getPolledResponse(power_status_response, OCS_get_power_status,
+                                                        slow_update_period_ms);
     if (power_status_error_or_fail > 1) {
         IUSaveText(&Status_ItemsT[STATUS_MAINS], power_status_response);
         IDSetText(&Status_ItemsTP, nullptr);
@@ -967,8 +978,8 @@ void OCS::SlowTimerHit()
     }
 
     char safety_status_response[RB_MAX_LEN] = {0};
-    int safety_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, safety_status_response,
-                                                                                     OCS_get_safety_status);
+    int safety_status_error_or_fail  = getPolledResponse(safety_status_response, OCS_get_safety_status,
+                                                         slow_update_period_ms, PRIORITY_STATUS);
     if (safety_status_error_or_fail > 1) {
         IUSaveText(&Status_ItemsT[STATUS_OCS_SAFETY], safety_status_response);
         IDSetText(&Status_ItemsTP, nullptr);
@@ -977,8 +988,8 @@ void OCS::SlowTimerHit()
     }
 
     char MCU_temp_response[RB_MAX_LEN] = {0};
-    int MCU_temp_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, MCU_temp_response,
-                                                                                 OCS_get_MCU_temperature);
+    int MCU_temp_status_error_or_fail  = getPolledResponse(MCU_temp_response, OCS_get_MCU_temperature,
+                                                           slow_update_period_ms);
     if (MCU_temp_status_error_or_fail > 1) {
         IUSaveText(&Status_ItemsT[STATUS_MCU_TEMPERATURE], MCU_temp_response);
         IDSetText(&Status_ItemsTP, nullptr);
@@ -991,8 +1002,8 @@ void OCS::SlowTimerHit()
     // at the time it could miss a transient condition that has been cleared in-between poll periods.
     // Last roof error holds the condition until cleared by a shutter/roof action.
     char roof_error_response[RB_MAX_LEN] = {0};
-    int roof_error_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, roof_error_response,
-                                                                            OCS_get_roof_last_error);
+    int roof_error_error_or_fail  = getPolledResponse(roof_error_response, OCS_get_roof_last_error,
+                                                      slow_update_period_ms, PRIORITY_STATUS);
     if (roof_error_error_or_fail > 1) {
         if (strcmp(roof_error_response, "Error: Open safety interlock") == 0 &&
                 strcmp(roof_error_response, last_shutter_error) != 0) {
@@ -1145,8 +1156,8 @@ void OCS::SlowTimerHit()
     if (thermostat_controls_enabled) {
         // Get the Obsy Thermostat readings
         char thermostat_status_response[RB_MAX_LEN] = {0};
-        int thermostat_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, thermostat_status_response,
-                                                                                       OCS_get_thermostat_status);
+        int thermostat_status_error_or_fail  = getPolledResponse(thermostat_status_response, OCS_get_thermostat_status,
+                                                                 slow_update_period_ms);
         if (thermostat_status_error_or_fail > 1) {
             char *split;
             split = strtok(thermostat_status_response, ",");
@@ -1162,8 +1173,9 @@ void OCS::SlowTimerHit()
         if (thermostat_relays[THERMOSTAT_HEAT_RELAY] > 0) {
             char heat_response[RB_MAX_LEN] = {0};
             int heat_int_response = 0;
-            int heat_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, heat_response, &heat_int_response,
-                                                                            OCS_get_thermostat_heat_setpoint);
+            int heat_setpoint_error_or_fail = getPolledResponse(heat_response, OCS_get_thermostat_heat_setpoint,
+                                                                slow_update_period_ms);
+            heat_int_response = charToInt(heat_response);
             if (heat_setpoint_error_or_fail >= 0 && heat_int_response != conversion_error) { // errors are negative
                 Thermostat_heat_setpointN[0].value = heat_int_response;
             } else {
@@ -1175,8 +1187,9 @@ void OCS::SlowTimerHit()
         if (thermostat_relays[THERMOSTAT_COOL_RELAY] > 0) {
             char cool_response[RB_MAX_LEN] = {0};
             int cool_int_response = 0;
-            int cool_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, cool_response, &cool_int_response,
-                                                                            OCS_get_thermostat_cool_setpoint);
+            int cool_setpoint_error_or_fail = getPolledResponse(cool_response, OCS_get_thermostat_cool_setpoint,
+                                                                slow_update_period_ms);
+            cool_int_response = charToInt(cool_response);
             if (cool_setpoint_error_or_fail >= 0 && cool_int_response != conversion_error) { // errors are negative
                 Thermostat_cool_setpointN[0].value =cool_int_response;
             } else {
@@ -1188,8 +1201,10 @@ void OCS::SlowTimerHit()
         if (thermostat_relays[THERMOSTAT_HUMIDITY_RELAY] > 0) {
             char humidity_response[RB_MAX_LEN] = {0};
             int humidity_int_response = 0;
-            int humidity_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, humidity_response, &humidity_int_response,
-                                                                                OCS_get_thermostat_humidity_setpoint);
+            int humidity_setpoint_error_or_fail = getPolledResponse(humidity_response,
+                                                                    OCS_get_thermostat_humidity_setpoint,
+                                                                    slow_update_period_ms);
+            humidity_int_response = charToInt(humidity_response);
             if (humidity_setpoint_error_or_fail >= 0 && humidity_int_response != conversion_error) { // errors are negative
                 Thermostat_humidity_setpointN[0].value = humidity_int_response;
             } else {
@@ -1204,8 +1219,8 @@ void OCS::SlowTimerHit()
                 char thermo_relay_response[RB_MAX_LEN] = {0};
                 char thermo_relay_command[RB_MAX_LEN] = {0};
                 sprintf(thermo_relay_command, "%s%d%s", OCS_get_relay_part, thermostat_relays[relay], OCS_command_terminator);
-                int thermo_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, thermo_relay_response,
-                                                                                         thermo_relay_command);
+                int thermo_relay_error_or_fail = getPolledResponse(thermo_relay_response, thermo_relay_command,
+                                                                   slow_update_period_ms);
                 if (thermo_relay_error_or_fail > 1) {
                     switch(relay) {
                         case THERMOSTAT_HEAT_RELAY:
@@ -1254,8 +1269,8 @@ void OCS::SlowTimerHit()
                 char power_relay_response[RB_MAX_LEN] = {0};
                 char power_relay_command[RB_MAX_LEN] = {0};
                 sprintf(power_relay_command, "%s%d%s", OCS_get_relay_part, power_device_relays[relay], OCS_command_terminator);
-                int power_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, power_relay_response,
-                                                                                        power_relay_command);
+                int power_relay_error_or_fail = getPolledResponse(power_relay_response, power_relay_command,
+                                                                  slow_update_period_ms);
                 if (power_relay_error_or_fail > 1) {
                     switch(relay) {
                         case POWER_DEVICE1:
@@ -1334,8 +1349,8 @@ void OCS::SlowTimerHit()
                 char light_relay_response[RB_MAX_LEN] = {0};
                 char light_relay_command[RB_MAX_LEN] = {0};
                 sprintf(light_relay_command, "%s%d%s", OCS_get_relay_part, light_relays[relay], OCS_command_terminator);
-                int light_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, light_relay_response,
-                                                                                        light_relay_command);
+                int light_relay_error_or_fail = getPolledResponse(light_relay_response, light_relay_command,
+                                                                  slow_update_period_ms);
                 if (light_relay_error_or_fail > 1) {
                     switch (relay) {
                         case LIGHT_WRW_RELAY:
@@ -1405,6 +1420,8 @@ IPState OCS::updateWeather() {
 
         LOG_DEBUG("Weather update called");
 
+        int weather_period_ms = static_cast<int>(WI::UpdatePeriodNP[0].getValue() * 1000);
+
         for (int measurement = 0; measurement < WEATHER_MEASUREMENTS_COUNT; measurement ++) {
             if (weather_enabled[measurement] == 1) {
                 char measurement_reponse[RB_MAX_LEN];
@@ -1445,8 +1462,8 @@ IPState OCS::updateWeather() {
                 }
 
                 double value = conversion_error;
-                int measurement_error_or_fail = getCommandDoubleResponse(PortFD, &value, measurement_reponse,
-                                                                         measurement_command);
+                int measurement_error_or_fail = getPolledDoubleResponse(&value, measurement_reponse,
+                                                                        measurement_command, weather_period_ms);
                 if ((measurement_error_or_fail >= 0) && (value != conversion_error) &&
                     (weather_enabled[measurement] == 1)) {
                     switch(measurement) {
@@ -1487,8 +1504,8 @@ IPState OCS::updateWeather() {
                 // Separate because WEATHER_CLOUD is the only weather parameter that return a string
                 if ((measurement == WEATHER_CLOUD) && (weather_enabled[WEATHER_CLOUD] == 1)) {
                     char measurement_reponse[RB_MAX_LEN];
-                    int measurement_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, measurement_reponse,
-                                                                             OCS_get_cloud_description);
+                    int measurement_error_or_fail = getPolledResponse(measurement_reponse, OCS_get_cloud_description,
+                                                                      weather_period_ms);
                     if (measurement_error_or_fail > 1) {
                         IUSaveText(&Weather_CloudT[0], measurement_reponse);
                         IDSetText(&Weather_CloudTP, nullptr);
@@ -1773,6 +1790,8 @@ bool OCS::Connect()
 ************************************************************/
 bool OCS::Disconnect()
 {
+    // Stop the command thread before the port is closed
+    stopCommandThread();
     bool status = INDI::Dome::Disconnect();
     return status;
 }
@@ -2170,296 +2189,362 @@ bool OCS::ISSnoopDevice(XMLEle *root)
  * OCS command functions, mostly copied from lx200_OnStep
  *******************************************************/
 
-/*********************************************************************
- * Send command to OCS without checking (intended non-existent) return
- * *******************************************************************/
-bool OCS::sendOCSCommandBlind(const char *cmd)
+/*****************************************************************
+ * Start the command thread, all port I/O goes through it from now
+ * ***************************************************************/
+void OCS::startCommandThread()
 {
-    // No need to block this command as there is no response
+    stopCommandThread();
 
-    int error_type;
-    int nbytes_write = 0;
-    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
-    flushIO(PortFD);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
-    tcflush(PortFD, TCIFLUSH);
-    if ((error_type = tty_write_string(PortFD, cmd, &nbytes_write)) != TTY_OK) {
-        LOGF_ERROR("CHECK CONNECTION: Error sending command %s", cmd);
-        waitingForResponse = false;
-        return 0; //Fail if we can't write
-        //return error_type;
-    }
-    return 1;
+    command_thread_quit = false;
+    command_thread = std::thread(&OCS::commandLoop, this);
 }
 
 /*********************************************************************
- * Send command to OCS that expects a 0 (sucess) or 1 (failure) return
+ * Stop the command thread and fail whatever is still waiting in queue
  * *******************************************************************/
-bool OCS::sendOCSCommand(const char *cmd)
+void OCS::stopCommandThread()
 {
-    blockUntilClear();
-
-    char response[1] = {0};
-    int error_type;
-    int nbytes_write = 0, nbytes_read = 0;
-
-    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
-
-    flushIO(PortFD);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
-    tcflush(PortFD, TCIFLUSH);
-
-    if ((error_type = tty_write_string(PortFD, cmd, &nbytes_write)) != TTY_OK)
-        return error_type;
-
-    error_type = tty_read_expanded(PortFD, response, 1, OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    {
+        std::lock_guard<std::mutex> guard(command_lock);
+        command_thread_quit = true;
+    }
+    command_cv.notify_all();
 
-    tcflush(PortFD, TCIFLUSH);
-    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%c>", response[0]);
-    //waitingForResponse = false;
-    clearBlock();
+    if (command_thread.joinable())
+        command_thread.join();
 
-    if (nbytes_read < 1) {
-        LOG_WARN("Timeout/Error on response. Check connection.");
-        return false;
+    std::lock_guard<std::mutex> guard(command_lock);
+    for (auto &queue : command_queue) {
+        for (auto &request : queue) {
+            CommandReply reply;
+            reply.error_or_fail = TTY_ERRNO;
+            request.reply.set_value(reply);
+        }
+        queue.clear();
     }
-
-    return (response[0] == '1'); //OCS uses 1 for success and non zero for failure, in *most* cases;
+    polled_items.clear();
 }
 
-/************************************************************
- * Send command to OCS that expects a single character return
- * **********************************************************/
-int OCS::getCommandSingleCharResponse(int fd, char *data, const char *cmd)
+/********************************************************************
+ * Command thread. Queued commands are sent strictly by priority, and
+ * polled telemetry is only refreshed while the queue is empty, so a
+ * control command never waits for more than one telemetry round trip.
+ * ******************************************************************/
+void OCS::commandLoop()
 {
-    blockUntilClear();
+    std::unique_lock<std::mutex> guard(command_lock);
+
+    while (!command_thread_quit) {
+        // Queued commands first, highest priority first
+        std::deque<CommandRequest> *queue = nullptr;
+        for (int priority = 0; priority < PRIORITY_COUNT; priority++) {
+            if (!command_queue[priority].empty()) {
+                queue = &command_queue[priority];
+                break;
+            }
+        }
 
-    char *term;
-    int error_type;
-    int nbytes_write = 0, nbytes_read = 0;
+        if (queue) {
+            CommandRequest request = std::move(queue->front());
+            queue->pop_front();
+            bool control = (queue == &command_queue[PRIORITY_CONTROL]);
 
-    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
+            guard.unlock();
+            CommandReply reply = transact(request.command.c_str(), request.type);
+            request.reply.set_value(reply);
+            guard.lock();
 
-    flushIO(fd);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
+            // Roof and dome status is refreshed right after a control command
+            if (control) {
+                for (auto &item : polled_items) {
+                    if (item.second.priority == PRIORITY_STATUS)
+                        item.second.next_update = std::chrono::steady_clock::now();
+                }
+            }
+            continue;
+        }
 
-    if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
-        return error_type;
+        // Then the most urgent polled item that is due
+        auto now = std::chrono::steady_clock::now();
+        auto next_wakeup = now + std::chrono::seconds(1);
+        auto due = polled_items.end();
+        for (auto item = polled_items.begin(); item != polled_items.end(); ++item) {
+            if (item->second.next_update > now) {
+                next_wakeup = std::min(next_wakeup, item->second.next_update);
+                continue;
+            }
+            if (due == polled_items.end() || item->second.priority < due->second.priority ||
+                    (item->second.priority == due->second.priority && item->second.next_update < due->second.next_update))
+                due = item;
+        }
 
-    error_type = tty_read_expanded(fd, data, 1, OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
-    tcflush(fd, TCIFLUSH);
+        if (due != polled_items.end()) {
+            // Map nodes are stable, only stopCommandThread() erases them
+            std::string command = due->first;
+            ResponseType type = due->second.type;
+            due->second.next_update = now + due->second.interval;
 
-    if (error_type != TTY_OK)
-        return error_type;
+            guard.unlock();
+            CommandReply reply = transact(command.c_str(), type);
+            guard.lock();
 
-    term = strchr(data, '#');
-    if (term)
-        *term = '\0';
-    if (nbytes_read < RB_MAX_LEN) { //given this function that should always be true, as should nbytes_read always be 1
-        data[nbytes_read] = '\0';
-    } else {
-        LOG_DEBUG("got RB_MAX_LEN bytes back (which should never happen), last byte set to null and possible overflow");
-        data[RB_MAX_LEN - 1] = '\0';
+            due->second.reply = reply;
+            continue;
+        }
+
+        command_cv.wait_until(guard, next_wakeup);
     }
+}
+
+/*****************************************************
+ * Queue a command and return the future of its reply
+ * ***************************************************/
+std::future<OCS::CommandReply> OCS::queueCommand(const char *cmd, ResponseType type, CommandPriority priority)
+{
+    CommandRequest request;
+    request.command = cmd;
+    request.type = type;
+    std::future<CommandReply> reply = request.reply.get_future();
 
-    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", data);
-    //waitingForResponse = false;
-    clearBlock();
+    {
+        std::lock_guard<std::mutex> guard(command_lock);
+        if (command_thread_quit || !command_thread.joinable()) {
+            CommandReply error;
+            error.error_or_fail = TTY_ERRNO;
+            request.reply.set_value(error);
+            return reply;
+        }
+        command_queue[priority].push_back(std::move(request));
+    }
+    command_cv.notify_one();
 
-    return nbytes_read;
+    return reply;
 }
 
-/**************************************************
- * Send command to OCS that expects a double return
- * ************************************************/
-int OCS::getCommandDoubleResponse(int fd, double *value, char *data, const char *cmd)
+/*****************************************************************
+ * Write the command and read the reply, runs on the command thread
+ * ***************************************************************/
+OCS::CommandReply OCS::transact(const char *cmd, ResponseType type)
 {
-    blockUntilClear();
-
-    char *term;
+    CommandReply reply;
     int error_type;
     int nbytes_write = 0, nbytes_read = 0;
 
     DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
 
-    flushIO(fd);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
-    tcflush(fd, TCIFLUSH);
+    flushIO(PortFD);
+    tcflush(PortFD, TCIFLUSH);
 
-    if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
-        return error_type;
+    if ((error_type = tty_write_string(PortFD, cmd, &nbytes_write)) != TTY_OK) {
+        LOGF_ERROR("CHECK CONNECTION: Error sending command %s", cmd);
+        reply.error_or_fail = error_type;
+        return reply;
+    }
 
-    error_type = tty_read_section_expanded(fd, data, '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
-    tcflush(fd, TCIFLUSH);
+    if (type == RESPONSE_NONE) {
+        reply.error_or_fail = nbytes_write;
+        return reply;
+    }
 
-    term = strchr(data, '#');
+    if (type == RESPONSE_CHAR)
+        error_type = tty_read_expanded(PortFD, reply.data, 1, OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    else
+        error_type = tty_read_section_expanded(PortFD, reply.data, '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds,
+                                               &nbytes_read);
+    tcflush(PortFD, TCIFLUSH);
+
+    char *term = strchr(reply.data, '#');
     if (term)
         *term = '\0';
     if (nbytes_read < RB_MAX_LEN) { //If within buffer, terminate string with \0 (in case it didn't find the #)
-        data[nbytes_read] = '\0'; //Indexed at 0, so this is the byte passed it
+        reply.data[nbytes_read] = '\0'; //Indexed at 0, so this is the byte passed it
     } else {
         LOG_DEBUG("got RB_MAX_LEN bytes back, last byte set to null and possible overflow");
-        data[RB_MAX_LEN - 1] = '\0';
+        reply.data[RB_MAX_LEN - 1] = '\0';
     }
 
-    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", data);
-    //waitingForResponse = false;
-    clearBlock();
+    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", reply.data);
 
     if (error_type != TTY_OK) {
         LOGF_DEBUG("Error %d", error_type);
         LOG_DEBUG("Flushing connection");
-        tcflush(fd, TCIOFLUSH);
-        return error_type;
+        tcflush(PortFD, TCIOFLUSH);
+        reply.error_or_fail = error_type;
+        return reply;
     }
 
-    if (sscanf(data, "%lf", value) != 1) {
-        LOG_WARN("Invalid response, check connection");
-        LOG_DEBUG("Flushing connection");
-        tcflush(fd, TCIOFLUSH);
-        return RES_ERR_FORMAT; //-1001, so as not to conflict with TTY_RESPONSE;
+    reply.error_or_fail = nbytes_read;
+    return reply;
+}
+
+/*********************************************************************
+ * Send command to OCS without checking (intended non-existent) return
+ * *******************************************************************/
+bool OCS::sendOCSCommandBlind(const char *cmd, CommandPriority priority)
+{
+    CommandReply reply = queueCommand(cmd, RESPONSE_NONE, priority).get();
+    return reply.error_or_fail >= 0; //Fail if we can't write
+}
+
+/*********************************************************************
+ * Send command to OCS that expects a 0 (sucess) or 1 (failure) return
+ * *******************************************************************/
+bool OCS::sendOCSCommand(const char *cmd, CommandPriority priority)
+{
+    CommandReply reply = queueCommand(cmd, RESPONSE_CHAR, priority).get();
+
+    if (reply.error_or_fail < 1) {
+        LOG_WARN("Timeout/Error on response. Check connection.");
+        return false;
     }
 
-    return nbytes_read;
+    return (reply.data[0] == '1'); //OCS uses 1 for success and non zero for failure, in *most* cases;
 }
 
-/************************************************
- * Send command to OCS that expects an int return
- * **********************************************/
-int OCS::getCommandIntResponse(int fd, int *value, char *data, const char *cmd)
+/************************************************************
+ * Send command to OCS that expects a single character return
+ * **********************************************************/
+int OCS::getCommandSingleCharResponse(int fd, char *data, const char *cmd, CommandPriority priority)
 {
-    blockUntilClear();
+    INDI_UNUSED(fd);
 
-    char *term;
-    int error_type;
-    int nbytes_write = 0, nbytes_read = 0;
+    CommandReply reply = queueCommand(cmd, RESPONSE_CHAR, priority).get();
+    memcpy(data, reply.data, RB_MAX_LEN);
 
-    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
+    return reply.error_or_fail;
+}
 
-    flushIO(fd);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
-    tcflush(fd, TCIFLUSH);
+/**************************************************
+ * Send command to OCS that expects a double return
+ * ************************************************/
+int OCS::getCommandDoubleResponse(int fd, double *value, char *data, const char *cmd, CommandPriority priority)
+{
+    INDI_UNUSED(fd);
 
-    if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
-        return error_type;
+    CommandReply reply = queueCommand(cmd, RESPONSE_STRING, priority).get();
+    memcpy(data, reply.data, RB_MAX_LEN);
 
-    error_type = tty_read_expanded(fd, data, sizeof(char), OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
-    tcflush(fd, TCIFLUSH);
+    if (reply.error_or_fail < 0)
+        return reply.error_or_fail;
 
-    term = strchr(data, '#');
-    if (term)
-        *term = '\0';
-    if (nbytes_read < RB_MAX_LEN) { //If within buffer, terminate string with \0 (in case it didn't find the #)
-        data[nbytes_read] = '\0'; //Indexed at 0, so this is the byte passed it
-    } else {
-        LOG_DEBUG("got RB_MAX_LEN bytes back, last byte set to null and possible overflow");
-        data[RB_MAX_LEN - 1] = '\0';
+    if (sscanf(data, "%lf", value) != 1) {
+        LOG_WARN("Invalid response, check connection");
+        return RES_ERR_FORMAT; //-1001, so as not to conflict with TTY_RESPONSE;
     }
 
-    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", data);
-    //waitingForResponse = false;
-    clearBlock();
+    return reply.error_or_fail;
+}
+
+/************************************************
+ * Send command to OCS that expects an int return
+ * **********************************************/
+int OCS::getCommandIntResponse(int fd, int *value, char *data, const char *cmd, CommandPriority priority)
+{
+    INDI_UNUSED(fd);
+
+    CommandReply reply = queueCommand(cmd, RESPONSE_CHAR, priority).get();
+    memcpy(data, reply.data, RB_MAX_LEN);
+
+    if (reply.error_or_fail < 0)
+        return reply.error_or_fail;
 
-    if (error_type != TTY_OK) {
-        LOGF_DEBUG("Error %d", error_type);
-        LOG_DEBUG("Flushing connection");
-        tcflush(fd, TCIOFLUSH);
-        return error_type;
-    }
     if (sscanf(data, "%i", value) != 1) {
         LOG_WARN("Invalid response, check connection");
-        LOG_DEBUG("Flushing connection");
-        tcflush(fd, TCIOFLUSH);
         return RES_ERR_FORMAT; //-1001, so as not to conflict with TTY_RESPONSE;
     }
 
-    return nbytes_read;
+    return reply.error_or_fail;
 }
 
 /***************************************************************************
  * Send command to OCS that expects a char[] return (could be a single char)
  * *************************************************************************/
-int OCS::getCommandSingleCharErrorOrLongResponse(int fd, char *data, const char *cmd)
+int OCS::getCommandSingleCharErrorOrLongResponse(int fd, char *data, const char *cmd, CommandPriority priority)
 {
-    blockUntilClear();
+    INDI_UNUSED(fd);
 
-    char *term;
-    int error_type;
-    int nbytes_write = 0, nbytes_read = 0;
-
-    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", cmd);
+    CommandReply reply = queueCommand(cmd, RESPONSE_STRING, priority).get();
+    memcpy(data, reply.data, RB_MAX_LEN);
 
-    flushIO(fd);
-    /* Add mutex */
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
-    tcflush(fd, TCIFLUSH);
-
-    if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
-        return error_type;
-
-    error_type = tty_read_section_expanded(fd, data, '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
-    tcflush(fd, TCIFLUSH);
-
-    term = strchr(data, '#');
-    if (term)
-        *term = '\0';
-    if (nbytes_read < RB_MAX_LEN) { //If within buffer, terminate string with \0 (in case it didn't find the #)
-        data[nbytes_read] = '\0'; //Indexed at 0, so this is the byte passed it
-    } else {
-        LOG_DEBUG("got RB_MAX_LEN bytes back, last byte set to null and possible overflow");
-        data[RB_MAX_LEN - 1] = '\0';
-    }
-
-    DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", data);
-    //waitingForResponse = false;
-    clearBlock();
-
-    if (error_type != TTY_OK) {
-        LOGF_DEBUG("Error %d", error_type);
-        return error_type;
-    }
-
-    return nbytes_read;
+    return reply.error_or_fail;
 }
 
 /********************************************************
  * Converts an OCS char[] return of a numeric into an int
  * ******************************************************/
-int OCS::getCommandIntFromCharResponse(int fd, char *data, int *response, const char *cmd)
+int OCS::getCommandIntFromCharResponse(int fd, char *data, int *response, const char *cmd, CommandPriority priority)
 {
-    int errorOrFail = getCommandSingleCharErrorOrLongResponse(fd, data, cmd);
+    int errorOrFail = getCommandSingleCharErrorOrLongResponse(fd, data, cmd, priority);
     if (errorOrFail < 1) {
-        waitingForResponse = false;
         return errorOrFail;
     } else {
-        int value = conversion_error;
-        try {
-            value = std::stoi(data);
-        } catch (const std::invalid_argument&) {
-            LOGF_WARN("Invalid response to %s: %s", cmd, data);
-        } catch (const std::out_of_range&) {
+        *response = charToInt(data);
+        if (*response == conversion_error) {
             LOGF_WARN("Invalid response to %s: %s", cmd, data);
         }
-        *response = value;
         return errorOrFail;
     }
 }
 
+/******************************************************************
+ * Return the last polled reply of a telemetry command. The command
+ * is registered and read synchronously on first use, after that the
+ * command thread refreshes it every interval_ms.
+ * ****************************************************************/
+int OCS::getPolledResponse(char *data, const char *cmd, int interval_ms, CommandPriority priority)
+{
+    {
+        std::lock_guard<std::mutex> guard(command_lock);
+        auto item = polled_items.find(cmd);
+        if (item != polled_items.end()) {
+            item->second.interval = std::chrono::milliseconds(interval_ms);
+            memcpy(data, item->second.reply.data, RB_MAX_LEN);
+            return item->second.reply.error_or_fail;
+        }
+    }
+
+    CommandReply reply = queueCommand(cmd, RESPONSE_STRING, priority).get();
+    memcpy(data, reply.data, RB_MAX_LEN);
+
+    std::lock_guard<std::mutex> guard(command_lock);
+    if (!command_thread_quit && command_thread.joinable()) {
+        PolledItem item;
+        item.type = RESPONSE_STRING;
+        item.priority = priority;
+        item.interval = std::chrono::milliseconds(interval_ms);
+        item.next_update = std::chrono::steady_clock::now() + item.interval;
+        item.reply = reply;
+        polled_items.emplace(cmd, item);
+    }
+
+    return reply.error_or_fail;
+}
+
+/********************************************
+ * Polled telemetry that is a double return
+ * ******************************************/
+int OCS::getPolledDoubleResponse(double *value, char *data, const char *cmd, int interval_ms, CommandPriority priority)
+{
+    int errorOrFail = getPolledResponse(data, cmd, interval_ms, priority);
+    if (errorOrFail < 0)
+        return errorOrFail;
+
+    if (sscanf(data, "%lf", value) != 1) {
+        LOGF_DEBUG("Invalid response to %s: %s", cmd, data);
+        return RES_ERR_FORMAT; //-1001, so as not to conflict with TTY_RESPONSE;
+    }
+
+    return errorOrFail;
+}
 
 /**********************
  * Flush the comms port
  * ********************/
 int OCS::flushIO(int fd)
 {
-    tcflush(fd, TCIOFLUSH);
     int error_type = 0;
     int nbytes_read;
-    std::unique_lock<std::mutex> guard(ocsCommsLock);
     tcflush(fd, TCIOFLUSH);
     do {
         char discard_data[RB_MAX_LEN] = {0};
@@ -2474,35 +2559,12 @@ int OCS::flushIO(int fd)
     return 0;
 }
 
-int OCS::charToInt (char *inString)
-{
-    int value = conversion_error;
-    try {
-        value = std::stoi(inString);
-    } catch (const std::invalid_argument&) {
-    } catch (const std::out_of_range&) {
-    }
-    return value;
-}
-
-/*******************************************************
- * Block outgoing command until previous return is clear
- * *****************************************************/
-void OCS::blockUntilClear()
-{
-    // Blocking wait for last command response to clear
-    while (waitingForResponse) {
-        usleep(((OCSTimeoutSeconds * 1000000) + OCSTimeoutMicroSeconds) / 10);
-//        usleep(OCSTimeoutMicroSeconds / 10);
-    }
-    // Grab the response waiting command blocker
-    waitingForResponse = true;
-}
-
-/*********************************************
- * Flush port and clear command sequence block
- * *******************************************/
-void OCS::clearBlock()
+int OCS::charToInt(const char *inString)
 {
-    waitingForResponse = false;
+    char *end = nullptr;
+    errno = 0;
+    long value = strtol(inString, &end, 10);
+    if (end == inString || errno == ERANGE || value < INT_MIN || value > INT_MAX)
+        return conversion_error;
+    return static_cast<int>(value);
 }
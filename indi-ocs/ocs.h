@@ -25,6 +25,15 @@
 #include "indipropertyswitch.h"
 #include "inditimer.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #define RB_MAX_LEN 64
 #define CMD_MAX_LEN 32
 enum ResponseErrors {RES_ERR_FORMAT = -1001};
@@ -416,7 +425,7 @@ class OCS : public INDI::Dome, public INDI::WeatherInterface
 {
   public:
     OCS();
-    virtual ~OCS() override = default;
+    virtual ~OCS() override;
     const char *getDefaultName() override;
     virtual bool initProperties() override;
     virtual void ISGetProperties(const char *dev) override;
@@ -437,18 +446,49 @@ class OCS : public INDI::Dome, public INDI::WeatherInterface
     void SlowTimerHit();
     virtual IPState updateWeather() override;
 
-    bool sendOCSCommand(const char *cmd);
-    bool sendOCSCommandBlind(const char *cmd);
+    // Command queue priorities, lower values are sent first
+    enum CommandPriority
+    {
+        PRIORITY_CONTROL,   // Client commands: roof, dome, safety, power...
+        PRIORITY_STATUS,    // Roof and dome status polling
+        PRIORITY_TELEMETRY, // Weather, thermostat, power and lights polling
+        PRIORITY_COUNT
+    };
+
+    enum ResponseType
+    {
+        RESPONSE_NONE,      // Blind command
+        RESPONSE_CHAR,      // Single character
+        RESPONSE_STRING     // # terminated string
+    };
+
+    struct CommandReply
+    {
+        int error_or_fail = 0; // Bytes read, or a negative tty error
+        char data[RB_MAX_LEN] = {0};
+    };
+
+    std::future<CommandReply> queueCommand(const char *cmd, ResponseType type, CommandPriority priority);
+
+    bool sendOCSCommand(const char *cmd, CommandPriority priority = PRIORITY_CONTROL);
+    bool sendOCSCommandBlind(const char *cmd, CommandPriority priority = PRIORITY_CONTROL);
     int flushIO(int fd);
-    int getCommandSingleCharResponse(int fd, char *data, const char *cmd); //Reimplemented from getCommandString
-    int getCommandSingleCharErrorOrLongResponse(int fd, char *data, const char *cmd); //Reimplemented from getCommandString
-    int getCommandDoubleResponse(int fd, double *value, char *data,
-                                 const char *cmd); //Reimplemented from getCommandString Will return a double, and raw value.
-    int getCommandIntResponse(int fd, int *value, char *data, const char *cmd);
-    int getCommandIntFromCharResponse(int fd, char *data, int *response, const char *cmd); //Calls getCommandSingleCharErrorOrLongResponse with conversion of return
-    int charToInt(char *inString);
-    void blockUntilClear();
-    void clearBlock();
+    int getCommandSingleCharResponse(int fd, char *data, const char *cmd,
+                                     CommandPriority priority = PRIORITY_CONTROL); //Reimplemented from getCommandString
+    int getCommandSingleCharErrorOrLongResponse(int fd, char *data, const char *cmd,
+                                                CommandPriority priority = PRIORITY_CONTROL); //Reimplemented from getCommandString
+    int getCommandDoubleResponse(int fd, double *value, char *data, const char *cmd,
+                                 CommandPriority priority = PRIORITY_CONTROL); //Reimplemented from getCommandString Will return a double, and raw value.
+    int getCommandIntResponse(int fd, int *value, char *data, const char *cmd,
+                              CommandPriority priority = PRIORITY_CONTROL);
+    int getCommandIntFromCharResponse(int fd, char *data, int *response, const char *cmd,
+                                      CommandPriority priority = PRIORITY_CONTROL); //Calls getCommandSingleCharErrorOrLongResponse with conversion of return
+    int charToInt(const char *inString);
+
+    // Polled telemetry, refreshed by the command thread while no commands are queued
+    int getPolledResponse(char *data, const char *cmd, int interval_ms, CommandPriority priority = PRIORITY_TELEMETRY);
+    int getPolledDoubleResponse(double *value, char *data, const char *cmd, int interval_ms,
+                                CommandPriority priority = PRIORITY_TELEMETRY);
 
     long int OCSTimeoutSeconds = 0;
     long int OCSTimeoutMicroSeconds = 100000;
@@ -463,9 +503,36 @@ private:
 
     // Timer for slow updates, once per minute
     INDI::Timer SlowTimer;
+    const int slow_update_period_ms = 60000;
+
+    // Command thread, the only place the port is accessed once connected
+    struct CommandRequest
+    {
+        std::string command;
+        ResponseType type;
+        std::promise<CommandReply> reply;
+    };
+
+    struct PolledItem
+    {
+        ResponseType type;
+        CommandPriority priority;
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point next_update;
+        CommandReply reply;
+    };
 
-    // Command sequence enforcement
-    bool waitingForResponse = false;
+    void startCommandThread();
+    void stopCommandThread();
+    void commandLoop();
+    CommandReply transact(const char *cmd, ResponseType type);
+
+    std::thread command_thread;
+    std::mutex command_lock;
+    std::condition_variable command_cv;
+    bool command_thread_quit = false;
+    std::deque<CommandRequest> command_queue[PRIORITY_COUNT];
+    std::map<std::string, PolledItem> polled_items;
 
     // Roof/Shutter control
     //---------------------
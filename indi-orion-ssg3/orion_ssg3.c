@@ -23,6 +23,7 @@
 #include <inttypes.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "orion_ssg3.h"
 #ifdef __APPLE__
 #include <libkern/OSByteOrder.h>
@@ -31,11 +32,20 @@
 #else
 #include <endian.h>
 #endif /* __APPLE__ */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #define ORION_SSG3_VID 0x07ee
 #define ORION_SSG3_PID 0x0502
 #define ORION_SSG3_INTERFACE_NUM 0
 #define ORION_SSG3_BULK_EP 0x82
+#define ORION_SSG3_BULK_PACKET 512
+#define ORION_SSG3_XFER_SIZE (64 * 1024)
+#define ORION_SSG3_XFER_TIMEOUT 5000
+#define ORION_SSG3_XFER_RETRIES 10
 
 /* These are the defaults that Orion Camera Studio sets */
 #define ORION_SSG3_DEFAULT_OFFSET 127
@@ -205,6 +215,8 @@ int orion_ssg3_open(struct orion_ssg3 *ssg3, struct orion_ssg3_info *info)
     ssg3->x_count = ICX419_EFFECTIVE_X_COUNT;
     ssg3->y1 = ICX419_EFFECTIVE_Y_START;
     ssg3->y_count = ICX419_EFFECTIVE_Y_COUNT;
+    memset(ssg3->xfer, 0, sizeof(ssg3->xfer));
+    memset(ssg3->xfer_buf, 0, sizeof(ssg3->xfer_buf));
 
 	rc = libusb_open(info->dev, &ssg3->devh);
 	if (rc) {
@@ -231,6 +243,15 @@ int orion_ssg3_open(struct orion_ssg3 *ssg3, struct orion_ssg3_info *info)
  */
 int orion_ssg3_close(struct orion_ssg3 *ssg3)
 {
+    int i;
+
+    for (i = 0; i < ORION_SSG3_XFER_COUNT; i++) {
+        libusb_free_transfer(ssg3->xfer[i]);
+        free(ssg3->xfer_buf[i]);
+        ssg3->xfer[i] = NULL;
+        ssg3->xfer_buf[i] = NULL;
+    }
+
     if (ssg3->devh) {
         libusb_release_interface(ssg3->devh, ORION_SSG3_INTERFACE_NUM);
 	    libusb_close(ssg3->devh);
@@ -407,9 +428,9 @@ int orion_ssg3_start_exposure(struct orion_ssg3 *ssg3, uint32_t msec)
         }
         ssg3->exp_done_time.tv_sec += msec / 1000;
         ssg3->exp_done_time.tv_usec += (msec % 1000) * 1000; 
-        if (ssg3->exp_done_time.tv_usec > 1000000) {
+        if (ssg3->exp_done_time.tv_usec >= 1000000) {
             ssg3->exp_done_time.tv_sec++;
-            ssg3->exp_done_time.tv_sec -= 1000000;
+            ssg3->exp_done_time.tv_usec -= 1000000;
         }
     }
 
@@ -455,73 +476,231 @@ int orion_ssg3_subframe(struct orion_ssg3 *ssg3, uint16_t x1, uint16_t x_count,
     return rc;
 }
 
+/* State of a frame download, shared with the transfer callbacks */
+struct ssg3_download {
+    struct orion_ssg3 *ssg3;
+    uint16_t *frame;
+    int x_count;
+    int line_sz;
+    int even_lines; /* Number of lines in the even field */
+    long needed;    /* Bytes in the frame */
+    long received;  /* Bytes placed in the frame so far */
+    long pending;   /* Bytes requested by the transfers in flight */
+    int busy[ORION_SSG3_XFER_COUNT];
+    int in_flight;
+    int fail_cnt;
+    int error;
+};
+
+/**
+ * Copy big-endian 16-bit pixels to host order
+ * @param dst: Destination, host order
+ * @param src: Source, big-endian
+ * @param bytes: Number of bytes to copy, always even
+ */
+static void swap16(uint8_t *dst, const uint8_t *src, int bytes)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, vrev16q_u8(vld1q_u8(src + i)));
+    }
+#endif
+    for (; i + 1 < bytes; i += 2) {
+        uint16_t v;
+        memcpy(&v, src + i, 2);
+        v = be16toh(v);
+        memcpy(dst + i, &v, 2);
+    }
+}
+
+/**
+ * Place downloaded data in the frame.
+ * The SSG3 has an interlace CCD, so the horizontal lines don't come out in order. Instead,
+ * they are split into an even and odd field. We get the even lines first and then the odd
+ * lines, so each downloaded line is written straight to its row in the frame.
+ */
+static void download_place(struct ssg3_download *dl, const uint8_t *data, int len)
+{
+    while (len > 0 && dl->received < dl->needed) {
+        int line = dl->received / dl->line_sz;
+        int off = dl->received % dl->line_sz;
+        int n = dl->line_sz - off;
+        int y;
+
+        if (n > len) {
+            n = len;
+        }
+        if (line < dl->even_lines) {
+            y = line * 2;
+        } else {
+            y = (line - dl->even_lines) * 2 + 1;
+        }
+
+        swap16((uint8_t *) &dl->frame[y * dl->x_count] + off, data, n);
+        dl->received += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void LIBUSB_CALL download_cb(struct libusb_transfer *xfer);
+
+/**
+ * Keep the idle transfers busy with requests for the rest of the frame.
+ * Requests are multiples of the bulk packet size so the camera may send several lines
+ * in one transfer, a short packet completes it early.
+ */
+static void download_submit(struct ssg3_download *dl)
+{
+    int i;
+    int rc;
+
+    for (i = 0; i < ORION_SSG3_XFER_COUNT && !dl->error; i++) {
+        long len = dl->needed - dl->received - dl->pending;
+
+        if (len <= 0) {
+            break;
+        }
+        if (dl->busy[i]) {
+            continue;
+        }
+        len = (len + ORION_SSG3_BULK_PACKET - 1) / ORION_SSG3_BULK_PACKET * ORION_SSG3_BULK_PACKET;
+        if (len > ORION_SSG3_XFER_SIZE) {
+            len = ORION_SSG3_XFER_SIZE;
+        }
+
+        libusb_fill_bulk_transfer(dl->ssg3->xfer[i], dl->ssg3->devh, ORION_SSG3_BULK_EP,
+                dl->ssg3->xfer_buf[i], len, download_cb, dl, ORION_SSG3_XFER_TIMEOUT);
+        rc = libusb_submit_transfer(dl->ssg3->xfer[i]);
+        if (rc) {
+            dl->error = -libusb_to_errno(rc);
+            break;
+        }
+        dl->busy[i] = 1;
+        dl->in_flight++;
+        dl->pending += len;
+    }
+}
+
+static void LIBUSB_CALL download_cb(struct libusb_transfer *xfer)
+{
+    struct ssg3_download *dl = xfer->user_data;
+    int i;
+
+    for (i = 0; i < ORION_SSG3_XFER_COUNT; i++) {
+        if (dl->ssg3->xfer[i] == xfer) {
+            dl->busy[i] = 0;
+        }
+    }
+    dl->in_flight--;
+    dl->pending -= xfer->length;
+
+    switch (xfer->status) {
+    case LIBUSB_TRANSFER_COMPLETED:
+    case LIBUSB_TRANSFER_TIMED_OUT:
+        if (xfer->actual_length > 0) {
+            download_place(dl, xfer->buffer, xfer->actual_length);
+            dl->fail_cnt = 0;
+        } else if (++dl->fail_cnt >= ORION_SSG3_XFER_RETRIES) {
+            dl->error = -ETIMEDOUT;
+        }
+        break;
+    case LIBUSB_TRANSFER_CANCELLED:
+        break;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+        dl->error = -ENODEV;
+        break;
+    default:
+        if (++dl->fail_cnt >= ORION_SSG3_XFER_RETRIES) {
+            dl->error = -EIO;
+        }
+        break;
+    }
+
+    if (!dl->error) {
+        download_submit(dl);
+    }
+}
+
 /**
  * Download an image
+ * Several bulk transfers are kept in flight and every line is written, in host order,
+ * straight to its de-interlaced row in buf, so no intermediate frame is needed.
  * @param ssg3: The ssg3 structure used to communicate with the camera
  * @param buf: The buffer to store the frame in
  * @param len: The number of bytes available in buf
+ * @return: 0 on success, -errno on failure
  */
 int orion_ssg3_image_download(struct orion_ssg3 *ssg3, uint8_t *buf, int len)
 {
-    int line_sz;
-    int got;
-    uint16_t *tmp;
-    int x, y;
-    uint16_t *frame;
-    int rc = 0;
+    struct ssg3_download dl;
+    struct timeval tv;
+    int cancelled = 0;
     int i;
-    int fail_cnt;
-    int needed;
-    int total;
 
-    frame = (uint16_t *) buf;
-    
-    needed = ssg3->x_count * ssg3->y_count * 2; /* 2 bytes/pixel */
-    if (needed < len) {
+    memset(&dl, 0, sizeof(dl));
+    dl.ssg3 = ssg3;
+    dl.frame = (uint16_t *) buf;
+    dl.x_count = ssg3->x_count;
+    dl.line_sz = ssg3->x_count * 2; /* 2 bytes/pixel */
+    dl.even_lines = (ssg3->y_count + 1) / 2;
+    dl.needed = (long) dl.line_sz * ssg3->y_count;
+    if (len < dl.needed) {
         return -ENOSPC;
     }
 
-    tmp = malloc(needed);
-    if (!tmp) {
-        return -ENOMEM;
-    }
-
-    line_sz = ssg3->x_count * 2; /* 2 bytes/pixel */
-
-    for (i = 0, fail_cnt = 0, total = 0; i < ssg3->y_count && fail_cnt < 10;) {
-        rc = libusb_bulk_transfer(ssg3->devh, ORION_SSG3_BULK_EP, &(((unsigned char *) tmp)[i * line_sz]), line_sz, &got, 5000);
-        if (!rc) {
-            total += got;
-            i++;
-            fail_cnt = 0;
-        } else {
-            fail_cnt++;
+    /* Transfers are allocated once and reused for every frame */
+    for (i = 0; i < ORION_SSG3_XFER_COUNT; i++) {
+        if (!ssg3->xfer[i]) {
+            ssg3->xfer[i] = libusb_alloc_transfer(0);
+        }
+        if (!ssg3->xfer_buf[i]) {
+            ssg3->xfer_buf[i] = malloc(ORION_SSG3_XFER_SIZE);
+        }
+        if (!ssg3->xfer[i] || !ssg3->xfer_buf[i]) {
+            return -ENOMEM;
         }
     }
 
-    fprintf(stderr, "needed = %d, total = %d, len = %d\n", needed, total, len);
+    download_submit(&dl);
 
-    /* The SSG3 has an interlace CCD, so the horizontal lines don't come out in order. Instead,
-       they are split into an even and odd field. We get the even lines first and then the odd
-       lines. This loop below de-interlaces the image to put the lines in the correct order
-       in the frame buffer. */
-    for (y = 0; y < ssg3->y_count; y++) {
-        int download_y; /* The y line in the download buffer */
-        if (y % 2 == 0) {
-            download_y = (y / 2);
-        } else {
-            download_y = (ssg3->y_count / 2) + (y / 2);
+    while (dl.in_flight > 0) {
+        /* Requests may outnumber the data left when the camera ends each line
+           with a short packet, drop them once the frame is complete */
+        if ((dl.error || dl.received >= dl.needed) && !cancelled) {
+            for (i = 0; i < ORION_SSG3_XFER_COUNT; i++) {
+                if (dl.busy[i]) {
+                    libusb_cancel_transfer(ssg3->xfer[i]);
+                }
+            }
+            cancelled = 1;
         }
 
-        for (x = 0; x < ssg3->x_count; x++) {
-            /* The raw pixel data is sent big-endian */
-            frame[x + y * ssg3->x_count] = be16toh(tmp[x + download_y * ssg3->x_count]);
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+        libusb_handle_events_timeout_completed(NULL, &tv, NULL);
+
+        /* All transfers came back short, ask for the rest of the frame */
+        if (!dl.in_flight && !dl.error && dl.received < dl.needed) {
+            download_submit(&dl);
         }
     }
 
-    free(tmp);
+    if (!dl.error && dl.received < dl.needed) {
+        dl.error = -EIO;
+    }
+    if (dl.error) {
+        fprintf(stderr, "needed = %ld, total = %ld, len = %d\n", dl.needed, dl.received, len);
+    }
 
-    return rc;
+    return dl.error;
 }
 
 int orion_ssg3_get_gain(struct orion_ssg3 *ssg3, uint8_t *gain)
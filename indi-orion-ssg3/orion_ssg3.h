@@ -24,6 +24,9 @@
 #include <libusb.h>
 #include <stdbool.h>
 
+/* Number of bulk transfers kept in flight while downloading a frame */
+#define ORION_SSG3_XFER_COUNT 4
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -52,6 +55,8 @@ struct orion_ssg3 {
     uint16_t y1;
     uint16_t y_count;
     struct timeval exp_done_time;
+    struct libusb_transfer *xfer[ORION_SSG3_XFER_COUNT];
+    uint8_t *xfer_buf[ORION_SSG3_XFER_COUNT];
 };
 
 enum {
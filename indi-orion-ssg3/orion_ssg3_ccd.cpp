@@ -26,6 +26,7 @@
 #include "orion_ssg3_ccd.h"
 #include "orion_ssg3.h"
 #include "config.h"
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <unistd.h>
@@ -94,6 +95,7 @@ bool SSG3CCD::Connect()
     //cap |= CCD_CAN_SUBFRAME;
     cap |= CCD_HAS_COOLER;
     cap |= CCD_HAS_ST4_PORT;
+    cap |= CCD_HAS_STREAMING;
     /* FIXME: kfitsviewer doesn't support CMYG
     if (ssg3.model->color) {
         IUSaveText(&BayerT[0], "0");
@@ -114,6 +116,8 @@ bool SSG3CCD::Connect()
  */
 bool SSG3CCD::Disconnect()
 {
+    mWorker.quit();
+    Streamer->setStream(false);
     TemperatureTimer.stop();
     saveConfig(true);
     orion_ssg3_close(&ssg3);
@@ -217,6 +221,9 @@ void SSG3CCD::setupParams()
 
     /* calculate how much memory we need for the primary CCD buffer */
     PrimaryCCD.setFrameBufferSize(PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * PrimaryCCD.getBPP() / 8);
+
+    Streamer->setPixelFormat(INDI_MONO, 16);
+    Streamer->setSize(orion_ssg3_get_image_width(&ssg3), orion_ssg3_get_image_height(&ssg3));
 }
 
 /*******************************************************************************
@@ -226,10 +233,17 @@ bool SSG3CCD::UpdateCCDBin(int x, int y)
 {
     int rc;
 
+    if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot change binning while streaming/recording.");
+        return false;
+    }
+
     rc = orion_ssg3_set_binning(&ssg3, x, y);
     if (!rc)
     {
         PrimaryCCD.setBin(x, y);
+        Streamer->setSize(orion_ssg3_get_image_width(&ssg3), orion_ssg3_get_image_height(&ssg3));
         return true;
     }
     return false;
@@ -244,6 +258,12 @@ bool SSG3CCD::StartExposure(float duration)
 {
     int rc;
 
+    if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot take exposure while streaming/recording.");
+        return false;
+    }
+
     ExposureRequest = duration;
 
     rc = orion_ssg3_start_exposure(&ssg3, duration * 1000);
@@ -427,6 +447,67 @@ void SSG3CCD::grabImage()
     ExposureComplete(&PrimaryCCD);
 }
 
+/**
+ * Start streaming, used by guiders to loop short exposures without the
+ * per frame overhead of a regular exposure.
+ */
+bool SSG3CCD::StartStreaming()
+{
+    mWorker.start(std::bind(&SSG3CCD::workerStreamVideo, this, std::placeholders::_1));
+    return true;
+}
+
+bool SSG3CCD::StopStreaming()
+{
+    mWorker.quit();
+    return true;
+}
+
+/**
+ * Streaming loop: the camera has no video mode, so exposures are started
+ * back to back and each frame is downloaded straight into the frame buffer.
+ */
+void SSG3CCD::workerStreamVideo(const std::atomic_bool &isAbortToQuit)
+{
+    uint32_t msec = std::max(1.0, 1000.0 / Streamer->getTargetFPS());
+    uint8_t *image = PrimaryCCD.getFrameBuffer();
+    int sz = PrimaryCCD.getFrameBufferSize();
+    int rc;
+
+    while (!isAbortToQuit)
+    {
+        rc = orion_ssg3_start_exposure(&ssg3, msec);
+        if (rc)
+        {
+            LOGF_ERROR("Failed to start video exposure: %s", strerror(-rc));
+            Streamer->setStream(false);
+            break;
+        }
+
+        while (!isAbortToQuit && !orion_ssg3_exposure_done(&ssg3))
+        {
+            usleep(1000);
+        }
+        if (isAbortToQuit)
+        {
+            break;
+        }
+
+        {
+            std::unique_lock<std::mutex> guard(ccdBufferLock);
+            rc = orion_ssg3_image_download(&ssg3, image, sz);
+        }
+        if (rc)
+        {
+            LOGF_ERROR("Failed to read video data: %s", strerror(-rc));
+            Streamer->setStream(false);
+            break;
+        }
+
+        Streamer->newFrame(image, orion_ssg3_get_image_width(&ssg3) * orion_ssg3_get_image_height(&ssg3) * 2);
+    }
+}
+
 #define TEMP_THRESHOLD 0.25
 /**
  * Set the CCD temperature
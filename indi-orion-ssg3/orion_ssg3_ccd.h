@@ -25,6 +25,7 @@
 #include <indipropertynumber.h>
 #include <indipropertyswitch.h>
 #include <indielapsedtimer.h>
+#include <indisinglethreadpool.h>
 #include "orion_ssg3.h"
 
 namespace SSG3
@@ -54,6 +55,9 @@ class SSG3CCD : public INDI::CCD
     virtual bool AbortExposure() override;
     virtual void TimerHit() override;
     virtual int SetTemperature(double temperature) override;
+    // Streaming
+    virtual bool StartStreaming() override;
+    virtual bool StopStreaming() override;
     // Guide Port
     virtual IPState GuideNorth(uint32_t ms) override;
     virtual IPState GuideSouth(uint32_t ms) override;
@@ -69,6 +73,7 @@ class SSG3CCD : public INDI::CCD
     // Utility functions
     void setupParams();
     void grabImage();
+    void workerStreamVideo(const std::atomic_bool &isAbortToQuit);
     bool activateCooler(bool enable);
     void updateTemperature(void);
 
@@ -94,4 +99,5 @@ class SSG3CCD : public INDI::CCD
     INDI::Timer WETimer;
     INDI::Timer NSTimer;
     INDI::ElapsedTimer ExposureElapsedTimer;
+    INDI::SingleThreadPool mWorker;
 };
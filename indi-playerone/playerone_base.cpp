@@ -35,6 +35,10 @@
 #include <vector>
 #include <map>
 #include <unistd.h>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <errno.h>
 
 #define USE_POA_EXP     // since SDK v3.8.0: change time unit of exposure from micor second to second
 
@@ -83,17 +87,20 @@ void POABase::workerStreamVideo(const std::atomic_bool &isAbortToQuit)
 
     while (!isAbortToQuit)
     {
-        POABool pIsReady = POA_FALSE;
-        while (pIsReady == POA_FALSE)
         {
-            //if (isAbortToQuit) //Triggered by external conditions
-            //    break;
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+            POABool pIsReady = POA_FALSE;
+            while (pIsReady == POA_FALSE)
+            {
+                //if (isAbortToQuit) //Triggered by external conditions
+                //    break;
 
-            //usleep(ExposureRequest / 10);
-            POAImageReady(mCameraInfo.cameraID, &pIsReady);
-        }
+                //usleep(ExposureRequest / 10);
+                POAImageReady(mCameraInfo.cameraID, &pIsReady);
+            }
 
-        ret = POAGetImageData(mCameraInfo.cameraID, targetFrame, totalBytes, waitMS);
+            ret = POAGetImageData(mCameraInfo.cameraID, targetFrame, totalBytes, waitMS);
+        }
         if (ret != POA_OK)
         {
             if (ret != POA_ERROR_TIMEOUT)
@@ -108,10 +115,18 @@ void POABase::workerStreamVideo(const std::atomic_bool &isAbortToQuit)
         }
 
         if (mCurrentVideoFormat == POA_RGB24)
+        {
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
             for (uint32_t i = 0; i < totalBytes; i += 3)
                 std::swap(targetFrame[i], targetFrame[i + 2]);
+        }
+
+        {
+            FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+            Streamer->newFrame(targetFrame, totalBytes);
+        }
 
-        Streamer->newFrame(targetFrame, totalBytes);
+        mFrameTimingProperties.frameDone();
     }
 
     // stop video capture
@@ -366,6 +381,8 @@ bool POABase::initProperties()
     FlipSP[FLIP_VERTICAL].fill("FLIP_VERTICAL", "Vertical", ISS_OFF);
     FlipSP.fill(getDeviceName(), "FLIP", "Flip", CONTROL_TAB, IP_RW, ISR_NOFMANY, 60, IPS_IDLE);
 
+    mFrameTimingProperties.initProperties(this);
+
     VideoFormatSP.fill(getDeviceName(), "CCD_VIDEO_FORMAT", "Format", CONTROL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
 
     BlinkNP[BLINK_COUNT   ].fill("BLINK_COUNT",    "Blinks before exposure", "%2.0f", 0, 100, 1.000, 0);
@@ -494,6 +511,7 @@ bool POABase::updateProperties()
 
         defineProperty(BlinkNP);
         defineProperty(ADCDepthNP);
+        mFrameTimingProperties.updateProperties(true);
         defineProperty(SDKVersionSP);
         if (!mSerialNumber.empty())
         {
@@ -530,6 +548,7 @@ bool POABase::updateProperties()
             deleteProperty(VideoFormatSP);
 
         deleteProperty(BlinkNP);
+        mFrameTimingProperties.updateProperties(false);
         deleteProperty(SDKVersionSP);
         if (!mSerialNumber.empty())
         {
@@ -776,6 +795,17 @@ void POABase::setupParams()
     Streamer->setSize(maxWidth, maxHeight);
 }
 
+bool POABase::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
+{
+    if (dev != nullptr && !strcmp(dev, getDeviceName()))
+    {
+        if (mFrameTimingProperties.ISNewText(name, texts, names, n))
+            return true;
+    }
+
+    return INDI::CCD::ISNewText(dev, name, texts, names, n);
+}
+
 bool POABase::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
 {
     POAErrors ret = POA_OK;
@@ -855,6 +885,9 @@ bool POABase::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
 {
     if (dev != nullptr && !strcmp(dev, getDeviceName()))
     {
+        if (mFrameTimingProperties.ISNewSwitch(name, states, names, n))
+            return true;
+
         if (ControlSP.isNameMatch(name))
         {
             if (ControlSP.update(states, names, n) == false)
@@ -1240,7 +1273,11 @@ int POABase::grabImage(float duration)
 
     POAImgFormat type = getImageType();
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    std::unique_lock<std::mutex> guard(ccdBufferLock, std::defer_lock);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_BUFFER_LOCK);
+        guard.lock();
+    }
     uint8_t *image = PrimaryCCD.getFrameBuffer();
     uint8_t *buffer = image;
 
@@ -1259,7 +1296,10 @@ int POABase::grabImage(float duration)
         }
     }
 
-    ret = POAGetImageData(mCameraInfo.cameraID, buffer, nTotalBytes, -1);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+        ret = POAGetImageData(mCameraInfo.cameraID, buffer, nTotalBytes, -1);
+    }
     if (ret != POA_OK)
     {
         LOGF_ERROR(
@@ -1273,6 +1313,7 @@ int POABase::grabImage(float duration)
 
     if (type == POA_RGB24)
     {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
         uint8_t *dstR = image;
         uint8_t *dstG = image + subW * subH;
         uint8_t *dstB = image + subW * subH * 2;
@@ -1302,7 +1343,12 @@ int POABase::grabImage(float duration)
     if (duration > VERBOSE_EXPOSURE)
         LOG_INFO("Download complete.");
 
-    ExposureComplete(&PrimaryCCD);
+    {
+        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+        ExposureComplete(&PrimaryCCD);
+    }
+
+    mFrameTimingProperties.frameDone();
     return 0;
 }
 
@@ -1677,6 +1723,7 @@ bool POABase::saveConfigItems(FILE *fp)
         SensorModeSP.save(fp);
 
     BlinkNP.save(fp);
+    mFrameTimingProperties.saveConfigItems(fp);
 
     return true;
 }
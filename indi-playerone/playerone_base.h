@@ -26,6 +26,7 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "frame_timing_properties.h"
 
 #include <vector>
 
@@ -55,6 +56,7 @@ class POABase : public INDI::CCD
     protected:
 
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+        virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
 
         // Streaming
@@ -167,6 +169,9 @@ class POABase : public INDI::CCD
             FLIP_VERTICAL
         };
 
+        FrameTiming mFrameTiming;
+        FrameTimingProperties mFrameTimingProperties {mFrameTiming};
+
         std::string mCameraName, mCameraID, mSerialNumber, mNickname;
         POACameraProperties mCameraInfo;
         uint8_t mExposureRetry {0};
@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <memory>
+#include <vector>
 #include <string.h>
 #include <math.h>
 #include <config.h>
@@ -173,7 +174,7 @@ bool IndiRpiGpio::Disconnect()
     // Close GPIO. Stop any timers
     for(int i=0; i<n_gpio_pin;i++)
     {
-        if(dev_timer[m_type[i]]) TimerChange(i, false, true);
+        if(dev_timer[m_type[i]]) StopSequence(i);
     }
     DEBUG(INDI::Logger::DBG_SESSION, "RPi GPIO disconnected successfully.");
     return true;
@@ -456,7 +457,7 @@ bool IndiRpiGpio::ISNewSwitch (const char *dev, const char *name, ISState *state
                 // See if the GPIO has changed
                 if( m_gpio_pin[i] != l_gpio_pin)
                 {
-                    if(dev_timer[m_type[i]]) TimerChange(i, false, true);   // Stop any timer
+                    if(dev_timer[m_type[i]]) StopSequence(i);   // Stop any timer
                     DEBUGF(INDI::Logger::DBG_SESSION, "%s type %s GPIO# %d timer cancelled", DeviceSP[i].label, dev_type[m_type[i]].c_str(), m_gpio_pin[i] );
                     if(dev_pwm[m_type[i]])     // Cancel the PWM on the old pin (not really needed if switched off)
                     {
@@ -509,7 +510,7 @@ bool IndiRpiGpio::ISNewSwitch (const char *dev, const char *name, ISState *state
                 {
                     if(dev_timer[m_type[i]] && !dev_timer[l_type])    // Cancel the timer
                     {
-                        TimerChange(i, false, true);                  // Stop any timer
+                        StopSequence(i);                              // Stop any timer
                         DEBUGF(INDI::Logger::DBG_SESSION, "%s type %s GPIO# %d timer cancelled", DeviceSP[i].label, dev_type[m_type[i]].c_str(), m_gpio_pin[i] );
                     }
                     if(dev_pwm[m_type[i]] && !dev_pwm[l_type])         // Cancel the PWM
@@ -569,7 +570,7 @@ bool IndiRpiGpio::ISNewSwitch (const char *dev, const char *name, ISState *state
                         }
                         else
                         {
-                            TimerChange(i, false, true);        // Stop the timer
+                            StopSequence(i);                    // Stop the timer
                             DEBUG(INDI::Logger::DBG_SESSION, "Timer Stop exposure");
                             TimerOnNP[i].s = IPS_IDLE;
                             IDSetNumber(&TimerOnNP[i], nullptr);
@@ -598,9 +599,9 @@ bool IndiRpiGpio::ISNewSwitch (const char *dev, const char *name, ISState *state
                         else
                         {
                             DEBUGF(INDI::Logger::DBG_SESSION, "%s %s GPIO# %d start timer: Duration %0.2f s Count %0.0f Delay %0.2f s", DeviceSP[i].label, dev_type[m_type[i]].c_str(), m_gpio_pin[i], TimerOnN[i][0].value, TimerOnN[i][1].value, TimerOnN[i][2].value);
-                            TimerChange(i, true);
                             TimerOnNP[i].s = IPS_BUSY;
                             IDSetNumber(&TimerOnNP[i], nullptr);
+                            StartSequence(i);
                         }
                     }
                     else
@@ -696,7 +697,7 @@ void IndiRpiGpio::TimerChange(int i, bool isInit, bool abort)
     {
     // integral duration: requires duration_cast
         auto int_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - timer_start[i]);
-        DEBUGF(INDI::Logger::DBG_SESSION, "Timer END: Port %d %s timer: Duration %d ms, Counter %d", ip, timer_isexp ? "Expose":"Delay", int_ms, timer_counter[i]);
+        DEBUGF(INDI::Logger::DBG_DEBUG, "Timer END: Port %d %s timer: Duration %d ms, Counter %d", ip, timer_isexp[i] ? "Expose":"Delay", static_cast<int>(int_ms.count()), timer_counter[i]);
     }
     if (timer_isexp[i])
     {
@@ -704,7 +705,7 @@ void IndiRpiGpio::TimerChange(int i, bool isInit, bool abort)
     }
     if(abort)
     {
-        DEBUGF(INDI::Logger::DBG_DEBUG, "Timer SEQ ABORT: Port %d %s Counter %d", ip, timer_isexp ? "Expose":"Delay", timer_counter[i]);
+        DEBUGF(INDI::Logger::DBG_DEBUG, "Timer SEQ ABORT: Port %d %s Counter %d", ip, timer_isexp[i] ? "Expose":"Delay", timer_counter[i]);
         timer_counter[i] = 0;
     }
     timer_isexp[i] =  ! timer_isexp[i];
@@ -712,12 +713,7 @@ void IndiRpiGpio::TimerChange(int i, bool isInit, bool abort)
     if (timer_counter[i] <= 0)
     {
         DEBUGF(INDI::Logger::DBG_SESSION, "Timer SEQ END: Port %d %s Counter %d", ip, timer_isexp[i] ? "Expose":"Delay", timer_counter[i]);
-        OnOffS[i][0].s = ISS_ON;
-        OnOffS[i][1].s = ISS_OFF;
-        OnOffSP[i].s = IPS_IDLE;
-        IDSetSwitch(&OnOffSP[i], nullptr);
-        TimerOnNP[i].s = IPS_IDLE;
-        IDSetNumber(&TimerOnNP[i], nullptr);
+        EndSequence(i);
         return;
     }
     uint32_t l_duration = (timer_isexp[i] ? TimerOnN[i][0].value : TimerOnN[i][2].value)*1000;
@@ -728,7 +724,7 @@ void IndiRpiGpio::TimerChange(int i, bool isInit, bool abort)
         gpio_write(m_piId, user_gpio, timer_isexp[i] ? ((ActiveS[i][0].s == ISS_ON)? PI_HIGH: PI_LOW): ((ActiveS[i][0].s == ISS_ON)? PI_LOW: PI_HIGH));
         startTimer(i, l_duration);
         timer_start[i] = std::chrono::system_clock::now();
-        DEBUGF(INDI::Logger::DBG_SESSION, "Timer START Port %d %s timer: Duration %d ms", ip, timer_isexp[i] ? "Expose":"Delay", l_duration);
+        DEBUGF(INDI::Logger::DBG_DEBUG, "Timer START Port %d %s timer: Duration %d ms", ip, timer_isexp[i] ? "Expose":"Delay", l_duration);
     }
     else
     {
@@ -738,7 +734,7 @@ void IndiRpiGpio::TimerChange(int i, bool isInit, bool abort)
         }
         else
         {
-            DEBUGF(INDI::Logger::DBG_SESSION, "Timer START Port %d %s timer: zero length duration %d ms", ip, timer_isexp[i] ? "Expose":"Delay", l_duration);
+            DEBUGF(INDI::Logger::DBG_DEBUG, "Timer START Port %d %s timer: zero length duration %d ms", ip, timer_isexp[i] ? "Expose":"Delay", l_duration);
             TimerChange(i);  // Handle a zero length delay
         }
     }
@@ -753,7 +749,141 @@ void IndiRpiGpio::TimerCallback(int i)
         return;
     }
     // Timer ended
-    DEBUGF(INDI::Logger::DBG_SESSION, "Timer callback: Timer ended for id %d", i);
-    TimerChange(i);  // Handle end of timer
+    DEBUGF(INDI::Logger::DBG_DEBUG, "Timer callback: Timer ended for id %d", i);
+    if (m_wave_port == i)
+        CheckWaveChain(i);  // Expected end of the wave chain
+    else
+        TimerChange(i);     // Handle end of timer
     return;
 }
+
+void IndiRpiGpio::EndSequence(int i)
+{
+    OnOffS[i][0].s = ISS_ON;
+    OnOffS[i][1].s = ISS_OFF;
+    OnOffSP[i].s = IPS_IDLE;
+    IDSetSwitch(&OnOffSP[i], nullptr);
+    TimerOnNP[i].s = IPS_IDLE;
+    IDSetNumber(&TimerOnNP[i], nullptr);
+}
+
+void IndiRpiGpio::StartSequence(int i)
+{
+    // Prefer a wave chain timed by pigpiod, INDI timers only if the chain is unavailable
+    if (StartWaveChain(i))
+        return;
+    TimerChange(i, true);
+}
+
+void IndiRpiGpio::StopSequence(int i)
+{
+    if (m_wave_port == i)
+    {
+        DEBUGF(INDI::Logger::DBG_DEBUG, "Wave chain ABORT: Port %d", i+1);
+        StopWaveChain();
+        EndSequence(i);
+    }
+    else
+        TimerChange(i, false, true);
+}
+
+// Append a delay of any length to a wave chain: a loop of 60 ms delays plus the remainder
+static void chainDelay(std::vector<char> &chain, uint32_t us)
+{
+    const uint32_t chunk = 60000;
+    uint32_t loops = us / chunk, rest = us % chunk;
+    if (loops > 0)
+    {
+        const char cmd[] = { (char)255, 0, (char)255, 2, (char)(chunk & 0xFF), (char)(chunk >> 8),
+                             (char)255, 1, (char)(loops & 0xFF), (char)(loops >> 8) };
+        chain.insert(chain.end(), cmd, cmd + sizeof(cmd));
+    }
+    if (rest > 0)
+    {
+        const char cmd[] = { (char)255, 2, (char)(rest & 0xFF), (char)(rest >> 8) };
+        chain.insert(chain.end(), cmd, cmd + sizeof(cmd));
+    }
+}
+
+bool IndiRpiGpio::StartWaveChain(int i)
+{
+    const int ip = i+1; // Port number
+    if (m_wave_port >= 0)
+    {
+        DEBUGF(INDI::Logger::DBG_DEBUG, "Port %d wave chain in use by port %d, using timers", ip, m_wave_port+1);
+        return false;
+    }
+
+    uint32_t exp_us = round(TimerOnN[i][0].value * 1e6);
+    uint32_t delay_us = round(TimerOnN[i][2].value * 1e6);
+    int count = TimerOnN[i][1].value;
+    if (exp_us == 0 || count < 1)
+        return false;   // TimerChange reports the invalid sequence
+
+    // One single pulse wave for each level, the chain provides all timing
+    const bool active_high = ActiveS[i][0].s == ISS_ON;
+    const uint32_t bit = 1u << m_gpio_pin[i];
+    gpioPulse_t pulse;
+    pulse.usDelay = 1;
+
+    set_mode(m_piId, m_gpio_pin[i], PI_OUTPUT);
+    wave_add_new(m_piId);
+    pulse.gpioOn = active_high ? bit : 0;
+    pulse.gpioOff = active_high ? 0 : bit;
+    wave_add_generic(m_piId, 1, &pulse);
+    m_wave_on = wave_create(m_piId);
+    pulse.gpioOn = active_high ? 0 : bit;
+    pulse.gpioOff = active_high ? bit : 0;
+    wave_add_generic(m_piId, 1, &pulse);
+    m_wave_off = wave_create(m_piId);
+
+    // Repeat count times { OFF, delay, ON, exposure } then OFF, as the timer sequence does
+    std::vector<char> chain = { (char)255, 0, (char)m_wave_off };
+    chainDelay(chain, delay_us);
+    chain.push_back(m_wave_on);
+    chainDelay(chain, exp_us);
+    const char repeat[] = { (char)255, 1, (char)(count & 0xFF), (char)(count >> 8), (char)m_wave_off };
+    chain.insert(chain.end(), repeat, repeat + sizeof(repeat));
+
+    int rc = (m_wave_on < 0 || m_wave_off < 0) ? PI_NO_WAVEFORM_ID : wave_chain(m_piId, chain.data(), chain.size());
+    if (rc != 0)
+    {
+        DEBUGF(INDI::Logger::DBG_WARNING, "Port %d wave chain failed (%d), using timers", ip, rc);
+        if (m_wave_on >= 0) wave_delete(m_piId, m_wave_on);
+        if (m_wave_off >= 0) wave_delete(m_piId, m_wave_off);
+        m_wave_on = m_wave_off = -1;
+        return false;
+    }
+
+    m_wave_port = i;
+    auto total = std::chrono::microseconds(static_cast<uint64_t>(count) * (exp_us + delay_us));
+    m_wave_end = std::chrono::steady_clock::now() + total;
+    startTimer(i, std::min<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(total).count() + 1, max_timer_ms));
+    DEBUGF(INDI::Logger::DBG_DEBUG, "Port %d wave chain started, %d bytes", ip, static_cast<int>(chain.size()));
+    return true;
+}
+
+void IndiRpiGpio::StopWaveChain()
+{
+    stopTimer(m_wave_port);
+    wave_tx_stop(m_piId);
+    wave_delete(m_piId, m_wave_on);
+    wave_delete(m_piId, m_wave_off);
+    gpio_write(m_piId, m_gpio_pin[m_wave_port], (ActiveS[m_wave_port][0].s == ISS_ON)? PI_LOW: PI_HIGH);
+    m_wave_on = m_wave_off = m_wave_port = -1;
+}
+
+void IndiRpiGpio::CheckWaveChain(int i)
+{
+    if (wave_tx_busy(m_piId) == 1)
+    {
+        // Not done yet: wait for the expected end, or poll shortly if it has passed
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(m_wave_end - std::chrono::steady_clock::now()).count();
+        startTimer(i, std::max<int64_t>(10, std::min<int64_t>(left, max_timer_ms)));
+        return;
+    }
+
+    DEBUGF(INDI::Logger::DBG_SESSION, "Timer SEQ END: Port %d Count %0.0f", i+1, TimerOnN[i][1].value);
+    StopWaveChain();
+    EndSequence(i);
+}
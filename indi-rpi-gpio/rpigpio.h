@@ -112,6 +112,18 @@ private:
     void startTimer(int id, int msec); 
     void stopTimer(int id); 
 
+    // Hardware timed sequences. pigpiod transmits one wave chain at a time, other ports fall back to INDI timers
+    int m_wave_port { -1 };
+    int m_wave_on { -1 };
+    int m_wave_off { -1 };
+    std::chrono::time_point<std::chrono::steady_clock> m_wave_end;
+    void StartSequence(int id);
+    void StopSequence(int id);
+    bool StartWaveChain(int id);
+    void StopWaveChain();
+    void CheckWaveChain(int id);
+    void EndSequence(int id);
+
 };
 inline int IndiRpiGpio::FindPinIndex(unsigned user_gpio)
 {
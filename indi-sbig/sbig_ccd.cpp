@@ -41,6 +41,7 @@
 
 #include <memory>
 #include <deque>
+#include <thread>
 
 #ifdef __APPLE__
 #include <sys/stat.h>
@@ -383,6 +384,18 @@ bool SBIGCCD::initProperties()
     IUFillSwitchVector(&IgnoreErrorsSP, IgnoreErrorsS, 1, getDeviceName(), "CCD_IGNORE_ERRORS", "Ignore", OPTIONS_TAB, IP_RW,
                        ISR_NOFMANY, 0, IPS_OK);
 
+    // Readout chunk
+    IUFillNumber(&ReadoutChunkN[0], "LINES", "Lines", "%.f", 1, 4096, 16, 64);
+    IUFillNumberVector(&ReadoutChunkNP, ReadoutChunkN, 1, getDeviceName(), "CCD_READOUT_CHUNK", "Readout Chunk", OPTIONS_TAB,
+                       IP_RW, 0, IPS_IDLE);
+
+    // Readout statistics of the last imaging CCD download
+    IUFillNumber(&ReadoutStatsN[STATS_LINES_PER_SEC], "LINES_PER_SEC", "Lines/s", "%.1f", 0, 0, 0, 0);
+    IUFillNumber(&ReadoutStatsN[STATS_LOCK_WAIT_TOTAL], "LOCK_WAIT_TOTAL", "Lock wait (ms)", "%.1f", 0, 0, 0, 0);
+    IUFillNumber(&ReadoutStatsN[STATS_LOCK_WAIT_MAX], "LOCK_WAIT_MAX", "Max lock wait (ms)", "%.1f", 0, 0, 0, 0);
+    IUFillNumberVector(&ReadoutStatsNP, ReadoutStatsN, 3, getDeviceName(), "CCD_READOUT_STATS", "Readout Stats", IMAGE_INFO_TAB,
+                       IP_RO, 0, IPS_IDLE);
+
     // CFW PRODUCT
     IUFillText(&FilterProdcutT[0], "NAME", "Name", "");
     IUFillText(&FilterProdcutT[1], "ID", "ID", "");
@@ -530,6 +543,8 @@ bool SBIGCCD::updateProperties()
             defineProperty(&CoolerNP);
         }
         defineProperty(&IgnoreErrorsSP);
+        defineProperty(&ReadoutChunkNP);
+        defineProperty(&ReadoutStatsNP);
         if (m_hasFilterWheel)
         {
             defineProperty(&FilterConnectionSP);
@@ -572,6 +587,8 @@ bool SBIGCCD::updateProperties()
             deleteProperty(CoolerNP.name);
         }
         deleteProperty(IgnoreErrorsSP.name);
+        deleteProperty(ReadoutChunkNP.name);
+        deleteProperty(ReadoutStatsNP.name);
 
         if (m_hasAO)
         {
@@ -756,6 +773,15 @@ bool SBIGCCD::ISNewNumber(const char *dev, const char *name, double values[], ch
         if (INDI::FilterInterface::processNumber(dev, name, values, names, n))
             return true;
 
+        // Readout Chunk
+        if (!strcmp(name, ReadoutChunkNP.name))
+        {
+            IUUpdateNumber(&ReadoutChunkNP, values, names, n);
+            ReadoutChunkNP.s = IPS_OK;
+            IDSetNumber(&ReadoutChunkNP, nullptr);
+            return true;
+        }
+
         // NS Adaptive Optics
         if (!strcmp(name, AONSNP.name))
         {
@@ -897,6 +923,8 @@ bool SBIGCCD::Disconnect()
 {
     if (!isConnected())
         return true;
+    m_ReadoutWorker.quit();
+    m_InReadout = false;
     m_useExternalTrackingCCD = false;
     m_hasGuideHead           = false;
 #ifdef ASYNC_READOUT
@@ -1132,6 +1160,9 @@ int SBIGCCD::StartExposure(INDI::CCDChip *targetChip, double duration)
 
 bool SBIGCCD::StartExposure(float duration)
 {
+    if (isReadoutBusy())
+        return false;
+
     ExposureRequest = duration;
 
     if (duration >= 3)
@@ -1191,6 +1222,8 @@ bool SBIGCCD::AbortExposure()
 {
     int res = CE_NO_ERROR;
     LOG_DEBUG("Aborting primary camera exposure...");
+    m_ReadoutWorker.quit();
+    m_InReadout = false;
     for (int i = 0; i < MAX_THREAD_RETRIES; i++)
     {
         res = AbortExposure(&PrimaryCCD);
@@ -1285,6 +1318,9 @@ bool SBIGCCD::updateFrameProperties(INDI::CCDChip *targetChip)
 
 bool SBIGCCD::UpdateCCDFrame(int x, int y, int w, int h)
 {
+    if (isReadoutBusy())
+        return false;
+
     LOGF_DEBUG("The final main camera image area is (%ld, %ld), (%ld, %ld)", x, y, w, h);
     PrimaryCCD.setFrame(x, y, w, h);
     int nbuf = (w * h * PrimaryCCD.getBPP() / 8) + 512;
@@ -1305,6 +1341,9 @@ bool SBIGCCD::UpdateGuiderFrame(int x, int y, int w, int h)
 
 bool SBIGCCD::UpdateCCDBin(int binx, int biny)
 {
+    if (isReadoutBusy())
+        return false;
+
     // only basic sanity checks; if the camera really supports the requested binning
     // mode is checked in getBinningMode
     if (binx > 255 || biny > 255)
@@ -1438,7 +1477,24 @@ void *SBIGCCD::grabCCD()
 }
 #endif
 
-bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
+void SBIGCCD::workerReadout(const std::atomic_bool &isAboutToQuit)
+{
+    if (grabImage(&PrimaryCCD, &isAboutToQuit) == false && !isAboutToQuit)
+        PrimaryCCD.setExposureFailed();
+    m_InReadout = false;
+}
+
+bool SBIGCCD::isReadoutBusy()
+{
+    if (m_InReadout)
+    {
+        LOG_ERROR("Main camera readout in progress, try again when it is complete.");
+        return true;
+    }
+    return false;
+}
+
+bool SBIGCCD::grabImage(INDI::CCDChip *targetChip, const std::atomic_bool *isAboutToQuit)
 {
     uint16_t left   = targetChip->getSubX() / targetChip->getBinX();
     uint16_t top    = targetChip->getSubY() / targetChip->getBinX();
@@ -1447,6 +1503,12 @@ bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
 
     LOGF_DEBUG("%s readout in progress...", targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
 
+    // The imaging CCD is read out on the worker, keep the frame buffer until it is filled.
+    // The guide head is read out in TimerHit, which must not wait for the imaging CCD.
+    std::unique_lock<std::mutex> bufferGuard(ccdBufferLock, std::defer_lock);
+    if (targetChip == &PrimaryCCD)
+        bufferGuard.lock();
+
     if (isSimulation())
     {
         uint8_t *image = targetChip->getFrameBuffer();
@@ -1464,12 +1526,16 @@ bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
         int res                = 0;
         for (int i = 0; i < MAX_THREAD_RETRIES; i++)
         {
-            res = readoutCCD(left, top, width, height, buffer, targetChip);
+            res = readoutCCD(left, top, width, height, buffer, targetChip, isAboutToQuit);
             if (res == CE_NO_ERROR)
                 break;
+            if (isAboutToQuit && *isAboutToQuit)
+                return false;
             LOGF_DEBUG("Readout error, retrying...", res);
             usleep(MAX_THREAD_WAIT);
         }
+        if (isAboutToQuit && *isAboutToQuit)
+            return false;
         if (res != CE_NO_ERROR)
         {
             LOGF_ERROR("%s readout error",
@@ -1477,6 +1543,8 @@ bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
             return false;
         }
     }
+    if (bufferGuard.owns_lock())
+        bufferGuard.unlock();
     LOGF_DEBUG("%s readout complete", targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
     ExposureComplete(targetChip);
     return true;
@@ -1489,6 +1557,7 @@ bool SBIGCCD::saveConfigItems(FILE *fp)
     IUSaveConfigSwitch(fp, &PortSP);
     IUSaveConfigText(fp, &IpTP);
     IUSaveConfigSwitch(fp, &IgnoreErrorsSP);
+    IUSaveConfigNumber(fp, &ReadoutChunkNP);
 
     INDI::FilterInterface::saveConfigItems(fp);
 
@@ -1515,8 +1584,8 @@ void SBIGCCD::TimerHit()
             LOG_DEBUG("Primay camera exposure done, downloading image...");
             targetChip->setExposureLeft(0);
             InExposure = false;
-            if (grabImage(targetChip) == false)
-                targetChip->setExposureFailed();
+            m_InReadout = true;
+            m_ReadoutWorker.start(std::bind(&SBIGCCD::workerReadout, this, std::placeholders::_1));
         }
         else
         {
@@ -2636,7 +2705,7 @@ bool SBIGCCD::isExposureDone(INDI::CCDChip *targetChip)
 //==========================================================================
 
 int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t height,
-                        uint16_t *buffer, INDI::CCDChip *targetChip)
+                        uint16_t *buffer, INDI::CCDChip *targetChip, const std::atomic_bool *isAboutToQuit)
 {
     int h, ccd, binning, res;
     if (targetChip == &PrimaryCCD)
@@ -2658,6 +2727,11 @@ int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t he
     srp.top         = top;
     srp.width       = width;
     srp.height      = height;
+
+    int chunk = std::max(1, static_cast<int>(ReadoutChunkN[0].value));
+    double lockWaitTotal = 0, lockWaitMax = 0;
+    auto readoutStart = std::chrono::steady_clock::now();
+
     std::unique_lock<std::mutex> guard(sbigLock);
     res = StartReadout(&srp);
     if (res != CE_NO_ERROR)
@@ -2672,9 +2746,31 @@ int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t he
     rlp.readoutMode = binning;
     rlp.pixelStart  = left;
     rlp.pixelLength = width;
-    for (h = 0; h < height; h++)
+    for (h = 0; h < height;)
     {
-        ReadoutLine(&rlp, buffer + (h * width), false);
+        int end = std::min(static_cast<int>(height), h + chunk);
+        for (; h < end; h++)
+        {
+            ReadoutLine(&rlp, buffer + (h * width), false);
+        }
+        if (h >= height)
+            break;
+
+        // Release the lock between chunks so queued commands (tracking CCD,
+        // temperature, filter wheel) are not blocked for the whole download.
+        guard.unlock();
+        std::this_thread::yield();
+        auto waitStart = std::chrono::steady_clock::now();
+        guard.lock();
+        std::chrono::duration<double, std::milli> wait = std::chrono::steady_clock::now() - waitStart;
+        lockWaitTotal += wait.count();
+        lockWaitMax = std::max(lockWaitMax, wait.count());
+
+        if (isAboutToQuit && *isAboutToQuit)
+        {
+            LOGF_DEBUG("%s readout aborted at line %d", (targetChip == &PrimaryCCD) ? "Primary" : "Guide", h);
+            break;
+        }
     }
     EndReadoutParams erp;
     erp.ccd = ccd;
@@ -2686,6 +2782,18 @@ int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t he
         return res;
     }
     guard.unlock();
+
+    if (targetChip == &PrimaryCCD)
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - readoutStart;
+        ReadoutStatsN[STATS_LINES_PER_SEC].value   = elapsed.count() > 0 ? h / elapsed.count() : 0;
+        ReadoutStatsN[STATS_LOCK_WAIT_TOTAL].value = lockWaitTotal;
+        ReadoutStatsN[STATS_LOCK_WAIT_MAX].value   = lockWaitMax;
+        ReadoutStatsNP.s = IPS_OK;
+        IDSetNumber(&ReadoutStatsNP, nullptr);
+        LOGF_DEBUG("Primary readout: %d lines at %.1f lines/s, lock wait %.1f ms (max %.1f ms)", h,
+                   ReadoutStatsN[STATS_LINES_PER_SEC].value, lockWaitTotal, lockWaitMax);
+    }
     return res;
 }
 
@@ -29,6 +29,7 @@
 
 #include <indiccd.h>
 #include <indifilterinterface.h>
+#include <indisinglethreadpool.h>
 
 #ifdef __APPLE__
 #include <libusb.h>
@@ -37,6 +38,7 @@
 #include <sbigudrv.h>
 #endif
 
+#include <atomic>
 #include <string>
 
 #define DEVICE struct usb_device *
@@ -251,6 +253,19 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         ISwitch IgnoreErrorsS[1];
         ISwitchVectorProperty IgnoreErrorsSP;
 
+        // Lines read between releases of the driver lock
+        INumber ReadoutChunkN[1];
+        INumberVectorProperty ReadoutChunkNP;
+
+        INumber ReadoutStatsN[3];
+        INumberVectorProperty ReadoutStatsNP;
+        enum
+        {
+            STATS_LINES_PER_SEC,
+            STATS_LOCK_WAIT_TOTAL,
+            STATS_LOCK_WAIT_MAX,
+        };
+
         /////////////////////////////////////////////////////////////////////////////
         /// Filter Wheel Properties
         /////////////////////////////////////////////////////////////////////////////
@@ -277,6 +292,14 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         /// Threading Variables
         /////////////////////////////////////////////////////////////////////////////
         std::mutex sbigLock;
+        // Imaging CCD readout runs here so the tracking CCD, cooler and
+        // filter wheel can be serviced between readout chunks.
+        INDI::SingleThreadPool m_ReadoutWorker;
+        void workerReadout(const std::atomic_bool &isAboutToQuit);
+        // Set while the worker writes the imaging CCD frame buffer, the frame
+        // and binning cannot change and no new exposure can start until done.
+        std::atomic_bool m_InReadout {false};
+        bool isReadoutBusy();
 
         /////////////////////////////////////////////////////////////////////////////
         /// Exposure Variables
@@ -408,7 +431,7 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         int getFrameType(INDI::CCDChip *targetChip, INDI::CCDChip::CCD_FRAME *frameType);
         int getShutterMode(INDI::CCDChip *targetChip, int &shutter);
         int readoutCCD(unsigned short left, unsigned short top, unsigned short width, unsigned short height,
-                       unsigned short *buffer, INDI::CCDChip *targetChip);
+                       unsigned short *buffer, INDI::CCDChip *targetChip, const std::atomic_bool *isAboutToQuit = nullptr);
 
         /////////////////////////////////////////////////////////////////////////////
         /// Filter Wheel Functions
@@ -433,7 +456,7 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         /////////////////////////////////////////////////////////////////////////////
         /// Utility Functions
         /////////////////////////////////////////////////////////////////////////////
-        bool grabImage(INDI::CCDChip *targetChip);
+        bool grabImage(INDI::CCDChip *targetChip, const std::atomic_bool *isAboutToQuit = nullptr);
         bool setupParams();
         // SBIG's software interface to the Universal Driver Library function:
         int SBIGUnivDrvCommand(PAR_COMMAND, void *, void *);
@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <chrono>
+
 #include "indicom.h"
 #include "indi_starbook_ten.h"
 #include "config.h"
 
 #define MOUNT_TAB "Mount"
 
+/* How long ReadScopeStatus accepts polled status that is not updated */
+static const std::chrono::seconds STATUS_TIMEOUT(10);
+
 template <typename Tr>
 Tr retry(int retries, std::function<Tr()> f)
 {
@@ -192,9 +198,13 @@ INDIStarbookTen::updateProperties()
         defineProperty(&HomeSP);
 
         r = fetchStartupInfo();
+
+        starbook->startPolling(httpConnection->host(), std::chrono::milliseconds(getCurrentPollingPeriod()));
     }
     else
     {
+        starbook->stopPolling();
+
         deleteProperty(InfoTP.name);
         deleteProperty(StateTP.name);
         deleteProperty(GuideRateNP.name);
@@ -373,75 +383,88 @@ INDIStarbookTen::fetchStartupInfo()
 bool
 INDIStarbookTen::ReadScopeStatus()
 {
-    try
+    auto polled = starbook->getPolledStatus();
+    auto lastCommand = starbook->getLastCommandTime();
+    auto now = std::chrono::steady_clock::now();
+    auto oldest = std::min({polled.status_time, polled.track_time, polled.pierside_time});
+
+    // Until the poller has fetched status newer than the last command, the cached
+    // state might e.g. report a goto or park that was just sent as finished.
+    if (oldest <= lastCommand)
     {
-        auto stat = retry<StarbookTen::MountStatus>(2, &StarbookTen::getStatus, starbook);
-        bool isTracking = retry<bool>(2, &StarbookTen::isTracking, starbook);
+        if (now - lastCommand < STATUS_TIMEOUT)
+            return true;
+
+        LOGF_ERROR("ReadScopeStatus failed: %s", polled.error.c_str());
+        return false;
+    }
+
+    if (now - oldest > STATUS_TIMEOUT)
+    {
+        LOGF_ERROR("ReadScopeStatus failed: %s", polled.error.c_str());
+        return false;
+    }
+
+    auto &stat = polled.status;
+    bool isTracking = polled.tracking;
 
-        updateStarbookState(stat);
+    updateStarbookState(stat);
 
-        if (stat.goto_busy)
+    if (stat.goto_busy)
+    {
+        if ((TrackState == SCOPE_IDLE) ||
+                (TrackState == SCOPE_TRACKING))
+            TrackState = SCOPE_SLEWING;
+    }
+    else
+    {
+        if (TrackState == SCOPE_PARKING)
         {
-            if ((TrackState == SCOPE_IDLE) ||
-                    (TrackState == SCOPE_TRACKING))
-                TrackState = SCOPE_SLEWING;
+            SetParked(true);
+        }
+        else if ((stat.state == StarbookTen::STATE_INIT) ||
+                 (stat.state == StarbookTen::STATE_USER))
+        {
+            TrackState = SCOPE_IDLE;
         }
         else
         {
-            if (TrackState == SCOPE_PARKING)
-            {
-                SetParked(true);
-            }
-            else if ((stat.state == StarbookTen::STATE_INIT) ||
-                     (stat.state == StarbookTen::STATE_USER))
-            {
-                TrackState = SCOPE_IDLE;
-            }
-            else
-            {
-                TrackState = isTracking ? SCOPE_TRACKING : SCOPE_IDLE;
-            }
+            TrackState = isTracking ? SCOPE_TRACKING : SCOPE_IDLE;
+        }
 
-            if (HomeSP.s == IPS_BUSY)
-            {
-                LOG_INFO("Find home completed");
-                HomeSP.s = IPS_OK;
-                HomeS[HS_FIND_HOME].s = ISS_OFF;
-                IDSetSwitch(&HomeSP, nullptr);
-            }
+        if (HomeSP.s == IPS_BUSY)
+        {
+            LOG_INFO("Find home completed");
+            HomeSP.s = IPS_OK;
+            HomeS[HS_FIND_HOME].s = ISS_OFF;
+            IDSetSwitch(&HomeSP, nullptr);
         }
+    }
 
-        NewRaDec(stat.ra, stat.dec);
+    NewRaDec(stat.ra, stat.dec);
 
-        auto ps = retry<StarbookTen::PierSide>(2, &StarbookTen::getPierSide, starbook);
-        setPierSide((ps == StarbookTen::PIERSIDE_EAST) ? INDI::Telescope::PIER_EAST : INDI::Telescope::PIER_WEST);
+    auto ps = polled.pierside;
+    setPierSide((ps == StarbookTen::PIERSIDE_EAST) ? INDI::Telescope::PIER_EAST : INDI::Telescope::PIER_WEST);
 
-        if (isPropGuidingRA || isPropGuidingDE)
+    if ((isPropGuidingRA || isPropGuidingDE) && polled.guide_time > lastCommand)
+    {
+        LOGF_DEBUG("Prop guiding status: RA=%d, DEC=%d", polled.guiding_ra, polled.guiding_dec);
+        if (isPropGuidingRA && !polled.guiding_ra)
         {
-            auto gs = retry<std::tuple<bool, bool> >(2, &StarbookTen::getGuidingRaDec, starbook);
-            LOGF_DEBUG("Prop guiding status: RA=%d, DEC=%d", !!(std::get<0>(gs)), !!(std::get<1>(gs)));
-            if (isPropGuidingRA && !std::get<0>(gs))
-            {
-                LOG_DEBUG("Prop guiding in RA finished");
-                isPropGuidingRA = false;
-                INDI::GuiderInterface::GuideComplete(AXIS_RA);
-            }
-
-            if (isPropGuidingDE && !std::get<1>(gs))
-            {
-                LOG_DEBUG("Prop guiding in DE finished");
-                isPropGuidingDE = false;
-                INDI::GuiderInterface::GuideComplete(AXIS_DE);
-            }
+            LOG_DEBUG("Prop guiding in RA finished");
+            isPropGuidingRA = false;
+            INDI::GuiderInterface::GuideComplete(AXIS_RA);
         }
 
-        return true;
-    }
-    catch (std::exception &ex)
-    {
-        LOGF_ERROR("ReadScopeStatus failed: %s", ex.what());
-        return false;
+        if (isPropGuidingDE && !polled.guiding_dec)
+        {
+            LOG_DEBUG("Prop guiding in DE finished");
+            isPropGuidingDE = false;
+            INDI::GuiderInterface::GuideComplete(AXIS_DE);
+        }
     }
+
+    return true;
 }
 
 
@@ -1,5 +1,6 @@
-#include <regex>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
 #include <stdio.h>
 #include "starbook_ten.h"
 
@@ -24,6 +25,8 @@ StarbookTen::StarbookTen(const char *base_url) {
 
 
 StarbookTen::~StarbookTen() {
+    stopPolling();
+
     if (destroyClient)
         delete http;
 }
@@ -50,6 +53,14 @@ bool
 StarbookTen::sendBasicCmd(const char *cmd) {
     auto res = http->Get(cmd);
 
+    {
+        // Status fetched from now on reflects the command, wake the pollers up for it
+        std::lock_guard<std::mutex> lock(pollLock);
+        lastCommand = std::chrono::steady_clock::now();
+        pollGeneration++;
+    }
+    pollCV.notify_all();
+
     if (!res || res->status != 200) {
         throw std::runtime_error("sendBasicCmd HTTP error");
     }
@@ -70,13 +81,9 @@ StarbookTen::getFirmwareVersion() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(<!--VERSION=([0-9]+)\.([0-9]+)-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        int vmaj = std::stoi(sm[1]);
-        int vmin = std::stoi(sm[2]);
+    int vmaj, vmin;
 
+    if (parseVersion(res->body, vmaj, vmin)) {
         return std::tuple<int,int>(vmaj, vmin);
     } else {
         throw std::runtime_error("Could not get version");
@@ -92,11 +99,10 @@ StarbookTen::getPierSide() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(PIERSIDE=([01]))");
-    std::smatch sm;
+    PierSide pierside;
 
-    if (std::regex_search(res->body, sm, r)) {
-        return static_cast<StarbookTen::PierSide>(std::stoi(sm[1]));
+    if (parsePierSide(res->body, pierside)) {
+        return pierside;
     } else {
         throw std::runtime_error("Could not get pier side");
     }
@@ -113,11 +119,10 @@ StarbookTen::getNewPierSide(double ra, double dec) {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(PIERSIDE=([01]))");
-    std::smatch sm;
+    PierSide pierside;
 
-    if (std::regex_search(res->body, sm, r)) {
-        return static_cast<StarbookTen::PierSide>(std::stoi(sm[1]));
+    if (parsePierSide(res->body, pierside)) {
+        return pierside;
     } else {
         throw std::runtime_error("Could not get new pier side");
     }
@@ -142,17 +147,7 @@ StarbookTen::getDateTime() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(TIME=(\d{4})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2}))");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        zdt.years = std::stoi(sm[1]);
-        zdt.months = std::stoi(sm[2]);
-        zdt.days = std::stoi(sm[3]);
-        zdt.hours = std::stoi(sm[4]);
-        zdt.minutes = std::stoi(sm[5]);
-        zdt.seconds = std::stoi(sm[6]);
-    } else {
+    if (!parseDateTime(res->body, zdt)) {
         throw std::runtime_error("Could not get time");
     }
 
@@ -162,12 +157,7 @@ StarbookTen::getDateTime() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex rtz(R"(<!--.*timezone=([+-]?\d+)-->)");
-    std::smatch smtz;
-
-    if (std::regex_search(res->body, smtz, rtz)) {
-        zdt.gmtoff = std::stoi(smtz[1])*3600;
-    } else {
+    if (!parseTimezone(res->body, zdt.gmtoff)) {
         throw std::runtime_error("Could not get timezone");
     }
 
@@ -225,23 +215,10 @@ StarbookTen::getLatLon() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(<!--longitude=([EW])(\d+)\+(\d+)&latitude=([NS])(\d+)\+(\d+)&.*-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        ln_dms lon_dms, lat_dms;
-
-        lon_dms.neg = (sm[1].compare("W") == 0) ? 1 : 0;
-        lon_dms.degrees = std::stoi(sm[2]);
-        lon_dms.minutes = std::stoi(sm[3]);
-        lon_dms.seconds = 0;
+    double lat, lon;
 
-        lat_dms.neg = (sm[4].compare("S") == 0) ? 1 : 0;
-        lat_dms.degrees = std::stoi(sm[5]);
-        lat_dms.minutes = std::stoi(sm[6]);
-        lat_dms.seconds = 0;
-
-        return std::tuple<double,double>(ln_dms_to_deg(&lat_dms), ln_dms_to_deg(&lon_dms));
+    if (parseLatLon(res->body, lat, lon)) {
+        return std::tuple<double,double>(lat, lon);
     } else {
         throw std::runtime_error("Could not get lat/long");
     }
@@ -256,11 +233,10 @@ StarbookTen::getCoordType() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"((J2000|NOW))");
-    std::smatch sm;
+    CoordType ct;
 
-    if (std::regex_search(res->body, sm, r)) {
-        return (sm[1].compare("J2000") == 0) ? COORD_TYPE_J2000 : COORD_TYPE_NOW;
+    if (parseCoordType(res->body, ct)) {
+        return ct;
     } else {
         throw std::runtime_error("Could not get coordinate type");
     }
@@ -281,20 +257,9 @@ StarbookTen::getStatus() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(<!--RA=(\-?\d+\.\d+)&DEC=(\-?\d+\.\d+)&GOTO=([01])&STATE=([A-Z]+)-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        MountStatus stat;
-
-        stat.ra = std::stod(sm[1]);
-        stat.dec = std::stod(sm[2]);
-        stat.goto_busy = !(sm[3].compare("0") == 0);
-        stat.state =
-            (sm[4].compare("USER") == 0)  ? STATE_USER  :
-            (sm[4].compare("CHART") == 0) ? STATE_CHART :
-            (sm[4].compare("SCOPE") == 0) ? STATE_SCOPE : STATE_INIT;
+    MountStatus stat;
 
+    if (parseStatus(res->body, stat)) {
         return stat;
     } else {
         throw std::runtime_error("Could not get status");
@@ -309,13 +274,10 @@ StarbookTen::isTracking() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    // TRACK=2 seems to be used during gotos, but since we can already figure
-    // gotos out from the getstatus2 call, there's no need to handle it here.
-    std::regex r(R"(<!--TRACK=([012])-->)");
-    std::smatch sm;
+    bool tracking;
 
-    if (std::regex_search(res->body, sm, r)) {
-        return !(sm[1].compare("1"));
+    if (parseTrackStatus(res->body, tracking)) {
+        return tracking;
     } else {
         throw std::runtime_error("Could not get track status");
     }
@@ -330,12 +292,10 @@ StarbookTen::getGuidingRaDec() {
         throw std::runtime_error("HTTP get failed");
     }
 
-    std::regex r(R"(<!--RA\+=([01])&RA\-=([01])&DEC\+=([01])&DEC\-=([01])-->)");
-    std::smatch sm;
+    bool guiding_ra, guiding_dec;
 
-    if (std::regex_search(res->body, sm, r)) {
-        return std::tuple<bool,bool>((!(sm[1].compare("1")) || !(sm[2].compare("1"))),
-                                     (!(sm[3].compare("1")) || !(sm[4].compare("1"))));
+    if (parseGuideStatus(res->body, guiding_ra, guiding_dec)) {
+        return std::tuple<bool,bool>(guiding_ra, guiding_dec);
     } else {
         throw std::runtime_error("Could not get guide status");
     }
@@ -448,6 +408,371 @@ StarbookTen::move(StarbookTen::Axis axis, double rate) {
 }
 
 
+void
+StarbookTen::startPolling(const char *base_url, std::chrono::milliseconds period) {
+    stopPolling();
+
+    {
+        std::lock_guard<std::mutex> lock(pollLock);
+        pollQuit = false;
+        polled = PolledStatus();
+        // Nothing was fetched yet, treat it like a command that is waiting for status
+        lastCommand = std::chrono::steady_clock::now();
+    }
+
+    for (int i = 0; i < POLL_LAST; i++)
+        pollThreads.emplace_back(&StarbookTen::pollLoop, this, std::string(base_url),
+                                 static_cast<PollEndpoint>(i), period);
+}
+
+
+void
+StarbookTen::stopPolling() {
+    {
+        std::lock_guard<std::mutex> lock(pollLock);
+        pollQuit = true;
+    }
+    pollCV.notify_all();
+
+    for (auto &t : pollThreads)
+        t.join();
+
+    pollThreads.clear();
+}
+
+
+StarbookTen::PolledStatus
+StarbookTen::getPolledStatus() {
+    std::lock_guard<std::mutex> lock(pollLock);
+    return polled;
+}
+
+
+std::chrono::steady_clock::time_point
+StarbookTen::getLastCommandTime() {
+    std::lock_guard<std::mutex> lock(pollLock);
+    return lastCommand;
+}
+
+
+void
+StarbookTen::pollLoop(std::string base_url, PollEndpoint endpoint, std::chrono::milliseconds period) {
+    static const char *paths[POLL_LAST] = {
+        "/getstatus2",
+        "/gettrackstatus",
+        "/get_pierside",
+        "/getguidestatus"
+    };
+
+    httplib::Client client(base_url.c_str());
+
+    client.set_connection_timeout(2, 0);
+    client.set_read_timeout(3, 0);
+    client.set_write_timeout(3, 0);
+
+    client.set_keep_alive(true);
+
+    client.set_url_encode(false);
+
+    std::unique_lock<std::mutex> lock(pollLock);
+
+    while (!pollQuit) {
+        unsigned generation = pollGeneration;
+        auto started = std::chrono::steady_clock::now();
+
+        lock.unlock();
+        auto res = client.Get(paths[endpoint]);
+        lock.lock();
+
+        storePolled(endpoint, res, started);
+
+        pollCV.wait_for(lock, period, [&]() {
+            return pollQuit || pollGeneration != generation;
+        });
+    }
+}
+
+
+/* Called with pollLock held */
+void
+StarbookTen::storePolled(PollEndpoint endpoint, const httplib::Result &res, std::chrono::steady_clock::time_point started) {
+    if (!res || res->status != 200) {
+        polled.error = "HTTP get failed";
+        return;
+    }
+
+    bool ok = false;
+
+    switch (endpoint) {
+    case POLL_STATUS: {
+        MountStatus stat;
+        if ((ok = parseStatus(res->body, stat))) {
+            polled.status = stat;
+            polled.status_time = started;
+        }
+        break;
+    }
+
+    case POLL_TRACK: {
+        bool tracking;
+        if ((ok = parseTrackStatus(res->body, tracking))) {
+            polled.tracking = tracking;
+            polled.track_time = started;
+        }
+        break;
+    }
+
+    case POLL_PIERSIDE: {
+        PierSide pierside;
+        if ((ok = parsePierSide(res->body, pierside))) {
+            polled.pierside = pierside;
+            polled.pierside_time = started;
+        }
+        break;
+    }
+
+    case POLL_GUIDE: {
+        bool guiding_ra, guiding_dec;
+        if ((ok = parseGuideStatus(res->body, guiding_ra, guiding_dec))) {
+            polled.guiding_ra = guiding_ra;
+            polled.guiding_dec = guiding_dec;
+            polled.guide_time = started;
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (!ok)
+        polled.error = "Could not parse status";
+}
+
+
+/* Small scanners for the "<!--KEY=value&...-->" answers of the Starbook. They
+ * advance p over what they consumed and fail without moving on a mismatch. */
+static bool
+scanLiteral(const char *&p, const char *lit) {
+    size_t len = strlen(lit);
+
+    if (strncmp(p, lit, len) != 0)
+        return false;
+
+    p += len;
+    return true;
+}
+
+
+static bool
+scanInt(const char *&p, long &value) {
+    char *end;
+
+    errno = 0;
+    value = strtol(p, &end, 10);
+
+    if (end == p || errno == ERANGE)
+        return false;
+
+    p = end;
+    return true;
+}
+
+
+static bool
+scanDouble(const char *&p, double &value) {
+    char *end;
+
+    value = strtod(p, &end);
+
+    if (end == p)
+        return false;
+
+    p = end;
+    return true;
+}
+
+
+static bool
+scanFlag(const char *&p, const char *flags, int &value) {
+    const char *f = (*p != '\0') ? strchr(flags, *p) : nullptr;
+
+    if (f == nullptr)
+        return false;
+
+    value = static_cast<int>(f - flags);
+    p++;
+    return true;
+}
+
+
+/* Position right after the first occurrence of key, or nullptr */
+static const char *
+findKey(const std::string &body, const char *key) {
+    size_t pos = body.find(key);
+
+    return (pos == std::string::npos) ? nullptr : body.c_str() + pos + strlen(key);
+}
+
+
+bool
+StarbookTen::parseVersion(const std::string &body, int &vmaj, int &vmin) {
+    const char *p = findKey(body, "<!--VERSION=");
+    long maj, min;
+
+    if (!p || !scanInt(p, maj) || !scanLiteral(p, ".") || !scanInt(p, min))
+        return false;
+
+    vmaj = maj;
+    vmin = min;
+    return true;
+}
+
+
+bool
+StarbookTen::parsePierSide(const std::string &body, PierSide &pierside) {
+    const char *p = findKey(body, "PIERSIDE=");
+    int side;
+
+    if (!p || !scanFlag(p, "01", side))
+        return false;
+
+    pierside = static_cast<PierSide>(side);
+    return true;
+}
+
+
+bool
+StarbookTen::parseDateTime(const std::string &body, ln_zonedate &zdt) {
+    const char *p = findKey(body, "TIME=");
+    long f[6];
+
+    if (!p)
+        return false;
+
+    for (int i = 0; i < 6; i++) {
+        if ((i > 0 && !scanLiteral(p, "+")) || !scanInt(p, f[i]))
+            return false;
+    }
+
+    zdt.years = f[0];
+    zdt.months = f[1];
+    zdt.days = f[2];
+    zdt.hours = f[3];
+    zdt.minutes = f[4];
+    zdt.seconds = f[5];
+    return true;
+}
+
+
+bool
+StarbookTen::parseTimezone(const std::string &body, long &gmtoff) {
+    const char *p = findKey(body, "timezone=");
+    long tz;
+
+    if (!p || !scanInt(p, tz))
+        return false;
+
+    gmtoff = tz * 3600;
+    return true;
+}
+
+
+bool
+StarbookTen::parseLatLon(const std::string &body, double &lat, double &lon) {
+    const char *p = findKey(body, "<!--longitude=");
+    ln_dms lon_dms, lat_dms;
+    int lon_neg, lat_neg;
+    long lon_deg, lon_min, lat_deg, lat_min;
+
+    if (!p ||
+        !scanFlag(p, "EW", lon_neg) || !scanInt(p, lon_deg) || !scanLiteral(p, "+") || !scanInt(p, lon_min) ||
+        !scanLiteral(p, "&latitude=") ||
+        !scanFlag(p, "NS", lat_neg) || !scanInt(p, lat_deg) || !scanLiteral(p, "+") || !scanInt(p, lat_min))
+        return false;
+
+    lon_dms.neg = lon_neg;
+    lon_dms.degrees = lon_deg;
+    lon_dms.minutes = lon_min;
+    lon_dms.seconds = 0;
+
+    lat_dms.neg = lat_neg;
+    lat_dms.degrees = lat_deg;
+    lat_dms.minutes = lat_min;
+    lat_dms.seconds = 0;
+
+    lat = ln_dms_to_deg(&lat_dms);
+    lon = ln_dms_to_deg(&lon_dms);
+    return true;
+}
+
+
+bool
+StarbookTen::parseCoordType(const std::string &body, CoordType &ct) {
+    size_t j2000 = body.find("J2000");
+    size_t now = body.find("NOW");
+
+    if (j2000 == std::string::npos && now == std::string::npos)
+        return false;
+
+    ct = (j2000 < now) ? COORD_TYPE_J2000 : COORD_TYPE_NOW;
+    return true;
+}
+
+
+bool
+StarbookTen::parseStatus(const std::string &body, MountStatus &stat) {
+    const char *p = findKey(body, "<!--RA=");
+    int goto_busy;
+
+    if (!p ||
+        !scanDouble(p, stat.ra) || !scanLiteral(p, "&DEC=") ||
+        !scanDouble(p, stat.dec) || !scanLiteral(p, "&GOTO=") ||
+        !scanFlag(p, "01", goto_busy) || !scanLiteral(p, "&STATE="))
+        return false;
+
+    stat.goto_busy = goto_busy;
+    stat.state =
+        scanLiteral(p, "USER")  ? STATE_USER  :
+        scanLiteral(p, "CHART") ? STATE_CHART :
+        scanLiteral(p, "SCOPE") ? STATE_SCOPE : STATE_INIT;
+    return true;
+}
+
+
+bool
+StarbookTen::parseTrackStatus(const std::string &body, bool &tracking) {
+    const char *p = findKey(body, "<!--TRACK=");
+    int track;
+
+    // TRACK=2 seems to be used during gotos, but since we can already figure
+    // gotos out from the getstatus2 call, there's no need to handle it here.
+    if (!p || !scanFlag(p, "012", track))
+        return false;
+
+    tracking = (track == 1);
+    return true;
+}
+
+
+bool
+StarbookTen::parseGuideStatus(const std::string &body, bool &guiding_ra, bool &guiding_dec) {
+    const char *p = findKey(body, "<!--RA+=");
+    int ra_p, ra_m, dec_p, dec_m;
+
+    if (!p ||
+        !scanFlag(p, "01", ra_p) || !scanLiteral(p, "&RA-=") ||
+        !scanFlag(p, "01", ra_m) || !scanLiteral(p, "&DEC+=") ||
+        !scanFlag(p, "01", dec_p) || !scanLiteral(p, "&DEC-=") ||
+        !scanFlag(p, "01", dec_m))
+        return false;
+
+    guiding_ra = ra_p || ra_m;
+    guiding_dec = dec_p || dec_m;
+    return true;
+}
+
+
 std::string
 StarbookTen::sxfmt(double x) {
     char buf[32];
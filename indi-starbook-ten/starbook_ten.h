@@ -1,7 +1,12 @@
 #ifndef _STARBOOK_TEN_H_
 #define _STARBOOK_TEN_H_
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <libnova/julian_day.h>
 #include <libnova/utility.h>
 #include "httplib.h"
@@ -15,6 +20,17 @@ private:
     bool sendBasicCmd(const char *cmd);
     std::string sxfmt(double x);
 
+    enum PollEndpoint {
+        POLL_STATUS,
+        POLL_TRACK,
+        POLL_PIERSIDE,
+        POLL_GUIDE,
+        POLL_LAST
+    };
+
+    void pollLoop(std::string base_url, PollEndpoint endpoint, std::chrono::milliseconds period);
+    void storePolled(PollEndpoint endpoint, const httplib::Result &res, std::chrono::steady_clock::time_point started);
+
 public:
     enum Axis {
         AXIS_PRIMARY   = 0,
@@ -52,6 +68,23 @@ public:
         State  state;
     };
 
+    /* Latest answers of the status endpoints, as fetched by the poller */
+    struct PolledStatus {
+        MountStatus status {};
+        bool        tracking { false };
+        PierSide    pierside { PIERSIDE_WEST };
+        bool        guiding_ra { false };
+        bool        guiding_dec { false };
+
+        /* Start time of the request each answer came from */
+        std::chrono::steady_clock::time_point status_time;
+        std::chrono::steady_clock::time_point track_time;
+        std::chrono::steady_clock::time_point pierside_time;
+        std::chrono::steady_clock::time_point guide_time;
+
+        std::string error;
+    };
+
     static const double slewRates[];
 
     StarbookTen(httplib::Client *http);
@@ -100,6 +133,34 @@ public:
     bool goTo(double ra, double dec);
 
     bool move(Axis axis, double rate);
+
+    /* Status poller. Every endpoint is fetched from its own thread over its own
+     * keep-alive connection, so the driver never waits on the network to read
+     * the mount state. Commands wake the pollers up so their effect shows early. */
+    void startPolling(const char *base_url, std::chrono::milliseconds period);
+    void stopPolling();
+    PolledStatus getPolledStatus();
+    std::chrono::steady_clock::time_point getLastCommandTime();
+
+    /* Response parsers, they return false if the body does not match */
+    static bool parseVersion(const std::string &body, int &vmaj, int &vmin);
+    static bool parsePierSide(const std::string &body, PierSide &pierside);
+    static bool parseDateTime(const std::string &body, ln_zonedate &zdt);
+    static bool parseTimezone(const std::string &body, long &gmtoff);
+    static bool parseLatLon(const std::string &body, double &lat, double &lon);
+    static bool parseCoordType(const std::string &body, CoordType &ct);
+    static bool parseStatus(const std::string &body, MountStatus &stat);
+    static bool parseTrackStatus(const std::string &body, bool &tracking);
+    static bool parseGuideStatus(const std::string &body, bool &guiding_ra, bool &guiding_dec);
+
+private:
+    std::vector<std::thread> pollThreads;
+    std::mutex pollLock;
+    std::condition_variable pollCV;
+    bool pollQuit { false };
+    unsigned pollGeneration { 0 };
+    PolledStatus polled;
+    std::chrono::steady_clock::time_point lastCommand;
 };
 
 #endif /* _STARBOOK_TEN_H_ */
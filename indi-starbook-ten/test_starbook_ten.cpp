@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "starbook_ten.h"
+
+#include <chrono>
+#include <thread>
+
+/* Local stand-in for the Starbook web server */
+class StarbookTenServer : public ::testing::Test {
+protected:
+    httplib::Server server;
+    std::thread thread;
+    std::string base_url;
+
+    std::mutex lock;
+    std::string status = "<!--RA=12.5&DEC=-45.25&GOTO=0&STATE=SCOPE-->";
+    int commands = 0;
+
+    void SetUp() override {
+        auto reply = [this](const char *path, std::function<std::string()> body) {
+            server.Get(path, [this, body](const httplib::Request &, httplib::Response &res) {
+                std::lock_guard<std::mutex> guard(lock);
+                res.set_content(body(), "text/html");
+            });
+        };
+
+        reply("/getstatus2", [this]() { return status; });
+        reply("/gettrackstatus", []() { return std::string("<!--TRACK=1-->"); });
+        reply("/get_pierside", []() { return std::string("<!--PIERSIDE=1-->"); });
+        reply("/getguidestatus", []() { return std::string("<!--RA+=0&RA-=1&DEC+=0&DEC-=0-->"); });
+        reply("/version", []() { return std::string("<!--VERSION=2.7-->"); });
+        reply("/stop", [this]() {
+            commands++;
+            status = "<!--RA=1.0&DEC=2.0&GOTO=1&STATE=CHART-->";
+            return std::string("<!--OK-->");
+        });
+
+        int port = server.bind_to_any_port("127.0.0.1");
+        ASSERT_GT(port, 0);
+        base_url = "http://127.0.0.1:" + std::to_string(port);
+        thread = std::thread([this]() { server.listen_after_bind(); });
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    /* Wait until every status endpoint was fetched after the last command */
+    static StarbookTen::PolledStatus waitForPoll(StarbookTen &sb) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        StarbookTen::PolledStatus polled;
+
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto command = sb.getLastCommandTime();
+            polled = sb.getPolledStatus();
+
+            if (polled.status_time > command && polled.track_time > command &&
+                polled.pierside_time > command && polled.guide_time > command)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return polled;
+    }
+};
+
+
+TEST(StarbookTenParser, status) {
+    StarbookTen::MountStatus stat;
+
+    ASSERT_TRUE(StarbookTen::parseStatus("<html><!--RA=12.5&DEC=-45.25&GOTO=1&STATE=CHART--></html>", stat));
+    ASSERT_DOUBLE_EQ(stat.ra, 12.5);
+    ASSERT_DOUBLE_EQ(stat.dec, -45.25);
+    ASSERT_TRUE(stat.goto_busy);
+    ASSERT_EQ(stat.state, StarbookTen::STATE_CHART);
+
+    ASSERT_TRUE(StarbookTen::parseStatus("<!--RA=0.0&DEC=0.0&GOTO=0&STATE=INIT-->", stat));
+    ASSERT_FALSE(stat.goto_busy);
+    ASSERT_EQ(stat.state, StarbookTen::STATE_INIT);
+
+    ASSERT_FALSE(StarbookTen::parseStatus("<!--RA=&DEC=0.0&GOTO=0&STATE=INIT-->", stat));
+    ASSERT_FALSE(StarbookTen::parseStatus("<!--RA=1.0&DEC=0.0&GOTO=2&STATE=INIT-->", stat));
+    ASSERT_FALSE(StarbookTen::parseStatus("", stat));
+}
+
+TEST(StarbookTenParser, flags) {
+    bool tracking, guiding_ra, guiding_dec;
+    StarbookTen::PierSide ps;
+
+    ASSERT_TRUE(StarbookTen::parseTrackStatus("<!--TRACK=1-->", tracking));
+    ASSERT_TRUE(tracking);
+    ASSERT_TRUE(StarbookTen::parseTrackStatus("<!--TRACK=2-->", tracking));
+    ASSERT_FALSE(tracking);
+    ASSERT_FALSE(StarbookTen::parseTrackStatus("<!--TRACK=3-->", tracking));
+
+    ASSERT_TRUE(StarbookTen::parsePierSide("<!--PIERSIDE=1-->", ps));
+    ASSERT_EQ(ps, StarbookTen::PIERSIDE_EAST);
+    ASSERT_FALSE(StarbookTen::parsePierSide("<!--PIERSIDE=x-->", ps));
+
+    ASSERT_TRUE(StarbookTen::parseGuideStatus("<!--RA+=0&RA-=0&DEC+=0&DEC-=1-->", guiding_ra, guiding_dec));
+    ASSERT_FALSE(guiding_ra);
+    ASSERT_TRUE(guiding_dec);
+}
+
+TEST(StarbookTenParser, place_and_time) {
+    ln_zonedate zdt;
+    long gmtoff;
+    double lat, lon;
+    int vmaj, vmin;
+    StarbookTen::CoordType ct;
+
+    ASSERT_TRUE(StarbookTen::parseDateTime("<!--TIME=2021+3+14+21+5+9-->", zdt));
+    ASSERT_EQ(zdt.years, 2021);
+    ASSERT_EQ(zdt.months, 3);
+    ASSERT_EQ(zdt.days, 14);
+    ASSERT_EQ(zdt.hours, 21);
+    ASSERT_EQ(zdt.minutes, 5);
+    ASSERT_DOUBLE_EQ(zdt.seconds, 9);
+
+    ASSERT_TRUE(StarbookTen::parseTimezone("<!--longitude=E10+30&latitude=N45+15&timezone=-5-->", gmtoff));
+    ASSERT_EQ(gmtoff, -5 * 3600);
+
+    ASSERT_TRUE(StarbookTen::parseLatLon("<!--longitude=W10+30&latitude=N45+15&timezone=1-->", lat, lon));
+    ASSERT_DOUBLE_EQ(lat, 45.25);
+    ASSERT_DOUBLE_EQ(lon, -10.5);
+
+    ASSERT_TRUE(StarbookTen::parseVersion("<!--VERSION=2.7-->", vmaj, vmin));
+    ASSERT_EQ(vmaj, 2);
+    ASSERT_EQ(vmin, 7);
+
+    ASSERT_TRUE(StarbookTen::parseCoordType("<!--TYPE=NOW-->", ct));
+    ASSERT_EQ(ct, StarbookTen::COORD_TYPE_NOW);
+    ASSERT_TRUE(StarbookTen::parseCoordType("<!--TYPE=J2000-->", ct));
+    ASSERT_EQ(ct, StarbookTen::COORD_TYPE_J2000);
+}
+
+TEST_F(StarbookTenServer, accessors) {
+    StarbookTen sb(base_url.c_str());
+
+    auto ver = sb.getFirmwareVersion();
+    ASSERT_EQ(std::get<0>(ver), 2);
+    ASSERT_EQ(std::get<1>(ver), 7);
+
+    auto stat = sb.getStatus();
+    ASSERT_DOUBLE_EQ(stat.ra, 12.5);
+    ASSERT_EQ(stat.state, StarbookTen::STATE_SCOPE);
+
+    ASSERT_TRUE(sb.isTracking());
+    ASSERT_EQ(sb.getPierSide(), StarbookTen::PIERSIDE_EAST);
+}
+
+TEST_F(StarbookTenServer, poller) {
+    StarbookTen sb(base_url.c_str());
+
+    sb.startPolling(base_url.c_str(), std::chrono::milliseconds(50));
+
+    auto polled = waitForPoll(sb);
+    ASSERT_DOUBLE_EQ(polled.status.ra, 12.5);
+    ASSERT_DOUBLE_EQ(polled.status.dec, -45.25);
+    ASSERT_FALSE(polled.status.goto_busy);
+    ASSERT_TRUE(polled.tracking);
+    ASSERT_EQ(polled.pierside, StarbookTen::PIERSIDE_EAST);
+    ASSERT_TRUE(polled.guiding_ra);
+    ASSERT_FALSE(polled.guiding_dec);
+
+    // Status fetched after a command must reflect it
+    ASSERT_TRUE(sb.stop());
+    polled = waitForPoll(sb);
+    ASSERT_GT(polled.status_time, sb.getLastCommandTime());
+    ASSERT_TRUE(polled.status.goto_busy);
+    ASSERT_EQ(polled.status.state, StarbookTen::STATE_CHART);
+
+    sb.stopPolling();
+    ASSERT_EQ(commands, 1);
+}
+
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
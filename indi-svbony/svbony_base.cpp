@@ -25,20 +25,25 @@
 #include "svbony_helpers.h"
 
 #include "config.h"
+#include "fits_date_obs.h"
 
 #include <stream/streammanager.h>
-#include <indielapsedtimer.h>
 
 #include <algorithm>
 #include <cmath>
 #include <vector>
 #include <map>
 #include <unistd.h>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <errno.h>
 
 #define MAX_EXP_RETRIES         3
 #define VERBOSE_EXPOSURE        3
 #define TEMP_TIMER_MS           1000 /* Temperature polling time (ms) */
 #define TEMP_THRESHOLD          .25  /* Differential temperature threshold (C)*/
+#define SEQUENCE_MAX_IDLE       5    /* Seconds a sequence exposure may wait for the next request */
 
 #define CONTROL_TAB "Controls"
 
@@ -83,8 +88,9 @@ bool SVBONYBase::SetROIFormat(int x, int y, int w, int h, int bin)
 // Discard unretrieved exposure data
 void SVBONYBase::discardVideoData()
 {
-    unsigned char* imageBuffer = PrimaryCCD.getFrameBuffer();
-    SVB_ERROR_CODE status = SVBGetVideoData(mCameraInfo.CameraID, imageBuffer, PrimaryCCD.getFrameBufferSize(),  1000);
+    if (mReadBuffer.size() < static_cast<size_t>(PrimaryCCD.getFrameBufferSize()))
+        mReadBuffer.resize(PrimaryCCD.getFrameBufferSize());
+    SVB_ERROR_CODE status = SVBGetVideoData(mCameraInfo.CameraID, mReadBuffer.data(), PrimaryCCD.getFrameBufferSize(),  1000);
     LOGF_DEBUG("Discard unretrieved exposure data: SVBGetVideoData:result=%d", status);
 }
 #endif
@@ -120,7 +126,10 @@ void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
             uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
             int waitMS           = static_cast<int>((ExposureRequest * 2000.0) + 500);
 
-            ret = SVBGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
+            {
+                FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+                ret = SVBGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
+            }
             if (ret != SVB_SUCCESS)
             {
                 if (ret != SVB_ERROR_TIMEOUT)
@@ -140,12 +149,18 @@ void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
             */
             if (Helpers::isRGB(mCurrentVideoFormat))
             {
+                FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
                 int nChannels = Helpers::getNChannels(mCurrentVideoFormat);
                 for (uint32_t i = 0; i < totalBytes; i += nChannels)
                     std::swap(targetFrame[i], targetFrame[i + 2]); // swap R and B channel.
             }
 
-            Streamer->newFrame(targetFrame, totalBytes);
+            {
+                FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+                Streamer->newFrame(targetFrame, totalBytes);
+            }
+
+            mFrameTimingProperties.frameDone();
         }
 
         SVBStopVideoCapture(mCameraInfo.CameraID);
@@ -170,104 +185,119 @@ void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
 void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float duration)
 {
     SVB_ERROR_CODE ret;
+    std::chrono::steady_clock::time_point exposureStart;
+    bool triggered = false;
 
-    // set camera soft trigger mode
-    ret = SVBSetCameraMode(mCameraInfo.CameraID, SVB_MODE_TRIG_SOFT);
-    if(ret != SVB_SUCCESS)
+    // Continue the exposure triggered at the end of the previous frame if it matches the request
     {
-        LOGF_ERROR("Failed to set soft trigger mode (%s).", Helpers::toString(ret));
-        return;
+        std::lock_guard<std::mutex> lock(mSequenceLock);
+        if (mSequenceTriggered)
+        {
+            mSequenceTriggered = false;
+            auto idle = std::chrono::duration<double>(std::chrono::steady_clock::now() - mSequenceStart).count();
+            if (duration == mSequenceDuration && idle < duration + SEQUENCE_MAX_IDLE)
+            {
+                triggered = true;
+                exposureStart = mSequenceStart;
+                mFrameStartUTC = mSequenceStartUTC;
+                LOGF_DEBUG("Continuing sequence exposure : %.3fs", duration);
+            }
+            else
+            {
+                LOG_DEBUG("Discarding sequence exposure, request differs.");
+                SVBStopVideoCapture(mCameraInfo.CameraID);
+            }
+        }
     }
-    LOG_DEBUG("Camera soft trigger mode");
 
-    ret = SVBStartVideoCapture(mCameraInfo.CameraID);
-    if (ret != SVB_SUCCESS)
+    PrimaryCCD.setExposureDuration(duration);
+    mFrameTriggered = triggered;
+
+    if (!triggered)
     {
-        LOGF_ERROR("Failed to start video capture (%s).", Helpers::toString(ret));
-        return;
-    }
+        // set camera soft trigger mode
+        ret = SVBSetCameraMode(mCameraInfo.CameraID, SVB_MODE_TRIG_SOFT);
+        if(ret != SVB_SUCCESS)
+        {
+            LOGF_ERROR("Failed to set soft trigger mode (%s).", Helpers::toString(ret));
+            return;
+        }
+        LOG_DEBUG("Camera soft trigger mode");
+
+        ret = SVBStartVideoCapture(mCameraInfo.CameraID);
+        if (ret != SVB_SUCCESS)
+        {
+            LOGF_ERROR("Failed to start video capture (%s).", Helpers::toString(ret));
+            return;
+        }
 
 #ifdef WORKAROUND_latest_image_can_be_getten_next_time
-    // Discard unretrieved exposure data
-    discardVideoData();
+        // Discard unretrieved exposure data
+        discardVideoData();
 #endif
 
-    PrimaryCCD.setExposureDuration(duration);
+        LOGF_DEBUG("StartExposure->setexp : %.3fs", duration);
+        ret = SVBSetControlValue(mCameraInfo.CameraID, SVB_EXPOSURE, duration * 1000 * 1000, SVB_FALSE);
+        if (ret != SVB_SUCCESS)
+        {
+            LOGF_ERROR("Failed to set exposure duration (%s).", Helpers::toString(ret));
+        }
 
-    LOGF_DEBUG("StartExposure->setexp : %.3fs", duration);
-    ret = SVBSetControlValue(mCameraInfo.CameraID, SVB_EXPOSURE, duration * 1000 * 1000, SVB_FALSE);
-    if (ret != SVB_SUCCESS)
-    {
-        LOGF_ERROR("Failed to set exposure duration (%s).", Helpers::toString(ret));
-    }
+        // Try exposure for 3 times
+        int nRetry = 3; // Number of retries to start exposure
+        while (nRetry--)
+        {
+            ret = SVBSendSoftTrigger(mCameraInfo.CameraID);
+            if (ret == SVB_SUCCESS)
+                break;
 
-    // Try exposure for 3 times
-    int nRetry = 3; // Number of retries to start exposure
-    while (nRetry--)
-    {
-        ret = SVBSendSoftTrigger(mCameraInfo.CameraID);
-        if (ret == SVB_SUCCESS)
-            break;
+            LOGF_ERROR("Failed to start exposure (%s)", Helpers::toString(ret));
+            // Wait 100ms before trying again
+            usleep(100 * 1000);
+        }
+        if (!nRetry)
+        {
+            LOG_ERROR("Failed to start exposure three times.");
+            return;
+        }
 
-        LOGF_ERROR("Failed to start exposure (%s)", Helpers::toString(ret));
-        // Wait 100ms before trying again
-        usleep(100 * 1000);
+        exposureStart = std::chrono::steady_clock::now();
     }
-    if (!nRetry)
-    {
-        LOG_ERROR("Failed to start exposure three times.");
-        return;
-    }
-
-    INDI::ElapsedTimer exposureTimer;
 
     if (duration > VERBOSE_EXPOSURE)
         LOGF_INFO("Taking a %g seconds frame...", duration);
 
     /*
-        Prepare a read buffer for SVB_IMG_RGB24 and SVB_IMG_RGB32
+        Prepare the read buffer, RGB24 and RGB32 are converted to planes on hand-off
     */
     SVB_IMG_TYPE type = getImageType();
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
-    uint8_t *buffer = image;
-
     uint16_t subW = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     uint16_t subH = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
     int nChannels = Helpers::getNChannels(type);
     size_t nTotalBytes = subW * subH * nChannels * (PrimaryCCD.getBPP() / 8);
 
-    if (Helpers::isRGB(type))
-    {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
-        if (buffer == nullptr)
-        {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24/32).", getDeviceName(), nTotalBytes);
-            guard.unlock();
-            return;
-        }
-    }
+    if (mReadBuffer.size() < nTotalBytes)
+        mReadBuffer.resize(nTotalBytes);
+    uint8_t *buffer = mReadBuffer.data();
 
     /*
         Perform exposure and image data reading
     */
-    nRetry = 50; // Number of retries when ret is SVB_ERROR_TIMEOUT
+    int nRetry = 50; // Number of retries when ret is SVB_ERROR_TIMEOUT
     while (1)
     {
         if (isAboutToQuit)
         {
             ret = SVBGetVideoData(mCameraInfo.CameraID, buffer, nTotalBytes,  1000);
             LOGF_DEBUG("Discard unretrieved exposure data: SVBGetVideoData(%s)", Helpers::toString(ret));
-            if (Helpers::isRGB(type))
-                free(buffer);
-            guard.unlock();
             PrimaryCCD.setExposureLeft(0);
             return;
         }
 
         float delay = 0.1;
-        float timeLeft = std::max(duration - exposureTimer.elapsed() / 1000.0, 0.0);
+        float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - exposureStart).count();
+        float timeLeft = std::max(duration - elapsed, 0.0f);
 
         /*
          * Check the status every second until the time left is
@@ -289,13 +319,29 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
         }
         else
         {
-            ret = SVBGetVideoData(mCameraInfo.CameraID, buffer, nTotalBytes, 1000);
+            {
+                FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_SDK_WAIT);
+                ret = SVBGetVideoData(mCameraInfo.CameraID, buffer, nTotalBytes, 1000);
+            }
             LOGF_DEBUG("Retrieved exposure data: SVBGetVideoData(%s)", Helpers::toString(ret));
             switch (ret)
             {
                 case SVB_SUCCESS:
+                {
+                    // The frame is in our buffer, the camera can start on the next one
+                    if (mSequenceMode)
+                        triggerSequenceExposure(duration);
+
+                    std::unique_lock<std::mutex> guard(ccdBufferLock, std::defer_lock);
+                    {
+                        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_BUFFER_LOCK);
+                        guard.lock();
+                    }
+                    uint8_t *image = PrimaryCCD.getFrameBuffer();
+
                     if (Helpers::isRGB(type))
                     {
+                        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
                         uint8_t *dstR = image;
                         uint8_t *dstG = image + subW * subH;
                         uint8_t *dstB = image + subW * subH * 2;
@@ -327,10 +373,18 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
                                 *dstR++ = *src++;
                             }
                         }
-                        free(buffer);
+                    }
+                    else
+                    {
+                        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_CONVERT);
+                        memcpy(image, buffer, nTotalBytes);
                     }
                     guard.unlock();
-                    sendImage(type, duration);
+                    {
+                        FrameTiming::Scope timing(mFrameTiming, FrameTiming::STAGE_HANDOFF);
+                        sendImage(type, duration);
+                    }
+                    mFrameTimingProperties.frameDone();
 
                     mExposureRetry = 0;
                     PrimaryCCD.setExposureLeft(0.0);
@@ -338,6 +392,7 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
                         LOG_INFO("Exposure done, downloading image...");
 
                     return;
+                }
 
                 case SVB_ERROR_TIMEOUT:
                     --nRetry;
@@ -350,9 +405,6 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
                     }
                 //fall through
                 default: // Cannot continue to retrive image data when ret is any error except timeout.
-                    if (Helpers::isRGB(type))
-                        free(buffer);
-                    guard.unlock();
                     PrimaryCCD.setExposureLeft(0);
                     PrimaryCCD.setExposureFailed();
                     return;
@@ -362,6 +414,34 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
     }
 }
 
+void SVBONYBase::triggerSequenceExposure(float duration)
+{
+    std::lock_guard<std::mutex> lock(mSequenceLock);
+
+    SVB_ERROR_CODE ret = SVBSendSoftTrigger(mCameraInfo.CameraID);
+    if (ret != SVB_SUCCESS)
+    {
+        LOGF_DEBUG("Failed to trigger next sequence exposure (%s).", Helpers::toString(ret));
+        return;
+    }
+
+    mSequenceTriggered = true;
+    mSequenceDuration = duration;
+    mSequenceStart = std::chrono::steady_clock::now();
+    mSequenceStartUTC = std::chrono::system_clock::now();
+}
+
+void SVBONYBase::cancelSequenceExposure()
+{
+    std::lock_guard<std::mutex> lock(mSequenceLock);
+
+    if (mSequenceTriggered)
+    {
+        mSequenceTriggered = false;
+        SVBStopVideoCapture(mCameraInfo.CameraID);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////
 /// Generic constructor
 ///////////////////////////////////////////////////////////////////////
@@ -406,6 +486,12 @@ bool SVBONYBase::initProperties()
     FlipSP[FLIP_VERTICAL].fill("FLIP_VERTICAL", "Vertical", ISS_OFF);
     FlipSP.fill(getDeviceName(), "FLIP", "Flip", CONTROL_TAB, IP_RW, ISR_NOFMANY, 60, IPS_IDLE);
 
+    mFrameTimingProperties.initProperties(this);
+
+    SequenceSP[SEQUENCE_ON].fill("SEQUENCE_ON", "On", ISS_OFF);
+    SequenceSP[SEQUENCE_OFF].fill("SEQUENCE_OFF", "Off", ISS_ON);
+    SequenceSP.fill(getDeviceName(), "CCD_SEQUENCE_MODE", "Sequence", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
     VideoFormatSP.fill(getDeviceName(), "CCD_VIDEO_FORMAT", "Format", CONTROL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
 
     ADCDepthNP[0].fill("BITS", "Bits", "%2.0f", 0, 32, 1, 16);
@@ -483,6 +569,8 @@ bool SVBONYBase::updateProperties()
         }
 
         defineProperty(ADCDepthNP);
+        defineProperty(SequenceSP);
+        mFrameTimingProperties.updateProperties(true);
         defineProperty(SDKVersionSP);
         if (!mSerialNumber.empty())
         {
@@ -512,6 +600,8 @@ bool SVBONYBase::updateProperties()
         if (!VideoFormatSP.isEmpty())
             deleteProperty(VideoFormatSP.getName());
 
+        deleteProperty(SequenceSP);
+        mFrameTimingProperties.updateProperties(false);
         deleteProperty(SDKVersionSP.getName());
         if (!mSerialNumber.empty())
         {
@@ -671,6 +761,7 @@ bool SVBONYBase::Disconnect()
 
     mWorker.quit();
     Streamer->setStream(false);
+    cancelSequenceExposure();
 
     if (isSimulation() == false)
     {
@@ -792,6 +883,17 @@ void SVBONYBase::setupParams()
     Streamer->setSize(maxWidth, maxHeight);
 }
 
+bool SVBONYBase::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
+{
+    if (dev != nullptr && !strcmp(dev, getDeviceName()))
+    {
+        if (mFrameTimingProperties.ISNewText(name, texts, names, n))
+            return true;
+    }
+
+    return INDI::CCD::ISNewText(dev, name, texts, names, n);
+}
+
 bool SVBONYBase::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
 {
     SVB_ERROR_CODE ret = SVB_SUCCESS;
@@ -800,6 +902,8 @@ bool SVBONYBase::ISNewNumber(const char *dev, const char *name, double values[],
     {
         if (ControlNP.isNameMatch(name))
         {
+            cancelSequenceExposure();
+
             std::vector<double> oldValues;
             for (const auto &num : ControlNP)
                 oldValues.push_back(num.getValue());
@@ -859,8 +963,24 @@ bool SVBONYBase::ISNewSwitch(const char *dev, const char *name, ISState *states,
 {
     if (dev != nullptr && !strcmp(dev, getDeviceName()))
     {
+        if (SequenceSP.isNameMatch(name))
+        {
+            SequenceSP.update(states, names, n);
+            mSequenceMode = SequenceSP[SEQUENCE_ON].getState() == ISS_ON;
+            if (!mSequenceMode)
+                cancelSequenceExposure();
+            SequenceSP.setState(IPS_OK);
+            SequenceSP.apply();
+            return true;
+        }
+
+        if (mFrameTimingProperties.ISNewSwitch(name, states, names, n))
+            return true;
+
         if (ControlSP.isNameMatch(name))
         {
+            cancelSequenceExposure();
+
             if (ControlSP.update(states, names, n) == false)
             {
                 ControlSP.setState(IPS_ALERT);
@@ -904,6 +1024,8 @@ bool SVBONYBase::ISNewSwitch(const char *dev, const char *name, ISState *states,
 
         if (FlipSP.isNameMatch(name))
         {
+            cancelSequenceExposure();
+
             if (FlipSP.update(states, names, n) == false)
             {
                 FlipSP.setState(IPS_ALERT);
@@ -1060,6 +1182,7 @@ bool SVBONYBase::AbortExposure()
     LOG_DEBUG("Aborting exposure...");
 
     mWorker.quit();
+    cancelSequenceExposure();
 
     SVBStopVideoCapture(mCameraInfo.CameraID);
     return true;
@@ -1067,6 +1190,7 @@ bool SVBONYBase::AbortExposure()
 
 bool SVBONYBase::StartStreaming()
 {
+    cancelSequenceExposure();
     mWorker.start(std::bind(&SVBONYBase::workerStreamVideo, this, std::placeholders::_1));
     return true;
 }
@@ -1079,6 +1203,8 @@ bool SVBONYBase::StopStreaming()
 
 bool SVBONYBase::UpdateCCDFrame(int x, int y, int w, int h)
 {
+    cancelSequenceExposure();
+
     uint32_t binX = PrimaryCCD.getBinX();
     uint32_t binY = PrimaryCCD.getBinY();
     uint32_t subX = x / binX;
@@ -1432,6 +1558,10 @@ void SVBONYBase::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FI
 {
     INDI::CCD::addFITSKeywords(targetChip, fitsKeywords);
 
+    // The chip stamps the start when the exposure is requested, a triggered one started earlier
+    if (mFrameTriggered)
+        setFITSDateObs(fitsKeywords, mFrameStartUTC);
+
     // e-/ADU
     auto np = ControlNP.findWidgetByName("Gain");
     if (np)
@@ -1465,6 +1595,9 @@ bool SVBONYBase::saveConfigItems(FILE *fp)
     if (!VideoFormatSP.isEmpty())
         VideoFormatSP.save(fp);
 
+    SequenceSP.save(fp);
+    mFrameTimingProperties.saveConfigItems(fp);
+
     return true;
 }
 
@@ -29,7 +29,11 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "frame_timing_properties.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <vector>
 
 #include <indiccd.h>
@@ -61,6 +65,7 @@ class SVBONYBase : public INDI::CCD
     protected:
 
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+        virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
 
         // Streaming
@@ -98,6 +103,12 @@ class SVBONYBase : public INDI::CCD
         /** Send CCD image to client */
         void sendImage(SVB_IMG_TYPE type, float duration);
 
+        /** Trigger the next exposure of a sequence as soon as a frame is read out */
+        void triggerSequenceExposure(float duration);
+
+        /** Stop the pending sequence exposure, the next one starts from scratch */
+        void cancelSequenceExposure();
+
 #ifdef WORKAROUND_latest_image_can_be_getten_next_time
         // Discard unretrieved exposure data
         void discardVideoData();
@@ -162,6 +173,31 @@ class SVBONYBase : public INDI::CCD
             FLIP_VERTICAL
         };
 
+        FrameTiming mFrameTiming;
+        FrameTimingProperties mFrameTimingProperties {mFrameTiming};
+
+        INDI::PropertySwitch  SequenceSP {2};
+        enum
+        {
+            SEQUENCE_ON,
+            SEQUENCE_OFF
+        };
+
+        // Frames are read here and copied into the frame buffer, which is only locked for the hand-off
+        std::vector<uint8_t> mReadBuffer;
+
+        // Exposure triggered right after the previous frame of a sequence, guarded by mSequenceLock
+        std::atomic_bool mSequenceMode {false};
+        std::mutex mSequenceLock;
+        bool mSequenceTriggered {false};
+        float mSequenceDuration {0};
+        std::chrono::steady_clock::time_point mSequenceStart;
+        std::chrono::system_clock::time_point mSequenceStartUTC;
+
+        // The frame being read continues a triggered exposure, DATE-OBS comes from mFrameStartUTC
+        bool mFrameTriggered {false};
+        std::chrono::system_clock::time_point mFrameStartUTC;
+
         std::string mCameraName, mCameraID, mSerialNumber, mNickname;
         SVB_CAMERA_INFO mCameraInfo;
         SVB_CAMERA_PROPERTY mCameraProperty;
@@ -27,32 +27,147 @@
 
 #include <curl/curl.h>
 
+#include <chrono>
 #include <memory>
 #include <cstring>
 #include <string>
 
-struct response_t
+#include <strings.h>
+
+/* Time the first updateWeather waits for the first report before giving up */
+#define FIRST_FETCH_TIMEOUT 10
+
+/* Keys of the "current" section, in the order of the FIELD_ enum */
+static const char *fieldNames[WeewxJSON::FIELD_COUNT] =
 {
-    char *response;
-    size_t size;
+    "temperature",
+    "dewpoint",
+    "humidity",
+    "heat index",
+    "barometer",
+    "wind speed",
+    "wind gust",
+    "wind direction",
+    "wind chill",
+    "rain rate"
 };
 
-static size_t cb(void *data, size_t size, size_t nmemb, void *userp)
+/*
+ * SAX handler that picks the value and units of the wanted entries of the
+ * "current" section while the report is scanned, without building a DOM.
+ */
+class CurrentReadingsParser
 {
-    size_t realsize        = size * nmemb;
-    struct response_t *mem = (struct response_t *)userp;
+    public:
+        explicit CurrentReadingsParser(WeewxJSON::Readings &readings) : readings(readings) {}
+
+        bool foundCurrent { false };
+
+        bool null()
+        {
+            return true;
+        }
+        bool boolean(bool)
+        {
+            return true;
+        }
+        bool number_integer(json::number_integer_t val)
+        {
+            return number(static_cast<double>(val));
+        }
+        bool number_unsigned(json::number_unsigned_t val)
+        {
+            return number(static_cast<double>(val));
+        }
+        bool number_float(json::number_float_t val, const json::string_t &)
+        {
+            return number(static_cast<double>(val));
+        }
+        bool string(json::string_t &val)
+        {
+            if (depth == 3 && field >= 0 && member == MEMBER_UNITS)
+                readings[field].units = val;
+            return true;
+        }
+        bool binary(json::binary_t &)
+        {
+            return true;
+        }
+        bool start_object(std::size_t)
+        {
+            depth++;
+            if (depth == 2 && currentKey)
+                inCurrent = foundCurrent = true;
+            return true;
+        }
+        bool key(json::string_t &val)
+        {
+            if (depth == 1)
+                currentKey = (val == "current");
+            else if (depth == 2 && inCurrent)
+                field = lookup(val);
+            else if (depth == 3 && field >= 0)
+                member = (val == "value") ? MEMBER_VALUE : (val == "units") ? MEMBER_UNITS : MEMBER_OTHER;
+            return true;
+        }
+        bool end_object()
+        {
+            if (depth == 2)
+                inCurrent = false;
+            else if (depth == 3)
+                field = -1;
+            depth--;
+            return true;
+        }
+        bool start_array(std::size_t)
+        {
+            depth++;
+            return true;
+        }
+        bool end_array()
+        {
+            depth--;
+            return true;
+        }
+        bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &)
+        {
+            return false;
+        }
 
-    char *ptr = (char *)realloc(mem->response, mem->size + realsize + 1);
-    if (ptr == NULL)
-        return 0; /* out of memory! */
+    private:
+        bool number(double val)
+        {
+            if (depth == 3 && field >= 0 && member == MEMBER_VALUE)
+            {
+                readings[field].value = val;
+                readings[field].valid = true;
+            }
+            return true;
+        }
 
-    mem->response = ptr;
-    memcpy(&(mem->response[mem->size]), data, realsize);
-    mem->size += realsize;
-    mem->response[mem->size] = 0;
+        static int lookup(const std::string &name)
+        {
+            for (int i = 0; i < WeewxJSON::FIELD_COUNT; i++)
+            {
+                if (name == fieldNames[i])
+                    return i;
+            }
+            return -1;
+        }
 
-    return realsize;
-}
+        enum
+        {
+            MEMBER_OTHER,
+            MEMBER_VALUE,
+            MEMBER_UNITS
+        } member { MEMBER_OTHER };
+
+        WeewxJSON::Readings &readings;
+        int depth { 0 };
+        bool currentKey { false };
+        bool inCurrent { false };
+        int field { -1 };
+};
 
 // We declare an auto pointer to WeewxJSON.
 std::unique_ptr<WeewxJSON> weewx_json(new WeewxJSON());
@@ -64,7 +179,10 @@ WeewxJSON::WeewxJSON()
     setWeatherConnection(CONNECTION_NONE);
 }
 
-WeewxJSON::~WeewxJSON() {}
+WeewxJSON::~WeewxJSON()
+{
+    stopFetching();
+}
 
 const char *WeewxJSON::getDefaultName()
 {
@@ -73,11 +191,13 @@ const char *WeewxJSON::getDefaultName()
 
 bool WeewxJSON::Connect()
 {
+    startFetching();
     return true;
 }
 
 bool WeewxJSON::Disconnect()
 {
+    stopFetching();
     return true;
 }
 
@@ -148,6 +268,13 @@ bool WeewxJSON::ISNewText(const char *dev, const char *name, char *texts[], char
             weewxJsonUrl.update(texts, names, n);
             weewxJsonUrl.setState(IPS_OK);
             weewxJsonUrl.apply();
+
+            {
+                std::lock_guard<std::mutex> lock(fetchLock);
+                fetchUrl  = weewxJsonUrl[WEEWX_URL].getText() ? weewxJsonUrl[WEEWX_URL].getText() : "";
+                fetchWake = true;
+            }
+            fetchCV.notify_all();
             return true;
         }
     }
@@ -155,40 +282,45 @@ bool WeewxJSON::ISNewText(const char *dev, const char *name, char *texts[], char
     return INDI::Weather::ISNewText(dev, name, texts, names, n);
 }
 
-void WeewxJSON::handleTemperatureData(json value, std::string key)
+bool WeewxJSON::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
 {
-    double temperatureValue = 0.0;
-    std::string units;
-
-    value["value"].get_to(temperatureValue);
-    value["units"].get_to(units);
+    bool result = INDI::Weather::ISNewNumber(dev, name, values, names, n);
 
-    if (strcmp(units.c_str(), "°F") == 0)
+    if (dev != nullptr && strcmp(dev, getDeviceName()) == 0 && WI::UpdatePeriodNP.isNameMatch(name))
     {
-        temperatureValue = (temperatureValue - 32.0) * 5.0 / 9.0;
+        // Let the fetch thread reschedule with the new period
+        {
+            std::lock_guard<std::mutex> lock(fetchLock);
+            fetchPeriod = getFetchPeriod();
+        }
+        fetchCV.notify_all();
     }
 
-    setParameterValue(key, temperatureValue);
+    return result;
 }
 
-void WeewxJSON::handleRawData(json value, std::string key)
+void WeewxJSON::handleTemperatureData(const Reading &reading, const std::string &key)
 {
-    double rawValue = 0.0;
+    double temperatureValue = reading.value;
 
-    value["value"].get_to(rawValue);
+    if (strcmp(reading.units.c_str(), "°F") == 0)
+    {
+        temperatureValue = (temperatureValue - 32.0) * 5.0 / 9.0;
+    }
 
-    setParameterValue(key, rawValue);
+    setParameterValue(key, temperatureValue);
 }
 
-void WeewxJSON::handleBarometerData(json value, std::string key)
+void WeewxJSON::handleRawData(const Reading &reading, const std::string &key)
 {
-    double pressureValue = 0.0;
-    std::string units;
+    setParameterValue(key, reading.value);
+}
 
-    value["value"].get_to(pressureValue);
-    value["units"].get_to(units);
+void WeewxJSON::handleBarometerData(const Reading &reading, const std::string &key)
+{
+    double pressureValue = reading.value;
 
-    if (strcmp(units.c_str(), "inHg") == 0)
+    if (strcmp(reading.units.c_str(), "inHg") == 0)
     {
         pressureValue = pressureValue * 33.864;
     }
@@ -196,15 +328,11 @@ void WeewxJSON::handleBarometerData(json value, std::string key)
     setParameterValue(key, pressureValue);
 }
 
-void WeewxJSON::handleWindSpeedData(json value, std::string key)
+void WeewxJSON::handleWindSpeedData(const Reading &reading, const std::string &key)
 {
-    double speedValue = 0.0;
-    std::string units;
+    double speedValue = reading.value;
 
-    value["value"].get_to(speedValue);
-    value["units"].get_to(units);
-
-    if (strcmp(units.c_str(), "mph") == 0)
+    if (strcmp(reading.units.c_str(), "mph") == 0)
     {
         speedValue = speedValue * 1.609;
     }
@@ -212,15 +340,11 @@ void WeewxJSON::handleWindSpeedData(json value, std::string key)
     setParameterValue(key, speedValue);
 }
 
-void WeewxJSON::handleRainRateData(json value, std::string key)
+void WeewxJSON::handleRainRateData(const Reading &reading, const std::string &key)
 {
-    double rainRate = 0.0;
-    std::string units;
-
-    value["value"].get_to(rainRate);
-    value["units"].get_to(units);
+    double rainRate = reading.value;
 
-    if (strcmp(units.c_str(), "in/hr") == 0)
+    if (strcmp(reading.units.c_str(), "in/hr") == 0)
     {
         rainRate = rainRate * 25.4;
     }
@@ -228,28 +352,28 @@ void WeewxJSON::handleRainRateData(json value, std::string key)
     setParameterValue(key, rainRate);
 }
 
-void WeewxJSON::handleWeatherData(json value)
+void WeewxJSON::handleWeatherData(const Readings &readings)
 {
-    if (value.contains("temperature"))
-        handleTemperatureData(value["temperature"], "WEATHER_TEMPERATURE");
-    if (value.contains("dewpoint"))
-        handleTemperatureData(value["dewpoint"], "WEATHER_DEW_POINT");
-    if (value.contains("humidity"))
-        handleRawData(value["humidity"], "WEATHER_HUMIDITY");
-    if (value.contains("heat index"))
-        handleTemperatureData(value["heat index"], "WEATHER_HEAT_INDEX");
-    if (value.contains("barometer"))
-        handleBarometerData(value["barometer"], "WEATHER_BAROMETER");
-    if (value.contains("wind speed"))
-        handleWindSpeedData(value["wind speed"], "WEATHER_WIND_SPEED");
-    if (value.contains("wind gust"))
-        handleWindSpeedData(value["wind gust"], "WEATHER_WIND_GUST");
-    if (value.contains("wind direction"))
-        handleRawData(value["wind direction"], "WEATHER_WIND_DIRECTION");
-    if (value.contains("wind chill"))
-        handleTemperatureData(value["wind chill"], "WEATHER_WIND_CHILL");
-    if (value.contains("rain rate"))
-        handleRainRateData(value["rain rate"], "WEATHER_RAIN_RATE");
+    if (readings[FIELD_TEMPERATURE].valid)
+        handleTemperatureData(readings[FIELD_TEMPERATURE], "WEATHER_TEMPERATURE");
+    if (readings[FIELD_DEW_POINT].valid)
+        handleTemperatureData(readings[FIELD_DEW_POINT], "WEATHER_DEW_POINT");
+    if (readings[FIELD_HUMIDITY].valid)
+        handleRawData(readings[FIELD_HUMIDITY], "WEATHER_HUMIDITY");
+    if (readings[FIELD_HEAT_INDEX].valid)
+        handleTemperatureData(readings[FIELD_HEAT_INDEX], "WEATHER_HEAT_INDEX");
+    if (readings[FIELD_BAROMETER].valid)
+        handleBarometerData(readings[FIELD_BAROMETER], "WEATHER_BAROMETER");
+    if (readings[FIELD_WIND_SPEED].valid)
+        handleWindSpeedData(readings[FIELD_WIND_SPEED], "WEATHER_WIND_SPEED");
+    if (readings[FIELD_WIND_GUST].valid)
+        handleWindSpeedData(readings[FIELD_WIND_GUST], "WEATHER_WIND_GUST");
+    if (readings[FIELD_WIND_DIRECTION].valid)
+        handleRawData(readings[FIELD_WIND_DIRECTION], "WEATHER_WIND_DIRECTION");
+    if (readings[FIELD_WIND_CHILL].valid)
+        handleTemperatureData(readings[FIELD_WIND_CHILL], "WEATHER_WIND_CHILL");
+    if (readings[FIELD_RAIN_RATE].valid)
+        handleRainRateData(readings[FIELD_RAIN_RATE], "WEATHER_RAIN_RATE");
 }
 
 IPState WeewxJSON::updateWeather()
@@ -257,50 +381,254 @@ IPState WeewxJSON::updateWeather()
     if (isDebug())
         IDLog("%s: updateWeather()\n", getDeviceName());
 
-    CURL *curl;
-    CURLcode res;
+    std::unique_lock<std::mutex> lock(fetchLock);
+
+    // Only the first update after connecting waits for the report, later ones
+    // publish whatever the fetch thread got last.
+    fetchCV.wait_for(lock, std::chrono::seconds(FIRST_FETCH_TIMEOUT), [this]()
+    {
+        return fetchCount > 0;
+    });
+
+    if (fetchCount == 0)
+    {
+        LOGF_ERROR("HTTP request to %s failed.", fetchUrl.c_str());
+        return IPS_ALERT;
+    }
+
+    // Without periodic updates nothing is fetched in the background, so a
+    // manual refresh asks for a new report and waits for it.
+    if (fetchPeriod == 0)
+    {
+        uint32_t previousCount = fetchCount;
+        fetchWake = true;
+        fetchCV.notify_all();
+        fetchCV.wait_for(lock, std::chrono::seconds(FIRST_FETCH_TIMEOUT), [this, previousCount]()
+        {
+            return fetchCount != previousCount;
+        });
+    }
+
+    if (!fetchError.empty())
+    {
+        LOG_ERROR(fetchError.c_str());
+        return IPS_ALERT;
+    }
+
+    Readings readings = currentReadings;
+    lock.unlock();
+
+    handleWeatherData(readings);
+
+    return IPS_OK;
+}
+
+void WeewxJSON::startFetching()
+{
+    stopFetching();
+
+    {
+        std::lock_guard<std::mutex> lock(fetchLock);
+        fetchQuit   = false;
+        fetchWake   = false;
+        fetchCount  = 0;
+        fetchError.clear();
+        fetchUrl    = weewxJsonUrl[WEEWX_URL].getText() ? weewxJsonUrl[WEEWX_URL].getText() : "";
+        fetchPeriod = getFetchPeriod();
+    }
+
+    fetchThread = std::thread(&WeewxJSON::fetchLoop, this);
+}
+
+uint32_t WeewxJSON::getFetchPeriod()
+{
+    // The readings are only published once per update period, fetching
+    // the report more often would just load the server.
+    return static_cast<uint32_t>(WI::UpdatePeriodNP[0].getValue() * 1000);
+}
+
+void WeewxJSON::stopFetching()
+{
+    {
+        std::lock_guard<std::mutex> lock(fetchLock);
+        fetchQuit = true;
+    }
+    fetchCV.notify_all();
+
+    if (fetchThread.joinable())
+        fetchThread.join();
+}
+
+void WeewxJSON::fetchLoop()
+{
+    CURL *curl = curl_easy_init();
+
+    if (curl == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(fetchLock);
+        fetchError = "Cannot initialize CURL, connection to HTTP server failed.";
+        fetchCount++;
+        fetchCV.notify_all();
+        return;
+    }
+
+    // The handle lives as long as the connection so curl can keep the
+    // connection to the server open between requests.
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
 
-    curl = curl_easy_init();
-    if (curl)
+    std::string previousUrl;
+    std::unique_lock<std::mutex> lock(fetchLock);
+
+    while (!fetchQuit)
     {
-        struct response_t chunk = { .response = nullptr, .size = 0 };
+        std::string url = fetchUrl;
+        fetchWake = false;
+        lock.unlock();
 
-        curl_easy_setopt(curl, CURLOPT_URL, weewxJsonUrl[WEEWX_URL].text);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, cb);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &chunk);
+        // Validators of another report are of no use
+        if (url != previousUrl)
+        {
+            etag.clear();
+            lastModified.clear();
+            previousUrl = url;
+        }
 
-        res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+        std::string error;
+        Readings readings;
+        FetchResult result = fetchReport(curl, url, error);
 
-        if (res == CURLcode::CURLE_OK)
+        if (result == FETCH_OK)
         {
-            nlohmann::json report = nlohmann::json::parse(chunk.response);
+            CurrentReadingsParser parser(readings);
 
-            if (report.contains("current"))
+            if (!json::sax_parse(body, &parser))
             {
-                handleWeatherData(report["current"]);
+                error = "Cannot parse weather report.";
+                result = FETCH_FAILED;
             }
-            else
+            else if (!parser.foundCurrent)
             {
-                LOG_ERROR("No current weather data found in report.");
-                return IPS_ALERT;
+                error = "No current weather data found in report.";
+                result = FETCH_FAILED;
             }
 
-            return IPS_OK;
+            // Do not let a broken report be skipped as unchanged next time
+            if (result == FETCH_FAILED)
+            {
+                etag.clear();
+                lastModified.clear();
+            }
         }
-        else
+
+        lock.lock();
+
+        if (result == FETCH_OK)
+            currentReadings = readings;
+        fetchError = error;
+        fetchCount++;
+        fetchCV.notify_all();
+
+        // The period is re-read after every wake up so a changed update
+        // period takes effect without waiting for the old one to expire.
+        auto fetched = std::chrono::steady_clock::now();
+        while (!fetchQuit && !fetchWake)
         {
-            LOGF_ERROR("HTTP request to %s failed.", weewxJsonUrl[WEEWX_URL].text);
-            return IPS_ALERT;
+            if (fetchPeriod == 0)
+                fetchCV.wait(lock);
+            else if (fetchCV.wait_until(lock, fetched + std::chrono::milliseconds(fetchPeriod)) == std::cv_status::timeout)
+                break;
         }
     }
-    else
+
+    lock.unlock();
+    curl_easy_cleanup(curl);
+}
+
+WeewxJSON::FetchResult WeewxJSON::fetchReport(CURL *curl, const std::string &url, std::string &error)
+{
+    struct curl_slist *headers = nullptr;
+
+    // Ask the server to only send the report if it changed since the last one
+    if (!etag.empty())
+        headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+    if (!lastModified.empty())
+        headers = curl_slist_append(headers, ("If-Modified-Since: " + lastModified).c_str());
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+    body.clear();
+    newEtag.clear();
+    newLastModified.clear();
+
+    CURLcode res = curl_easy_perform(curl);
+
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+    curl_slist_free_all(headers);
+
+    long code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+
+    if (res != CURLE_OK || (code != 0 && code != 200 && code != 304))
     {
-        LOGF_ERROR("Cannot initialize CURL, connection to HTTP server %s failed.", weewxJsonUrl[WEEWX_URL].text);
-        return IPS_ALERT;
+        error = "HTTP request to " + url + " failed.";
+        return FETCH_FAILED;
     }
 
-    return IPS_OK;
+    if (code == 304)
+        return FETCH_UNCHANGED;
+
+    etag = newEtag;
+    lastModified = newLastModified;
+
+    return FETCH_OK;
+}
+
+size_t WeewxJSON::writeCallback(void *data, size_t size, size_t nmemb, void *userp)
+{
+    size_t realsize = size * nmemb;
+    WeewxJSON *self = static_cast<WeewxJSON *>(userp);
+
+    // The buffer keeps its capacity from one report to the next
+    self->body.append(static_cast<const char *>(data), realsize);
+
+    return realsize;
+}
+
+size_t WeewxJSON::headerCallback(char *data, size_t size, size_t nmemb, void *userp)
+{
+    size_t realsize = size * nmemb;
+    WeewxJSON *self = static_cast<WeewxJSON *>(userp);
+
+    auto value = [&](const char *name) -> std::string
+    {
+        size_t length = strlen(name);
+        if (realsize <= length || strncasecmp(data, name, length) != 0)
+            return std::string();
+
+        size_t start = length, end = realsize;
+        while (start < end && (data[start] == ' ' || data[start] == '\t'))
+            start++;
+        while (end > start && (data[end - 1] == '\r' || data[end - 1] == '\n' || data[end - 1] == ' '))
+            end--;
+        return std::string(data + start, end - start);
+    };
+
+    std::string etag = value("ETag:");
+    if (!etag.empty())
+        self->newEtag = etag;
+
+    std::string lastModified = value("Last-Modified:");
+    if (!lastModified.empty())
+        self->newLastModified = lastModified;
+
+    return realsize;
 }
 
 bool WeewxJSON::saveConfigItems(FILE *fp)
@@ -27,6 +27,15 @@
 
 #include <libindi/indiweather.h>
 #include <libindi/indipropertytext.h>
+
+#include <curl/curl.h>
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #ifdef _USE_SYSTEM_JSONLIB
 #include <nlohmann/json.hpp>
 #else
@@ -50,23 +59,86 @@ class WeewxJSON : public INDI::Weather
     bool updateProperties() override;
     virtual void ISGetProperties(const char *dev) override;
     virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
+    virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+
+    /* Entries of the "current" section of the report used by the driver */
+    enum
+    {
+        FIELD_TEMPERATURE,
+        FIELD_DEW_POINT,
+        FIELD_HUMIDITY,
+        FIELD_HEAT_INDEX,
+        FIELD_BAROMETER,
+        FIELD_WIND_SPEED,
+        FIELD_WIND_GUST,
+        FIELD_WIND_DIRECTION,
+        FIELD_WIND_CHILL,
+        FIELD_RAIN_RATE,
+        FIELD_COUNT
+    };
+
+    struct Reading
+    {
+        bool valid { false };
+        double value { 0 };
+        std::string units;
+    };
+
+    typedef std::array<Reading, FIELD_COUNT> Readings;
 
   protected:
-    void handleTemperatureData(json value, std::string key);
-    void handleRawData(json value, std::string key);
-    void handleBarometerData(json value, std::string key);
-    void handleWindSpeedData(json value, std::string key);
-    void handleRainRateData(json value, std::string key);
-    void handleWeatherData(json value);
+    void handleTemperatureData(const Reading &reading, const std::string &key);
+    void handleRawData(const Reading &reading, const std::string &key);
+    void handleBarometerData(const Reading &reading, const std::string &key);
+    void handleWindSpeedData(const Reading &reading, const std::string &key);
+    void handleRainRateData(const Reading &reading, const std::string &key);
+    void handleWeatherData(const Readings &readings);
 
     virtual IPState updateWeather() override;
 
     virtual bool saveConfigItems(FILE *fp) override;
 
   private:
+    enum FetchResult
+    {
+        FETCH_OK,
+        FETCH_UNCHANGED,
+        FETCH_FAILED
+    };
+
+    void startFetching();
+    void stopFetching();
+    void fetchLoop();
+    uint32_t getFetchPeriod();
+    FetchResult fetchReport(CURL *curl, const std::string &url, std::string &error);
+
+    static size_t writeCallback(void *data, size_t size, size_t nmemb, void *userp);
+    static size_t headerCallback(char *data, size_t size, size_t nmemb, void *userp);
+
     INDI::PropertyText weewxJsonUrl{ 1 };
     enum
     {
         WEEWX_URL,
     };
+
+    /* The report is fetched from a background thread over a persistent curl
+     * handle, updateWeather only publishes the latest readings. */
+    std::thread fetchThread;
+    std::mutex fetchLock;
+    std::condition_variable fetchCV;
+    bool fetchQuit { false };
+    bool fetchWake { false };
+    std::string fetchUrl;
+    /* Follows the weather update period, 0 fetches only on request */
+    uint32_t fetchPeriod { 60000 };
+
+    /* Result of the latest fetch, protected by fetchLock */
+    uint32_t fetchCount { 0 };
+    std::string fetchError;
+    Readings currentReadings;
+
+    /* Only used by the fetch thread */
+    std::string body;
+    std::string etag, newEtag;
+    std::string lastModified, newLastModified;
 };
@@ -478,6 +478,23 @@ Apg::Status Alta::GetImagingStatus()
 //////////////////////////// 
 // GET  IMAGE 
 void Alta::GetImage( std::vector<uint16_t> & out )
+{
+    uint16_t r=0, c = 0;
+    ExposureAndGetImgRC( r, c );
+    const uint32_t NumPixels = r*GetImageZ()*GetRoiNumCols();
+
+    if( NumPixels != out.size() )
+    {
+        out.clear();
+        out.resize( NumPixels );
+    }
+
+    GetImage( &out[0], NumPixels );
+}
+
+//////////////////////////// 
+// GET  IMAGE 
+void Alta::GetImage( uint16_t * out, const uint32_t NumPixels )
 {
 #ifdef DEBUGGING_CAMERA
     apgHelper::DebugMsg( "Alta::GetImage -> BEGINNING" );
@@ -512,40 +529,36 @@ void Alta::GetImage( std::vector<uint16_t> & out )
         }
     }
 
-    // allocating the buffers for the image
-    // doing this outside of the try / catch, so that
-    // even if the GetImage function throws
-    // we can try to copy whatever data we managed
-    // to fetch from the camera into the user supplied
-    // vector
     uint16_t r=0, c = 0;
     ExposureAndGetImgRC( r, c );
     const uint16_t z = GetImageZ();
-    std::vector<uint16_t> datafromCam( r*c*z, 0 ); 
 
     const int32_t dataLen = r*z;
     const int32_t numCols = GetRoiNumCols();  
 
-    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    if( apgHelper::SizeT2Int32( NumPixels ) < dataLen*numCols )
     {
-        out.clear();
-        out.resize( dataLen*numCols );
+        std::stringstream msg;
+        msg << "Image buffer of " << NumPixels << " pixels too small, ";
+        msg << dataLen*numCols << " pixels required.";
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_InvalidUsage );
     }
 
+    // the AD garbage pixels at the beginning of every row are
+    // removed as the data arrives, so even if the download throws
+    // whatever we managed to fetch is already in the user buffer
+    ImgFix::RowFixer fixer( ImgFix::RowFixer::SINGLE, out, dataLen, numCols,
+        m_CcdAcqSettings->GetPixelShift() );
+
     try
     {
-        m_CamIo->GetImageData( datafromCam );
+        m_CamIo->GetImageData( r*c*z, 
+            [&fixer]( const uint16_t * data, uint32_t count ) { fixer.Push( data, count ); } );
     }
     catch(std::exception & err )
     {
         m_ImageInProgress = false;
-        
-        // log and remove the AD garbage pixels at the beginning of every row
-        std::string msg( "Removing AD latency pixels in exception handler" );
-        ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
-        apgHelper::mkMsg( m_fileName, msg, __LINE__) );
-
-        FixImgFromCamera( datafromCam, out, dataLen, numCols );
         throw;
     }
     
@@ -578,9 +591,6 @@ void Alta::GetImage( std::vector<uint16_t> & out )
 #ifdef DEBUGGING_CAMERA
     apgHelper::DebugMsg( "Alta::GetImage -> m_ImageInProgress = %d", m_ImageInProgress );
 #endif
-
-    // removing the AD garbage pixels at the beginning of every row
-    FixImgFromCamera( datafromCam, out, dataLen, numCols );
   
     ApgLogger::Instance().Write(ApgLogger::LEVEL_DEBUG,"info","Get Image Completed.");
 
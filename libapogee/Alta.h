@@ -40,6 +40,7 @@ class DLL_EXPORT Alta : public ApogeeCam
         Apg::Status GetImagingStatus();
       
         void GetImage( std::vector<uint16_t> & out );
+        void GetImage( uint16_t * out, uint32_t NumPixels );
 
         void StopExposure( bool Digitize );
 
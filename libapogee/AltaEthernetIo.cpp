@@ -14,6 +14,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cstring>  //for memset
+#include <algorithm>
 
 #include "libCurlWrap.h" 
 #include "apgHelper.h" 
@@ -100,12 +101,138 @@ namespace
             return ss.str();
         }
     }
+
+    //  SWAP     BIG     ENDIAN
+    // the pixels come over the wire big endian, swap them four at
+    // a time in a 64 bit word, the plain per pixel loop is not
+    // vectorized by the compiler at the usual optimization level
+    void SwapBigEndian( const uint8_t * in, uint16_t * out, const size_t count )
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        memcpy( out, in, count*sizeof(uint16_t) );
+#else
+        const uint64_t LOW_BYTES = 0x00FF00FF00FF00FFULL;
+        size_t i = 0;
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            uint64_t v = 0;
+            memcpy( &v, in + 2*i, sizeof(v) );
+            v = ((v & LOW_BYTES) << 8) | ((v >> 8) & LOW_BYTES);
+            memcpy( out + i, &v, sizeof(v) );
+        }
+
+        for( ; i < count; ++i )
+        {
+            out[i] = static_cast<uint16_t>( (in[2*i] << 8) | in[2*i+1] );
+        }
+#endif
+    }
+
+    //  IMAGE     DECODER
+    // decodes the image.bin body while curl receives it, either straight
+    // into the destination or chunk by chunk to a sink.  curl may split a
+    // pixel across two writes, so the odd byte is kept for the next one.
+    class ImageDecoder
+    {
+        public:
+            ImageDecoder( uint16_t * out, const uint32_t NumPixels ) :
+                m_Out( out ), m_Sink( 0 ), m_Scratch( 0 ),
+                m_NumPixels( NumPixels ), m_NumBytes( 0 ), m_HighByte( 0 )
+            {
+            }
+
+            ImageDecoder( const ICamIo::ImgDataSink & sink, std::vector<uint16_t> & scratch,
+                const uint32_t NumPixels ) :
+                m_Out( 0 ), m_Sink( &sink ), m_Scratch( &scratch ),
+                m_NumPixels( NumPixels ), m_NumBytes( 0 ), m_HighByte( 0 )
+            {
+            }
+
+            void Write( const uint8_t * data, const size_t size )
+            {
+                const size_t ExpectedBytes = m_NumPixels * sizeof(uint16_t);
+                const size_t start = m_NumBytes;
+                m_NumBytes += size;
+
+                // anything past the expected image is only counted
+                size_t len = start < ExpectedBytes ? 
+                    std::min( size, ExpectedBytes - start ) : 0;
+
+                if( 0 == len )
+                {
+                    return;
+                }
+
+                uint16_t * dst = 0;
+                if( m_Sink )
+                {
+                    if( m_Scratch->size() < len / 2 + 1 )
+                    {
+                        m_Scratch->resize( len / 2 + 1 );
+                    }
+                    dst = &(*m_Scratch)[0];
+                }
+                else
+                {
+                    dst = m_Out + start / 2;
+                }
+
+                size_t n = 0;
+
+                // finish the pixel split by the previous write
+                if( start % 2 )
+                {
+                    dst[n++] = static_cast<uint16_t>( (m_HighByte << 8) | data[0] );
+                    ++data;
+                    --len;
+                }
+
+                SwapBigEndian( data, dst + n, len / 2 );
+                n += len / 2;
+
+                if( len % 2 )
+                {
+                    m_HighByte = data[len-1];
+                }
+
+                if( m_Sink && n )
+                {
+                    (*m_Sink)( dst, static_cast<uint32_t>( n ) );
+                }
+            }
+
+            size_t GetNumBytes() const { return m_NumBytes; }
+
+        private:
+            uint16_t * m_Out;
+            const ICamIo::ImgDataSink * m_Sink;
+            std::vector<uint16_t> * m_Scratch;
+            const size_t m_NumPixels;
+            size_t m_NumBytes;
+            uint8_t m_HighByte;
+    };
+
+    //  CHECK    IMAGE      SIZE
+    void CheckImageSize( const std::string & fileName, const std::string & url,
+        const size_t received, const size_t requested )
+    {
+        if( received != requested )
+        {
+            std::stringstream errMsg;
+            errMsg << url << " error - " << requested << " bytes requested ";
+            errMsg << received << " bytes received.";
+            apgHelper::throwRuntimeException( fileName, errMsg.str(), 
+                __LINE__, Apg::ErrorType_Critical );
+        }
+    }
 }
 
 //////////////////////////// 
 // CTOR 
 AltaEthernetIo::AltaEthernetIo( const std::string url ) : m_url( url ),
-                                                          m_fileName( __BASE_FILE__ )
+                                                          m_fileName( __BASE_FILE__ ),
+                                                          m_libcurl( new CLibCurlWrap )
 
 { 
     //open a session with the camera
@@ -133,10 +260,8 @@ void AltaEthernetIo::OpenSession()
 {
     const std::string fullUrl = m_url + "/SESSION?Open";
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
      if( std::string::npos == result.find("SessionId=") )
     {
@@ -157,10 +282,8 @@ void AltaEthernetIo::CloseSession()
 {
     const std::string fullUrl = m_url + "/SESSION?Close";
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
      if( std::string::npos == result.find("SessionId=") )
     {
@@ -184,9 +307,8 @@ uint16_t AltaEthernetIo::ReadReg( uint16_t reg ) const
 
     const std::string finalUrl = m_url + "/FPGA?RR="+ help::uShort2Str( reg );
         
-    CLibCurlWrap theCurl;
     std::string result;
-    theCurl.HttpGet( finalUrl, result );
+    m_libcurl->HttpGet( finalUrl, result );
 
     std::vector<std::string> tokens = help::MakeTokens(result,"=");
 
@@ -228,9 +350,8 @@ std::map<uint16_t,uint16_t> AltaEthernetIo::ReadRegs(const std::vector<uint16_t>
          if( MAX_READS_PER_URL-1 == count )
         {
             //send the max data
-            CLibCurlWrap theCurl;
             std::string result;
-            theCurl.HttpGet( finalUrl, result );
+            m_libcurl->HttpGet( finalUrl, result );
             finalResult.append( result );
 
             //reset
@@ -248,9 +369,8 @@ std::map<uint16_t,uint16_t> AltaEthernetIo::ReadRegs(const std::vector<uint16_t>
     if( count )
     {
         //send the cmd
-        CLibCurlWrap theCurl;
         std::string result;
-        theCurl.HttpGet( finalUrl, result );
+        m_libcurl->HttpGet( finalUrl, result );
         finalResult.append( result );
     }
 
@@ -299,10 +419,8 @@ void AltaEthernetIo::WriteReg( uint16_t reg, uint16_t val )
     std::string fullUrl = m_url + "/FPGA?WR=" +
         help::uShort2Str(reg) + "&WD=" + help::uShort2Str(val, true);
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
 }
 
@@ -322,45 +440,30 @@ void AltaEthernetIo::WriteMRMD(const uint16_t reg, const std::vector<uint16_t> &
 // GET  IMAGE   DATA
 void AltaEthernetIo::GetImageData(std::vector<uint16_t> & ImageData)
 {
-    const int32_t NumBytesExpected = 
-        apgHelper::SizeT2Int32( ImageData.size() )*sizeof(uint16_t);
-
-    //grab the data
+    //grab the data, decoding it straight into the output
     std::string fullUrl = m_url + "/UE/image.bin";
 
-    CLibCurlWrap theCurl;
-    std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    ImageDecoder decoder( &ImageData[0], apgHelper::SizeT2Uint32( ImageData.size() ) );
+    m_libcurl->HttpGetStream( fullUrl, 
+        [&decoder]( const uint8_t * data, size_t size ) { decoder.Write( data, size ); } );
 
-    if( NumBytesExpected !=  apgHelper::SizeT2Int32( result.size() ) )
-    {
-        std::stringstream received;
-        received <<  result.size();
-
-        std::stringstream requested;
-        requested << NumBytesExpected;
+    CheckImageSize( m_fileName, fullUrl, decoder.GetNumBytes(), 
+        ImageData.size()*sizeof(uint16_t) );
+}
 
-        std::string errMsg = fullUrl + " error - " + requested.str() \
-            + " bytes requested " + received.str() + " bytes received.";
-        apgHelper::throwRuntimeException( m_fileName, errMsg, 
-            __LINE__, Apg::ErrorType_Critical );
-    }
-    
-    std::string::iterator strIter;
-    std::string::iterator strIterNext;
-    std::vector<uint16_t>::iterator dataIter;
-    int32_t i=0;
+//////////////////////////// 
+// GET  IMAGE   DATA
+void AltaEthernetIo::GetImageData( const uint32_t NumPixels, const ImgDataSink & sink )
+{
+    //grab the data, handing every decoded chunk to the sink
+    std::string fullUrl = m_url + "/UE/image.bin";
 
-    for(strIter = result.begin(); strIter != result.end(); strIter+=2, ++i)
-    {
-        strIterNext = strIter+1;
-        uint8_t a = (*strIter);
-        uint8_t b = (*strIterNext);
+    ImageDecoder decoder( sink, m_ImgScratch, NumPixels );
+    m_libcurl->HttpGetStream( fullUrl, 
+        [&decoder]( const uint8_t * data, size_t size ) { decoder.Write( data, size ); } );
 
-        //TODO verify this works on mac...
-        uint16_t v = ((a << 8) | b);
-        ImageData.at(i) = v;
-    }
+    CheckImageSize( m_fileName, fullUrl, decoder.GetNumBytes(), 
+        static_cast<size_t>( NumPixels )*sizeof(uint16_t) );
 }
 
 //////////////////////////// 
@@ -386,10 +489,8 @@ void AltaEthernetIo::SetupImgXfer(const uint16_t Rows,
     const std::string fullUrl = m_url + "/FPGA?CI=0,0," + help::uShort2Str(Cols)
         + "," + rolled.str() + ",0xFFFFFFFF"; 
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
 }
 
@@ -472,13 +573,11 @@ void AltaEthernetIo::GetMacAddress( std::string & Mac )
    
     const std::string fullUrl = m_url + "/NVRAM?Tag=10&Length=6&Get";
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
     const std::string dataUrl = m_url + "/UE/nvram.bin";
-    theCurl.HttpGet( dataUrl, Mac );
+    m_libcurl->HttpGet( dataUrl, Mac );
 
 }
 
@@ -488,10 +587,8 @@ void AltaEthernetIo::Reboot()
 {
     const std::string fullUrl = m_url + "/REBOOT?Submit=Reboot";
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
 }
 
@@ -513,9 +610,8 @@ void AltaEthernetIo::WriteSRMD(const uint16_t reg, const std::vector<uint16_t> &
         if( MAX_WRITES_PER_URL-1 == count )
         {
             //send the max data
-            CLibCurlWrap theCurl;
             std::string result;
-            theCurl.HttpGet( fullUrl, result );
+            m_libcurl->HttpGet( fullUrl, result );
 
             //reset
             count = 0;
@@ -530,9 +626,8 @@ void AltaEthernetIo::WriteSRMD(const uint16_t reg, const std::vector<uint16_t> &
     //send any remaining data
     if( count )
     {
-        CLibCurlWrap theCurl;
         std::string result;
-        theCurl.HttpGet( fullUrl, result );
+        m_libcurl->HttpGet( fullUrl, result );
     }
 }
 
@@ -552,8 +647,7 @@ std::string AltaEthernetIo::GetNetworkSettings()
 //      GET    DRIVER   VERSION
 std::string AltaEthernetIo::GetDriverVersion()
 {
-    CLibCurlWrap theCurl;
-    return theCurl.GetVerison();
+    return m_libcurl->GetVerison();
 }
         
 //////////////////////////// 
@@ -583,10 +677,8 @@ void AltaEthernetIo::SetSerialBaudRate( const uint16_t PortId , const uint32_t B
      std::string fullUrl = m_url + "/SERCFG?SetBitRate=" +
         GetPortStr( PortId ) + "," + uint32ToStr( BaudRate );
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 }
 
 //////////////////////////// 
@@ -595,9 +687,8 @@ uint32_t AltaEthernetIo::GetSerialBaudRate(  const uint16_t PortId  )
 {
     const std::string finalUrl = m_url + "/SERCFG?GetBitRate="+ GetPortStr( PortId );
         
-    CLibCurlWrap theCurl;
     std::string result;
-    theCurl.HttpGet( finalUrl, result );
+    m_libcurl->HttpGet( finalUrl, result );
 
     std::vector<std::string> tokens = help::MakeTokens(result,",");
 
@@ -615,9 +706,8 @@ Apg::SerialFC AltaEthernetIo::GetSerialFlowControl( uint16_t PortId )
 {
     const std::string finalUrl = m_url + "/SERCFG?GetFlowControl="+ GetPortStr( PortId );
         
-    CLibCurlWrap theCurl;
     std::string result;
-    theCurl.HttpGet( finalUrl, result );
+    m_libcurl->HttpGet( finalUrl, result );
 
     std::vector<std::string> tokens = help::MakeTokens(result,",");
 
@@ -665,10 +755,8 @@ void AltaEthernetIo::SetSerialFlowControl( uint16_t PortId,
     const std::string fullUrl = m_url + "/SERCFG?SetFlowControl="+ GetPortStr( PortId ) +
         "," + cflowStr;
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
 }
 
@@ -678,9 +766,8 @@ Apg::SerialParity AltaEthernetIo::GetSerialParity( uint16_t PortId )
 {
     const std::string finalUrl = m_url + "/SERCFG?GetParityBits="+ GetPortStr( PortId );
         
-    CLibCurlWrap theCurl;
     std::string result;
-    theCurl.HttpGet( finalUrl, result );
+    m_libcurl->HttpGet( finalUrl, result );
 
     std::vector<std::string> tokens = help::MakeTokens(result,",");
     
@@ -737,10 +824,8 @@ void AltaEthernetIo::SetSerialParity( uint16_t PortId,
     const std::string fullUrl = m_url + "/SERCFG?SetParityBits="+ GetPortStr( PortId ) +
         "," + parityStr;
 
-    CLibCurlWrap theCurl;
-
     std::string result;
-    theCurl.HttpGet( fullUrl, result );
+    m_libcurl->HttpGet( fullUrl, result );
 
 }
 
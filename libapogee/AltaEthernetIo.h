@@ -20,6 +20,8 @@
 #include "ICamIo.h" 
 #include "IAltaSerialPortIo.h" 
 
+class CLibCurlWrap;
+
 class AltaEthernetIo : public ICamIo, public IAltaSerialPortIo
 { 
     public: 
@@ -42,6 +44,7 @@ class AltaEthernetIo : public ICamIo, public IAltaSerialPortIo
         void CancelImgXfer();
 
         void GetImageData( std::vector<uint16_t> & data );
+        void GetImageData( uint32_t NumPixels, const ImgDataSink & sink );
 
         void GetStatus(CameraStatusRegs::AdvStatus & status);
         void GetStatus(CameraStatusRegs::BasicStatus & status);
@@ -85,6 +88,11 @@ class AltaEthernetIo : public ICamIo, public IAltaSerialPortIo
         const std::string m_fileName;
         std::vector<uint16_t> m_StatusRegs;
 
+        // one handle for all requests so the connection is kept open
+        std::shared_ptr<CLibCurlWrap> m_libcurl;
+        // decoded pixels on their way to an image data sink
+        std::vector<uint16_t> m_ImgScratch;
+
         //disabling the copy ctor and assignment operator
         //generated by the compiler - don't want them
         //Effective C++ Item 6
@@ -26,6 +26,7 @@
 #include "AspenIo.h"  
 #include "AltaIo.h"  
 #include <sstream>
+#include <algorithm>
 
 namespace
 {    
@@ -2637,6 +2638,27 @@ void ApogeeCam::GrabImageAndThrowItAway()
     GetImage( data );
 }
 
+//////////////////////////// 
+// GET  IMAGE 
+void ApogeeCam::GetImage( uint16_t * out, const uint32_t NumPixels )
+{
+    // camera models without a streaming download collect the whole
+    // image first and copy it into the user buffer
+    std::vector<uint16_t> data;
+    GetImage( data );
+
+    if( NumPixels < data.size() )
+    {
+        std::stringstream msg;
+        msg << "Image buffer of " << NumPixels << " pixels too small, ";
+        msg << data.size() << " pixels required.";
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_InvalidUsage );
+    }
+
+    std::copy( data.begin(), data.end(), out );
+}
+
 //////////////////////////// 
 //      GET    PIXEL      WIDTH
 double ApogeeCam::GetPixelWidth()
@@ -1324,6 +1324,21 @@ class DLL_EXPORT ApogeeCam
         //Effective C++ Item 6
         ApogeeCam(const ApogeeCam&);
         ApogeeCam& operator=(ApogeeCam&);
+
+    public:
+        // Added in 3.3.  Declared last so the existing vtable layout is kept
+        // and programs built against earlier 3.x releases keep working.
+
+        /*! 
+         * Downloads the image data from the camera straight into a caller
+         * supplied buffer.  The AD latency pixels are removed and multiple
+         * output data is re-ordered while the download is in progress.
+         * \param [out] out Buffer that will recieve the image data
+         * \param [in] NumPixels Size of the buffer in pixels, it must hold at least
+         * GetRoiNumRows() * GetRoiNumCols() pixels for every image downloaded
+         * \exception std::runtime_error
+         */
+        virtual void GetImage( uint16_t * out, uint32_t NumPixels );
 }; 
 
 #endif
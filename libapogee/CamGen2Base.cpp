@@ -18,6 +18,7 @@
 #include "CcdAcqParams.h" 
 #include "ApgLogger.h" 
 #include "PlatformData.h" 
+#include "ImgFix.h" 
 
 #include <sstream>
 #include <cstring>  //for memset
@@ -316,9 +317,34 @@ Apg::Status CamGen2Base::GetImagingStatus()
 //////////////////////////// 
 // GET  IMAGE 
 void CamGen2Base::GetImage( std::vector<uint16_t> & out )
+{
+    uint16_t r=0, c= 0;
+    ExposureAndGetImgRC( r, c );
+    const uint32_t NumPixels = r*GetImageZ()*GetRoiNumCols();
+
+    if( NumPixels != out.size() )
+    {
+        out.clear();
+        out.resize( NumPixels );
+    }
+
+    GetImage( &out[0], NumPixels );
+}
+
+//////////////////////////// 
+// GET  IMAGE 
+void CamGen2Base::GetImage( uint16_t * out, const uint32_t NumPixels )
+{
+    DownloadImage( out, NumPixels, true );
+}
+
+//////////////////////////// 
+// DOWNLOAD     IMAGE 
+void CamGen2Base::DownloadImage( uint16_t * out, const uint32_t NumPixels,
+                                 const bool DoPixelReorder )
 {
 #ifdef DEBUGGING_CAMERA
-    apgHelper::DebugMsg( "CamGen2Base::GetImage -> BEGIN" );
+    apgHelper::DebugMsg( "CamGen2Base::DownloadImage -> BEGIN" );
 #endif
 
     ApgLogger::Instance().Write(ApgLogger::LEVEL_DEBUG,"info","Getting Image.");
@@ -341,40 +367,65 @@ void CamGen2Base::GetImage( std::vector<uint16_t> & out )
             __LINE__, Apg::ErrorType_InvalidMode );
     }
 
-
-    // allocating the buffers for the image
-    // doing this outside of the try / catch, so that
-    // even if the GetImage function throws
-    // we can try to copy whatever data we managed
-    // to fetch from the camera into the user supplied
-    // vector
     uint16_t r=0, c= 0;
     ExposureAndGetImgRC( r, c );
     const uint16_t z = GetImageZ();
-    std::vector<uint16_t>  datafromCam( r*c*z );
 
     const int32_t dataLen = r*z;
     const int32_t numCols = GetRoiNumCols();
     
-    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    if( apgHelper::SizeT2Int32( NumPixels ) < dataLen*numCols )
     {
-        out.clear();
-        out.resize( dataLen*numCols );
+        std::stringstream msg;
+        msg << "Image buffer of " << NumPixels << " pixels too small, ";
+        msg << dataLen*numCols << " pixels required.";
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_InvalidUsage );
+    }
+
+    // same fixes as the FixImgFromCamera implementations of the camera models
+    ImgFix::RowFixer::Layout layout = ImgFix::RowFixer::SINGLE;
+    int32_t numLatencyPixels = m_CcdAcqSettings->GetPixelShift();
+
+    switch( m_CamCfgData->m_MetaData.NumAdOutputs )
+    {
+        case 1:
+        break;
+
+        case 2:
+            layout = ImgFix::RowFixer::DUAL;
+            numLatencyPixels *= 2;
+        break;
+
+        case 4:
+            layout = DoPixelReorder ? ImgFix::RowFixer::QUAD :
+                ImgFix::RowFixer::QUAD_NO_REORDER;
+            numLatencyPixels = c - numCols;
+        break;
+
+        default:
+        {
+            std::stringstream msg;
+            msg << "Invaild number of ad outputs = " << m_CamCfgData->m_MetaData.NumAdOutputs;
+            apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+                __LINE__, Apg::ErrorType_InvalidUsage );
+        }
+        break;
     }
 
+    // the AD garbage pixels are removed and the outputs re-ordered
+    // as the data arrives, so even if the download throws whatever
+    // we managed to fetch is already in the user buffer
+    ImgFix::RowFixer fixer( layout, out, dataLen, numCols, numLatencyPixels );
+
     try
     {
-        m_CamIo->GetImageData( datafromCam );
+        m_CamIo->GetImageData( r*c*z, 
+            [&fixer]( const uint16_t * data, uint32_t count ) { fixer.Push( data, count ); } );
     }
     catch(std::exception & err )
     {
         m_ImageInProgress = false;
-        // logging and at a minimum removing the AD garbage pixels at the beginning of every row
-        std::string msg( "Removing AD latency pixels in exception handler" );
-        ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
-        apgHelper::mkMsg( m_fileName, msg, __LINE__) );
-
-        FixImgFromCamera( datafromCam, out, dataLen, numCols );
         throw;
     }
         
@@ -399,14 +450,11 @@ void CamGen2Base::GetImage( std::vector<uint16_t> & out )
         }
     
     }
-    
-    // at a minimum removing the AD garbage pixels at the beginning of every row
-    FixImgFromCamera( datafromCam, out, dataLen, numCols );
 
    ApgLogger::Instance().Write(ApgLogger::LEVEL_DEBUG,"info","Get Image Completed.");
 
 #ifdef DEBUGGING_CAMERA
-    apgHelper::DebugMsg( "CamGen2Base::GetImage -> END" );
+    apgHelper::DebugMsg( "CamGen2Base::DownloadImage -> END" );
 #endif
 
 }
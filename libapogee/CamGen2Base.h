@@ -25,6 +25,7 @@ class DLL_EXPORT CamGen2Base  : public ApogeeCam
         Apg::Status GetImagingStatus();
 
         void GetImage( std::vector<uint16_t> & out );
+        void GetImage( uint16_t * out, uint32_t NumPixels );
 
         void StopExposure( bool Digitize );
 
@@ -51,6 +52,8 @@ class DLL_EXPORT CamGen2Base  : public ApogeeCam
 
         void DefaultStartExposure( double Duration, bool IsLight, bool IssueReset=true );
 
+        void DownloadImage( uint16_t * out, uint32_t NumPixels, bool DoPixelReorder );
+
     private:
         const std::string m_fileName;
 
@@ -13,6 +13,10 @@
 
 #include <sstream>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 
 #include <iostream>
@@ -213,6 +217,130 @@ void CamUsbIo::GetImageData( std::vector<uint16_t> & data )
     
 }
 
+//////////////////////////// 
+// GET  IMAGE   DATA
+void CamUsbIo::GetImageData( const uint32_t NumPixels, const ImgDataSink & sink )
+{
+    // while the sink works on one buffer the next usb read goes into another
+    const size_t NUM_XFER_BUFS = 3;
+    const size_t BufPixels = m_MaxBufSize / sizeof(uint16_t);
+
+    if( NUM_XFER_BUFS != m_XferBufs.size() || BufPixels != m_XferBufs[0].size() )
+    {
+        m_XferBufs.assign( NUM_XFER_BUFS, std::vector<uint16_t>( BufPixels ) );
+    }
+
+    std::mutex lock;
+    std::condition_variable cond;
+    std::deque< std::pair<uint16_t *, uint32_t> > full;
+    std::deque<uint16_t *> empty;
+    bool done = false;
+
+    for( size_t i = 0; i < NUM_XFER_BUFS; ++i )
+    {
+        empty.push_back( &m_XferBufs[i][0] );
+    }
+
+    std::thread worker( [&]()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        for( ;; )
+        {
+            cond.wait( guard, [&]() { return done || !full.empty(); } );
+
+            if( full.empty() )
+            {
+                break;
+            }
+
+            std::pair<uint16_t *, uint32_t> chunk = full.front();
+            full.pop_front();
+
+            guard.unlock();
+            sink( chunk.first, chunk.second );
+            guard.lock();
+
+            empty.push_back( chunk.first );
+            cond.notify_all();
+        }
+    } );
+
+    // let the worker drain the chunks already read, also when the
+    // read throws, so the caller keeps whatever was downloaded
+    auto finish = [&]()
+    {
+        {
+            std::lock_guard<std::mutex> guard( lock );
+            done = true;
+        }
+        cond.notify_all();
+        worker.join();
+    };
+
+    //the padding is read from the camera, but not passed to the sink
+    const int32_t PadSize = GetPadding( apgHelper::SizeT2Int32( NumPixels ) );
+    const uint32_t TotalBytes = (NumPixels + PadSize) * sizeof(uint16_t);
+    uint32_t NumBytesExpected = TotalBytes;
+    uint32_t PixelsLeft = NumPixels;
+
+    try
+    {
+        while( NumBytesExpected > 0 )
+        {
+            uint16_t * buf = 0;
+            {
+                std::unique_lock<std::mutex> guard( lock );
+                cond.wait( guard, [&]() { return !empty.empty(); } );
+                buf = empty.front();
+                empty.pop_front();
+            }
+
+            uint32_t SizeToRead = std::min<uint32_t>(NumBytesExpected,
+                m_MaxBufSize );
+
+            uint32_t ReceivedSize = 0;
+
+            m_Usb->ReadImage( buf, SizeToRead, ReceivedSize );
+
+            NumBytesExpected -= ReceivedSize;
+
+            const uint32_t count = std::min<uint32_t>( PixelsLeft,
+                ReceivedSize / sizeof(uint16_t) );
+            PixelsLeft -= count;
+
+            {
+                std::lock_guard<std::mutex> guard( lock );
+                full.push_back( std::make_pair( buf, count ) );
+            }
+            cond.notify_all();
+
+            if( ReceivedSize != SizeToRead )
+            {
+                break;
+            }
+        }
+    }
+    catch( ... )
+    {
+        finish();
+        throw;
+    }
+
+    finish();
+
+    if( NumBytesExpected )
+    {
+        const uint32_t  DownloadedBytes = TotalBytes - NumBytesExpected;
+        std::stringstream msg;
+        msg << "GetImageData error - Expected " << TotalBytes << " bytes.";
+        msg << "  Downloaded " <<  DownloadedBytes << " bytes.";
+        msg << "  " << NumBytesExpected << " bytes remaining.";
+        
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_Critical );
+    }
+}
+
 //////////////////////////// 
 // GET  STATUS
 void CamUsbIo::GetStatus(CameraStatusRegs::BasicStatus & status)
@@ -49,6 +49,7 @@ class CamUsbIo : public ICamIo
         void CancelImgXfer();
        
         void GetImageData( std::vector<uint16_t> & data );
+        void GetImageData( uint32_t NumPixels, const ImgDataSink & sink );
     
         void GetStatus(CameraStatusRegs::BasicStatus & status);
         void GetStatus(CameraStatusRegs::AdvStatus & status);
@@ -94,6 +95,9 @@ class CamUsbIo : public ICamIo
 
         int32_t GetPadding( const int32_t Num );
 
+        // transfer buffers for the chunked GetImageData, kept between images
+        std::vector< std::vector<uint16_t> > m_XferBufs;
+
         private:
         //disabling the copy ctor and assignment operator
         //generated by the compiler - don't want them
@@ -233,6 +233,38 @@ void CameraIo::GetImageData( std::vector<uint16_t> & data )
     }
 }
 
+//////////////////////////// 
+// GET  IMAGE   DATA
+void CameraIo::GetImageData( const uint32_t NumPixels, const ICamIo::ImgDataSink & sink )
+{
+    if( 0 == NumPixels )
+    {
+        apgHelper::throwRuntimeException( m_fileName, 
+            "number of pixels to GetImageData must not be zero", 
+            __LINE__, Apg::ErrorType_InvalidUsage );
+    }
+
+    try
+    {
+       m_Interface->GetImageData( NumPixels, sink );
+    }
+    catch( std::exception & err )
+    {
+        //log that we are trying to reset the camera
+        std::string msg( "Exception caught trying to fetch the image.  Canceling exposure and resetting the camera." );
+        ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
+        apgHelper::mkMsg( m_fileName, msg, __LINE__) );
+
+        //try to get the USB interface and camera
+        //in a state to image again
+        Reset( true );
+        CancelImgXfer();
+        
+        //rethrow current exception
+        throw;
+    }
+}
+
 //////////////////////////// 
 // GET  STATUS
 void CameraIo::GetStatus(CameraStatusRegs::BasicStatus & status)
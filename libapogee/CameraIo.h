@@ -20,10 +20,10 @@
 #include "CamCfgMatrix.h"
 #include "CameraInfo.h" 
 #include "DefDllExport.h"
+#include "ICamIo.h"
 
 #include <memory>
 
-class ICamIo;
 class CamRegMirror;
 
 
@@ -58,6 +58,7 @@ class DLL_EXPORT CameraIo
         void CancelImgXfer();
        
         void GetImageData( std::vector<uint16_t> & data );
+        void GetImageData( uint32_t NumPixels, const ICamIo::ImgDataSink & sink );
     
         void GetStatus(CameraStatusRegs::BasicStatus & status);
         void GetStatus(CameraStatusRegs::AdvStatus & status);
@@ -7,6 +7,8 @@
 */ 
 
 #include "ICamIo.h" 
+#include "apgHelper.h" 
+#include <exception>
 
 
 //////////////////////////// 
@@ -22,3 +24,23 @@ ICamIo::~ICamIo()
 { 
 
 }
+
+//////////////////////////// 
+// GET  IMAGE   DATA
+void ICamIo::GetImageData( const uint32_t NumPixels, const ImgDataSink & sink )
+{
+    std::vector<uint16_t> data( NumPixels );
+
+    try
+    {
+        GetImageData( data );
+    }
+    catch( std::exception & )
+    {
+        // pass on whatever made it, same as the callers used to
+        sink( &data[0], apgHelper::SizeT2Uint32( data.size() ) );
+        throw;
+    }
+
+    sink( &data[0], apgHelper::SizeT2Uint32( data.size() ) );
+}
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <functional>
 
 #include "CameraStatusRegs.h" 
 
@@ -50,6 +51,12 @@ class ICamIo
          */
         virtual void GetImageData( std::vector<uint16_t> & data ) = 0;	
 
+        /*!
+         *  Receives the image data from GetImageData as it arrives, the
+         *  pointer is only valid for the duration of the call
+         */
+        typedef std::function<void(const uint16_t * data, uint32_t count)> ImgDataSink;
+
         /*!
          *  Reads camera control registers
          * \param[in] reg Register to read.
@@ -96,6 +103,18 @@ class ICamIo
         virtual std::string GetDriverVersion() = 0;
 
         virtual bool IsError() = 0;
+
+        // Declared last to keep the existing vtable layout
+
+        /*!
+         *  Moves the data from the camera to the host PC, handing it to the
+         *  sink in chunks instead of collecting the whole image first.
+         *  This default implementation downloads the whole image and passes
+         *  it on in one chunk.
+         * \param[in] NumPixels Total number of pixels to transfer from the camera to host
+         * \param[in] sink Called with every chunk of image data, in order
+         */
+        virtual void GetImageData( uint32_t NumPixels, const ImgDataSink & sink );
     protected:
         ICamIo();
 }; 
@@ -155,3 +155,155 @@ void ImgFix::DualOuputFix( const std::vector<uint16_t> & data,
         index += numLatencyPixels;
     }
 }
+
+//////////////////////////// 
+//      ROW      FIXER
+ImgFix::RowFixer::RowFixer( const Layout layout, uint16_t * out,
+                            const int32_t rows, const int32_t cols,
+                            const int32_t numLatencyPixels ) :
+                                m_Layout( layout ),
+                                m_Out( out ),
+                                m_Rows( rows ),
+                                m_Cols( cols ),
+                                m_NumLatencyPixels( numLatencyPixels ),
+                                m_UnitLen( 0 ),
+                                m_NumUnits( 0 ),
+                                m_UnitsDone( 0 ),
+                                m_CarryLen( 0 )
+{
+    const int32_t HALF_COLS = cols / 2;
+
+    // the raw data always starts with the latency pixels of a row,
+    // so a unit is the latency pixels followed by the image pixels
+    switch( m_Layout )
+    {
+        case SINGLE:
+            m_UnitLen = numLatencyPixels + cols;
+            m_NumUnits = rows;
+        break;
+
+        case DUAL:
+            m_UnitLen = numLatencyPixels + HALF_COLS*2;
+            m_NumUnits = rows;
+        break;
+
+        case QUAD:
+            m_UnitLen = numLatencyPixels*2 + HALF_COLS*4;
+            m_NumUnits = rows / 2;
+        break;
+
+        case QUAD_NO_REORDER:
+            m_UnitLen = numLatencyPixels*2 + HALF_COLS*4;
+            m_NumUnits = HALF_COLS ? 
+                ( rows*cols + HALF_COLS*4 - 1 ) / ( HALF_COLS*4 ) : 0;
+        break;
+    }
+
+    m_Carry.resize( m_UnitLen );
+}
+
+//////////////////////////// 
+//      PUSH
+void ImgFix::RowFixer::Push( const uint16_t * data, uint32_t count )
+{
+    if( m_UnitLen <= 0 )
+    {
+        return;
+    }
+
+    // finish the unit started by the previous chunk
+    if( m_CarryLen > 0 )
+    {
+        const uint32_t len = std::min<uint32_t>( count, m_UnitLen - m_CarryLen );
+        std::copy( data, data + len, m_Carry.begin() + m_CarryLen );
+        m_CarryLen += len;
+        data += len;
+        count -= len;
+
+        if( m_CarryLen < m_UnitLen )
+        {
+            return;
+        }
+
+        FixUnit( &m_Carry[0] );
+        m_CarryLen = 0;
+    }
+
+    while( count >= static_cast<uint32_t>(m_UnitLen) )
+    {
+        FixUnit( data );
+        data += m_UnitLen;
+        count -= m_UnitLen;
+    }
+
+    if( count > 0 )
+    {
+        std::copy( data, data + count, m_Carry.begin() );
+        m_CarryLen = count;
+    }
+}
+
+//////////////////////////// 
+//      FIX      UNIT
+void ImgFix::RowFixer::FixUnit( const uint16_t * data )
+{
+    // ignore anything past the end of the image, e.g. usb padding
+    if( m_UnitsDone >= m_NumUnits )
+    {
+        return;
+    }
+
+    const int32_t r = m_UnitsDone++;
+    const int32_t HALF_COLS = m_Cols / 2;
+
+    switch( m_Layout )
+    {
+        case SINGLE:
+        {
+            const uint16_t * start = data + m_NumLatencyPixels;
+            std::copy( start, start + m_Cols, m_Out + r*m_Cols );
+        }
+        break;
+
+        case DUAL:
+        {
+            //account for the odd no op col
+            const int32_t oddAdjust = ( m_Cols % 2 ) ? 1 : 0;
+            uint16_t * top = m_Out + m_Cols*r;
+            const uint16_t * in = data + m_NumLatencyPixels;
+
+            for( int32_t c=0; c < HALF_COLS; ++c, in += 2 )
+            {
+                top[ m_Cols-(c+1) - oddAdjust ] = in[0];
+                top[ c ] = in[1];
+            }
+        }
+        break;
+
+        case QUAD:
+        {
+            uint16_t * top = m_Out + m_Cols*r;
+            uint16_t * bottom = m_Out + m_Cols*(m_Rows-(r+1));
+            const uint16_t * in = data + m_NumLatencyPixels*2;
+
+            for( int32_t c=0; c < HALF_COLS; ++c, in += 4 )
+            {
+                top[ c ] = in[0];
+                top[ m_Cols-(c+1) ] = in[1];
+                bottom[ m_Cols-(c+1) ] = in[2];
+                bottom[ c ] = in[3];
+            }
+        }
+        break;
+
+        case QUAD_NO_REORDER:
+        {
+            const int32_t numGood = HALF_COLS*4;
+            const int32_t offset = r*numGood;
+            const int32_t len = std::min<int32_t>( m_Rows*m_Cols - offset, numGood );
+            const uint16_t * start = data + m_NumLatencyPixels*2;
+            std::copy( start, start + len, m_Out + offset );
+        }
+        break;
+    }
+}
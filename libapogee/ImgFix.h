@@ -38,6 +38,46 @@ namespace ImgFix
                                      std::vector<uint16_t> & out,
                                      const int32_t rows,  const int32_t cols,
                                      const int32_t numLatencyPixels );
+
+    /*!
+     * Same fixes as the functions above, applied while the image is
+     * still downloading.  The raw data is pushed in chunks of any size and
+     * every complete raw row (row pair for quad outputs) is written straight
+     * into the output buffer, so no full frame copy of the raw data is needed.
+     */
+    class RowFixer
+    {
+        public:
+            enum Layout
+            {
+                SINGLE,
+                DUAL,
+                QUAD,
+                QUAD_NO_REORDER
+            };
+
+            RowFixer( Layout layout, uint16_t * out, int32_t rows,
+                int32_t cols, int32_t numLatencyPixels );
+
+            void Push( const uint16_t * data, uint32_t count );
+
+        private:
+            void FixUnit( const uint16_t * data );
+
+            Layout m_Layout;
+            uint16_t * m_Out;
+            int32_t m_Rows;
+            int32_t m_Cols;
+            int32_t m_NumLatencyPixels;
+
+            int32_t m_UnitLen;
+            int32_t m_NumUnits;
+            int32_t m_UnitsDone;
+
+            // partial raw row left over from the previous chunk
+            std::vector<uint16_t> m_Carry;
+            int32_t m_CarryLen;
+    };
 }; 
 
 #endif
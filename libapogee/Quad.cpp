@@ -241,6 +241,13 @@ void Quad::FixImgFromCamera( const std::vector<uint16_t> & data,
     
 }
 
+//////////////////////////// 
+// GET  IMAGE 
+void Quad::GetImage( uint16_t * out, const uint32_t NumPixels )
+{
+    DownloadImage( out, NumPixels, m_DoPixelReorder );
+}
+
 
 //////////////////////////// 
 //      START        EXPOSURE
@@ -34,6 +34,9 @@ class DLL_EXPORT Quad: public CamGen2Base
 
         void StartExposure( double Duration, bool IsLight );
 
+        using CamGen2Base::GetImage;
+        void GetImage( uint16_t * out, uint32_t NumPixels );
+
         bool IsPixelReorderOn() { return m_DoPixelReorder; }
 
         void SetPixelReorder( const bool TurnOn ) { m_DoPixelReorder = TurnOn; }
@@ -44,6 +44,18 @@ static int32_t strWriter(char *data, size_t size, size_t nmemb,
     return apgHelper::SizeT2Int32( numBytes );
 }
 
+//////////////////////////// 
+// SINK WRITER
+static size_t sinkWriter(char *data, size_t size, size_t nmemb,  
+                  const CLibCurlWrap::DataSink *sink) 
+{
+    const size_t numBytes = size * nmemb;
+
+    (*sink)( reinterpret_cast<const uint8_t *>(data), numBytes );
+
+    return numBytes;
+}
+
 //////////////////////////// 
 // LOCAL     NAMESPACE
 namespace
@@ -81,6 +93,7 @@ void CLibCurlWrap::HttpGet(const std::string & url,
                             std::string & result)
 {
     CurlSetupStrWrite ( url );
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
     result = ExecuteStr();
 }
 
@@ -90,9 +103,34 @@ void CLibCurlWrap::HttpGet(const std::string & url,
             std::vector<uint8_t> & result)
 {
     CurlSetupVectWrite ( url, result );
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
     ExecuteVect( result );
 }
 
+//////////////////////////// 
+// HTTP GET     STREAM
+void CLibCurlWrap::HttpGetStream(const std::string & url,
+            const DataSink & sink)
+{
+    // same handle every time, so curl keeps the connection open between calls
+    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, errorBuffer);  
+    curl_easy_setopt(m_curlHandle, CURLOPT_URL, url.c_str());  
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, sinkWriter);  
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &sink); 
+    curl_easy_setopt(m_curlHandle, CURLOPT_TIMEOUT, m_timeout);
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
+
+    const CURLcode returnCode = curl_easy_perform(m_curlHandle);
+
+    if( CURLE_OK != returnCode )
+    {
+        std::string curlError( errorBuffer );
+
+        apgHelper::throwRuntimeException( m_fileName, curlError, 
+            __LINE__, Apg::ErrorType_Critical );
+    }
+}
+
 //////////////////////////// 
 // HTTP POST 
 void CLibCurlWrap::HttpPost(const std::string & url,
@@ -16,6 +16,7 @@
 #include "curl/curl.h"
 #include <string>
 #include <vector>
+#include <functional>
 #include <stdint.h>
 
 class CLibCurlWrap 
@@ -30,6 +31,12 @@ class CLibCurlWrap
         void HttpGet(const std::string & url,
             std::vector<uint8_t> & result);
 
+        // hands the body to the sink as it arrives instead of buffering it,
+        // the sink must not throw
+        typedef std::function<void(const uint8_t * data, size_t size)> DataSink;
+        void HttpGetStream(const std::string & url,
+            const DataSink & sink);
+
         void HttpPost(const std::string & url,
             const std::string & postFields, 
             std::string & result);
@@ -43,9 +43,16 @@ POSSIBILITY OF SUCH DAMAGE.
 #include <stdarg.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <libusb.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #define MAXRBUF 512
 
 // globals
@@ -85,6 +92,52 @@ UInt16 gRoi_bottom[kNumCamsSupported];
 // this is where we store the average.  It is computed every time the gain setting on the image sensor is made.
 SInt32 gBlackOffsets[1280];
 
+// asynchronous image download.  RcvUSBImage keeps FC_IMAGE_XFER_COUNT bulk transfers of
+// FC_IMAGE_XFER_SIZE bytes queued while a frame is read from the camera.
+#define FC_IMAGE_XFER_COUNT 4
+#define FC_IMAGE_XFER_SIZE  (128 * 1024)
+
+// called for every row of the image as soon as it has been received
+typedef void (*fcRowHandler)(void *context, UInt16 *rowPtr, int row);
+
+typedef struct
+{
+    unsigned char *data;
+    int maxBytes;
+    int nextOffset; // where the next queued transfer will put its data
+    int received;   // bytes received so far
+    int pending;    // transfers currently submitted
+    int status;     // LIBUSB_TRANSFER_COMPLETED unless a transfer failed
+    bool done;      // set once the frame is complete or a transfer failed
+    int rowBytes;
+    int numRows;
+    int rowsDone;
+    fcRowHandler rowHandler;
+    void *context;
+} fcImageXfer;
+
+// for the Starfish black level compensation we gather the sums of the black cols of every
+// row while the image is arriving.  See fcImage_doFullFrameRowLevelNormalization.
+typedef struct
+{
+    int64_t frameSum;      // all the black pixels in the frame
+    SInt32 rowSums[4096]; // the black pixels of each row
+} fcRowBlackSums;
+
+fcRowBlackSums gRowBlackSums;
+
+// column corrections for the IBIS 1300 image sensor derived from gBlackOffsets.
+// See fcImage_IBIS_prepareColLevelNormalization.
+typedef struct
+{
+    int width;
+    UInt16 pedestal;
+    UInt16 colAdd[1280];
+    UInt16 colSub[1280];
+} fcIbisColNormalization;
+
+fcIbisColNormalization gIbisColNormalization;
+
 // for the Starfish PRO camera, we will calculate the column and row offsets from information in the overscan pixels
 // we will use the vertical overscan to calculate the column offsets and the horizontal overscan to calculate the
 // row offsets.  The final number in this vector will be the number that needs to be added to the given row/col
@@ -177,6 +230,163 @@ int RcvUSB(int camNum, unsigned char *data, int maxBytes)
     }
 }
 
+// completion callback for the transfers queued by RcvUSBImage
+static void LIBUSB_CALL fcImageXferCallback(struct libusb_transfer *transfer)
+{
+    fcImageXfer *xfer = (fcImageXfer *)transfer->user_data;
+    int offset        = (int)(transfer->buffer - xfer->data);
+    int length;
+
+    xfer->pending--;
+
+    if (transfer->status == LIBUSB_TRANSFER_COMPLETED)
+    {
+        if (offset + transfer->actual_length > xfer->received)
+            xfer->received = offset + transfer->actual_length;
+
+        // a short transfer means the camera has sent the whole frame
+        if (transfer->actual_length < transfer->length)
+            xfer->done = true;
+    }
+    else if (transfer->status != LIBUSB_TRANSFER_CANCELLED)
+    {
+        xfer->status = transfer->status;
+        xfer->done   = true;
+    }
+
+    if (xfer->rowHandler != NULL && xfer->status == LIBUSB_TRANSFER_COMPLETED)
+    {
+        while (xfer->rowsDone < xfer->numRows && (xfer->rowsDone + 1) * xfer->rowBytes <= xfer->received)
+        {
+            xfer->rowHandler(xfer->context, (UInt16 *)(xfer->data + xfer->rowsDone * xfer->rowBytes), xfer->rowsDone);
+            xfer->rowsDone++;
+        }
+    }
+
+    // queue this transfer again for the next part of the frame
+    if (!xfer->done && xfer->nextOffset < xfer->maxBytes)
+    {
+        length = xfer->maxBytes - xfer->nextOffset;
+        if (length > FC_IMAGE_XFER_SIZE)
+            length = FC_IMAGE_XFER_SIZE;
+
+        libusb_fill_bulk_transfer(transfer, transfer->dev_handle, FC_STARFISH_BULK_IN_ENDPOINT,
+                                  xfer->data + xfer->nextOffset, length, fcImageXferCallback, xfer, 10000);
+
+        if (libusb_submit_transfer(transfer) == 0)
+        {
+            xfer->nextOffset += length;
+            xfer->pending++;
+        }
+        else
+        {
+            xfer->status = LIBUSB_TRANSFER_ERROR;
+            xfer->done   = true;
+        }
+    }
+}
+
+// asynchronous variant of RcvUSB used to read an image.  Several bulk transfers are kept
+// queued on the bulk in endpoint so the camera never waits on the host between packets,
+// and the data lands directly in the caller's buffer.  Transfers on one endpoint complete
+// in the order they were submitted, so whenever a complete row has arrived rowHandler
+// (if not NULL) is called for it while the rest of the frame is still being transferred.
+// returns the number of bytes received, 0 on error
+//
+int RcvUSBImage(int camNum, unsigned char *data, int maxBytes, int rowBytes, fcRowHandler rowHandler, void *context)
+{
+    struct libusb_device_handle *dev;
+    struct libusb_transfer *transfers[FC_IMAGE_XFER_COUNT];
+    struct timeval tv;
+    fcImageXfer xfer;
+    bool cancelled = false;
+    int i, length;
+
+    dev = gCamerasFound[camNum - 1].dev;
+    if (dev == NULL)
+    {
+        Starfish_LogFmt("Error on Receiving Libusb Bulk Transfer: no camera handle\n");
+
+        return 0;
+    }
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.data       = data;
+    xfer.maxBytes   = maxBytes;
+    xfer.status     = LIBUSB_TRANSFER_COMPLETED;
+    xfer.rowBytes   = rowBytes;
+    xfer.numRows    = rowBytes > 0 ? maxBytes / rowBytes : 0;
+    xfer.rowHandler = rowHandler;
+    xfer.context    = context;
+
+    for (i = 0; i < FC_IMAGE_XFER_COUNT; i++)
+    {
+        transfers[i] = NULL;
+
+        if (xfer.done || xfer.nextOffset >= maxBytes)
+            continue;
+
+        transfers[i] = libusb_alloc_transfer(0);
+        if (transfers[i] == NULL)
+        {
+            xfer.status = LIBUSB_TRANSFER_ERROR;
+            xfer.done   = true;
+            continue;
+        }
+
+        length = maxBytes - xfer.nextOffset;
+        if (length > FC_IMAGE_XFER_SIZE)
+            length = FC_IMAGE_XFER_SIZE;
+
+        libusb_fill_bulk_transfer(transfers[i], dev, FC_STARFISH_BULK_IN_ENDPOINT, data + xfer.nextOffset, length,
+                                  fcImageXferCallback, &xfer, 10000);
+
+        if (libusb_submit_transfer(transfers[i]) == 0)
+        {
+            xfer.nextOffset += length;
+            xfer.pending++;
+        }
+        else
+        {
+            xfer.status = LIBUSB_TRANSFER_ERROR;
+            xfer.done   = true;
+        }
+    }
+
+    while (xfer.pending > 0)
+    {
+        // once the frame is complete (or failed) the transfers still queued will never see any data
+        if (xfer.done && !cancelled)
+        {
+            for (i = 0; i < FC_IMAGE_XFER_COUNT; i++)
+                if (transfers[i] != NULL)
+                    libusb_cancel_transfer(transfers[i]);
+
+            cancelled = true;
+        }
+
+        tv.tv_sec  = 1;
+        tv.tv_usec = 0;
+        libusb_handle_events_timeout_completed(gCtx, &tv, NULL);
+    }
+
+    for (i = 0; i < FC_IMAGE_XFER_COUNT; i++)
+        if (transfers[i] != NULL)
+            libusb_free_transfer(transfers[i]);
+
+    if (xfer.status != LIBUSB_TRANSFER_COMPLETED)
+    {
+        Starfish_LogFmt("Error on Receiving Libusb Bulk Transfer: %s\n",
+                        libusb_error_name(xfer.status == LIBUSB_TRANSFER_TIMED_OUT ? LIBUSB_ERROR_TIMEOUT : LIBUSB_ERROR_IO));
+
+        return 0;
+    }
+
+    Starfish_LogFmt("RcvUSBImage - %d bytes\n", xfer.received);
+
+    return xfer.received;
+}
+
 // routine to check to see if we have a starfish log file on disk
 // return TRUE if one exists
 //
@@ -1037,210 +1247,90 @@ UInt16 fcUsb_GetUsbCmdCksum(UInt16 *cmdParams)
     return theCksum;
 }
 
-// helper routine for fcImage_doFullFrameRowLevelNormalization.
-// will calculate the average level of the pixels in the
-// black cols of the image sensor
-//
-float fcImage_calcFullFrameAllColAvg(UInt16 *frameBufferPtr, int imageWidth, int imageHeight)
+// add a constant offset to a row of pixels, saturating at 0 and 65535.  Only one of
+// addValue / subValue is ever non-zero, which lets us use the saturating 16 bit
+// add / subtract instructions instead of widening every pixel.
+static void fcImage_offsetRow(const UInt16 *inputPtr, UInt16 *outputPtr, int count, UInt16 addValue, UInt16 subValue)
 {
-    float floatPixel;
-    float retValue;
-    int row, col;
-    //bool evenRow;
-    UInt16 *inputPtr;
-    UInt16 aPixel;
+    int col = 0;
 
-    retValue = 0.0;
+#if defined(__SSE2__)
+    __m128i add = _mm_set1_epi16((short)addValue);
+    __m128i sub = _mm_set1_epi16((short)subValue);
 
-    // we will average all of the pixels in cols 0 -> 14
-    for (row = 0; row < imageHeight; row++)
+    for (; col + 8 <= count; col += 8)
     {
-        inputPtr = frameBufferPtr;
-        inputPtr = inputPtr + (row * imageWidth);
-
-        for (col = 0; col < 14; col++)
-        {
-            // get the next pixel
-            aPixel = *inputPtr++;
-
-            floatPixel = (float)aPixel;
-            retValue += floatPixel;
-        }
+        __m128i pix = _mm_loadu_si128((const __m128i *)(inputPtr + col));
+        pix         = _mm_subs_epu16(_mm_adds_epu16(pix, add), sub);
+        _mm_storeu_si128((__m128i *)(outputPtr + col), pix);
     }
+#elif defined(__ARM_NEON)
+    uint16x8_t add = vdupq_n_u16(addValue);
+    uint16x8_t sub = vdupq_n_u16(subValue);
 
-    //divide by the number of pixels in the black col
-    retValue = retValue / (14.0 * (float)imageHeight);
-
-    return retValue;
-}
-
-// helper routine for fcImage_doFullFrameRowLevelNormalization.
-// will calculate the average level of the pixels in the
-// defined ROW's black columns
-float fcImage_calcFullFrameRowAvgForRow(UInt16 *frameBufferPtr, int imageWidth, int imageHeight, int theRow)
-{
-	INDI_UNUSED(imageHeight);
-    float floatPixel;
-    float retValue;
-    int /*row,*/ col;
-    //bool evenRow;
-    UInt16 *inputPtr;
-    UInt16 aPixel;
-
-    UInt16 lowPixel;
-    UInt16 hiPixel;
-
-    retValue = 0.0;
-
-    lowPixel = 0xffff;
-    hiPixel  = 0;
-
-    // we will average all of the pixels in cols 0 -> 14
-    inputPtr = frameBufferPtr;
-    inputPtr = inputPtr + (theRow * imageWidth);
+    for (; col + 8 <= count; col += 8)
+        vst1q_u16(outputPtr + col, vqsubq_u16(vqaddq_u16(vld1q_u16(inputPtr + col), add), sub));
+#endif
 
-    for (col = 0; col < 14; col++)
+    for (; col < count; col++)
     {
-        // get the next pixel
-        aPixel = *inputPtr++;
+        SInt32 bigPixel = (SInt32)inputPtr[col] + addValue - subValue;
 
-        // find lowest and highest pixel
-        if (lowPixel > aPixel)
-            lowPixel = aPixel;
+        if (bigPixel > 65535)
+            bigPixel = 65535;
 
-        if (hiPixel < aPixel)
-            hiPixel = aPixel;
+        if (bigPixel < 0)
+            bigPixel = 0;
 
-        floatPixel = (float)aPixel;
-        retValue += floatPixel;
+        outputPtr[col] = (UInt16)bigPixel;
     }
+}
 
-    // throw out lowest and highest
-    //	floatPixel = (float) lowPixel;
-    //	retValue  -= floatPixel;
-    //	floatPixel = (float) hiPixel;
-    //	retValue  -= floatPixel;
+// row handler for the black level compensated download.  Called as soon as each row
+// has arrived from the camera.  Sums the pixels in black cols 0 -> 13 of the row so that
+// the normalization pass does not have to touch the black cols again.
+static void fcImage_accumulateRowBlack(void *context, UInt16 *rowPtr, int row)
+{
+    fcRowBlackSums *sums = (fcRowBlackSums *)context;
+    SInt32 rowSum        = 0;
+    int col;
 
-    //divide by the number of pixels in the black col
-    retValue = retValue / 14.0;
-    //	retValue = retValue / 12.0;
+    for (col = 0; col < 14; col++)
+        rowSum += rowPtr[col];
 
-    return retValue;
+    sums->rowSums[row] = rowSum;
+    sums->frameSum += rowSum;
 }
 
-// routine to perform line level normalization on the RAW camera image
-// Used to get rid of the camera's read noise associated with ROWs
-// enter with pointer to 16 bit image
+// routine to perform line level normalization on the RAW camera image and strip the
+// black columns in the same pass.  Used to get rid of the camera's read noise associated
+// with ROWs.  Every row is shifted so that the average of its black cols matches the
+// average of all the black pixels in the frame:
 //
-void fcImage_doFullFrameRowLevelNormalization(UInt16 *frameBufferPtr, int imageWidth, int imageHeight)
+//      rowOffset = frameAvg - rowAvg = (frameSum - imageHeight * rowSum) / (14 * imageHeight)
+//
+// computed in integer math from the sums gathered by fcImage_accumulateRowBlack.
+// The camera's image (including the 16 black cols) is in inputPtr, the stripped and
+// normalized image is written to frameBuffer.
+void fcImage_doFullFrameRowLevelNormalization(const UInt16 *inputPtr, UInt16 *frameBuffer, int imageWidth,
+                                              int imageHeight, const fcRowBlackSums *sums)
 {
-    //float reference;
-    int row, col;
-    UInt16 *inputPtr;
-    UInt16 aPixel;
-    float rowAvg = 0;
-    float thisRowAvg;
-    //float minRowAvg;
-    //float colAvg;
-    float frameAvg;
-    float rowOffset;
-    //float colOffset;
-    float floatPixel;
-
-    if (gDoSimulation)
-    {
-        srand(time(NULL));
-        int i = 0, j = 0;
-
-        for (i = 0; i < imageHeight; i++)
-            for (j = 0; j < imageWidth; j++)
-                frameBufferPtr[i * imageWidth + j] = rand() % 65535;
-
-        return;
-    }
-
-    // make sure we are dealing with 16 bit pixels
-    //	printf("fcImage_doFullFrameRowLevelNormalization\n");
-
-    // calculate the average of all the black pixels
-    frameAvg = fcImage_calcFullFrameAllColAvg(frameBufferPtr, imageWidth, imageHeight);
+    int row;
+    int64_t divisor = 14 * (int64_t)imageHeight;
 
     for (row = 0; row < imageHeight; row++)
     {
-        if (row > 0)
-            rowAvg = fcImage_calcFullFrameRowAvgForRow(frameBufferPtr, imageWidth, imageHeight, (row - 1));
-        //		rowAvg  = [self calcFullFrameRowMedianForRow: (row - 1)];
-
-        thisRowAvg = fcImage_calcFullFrameRowAvgForRow(frameBufferPtr, imageWidth, imageHeight, row);
-        //		thisRowAvg = [self calcFullFrameRowMedianForRow: row];
+        int64_t delta = sums->frameSum - (int64_t)imageHeight * sums->rowSums[row];
+        SInt32 rowOffset;
 
-        if (row == 0)
-            rowOffset = frameAvg - thisRowAvg;
+        // round to the nearest count
+        if (delta >= 0)
+            rowOffset = (SInt32)((delta + divisor / 2) / divisor);
         else
-            rowOffset = rowAvg - thisRowAvg; // 11-23-07
-
-        inputPtr = frameBufferPtr;
-        inputPtr = inputPtr + (row * imageWidth);
-        for (col = 0; col < imageWidth; col++)
-        //		for (col = 0; col < (imageWidth / 2); col++)
-        {
-            // get the next pixel
-            aPixel = *inputPtr;
-
-            floatPixel = (float)aPixel;
-
-            floatPixel += rowOffset;
+            rowOffset = -(SInt32)((-delta + divisor / 2) / divisor);
 
-            if (floatPixel > 65535.0)
-                floatPixel = 65535.0;
-
-            if (floatPixel < 0.0)
-                floatPixel = 0.0;
-
-            // put corrected value back
-            *inputPtr++ = (UInt16)floatPixel;
-        }
-    }
-}
-
-// routine to strip the black columns form the image read from the camera.  the camera's image is
-// assumed to be in gFrameBuffer and the pointer passed to this routine is where we will put the
-// stripped image;
-void fcImage_StripBlackCols(int camNum, UInt16 *frameBuffer)
-{
-    //float reference;
-    int row, col;
-    int imageHeight, imageWidth;
-    UInt16 *inputPtr;
-    UInt16 *outputPtr;
-    //UInt16 aPixel;
-    //float rowAvg;
-    //float thisRowAvg;
-    //float minRowAvg;
-    //float colAvg;
-    //float frameAvg;
-    //float rowOffset;
-    //float colOffset;
-    //float floatPixel;
-
-    imageHeight = (gRoi_bottom[camNum - 1] - gRoi_top[camNum - 1]) + 1;
-    imageWidth  = (gRoi_right[camNum - 1] - gRoi_left[camNum - 1]) + 1;
-
-    for (row = 0; row < imageHeight; row++)
-    {
-        inputPtr = gFrameBuffer;
-        //		if (row < (imageHeight / 2))
-        inputPtr = inputPtr + (row * (imageWidth + 16)) + 16;
-        //		else
-        //			inputPtr = inputPtr + (row * (imageWidth + 16));
-        outputPtr = frameBuffer;
-        outputPtr = outputPtr + (row * imageWidth);
-
-        for (col = 0; col < imageWidth; col++)
-        {
-            // transfer pixel
-            *outputPtr++ = *inputPtr++;
-        }
+        fcImage_offsetRow(inputPtr + (row * (imageWidth + 16)) + 16, frameBuffer + (row * imageWidth), imageWidth,
+                          rowOffset > 0 ? (UInt16)rowOffset : 0, rowOffset < 0 ? (UInt16)(-rowOffset) : 0);
     }
 }
 
@@ -1285,87 +1375,89 @@ void fcImage_IBIS_divideBlackRowAverage(void)
         gBlackOffsets[i] = gBlackOffsets[i] / 4;
 }
 
-// helper routine for fcImage_IBIS_doFullFrameColLevelNormalization.
-// will calculate the average level of the pixels in the
-// first black row of the image sensor
-//
-float fcImage_IBIS_calcFirstBlackRowAverage(UInt16 *frameBufferPtr, int imageWidth, int imageHeight)
+// here to prepare the per column corrections for the IBIS1300 image sensor.  The average of the
+// first black row (kept in gBlackOffsets) is both the level every column is normalized to and the
+// pedestal which is then subtracted from the image.  The column offsets are split into an add
+// and a subtract vector so they can be applied with saturating 16 bit arithmetic.
+void fcImage_IBIS_prepareColLevelNormalization(int imageWidth, fcIbisColNormalization *norm)
 {
-	INDI_UNUSED(frameBufferPtr);
-	INDI_UNUSED(imageHeight);
-    float floatPixel;
-    float retValue;
-    int /*row,*/ col;
-    //bool evenRow;
-    //UInt16 *inputPtr;
-    SInt32 aPixel;
+    int64_t blackSum = 0;
+    SInt32 blackAvg;
+    SInt32 colOffset;
+    int col;
 
-    retValue = 0.0;
+    if (imageWidth > 1280)
+        imageWidth = 1280;
 
-    // we will average all of the pixels in the first row
+    for (col = 0; col < imageWidth; col++)
+        blackSum += gBlackOffsets[col];
+
+    blackAvg = imageWidth > 0 ? (SInt32)(blackSum / imageWidth) : 0;
 
     for (col = 0; col < imageWidth; col++)
     {
-        // get the next pixel
-        aPixel = gBlackOffsets[col];
+        colOffset = blackAvg - gBlackOffsets[col];
 
-        floatPixel = (float)aPixel;
-        retValue += floatPixel;
+        norm->colAdd[col] = colOffset > 0 ? (UInt16)colOffset : 0;
+        norm->colSub[col] = colOffset < 0 ? (UInt16)(-colOffset) : 0;
     }
 
-    //divide by the number of pixels in the black row
-    retValue = retValue / (float)imageWidth;
-
-    return retValue;
+    norm->width    = imageWidth;
+    norm->pedestal = (UInt16)blackAvg;
 }
 
-// routine which will subtract out the offset pedestal from the image.  It looks at the
-// first row of black pixels to determine the average of the row.  Then it subtracts out
-// that number from each pixel in the image.
-void fcImage_IBIS_subtractPedestal(UInt16 *frameBufferPtr, int imageWidth, int imageHeight)
+// row handler used while the IBIS1300 image is arriving from the camera.  Performs column level
+// normalization and pedestal subtraction on one row in a single pass:
+//
+//      pixel = clamp(clamp(pixel + colOffset) - pedestal)
+//
+// The first row holds the black pixels and is left untouched.
+static void fcImage_IBIS_normalizeRow(void *context, UInt16 *rowPtr, int row)
 {
-    //float reference;
-    int row, col;
-    UInt16 *inputPtr;
-    UInt16 aPixel;
-    SInt32 bigPixel;
-    SInt32 thePedestal;
-    //float rowAvg;
-    //float thisColBlack;
-    //float minRowAvg;
-    //float colAvg;
-    float frameAvg;
-    //float rowOffset;
-    //float colOffset;
-    //float floatPixel;
+    const fcIbisColNormalization *norm = (const fcIbisColNormalization *)context;
+    int col = 0;
+
+    if (row == 0)
+        return;
 
-    // calculate the average of all the black pixels in the first row
-    frameAvg    = fcImage_IBIS_calcFirstBlackRowAverage(frameBufferPtr, imageWidth, imageHeight);
-    thePedestal = (SInt32)frameAvg;
+#if defined(__SSE2__)
+    __m128i ped = _mm_set1_epi16((short)norm->pedestal);
 
-    // don't touch the black row.  Start at row '1'
-    inputPtr = frameBufferPtr;
-    inputPtr = inputPtr + imageWidth;
-    for (col = 0; col < imageWidth; col++)
+    for (; col + 8 <= norm->width; col += 8)
     {
-        for (row = 1; row < imageHeight; row++)
-        {
-            aPixel   = *inputPtr;
-            bigPixel = (SInt32)aPixel;
-            bigPixel = bigPixel - thePedestal;
+        __m128i pix = _mm_loadu_si128((const __m128i *)(rowPtr + col));
+        pix         = _mm_subs_epu16(pix, _mm_loadu_si128((const __m128i *)(norm->colSub + col)));
+        pix         = _mm_adds_epu16(pix, _mm_loadu_si128((const __m128i *)(norm->colAdd + col)));
+        pix         = _mm_subs_epu16(pix, ped);
+        _mm_storeu_si128((__m128i *)(rowPtr + col), pix);
+    }
+#elif defined(__ARM_NEON)
+    uint16x8_t ped = vdupq_n_u16(norm->pedestal);
 
-            if (bigPixel > 65535)
-                bigPixel = 65535;
+    for (; col + 8 <= norm->width; col += 8)
+    {
+        uint16x8_t pix = vqsubq_u16(vld1q_u16(rowPtr + col), vld1q_u16(norm->colSub + col));
+        pix            = vqaddq_u16(pix, vld1q_u16(norm->colAdd + col));
+        vst1q_u16(rowPtr + col, vqsubq_u16(pix, ped));
+    }
+#endif
 
-            if (bigPixel < 0)
-                bigPixel = 0;
+    for (; col < norm->width; col++)
+    {
+        SInt32 bigPixel = (SInt32)rowPtr[col] + norm->colAdd[col] - norm->colSub[col];
 
-            // put corrected value back
-            *inputPtr = (UInt16)bigPixel;
+        if (bigPixel > 65535)
+            bigPixel = 65535;
 
-            // point to next
-            inputPtr++;
-        }
+        if (bigPixel < 0)
+            bigPixel = 0;
+
+        bigPixel -= norm->pedestal;
+
+        if (bigPixel < 0)
+            bigPixel = 0;
+
+        rowPtr[col] = (UInt16)bigPixel;
     }
 }
 
@@ -1428,66 +1520,6 @@ void fcImage_IBIS_computeAvgColOffsets(int camNum)
     fcUsb_cmd_setIntegrationTime(camNum, savedIntegrationTime);
 }
 
-// routine to perform column level normalization on the RAW camera image
-// Used to get rid of the camera's fixed pattern noise associated with COLs
-// enter with pointer to 16 bit image
-//
-void fcImage_IBIS_doFullFrameColLevelNormalization(UInt16 *frameBufferPtr, int imageWidth, int imageHeight)
-{
-    //float reference;
-    int row, col;
-    UInt16 *inputPtr;
-    UInt16 aPixel;
-    //float rowAvg;
-    SInt32 thisColBlack;
-    //float minRowAvg;
-    //float colAvg;
-    float frameAvg;
-    //float rowOffset;
-    SInt32 colOffset;
-    //float floatPixel;
-    SInt32 blackAvg;
-    SInt32 bigPixel;
-    //SInt32 theOffset;
-
-    // make sure we are dealing with 16 bit pixels
-
-    //	printf("fcImage_IBIS_doFullFrameColLevelNormalization\n");
-
-    // calculate the average of all the black pixels
-    frameAvg = fcImage_IBIS_calcFirstBlackRowAverage(frameBufferPtr, imageWidth, imageHeight);
-    blackAvg = (SInt32)frameAvg;
-
-    for (col = 0; col < imageWidth; col++)
-    {
-        // first get this cols black pixel from the first row of the image
-        thisColBlack = gBlackOffsets[col];
-
-        colOffset = blackAvg - thisColBlack;
-
-        for (row = 1; row < imageHeight; row++)
-        {
-            // get the pixel for this row/col
-            inputPtr = frameBufferPtr;
-            inputPtr = inputPtr + (row * imageWidth) + col;
-            aPixel   = *inputPtr;
-            bigPixel = (SInt32)aPixel;
-
-            // normalize
-            bigPixel = bigPixel + colOffset;
-
-            if (bigPixel > 65535)
-                bigPixel = 65535;
-
-            if (bigPixel < 0)
-                bigPixel = 0;
-
-            // put corrected value back
-            *inputPtr = (UInt16)bigPixel;
-        }
-    }
-}
-
 // routine to compute the column level offsets in the image.
 // We do this by examining the vertical overscan region in the image
 // Computing the average in the particular column.
@@ -3778,7 +3810,7 @@ int fcUsb_cmd_getRawFrame(int camNum, UInt16 numRows, UInt16 numCols, UInt16 *fr
     if (gCamerasFound[camNum - 1].camFinalProduct == starfish_pro4m_final_deviceID)
     {
         maxBytes     = numRows * numCols * 2; // 2 bytes / pixel
-        numBytesRead = RcvUSB(camNum, (unsigned char *)&frameBuffer, maxBytes);
+        numBytesRead = RcvUSBImage(camNum, (unsigned char *)frameBuffer, maxBytes, numCols * 2, NULL, NULL);
 
         Starfish_LogFmt("   read - %ld bytes\n", numBytesRead);
         
@@ -3790,11 +3822,12 @@ int fcUsb_cmd_getRawFrame(int camNum, UInt16 numRows, UInt16 numCols, UInt16 *fr
     {
         if (gCamerasFound[camNum - 1].camFinalProduct == starfish_ibis13_final_deviceID)
         {
-            maxBytes     = numRows * numCols * 2; // 2 bytes / pixel
-            numBytesRead = RcvUSB(camNum, (unsigned char *)&frameBuffer, maxBytes);
+            // column normalization and pedestal subtraction are done on each row as it arrives
+            fcImage_IBIS_prepareColLevelNormalization(numCols, &gIbisColNormalization);
 
-            fcImage_IBIS_doFullFrameColLevelNormalization(frameBuffer, numCols, numRows);
-            fcImage_IBIS_subtractPedestal(frameBuffer, numCols, numRows);
+            maxBytes     = numRows * numCols * 2; // 2 bytes / pixel
+            numBytesRead = RcvUSBImage(camNum, (unsigned char *)frameBuffer, maxBytes, numCols * 2,
+                                       fcImage_IBIS_normalizeRow, &gIbisColNormalization);
         }
         else
         {
@@ -3802,21 +3835,23 @@ int fcUsb_cmd_getRawFrame(int camNum, UInt16 numRows, UInt16 numCols, UInt16 *fr
             // then strip out the balck cols after we are done with them
             if (gReadBlack[camNum - 1])
             {
+                gRowBlackSums.frameSum = 0;
+
                 maxBytes     = numRows * (numCols + 16) * 2; // 2 bytes / pixel
-                numBytesRead = RcvUSB(camNum, (unsigned char *)gFrameBuffer, maxBytes);
+                numBytesRead = RcvUSBImage(camNum, (unsigned char *)gFrameBuffer, maxBytes, (numCols + 16) * 2,
+                                           fcImage_accumulateRowBlack, &gRowBlackSums);
             }
             else
             {
                 maxBytes     = numRows * numCols * 2; // 2 bytes / pixel
-                numBytesRead = RcvUSB(camNum, (unsigned char *)frameBuffer, maxBytes);
+                numBytesRead = RcvUSBImage(camNum, (unsigned char *)frameBuffer, maxBytes, numCols * 2, NULL, NULL);
             }
             Starfish_LogFmt("   fcUsb_cmd_getRawFrame - numBytesRead - %i\n", (unsigned int)numBytesRead);
             
-            if (gReadBlack[camNum - 1] && numBytesRead != 0)
-            {
-                fcImage_doFullFrameRowLevelNormalization(gFrameBuffer, (numCols + 16), numRows);
-                fcImage_StripBlackCols(camNum, frameBuffer);
-            }
+            // the row offsets need the average of the whole frame, so this is the one pass
+            // left after the download
+            if (gReadBlack[camNum - 1] && numBytesRead == (UInt32)maxBytes)
+                fcImage_doFullFrameRowLevelNormalization(gFrameBuffer, frameBuffer, numCols, numRows, &gRowBlackSums);
         } // if Starfish
     }
 
@@ -90,6 +90,9 @@ static long fli_camera_set_flushes(flidev_t dev, long nflushes);
 #define fli_camera_parport_set_flushes fli_camera_set_flushes
 #define fli_camera_usb_set_flushes fli_camera_set_flushes
 
+static long fli_camera_grab_frame(flidev_t dev, void *buff,
+				  size_t buffsize, size_t *bytesgrabbed);
+
 long fli_camera_open(flidev_t dev)
 {
   int r;
@@ -668,6 +671,22 @@ long fli_camera_command(flidev_t dev, int cmd, int argc, ...)
 			}
 			break;
 
+		case FLI_GRAB_FRAME:
+			if (argc != 3)
+				r = -EINVAL;
+			else
+			{
+				void *buf;
+				size_t buffsize, *bytesgrabbed;
+
+				buf = va_arg(ap, void *);
+				buffsize = *va_arg(ap, size_t *);
+				bytesgrabbed = va_arg(ap, size_t *);
+
+				r = fli_camera_grab_frame(dev, buf, buffsize, bytesgrabbed);
+			}
+			break;
+
 		case FLI_EXPOSE_FRAME:
 			if (argc != 0)
 				r = -EINVAL;
@@ -1302,3 +1321,52 @@ static long fli_camera_set_flushes(flidev_t dev, long nflushes)
 
   return 0;
 }
+
+/* Grab as many whole rows of the current image area as fit in buffsize.
+ * The per domain row grabbers already batch the USB transfers, so calling
+ * them back to back keeps the bulk pipe busy without a round trip through
+ * the public API for every row. */
+static long fli_camera_grab_frame(flidev_t dev, void *buff,
+				  size_t buffsize, size_t *bytesgrabbed)
+{
+  flicamdata_t *cam;
+  size_t width, rowsize, rows, i;
+  long r = 0;
+
+  cam = DEVICE->device_data;
+  *bytesgrabbed = 0;
+
+  if (cam->image_area.lr.x <= cam->image_area.ul.x)
+    return -EINVAL;
+
+  width = (size_t) (cam->image_area.lr.x - cam->image_area.ul.x);
+  rowsize = width * ((cam->bitdepth == FLI_MODE_8BIT) ? 1 : 2);
+  rows = buffsize / rowsize;
+
+  if (rows == 0)
+    return -EINVAL;
+
+  for (i = 0; i < rows; i++)
+  {
+    switch (DEVICE->domain)
+    {
+      case FLIDOMAIN_PARALLEL_PORT:
+        r = fli_camera_parport_grab_row(dev, (char *) buff + i * rowsize, width);
+        break;
+
+      case FLIDOMAIN_USB:
+        r = fli_camera_usb_grab_row(dev, (char *) buff + i * rowsize, width);
+        break;
+
+      default:
+        r = -EINVAL;
+    }
+
+    if (r != 0)
+      break;
+
+    *bytesgrabbed += rowsize;
+  }
+
+  return r;
+}
@@ -225,14 +225,33 @@ LIBFLIAPI FLIUsbBulkIO(flidev_t dev, int ep, void *buf, long *len)
 	return usb_bulktransfer(dev, ep, buf, len);
 }
 
+/**
+   Grab image rows from a given camera in one call.  This function
+   reads as many whole rows of the current image area as fit in
+   \texttt{buffsize} bytes, so it can be used to download the full
+   frame at once or a band of rows at a time.  The number of bytes
+   actually stored is returned in \texttt{bytesgrabbed}.
+
+   @param dev Camera whose image to grab.
+
+   @param buff Pointer to where the rows will be placed.
+
+   @param buffsize Size of \texttt{buff} in bytes.
+
+   @param bytesgrabbed Pointer to where the number of bytes grabbed
+   will be placed.
+
+   @return Zero on success.
+   @return Non-zero on failure.
+
+   @see FLIGrabRow
+*/
 LIBFLIAPI FLIGrabFrame(flidev_t dev, void* buff,
 		       size_t buffsize, size_t* bytesgrabbed)
 {
-  INDI_UNUSED(dev);
-  INDI_UNUSED(buff);
-  INDI_UNUSED(buffsize);
-  INDI_UNUSED(bytesgrabbed);
-	return -EINVAL;
+  CHKDEVICE(dev);
+
+  return DEVICE->fli_command(dev, FLI_GRAB_FRAME, 3, buff, &buffsize, bytesgrabbed);
 }
 
 /**
@@ -15,6 +15,11 @@ REVISION HISTORY
 #include "QSI_Interface.h"
 #include "IHostIO.h"
 #include "QSIError.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Constructor
@@ -2514,6 +2519,56 @@ void QSI_Interface::GetAutoZeroAdjustment(QSI_AutoZeroData autoZeroData, USHORT
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Add the AutoZero adjustment and limit to Max ADU, 8 pixels at a time with saturating
+// 16 bit arithmetic. Same result as the per pixel loop in AdjustZero for adjustments
+// and Max ADU values that fit in 16 bits.
+static void AdjustZeroPixels(const USHORT* pSrc, USHORT* pDst, int iCount, int iAdjust, int iMaxADU)
+{
+	if (iAdjust > 65535) iAdjust = 65535;
+	if (iAdjust < -65535) iAdjust = -65535;
+	if (iMaxADU > 65535) iMaxADU = 65535;
+	if (iMaxADU < 0) iMaxADU = 0;
+
+	const USHORT usAdd = iAdjust > 0 ? (USHORT)iAdjust : 0;
+	const USHORT usSub = iAdjust < 0 ? (USHORT)(-iAdjust) : 0;
+	const USHORT usMax = (USHORT)iMaxADU;
+	int i = 0;
+
+#if defined(__SSE2__)
+	const __m128i vAdd = _mm_set1_epi16((short)usAdd);
+	const __m128i vSub = _mm_set1_epi16((short)usSub);
+	const __m128i vMax = _mm_set1_epi16((short)usMax);
+	for (; i + 8 <= iCount; i += 8)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(pSrc + i));
+		v = _mm_subs_epu16(_mm_adds_epu16(v, vAdd), vSub);
+		// SSE2 has no unsigned 16 bit min: min(a,b) = a - (a -sat b)
+		v = _mm_sub_epi16(v, _mm_subs_epu16(v, vMax));
+		_mm_storeu_si128((__m128i*)(pDst + i), v);
+	}
+#elif defined(__ARM_NEON)
+	const uint16x8_t vAdd = vdupq_n_u16(usAdd);
+	const uint16x8_t vSub = vdupq_n_u16(usSub);
+	const uint16x8_t vMax = vdupq_n_u16(usMax);
+	for (; i + 8 <= iCount; i += 8)
+	{
+		uint16x8_t v = vld1q_u16(pSrc + i);
+		v = vminq_u16(vqsubq_u16(vqaddq_u16(v, vAdd), vSub), vMax);
+		vst1q_u16(pDst + i, v);
+	}
+#endif
+
+	for (; i < iCount; i++)
+	{
+		int pixel = (int)pSrc[i] + usAdd - usSub;
+		if (pixel < 0) pixel = 0;
+		if (pixel > 65535) pixel = 65535;
+		if (pixel > usMax) pixel = usMax;
+		pDst[i] = (USHORT)pixel;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // AutoZero (drift adjust) the image using the median value of the zero data
 int QSI_Interface::AdjustZero(USHORT* pSrc, USHORT* pDst, int iPixelsPerRow, int iRowsLeft, int usAdjust, bool bAdjust)
@@ -2534,21 +2589,35 @@ int QSI_Interface::AdjustZero(USHORT* pSrc, USHORT* pDst, int iPixelsPerRow, int
 		bAdjust = false;
 	}
 
-	m_log->Write(6, _T("First row of un-adjusted image data (up to the first 512 bytes):"));
+	if (m_log->LoggingEnabled(6))
+	{
+		m_log->Write(6, _T("First row of un-adjusted image data (up to the first 512 bytes):"));
 
-	int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
-	int iLines = (iSampleSize / 16);
-	if (iSampleSize % 16 > 0)
-		iLines++;
+		int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
+		int iLines = (iSampleSize / 16);
+		if (iSampleSize % 16 > 0)
+			iLines++;
 
-	for (int i = 0; i < iLines; i++)
-	{
-		for (int j = 0; j < 16 && iSampleSize > 0; j++)
+		for (int i = 0; i < iLines; i++)
 		{
-			snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pSrc)[(i*16)+j]);
-			iSampleSize--;
+			for (int j = 0; j < 16 && iSampleSize > 0; j++)
+			{
+				snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pSrc)[(i*16)+j]);
+				iSampleSize--;
+			}
+			m_log->Write(6);
 		}
-		m_log->Write(6);
+	}
+
+	//
+	// The pixel statistics are only ever logged at level 6, so without
+	// logging the image is adjusted by the vector code in a single pass
+	//
+	if (!m_log->LoggingEnabled(6))
+	{
+		AdjustZeroPixels(pSrc, pDst, iPixelsPerRow * iRowsLeft, bAdjust ? usAdjust : 0, m_dwAutoZeroMaxADU);
+		m_log->Write(2, _T("AutoZero adjust pixels (unsigned short) complete."));
+		return result;
 	}
 
 	//
@@ -2585,33 +2654,27 @@ int QSI_Interface::AdjustZero(USHORT* pSrc, USHORT* pDst, int iPixelsPerRow, int
 		}
 	}
 
-	if (m_log->LoggingEnabled(6) || (m_log->LoggingEnabled(1) && iNegPixelCount > 0) )
-	{
-		m_log->Write(6, _T("AutoZero Data:"));
-		snprintf(m_log->m_Message, MSGSIZE, _T("NegPixels: %d, Lowest Net Pixel: %d, Pixels Exceeding Sat Threshold : %d"),
-											 iNegPixelCount, iLowPixel, iSatPixelCount );
-		m_log->Write(6);
-	}
+	m_log->Write(6, _T("AutoZero Data:"));
+	snprintf(m_log->m_Message, MSGSIZE, _T("NegPixels: %d, Lowest Net Pixel: %d, Pixels Exceeding Sat Threshold : %d"),
+										 iNegPixelCount, iLowPixel, iSatPixelCount );
+	m_log->Write(6);
 
-	if (m_log->LoggingEnabled(6))
-	{
-		m_log->Write(6, _T("First row of adjusted image data (up to the first 512 bytes):"));
+	m_log->Write(6, _T("First row of adjusted image data (up to the first 512 bytes):"));
 
-		int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
+	int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
 
-		int iLines = (iSampleSize / 16);
-		if (iSampleSize % 16 > 0)
-			iLines++;
+	int iLines = (iSampleSize / 16);
+	if (iSampleSize % 16 > 0)
+		iLines++;
 
-		for (int i = 0; i < iLines; i++)
+	for (int i = 0; i < iLines; i++)
+	{
+		for (int j = 0; j < 16 && iSampleSize > 0; j++)
 		{
-			for (int j = 0; j < 16 && iSampleSize > 0; j++)
-			{
-				snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pDst)[(i*16)+j]);
-				iSampleSize--;
-			}
-			m_log->Write(6);
+			snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pDst)[(i*16)+j]);
+			iSampleSize--;
 		}
+		m_log->Write(6);
 	}
 	m_log->Write(2, _T("AutoZero adjust pixels (unsigned short) complete."));
 	return result;
@@ -2740,21 +2803,24 @@ int QSI_Interface::AdjustZero(USHORT* pSrc, long* pDst, int iPixelsPerRow, int i
 		bAdjust = false;
 	}
 
-	m_log->Write(6, _T("First row of un-adjusted image data (up to the first 512 bytes):"));
+	if (m_log->LoggingEnabled(6))
+	{
+		m_log->Write(6, _T("First row of un-adjusted image data (up to the first 512 bytes):"));
 
-	int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
-	int iLines = (iSampleSize / 16);
-	if (iSampleSize % 16 > 0)
-		iLines++;
+		int iSampleSize = iPixelsPerRow  > 512 ? 512 : iPixelsPerRow;
+		int iLines = (iSampleSize / 16);
+		if (iSampleSize % 16 > 0)
+			iLines++;
 
-	for (int i = 0; i < iLines; i++)
-	{
-		for (int j = 0; j < 16 && iSampleSize > 0; j++)
+		for (int i = 0; i < iLines; i++)
 		{
-			snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pSrc)[(i*16)+j]);
-			iSampleSize--;
+			for (int j = 0; j < 16 && iSampleSize > 0; j++)
+			{
+				snprintf(m_log->m_Message+(j*6), MSGSIZE, _T("%5u "), ((unsigned short*)pSrc)[(i*16)+j]);
+				iSampleSize--;
+			}
+			m_log->Write(6);
 		}
-		m_log->Write(6);
 	}
 
 	//